@@ -0,0 +1,367 @@
+// Decoder microbenchmarks: per-function ns/frame percentiles, throughput and heap allocations.
+// Runs headless on any platform; --json emits a machine-readable report for tracking across versions.
+#include "AllocationCounter.h"
+#include "FrameCorpus.h"
+#include "BatchDecoder.h"
+#include "MotionFusion.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifndef JOYCON2_VERSION
+#define JOYCON2_VERSION "unknown"
+#endif
+#ifndef JOYCON2_BUILD_TYPE
+#define JOYCON2_BUILD_TYPE "unknown"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the optimizer from discarding results
+volatile uint32_t g_sink;
+
+uint32_t Fold(const DS4_REPORT_EX& report) {
+    return report.Report.bThumbLX ^ (report.Report.bThumbRY << 8) ^ (report.Report.wButtons << 16) ^
+           static_cast<uint16_t>(report.Report.wGyroX) ^ report.Report.bTriggerL;
+}
+
+struct BenchOptions {
+    size_t samples = 200;
+    size_t batch = 1024;
+    size_t corpusFrames = 4096;
+    std::string capturePath;
+    CorpusKind captureKind = CorpusKind::JoyConLeft;
+    std::string filter;
+    bool json = false;
+    std::string jsonPath;  // empty or "-" = stdout
+};
+
+struct BenchResult {
+    std::string name;
+    std::string corpus;
+    size_t frames = 0;
+    double throughputFps = 0;
+    double nsMin = 0, nsMean = 0, nsP50 = 0, nsP90 = 0, nsP99 = 0, nsMax = 0;
+    double allocsPerFrame = 0;
+    double bytesPerFrame = 0;
+};
+
+double Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    double rank = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(rank);
+    size_t hi = (std::min)(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+BenchResult Summarize(const std::string& name, const FrameCorpus& corpus, std::vector<double>& perFrame,
+                      double totalNs, size_t frames, uint64_t allocs, uint64_t bytes) {
+    std::sort(perFrame.begin(), perFrame.end());
+    BenchResult r;
+    r.name = name;
+    r.corpus = CorpusKindName(corpus.kind);
+    r.frames = frames;
+    r.throughputFps = totalNs > 0 ? frames * 1e9 / totalNs : 0;
+    r.nsMin = perFrame.front();
+    r.nsMax = perFrame.back();
+    r.nsMean = totalNs / frames;
+    r.nsP50 = Percentile(perFrame, 0.50);
+    r.nsP90 = Percentile(perFrame, 0.90);
+    r.nsP99 = Percentile(perFrame, 0.99);
+    r.allocsPerFrame = static_cast<double>(allocs) / frames;
+    r.bytesPerFrame = static_cast<double>(bytes) / frames;
+    return r;
+}
+
+// Each sample times one batch of frames (cycling through the corpus); the per-sample
+// ns/frame values form the percentile distribution.
+BenchResult Measure(const std::string& name, const FrameCorpus& corpus, const BenchOptions& opt,
+                    const std::function<uint32_t(size_t)>& body) {
+    const size_t count = corpus.frames.size();
+    uint32_t sink = 0;
+    for (size_t i = 0; i < (std::min)(count, opt.batch); ++i) sink ^= body(i);  // warm-up
+
+    std::vector<double> perFrame;
+    perFrame.reserve(opt.samples);
+    size_t cursor = 0;
+    double totalNs = 0;
+
+    uint64_t allocsBefore = AllocationCount();
+    uint64_t bytesBefore = AllocatedBytes();
+    for (size_t s = 0; s < opt.samples; ++s) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < opt.batch; ++i) {
+            sink ^= body(cursor);
+            if (++cursor == count) cursor = 0;
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        totalNs += ns;
+        perFrame.push_back(ns / opt.batch);
+    }
+    uint64_t allocs = AllocationCount() - allocsBefore;
+    uint64_t bytes = AllocatedBytes() - bytesBefore;
+    g_sink = sink;
+    return Summarize(name, corpus, perFrame, totalNs, opt.samples * opt.batch, allocs, bytes);
+}
+
+// Batch decoding: each sample decodes the whole corpus in one DecodeFrameBatch call into a
+// reused FrameBatch, so steady-state runs should show zero allocations
+BenchResult MeasureBatch(BatchKernel kernel, const FrameCorpus& corpus, const BenchOptions& opt) {
+    std::vector<uint8_t> flat;
+    flat.reserve(corpus.frames.size() * JOYCON_FRAME_SIZE);
+    for (const RawFrame& raw : corpus.frames) flat.insert(flat.end(), raw.begin(), raw.end());
+
+    FrameBatch batch;
+    DecodeFrameBatch(flat, corpus.lengths, batch, kernel);  // warm-up, sizes the output
+
+    std::vector<double> perFrame;
+    perFrame.reserve(opt.samples);
+    double totalNs = 0;
+    uint32_t sink = 0;
+    uint64_t allocsBefore = AllocationCount();
+    uint64_t bytesBefore = AllocatedBytes();
+    for (size_t s = 0; s < opt.samples; ++s) {
+        auto start = Clock::now();
+        DecodeFrameBatch(flat, corpus.lengths, batch, kernel);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        sink ^= batch.leftX[s % batch.count] ^ static_cast<uint16_t>(batch.gyroZ[s % batch.count]);
+        totalNs += ns;
+        perFrame.push_back(ns / batch.count);
+    }
+    uint64_t allocs = AllocationCount() - allocsBefore;
+    uint64_t bytes = AllocatedBytes() - bytesBefore;
+    g_sink = sink;
+    std::string name = std::string("DecodeFrameBatch/") + BatchKernelName(kernel);
+    return Summarize(name, corpus, perFrame, totalNs, opt.samples * batch.count, allocs, bytes);
+}
+
+std::vector<JoyConInputFrame> DecodeAll(const FrameCorpus& corpus) {
+    std::vector<JoyConInputFrame> out;
+    out.reserve(corpus.frames.size());
+    for (size_t i = 0; i < corpus.frames.size(); ++i)
+        out.push_back(DecodeInputFrame(corpus.frames[i], corpus.lengths[i]));
+    return out;
+}
+
+JoyConSide StickSide(CorpusKind kind) {
+    return kind == CorpusKind::JoyConRight ? JoyConSide::Right : JoyConSide::Left;
+}
+
+void RunCorpus(const FrameCorpus& corpus, const FrameCorpus* partner, const BenchOptions& opt,
+               std::vector<BenchResult>& results) {
+    const std::vector<JoyConInputFrame> decoded = DecodeAll(corpus);
+    const CorpusKind kind = corpus.kind;
+    const JoyConSide side = StickSide(kind);
+
+    auto run = [&](const std::string& name, const std::function<uint32_t(size_t)>& body) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) return;
+        results.push_back(Measure(name, corpus, opt, body));
+    };
+
+    run("DecodeInputFrame", [&](size_t i) {
+        JoyConInputFrame f = DecodeInputFrame(corpus.frames[i], corpus.lengths[i]);
+        return static_cast<uint32_t>(f.buttons) ^ f.leftStick.x ^ f.rightStick.y ^ static_cast<uint16_t>(f.motion.gyroZ);
+    });
+    run("DecodeJoystick", [&](size_t i) {
+        StickData s = DecodeJoystick(decoded[i], side, JoyConOrientation::Upright);
+        return static_cast<uint32_t>(static_cast<uint16_t>(s.x)) ^ (static_cast<uint32_t>(static_cast<uint16_t>(s.y)) << 16);
+    });
+    run("DecodeMotion", [&](size_t i) {
+        MotionData m = DecodeMotion(corpus.frames[i]);
+        return static_cast<uint32_t>(static_cast<uint16_t>(m.gyroX)) ^ static_cast<uint16_t>(m.accelZ);
+    });
+
+    // Orientation fusion: one IMU, and one frame for each of 8 connected controllers
+    MotionFusion fusion[8];
+    run("MotionFusion/1", [&](size_t i) {
+        fusion[0].Update(decoded[i].motion);
+        return static_cast<uint32_t>(fusion[0].Orientation().w * 65536.0f);
+    });
+    run("MotionFusion/8", [&](size_t i) {
+        uint32_t sink = 0;
+        for (size_t c = 0; c < 8; ++c) {
+            fusion[c].Update(decoded[(i + c * 97) % decoded.size()].motion);
+            sink ^= static_cast<uint32_t>(fusion[c].Gravity().z * 65536.0f);
+        }
+        return sink;
+    });
+
+    BatchKernel previous = BatchKernel::Auto;
+    for (BatchKernel kernel : { BatchKernel::Scalar, BatchKernel::SSE2, BatchKernel::AVX2 }) {
+        // Skip kernels the CPU or build lacks (they resolve to one already measured)
+        BatchKernel resolved = ResolveBatchKernel(kernel);
+        if (resolved != kernel || resolved == previous) continue;
+        previous = resolved;
+        std::string name = std::string("DecodeFrameBatch/") + BatchKernelName(kernel);
+        if (opt.filter.empty() || name.find(opt.filter) != std::string::npos)
+            results.push_back(MeasureBatch(kernel, corpus, opt));
+    }
+
+    switch (kind) {
+    case CorpusKind::JoyConLeft:
+    case CorpusKind::JoyConRight:
+        run("GenerateDS4Report/upright", [&](size_t i) {
+            return Fold(GenerateDS4Report(decoded[i], side, JoyConOrientation::Upright));
+        });
+        run("GenerateDS4Report/sideways", [&](size_t i) {
+            return Fold(GenerateDS4Report(decoded[i], side, JoyConOrientation::Sideways));
+        });
+        if (kind == CorpusKind::JoyConLeft && partner) {
+            const std::vector<JoyConInputFrame> right = DecodeAll(*partner);
+            run("GenerateDualJoyConDS4Report", [&](size_t i) {
+                return Fold(GenerateDualJoyConDS4Report(decoded[i], right[i % right.size()], GyroSource::Both));
+            });
+        }
+        break;
+    case CorpusKind::ProController:
+        run("GenerateProControllerReport", [&](size_t i) {
+            return Fold(GenerateProControllerReport(decoded[i]));
+        });
+        break;
+    case CorpusKind::NSOGC:
+        run("GenerateNSOGCReport", [&](size_t i) {
+            return Fold(GenerateNSOGCReport(decoded[i]));
+        });
+        break;
+    }
+}
+
+void PrintTable(const std::vector<BenchResult>& results) {
+    std::printf("%-30s %-15s %9s %9s %9s %9s %13s %8s\n",
+                "function", "corpus", "p50 ns", "p90 ns", "p99 ns", "mean ns", "frames/s", "allocs");
+    for (const BenchResult& r : results) {
+        std::printf("%-30s %-15s %9.1f %9.1f %9.1f %9.1f %13.0f %8.3f\n",
+                    r.name.c_str(), r.corpus.c_str(), r.nsP50, r.nsP90, r.nsP99, r.nsMean,
+                    r.throughputFps, r.allocsPerFrame);
+    }
+}
+
+std::string CompilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string JsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out += c;
+    }
+    return out;
+}
+
+void WriteJson(FILE* out, const BenchOptions& opt, size_t corpusFrames, const std::vector<BenchResult>& results) {
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"benchmark\": \"joycon2_core_bench\",\n");
+    std::fprintf(out, "  \"version\": \"%s\",\n", JOYCON2_VERSION);
+    std::fprintf(out, "  \"build_type\": \"%s\",\n", JOYCON2_BUILD_TYPE);
+    std::fprintf(out, "  \"compiler\": \"%s\",\n", JsonEscape(CompilerName()).c_str());
+    std::fprintf(out, "  \"corpus\": \"%s\",\n", opt.capturePath.empty() ? "synthetic" : JsonEscape(opt.capturePath).c_str());
+    std::fprintf(out, "  \"corpus_frames\": %zu,\n", corpusFrames);
+    std::fprintf(out, "  \"samples\": %zu,\n", opt.samples);
+    std::fprintf(out, "  \"batch\": %zu,\n", opt.batch);
+    std::fprintf(out, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::fprintf(out,
+            "    {\"function\": \"%s\", \"corpus\": \"%s\", \"frames\": %zu, \"throughput_fps\": %.1f, "
+            "\"ns_per_frame\": {\"min\": %.3f, \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}, "
+            "\"allocs_per_frame\": %.6f, \"alloc_bytes_per_frame\": %.3f}%s\n",
+            r.name.c_str(), r.corpus.c_str(), r.frames, r.throughputFps,
+            r.nsMin, r.nsMean, r.nsP50, r.nsP90, r.nsP99, r.nsMax,
+            r.allocsPerFrame, r.bytesPerFrame, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
+
+void PrintUsage() {
+    std::printf(
+        "usage: joycon2_core_bench [options]\n"
+        "  --samples N          timed batches per function (default 200)\n"
+        "  --batch N            frames per timed batch (default 1024)\n"
+        "  --frames N           synthetic frames per controller type (default 4096)\n"
+        "  --capture FILE       use a hex capture (one notification per line) instead of synthetic frames\n"
+        "  --kind left|right|pro|gc   controller type of the capture (default left)\n"
+        "  --filter TEXT        only run functions whose name contains TEXT\n"
+        "  --json [FILE]        write a JSON report to FILE (or stdout)\n");
+}
+
+bool ParseArgs(int argc, char** argv, BenchOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--samples" && hasValue) opt.samples = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--batch" && hasValue) opt.batch = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--frames" && hasValue) opt.corpusFrames = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--capture" && hasValue) opt.capturePath = argv[++i];
+        else if (arg == "--kind" && hasValue) { if (!ParseCorpusKind(argv[++i], opt.captureKind)) return false; }
+        else if (arg == "--filter" && hasValue) opt.filter = argv[++i];
+        else if (arg == "--json") {
+            opt.json = true;
+            if (hasValue && argv[i + 1][0] != '-') opt.jsonPath = argv[++i];
+            else if (hasValue && !std::strcmp(argv[i + 1], "-")) ++i;
+        }
+        else return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!ParseArgs(argc, argv, opt)) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::vector<FrameCorpus> corpora;
+    if (!opt.capturePath.empty()) {
+        FrameCorpus capture;
+        if (!LoadHexCorpus(opt.capturePath, opt.captureKind, capture)) {
+            std::fprintf(stderr, "failed to load capture %s\n", opt.capturePath.c_str());
+            return 1;
+        }
+        corpora.push_back(std::move(capture));
+    } else {
+        for (CorpusKind kind : { CorpusKind::JoyConLeft, CorpusKind::JoyConRight, CorpusKind::ProController, CorpusKind::NSOGC })
+            corpora.push_back(MakeSyntheticCorpus(kind, opt.corpusFrames));
+    }
+
+    // Dual Joy-Con pairs the left corpus with the right one (or with itself for a capture)
+    const FrameCorpus* rightCorpus = corpora.size() > 1 ? &corpora[1] : &corpora[0];
+
+    std::vector<BenchResult> results;
+    size_t corpusFrames = 0;
+    for (const FrameCorpus& corpus : corpora) {
+        corpusFrames += corpus.frames.size();
+        RunCorpus(corpus, rightCorpus, opt, results);
+    }
+
+    if (!opt.json) {
+        PrintTable(results);
+        return 0;
+    }
+    FILE* out = opt.jsonPath.empty() ? stdout : std::fopen(opt.jsonPath.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "failed to open %s\n", opt.jsonPath.c_str());
+        return 1;
+    }
+    WriteJson(out, opt, corpusFrames, results);
+    if (out != stdout) std::fclose(out);
+    return 0;
+}
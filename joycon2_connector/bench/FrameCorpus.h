@@ -0,0 +1,134 @@
+#pragma once
+// Frame sets fed to the benchmarks: synthetic per controller type, or loaded from a hex capture
+#include "SampleFrames.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+enum class CorpusKind { JoyConLeft, JoyConRight, ProController, NSOGC };
+
+struct FrameCorpus {
+    CorpusKind kind;
+    std::vector<RawFrame> frames;
+    std::vector<uint32_t> lengths;
+};
+
+inline const char* CorpusKindName(CorpusKind kind) {
+    switch (kind) {
+    case CorpusKind::JoyConLeft: return "joycon_left";
+    case CorpusKind::JoyConRight: return "joycon_right";
+    case CorpusKind::ProController: return "pro_controller";
+    case CorpusKind::NSOGC: return "nso_gc";
+    }
+    return "unknown";
+}
+
+// Command-line spelling: left, right, pro, gc
+inline bool ParseCorpusKind(const char* s, CorpusKind& kind) {
+    if (!std::strcmp(s, "left")) kind = CorpusKind::JoyConLeft;
+    else if (!std::strcmp(s, "right")) kind = CorpusKind::JoyConRight;
+    else if (!std::strcmp(s, "pro")) kind = CorpusKind::ProController;
+    else if (!std::strcmp(s, "gc")) kind = CorpusKind::NSOGC;
+    else return false;
+    return true;
+}
+
+// xorshift32: deterministic across platforms so results are comparable between runs
+struct CorpusRng {
+    uint32_t state;
+    uint32_t Next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    int Range(int lo, int hi) { return lo + static_cast<int>(Next() % static_cast<uint32_t>(hi - lo + 1)); }
+};
+
+inline void PutStick(RawFrame& raw, size_t offset, uint16_t x, uint16_t y) {
+    raw[offset] = static_cast<uint8_t>(x & 0xFF);
+    raw[offset + 1] = static_cast<uint8_t>(((x >> 8) & 0x0F) | ((y & 0x0F) << 4));
+    raw[offset + 2] = static_cast<uint8_t>(y >> 4);
+}
+
+inline void PutShort(RawFrame& raw, size_t offset, int16_t value) {
+    raw[offset] = static_cast<uint8_t>(value & 0xFF);
+    raw[offset + 1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+}
+
+// Sticks mostly near center with regular full deflections, so the deadzone and clamp
+// branches are both exercised; a few buttons held at a time; IMU noise around 1G
+inline uint16_t RandomStickAxis(CorpusRng& rng) {
+    switch (rng.Next() % 4) {
+    case 0: return static_cast<uint16_t>(rng.Range(2048 - 60, 2048 + 60));
+    case 1: return static_cast<uint16_t>(rng.Range(0, 4095));
+    case 2: return static_cast<uint16_t>(rng.Range(0, 300));
+    default: return static_cast<uint16_t>(rng.Range(3800, 4095));
+    }
+}
+
+inline FrameCorpus MakeSyntheticCorpus(CorpusKind kind, size_t count, uint32_t seed = 0x4A43324Bu) {
+    FrameCorpus corpus{ kind, {}, {} };
+    corpus.frames.reserve(count);
+    corpus.lengths.assign(count, sizeof(SAMPLE_NOTIFICATION));
+    CorpusRng rng{ seed ^ (static_cast<uint32_t>(kind) * 0x9E3779B9u) };
+
+    for (size_t i = 0; i < count; ++i) {
+        RawFrame raw = MakeSampleFrame();
+
+        uint64_t state = 0;
+        for (int bit = 0; bit < 48; ++bit)
+            if (rng.Next() % 12 == 0) state |= 1ull << bit;
+        SetButtonBytes(raw, state);
+
+        PutStick(raw, 10, RandomStickAxis(rng), RandomStickAxis(rng));
+        if (kind != CorpusKind::JoyConLeft)
+            PutStick(raw, 13, RandomStickAxis(rng), RandomStickAxis(rng));
+
+        if (kind == CorpusKind::JoyConRight) {
+            PutShort(raw, 0x10, static_cast<int16_t>(rng.Range(-2000, 2000)));
+            PutShort(raw, 0x12, static_cast<int16_t>(rng.Range(-2000, 2000)));
+        }
+
+        for (size_t axis = 0; axis < 3; ++axis)
+            PutShort(raw, 0x30 + axis * 2, static_cast<int16_t>(rng.Range(-600, 600) + (axis == 2 ? 4096 : 0)));
+        for (size_t axis = 0; axis < 3; ++axis)
+            PutShort(raw, 0x36 + axis * 2, static_cast<int16_t>(rng.Range(-3000, 3000)));
+
+        if (kind == CorpusKind::NSOGC) {
+            raw[0x3C] = static_cast<uint8_t>(rng.Range(0, 255));
+            raw[0x3D] = static_cast<uint8_t>(rng.Range(0, 255));
+        }
+        corpus.frames.push_back(raw);
+    }
+    return corpus;
+}
+
+// Hex capture: one notification per line as space-separated bytes ("08 67 00 ..."),
+// '#' starts a comment. Bytes past JOYCON_FRAME_SIZE are ignored.
+inline bool LoadHexCorpus(const std::string& path, CorpusKind kind, FrameCorpus& corpus) {
+    FILE* file = std::fopen(path.c_str(), "r");
+    if (!file) return false;
+
+    corpus = FrameCorpus{ kind, {}, {} };
+    char line[1024];
+    while (std::fgets(line, sizeof(line), file)) {
+        RawFrame raw{};
+        uint32_t length = 0;
+        const char* p = line;
+        while (*p && *p != '#' && *p != '\n') {
+            unsigned value = 0;
+            int consumed = 0;
+            if (std::sscanf(p, " %2x%n", &value, &consumed) != 1) break;
+            if (length < JOYCON_FRAME_SIZE) raw[length] = static_cast<uint8_t>(value);
+            ++length;
+            p += consumed;
+        }
+        if (length == 0) continue;
+        corpus.frames.push_back(raw);
+        corpus.lengths.push_back(length);
+    }
+    std::fclose(file);
+    return !corpus.frames.empty();
+}
@@ -80,8 +80,9 @@ static NavItem g_navItems[] = {
     { "nav_add_device" },
     { "nav_layout_mgr" },
     { "nav_mouse_settings" },
+    { "nav_stick_settings" },
 };
-static const int NAV_COUNT = 4;
+static const int NAV_COUNT = 5;
 
 // Windows system font candidates
 static const char* FONT_CJK_CANDIDATES[] = { "msyh.ttc", "msyhbd.ttc", "simsun.ttc", "malgun.ttf" };
@@ -619,6 +620,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
         }
     }
 
+    // Emulator motion server, if enabled in the config
+    PlayerManager::Instance().ApplyDsuConfig();
+
     // Clear color
     float clearColor[4] = { 0.96f, 0.94f, 0.92f, 1.0f };
 
@@ -687,6 +691,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
         case 1: RenderAddDevice(g_activePage); break;
         case 2: RenderLayoutManager(); break;
         case 3: RenderMouseSettings(); break;
+        case 4: RenderStickSettings(); break;
         }
         ImGui::EndChild();
 
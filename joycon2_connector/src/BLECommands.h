@@ -2,7 +2,11 @@
 // BLE Commands for Joy-Con / Pro Controller communication
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Storage.Streams.h>
+#include <winrt/Windows.Devices.Bluetooth.h>
 #include <winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h>
+#include "CaptureFile.h"
+#include "SensorClock.h"
+#include "VibrationMapping.h"
 #include <vector>
 #include <thread>
 #include <chrono>
@@ -11,6 +15,15 @@ using namespace winrt;
 using namespace Windows::Devices::Bluetooth::GenericAttributeProfile;
 using namespace Windows::Storage::Streams;
 
+// Adds the write to the session capture while one is recording (see CaptureFile.h)
+inline void CaptureCommandWrite(GattCharacteristic const& characteristic, IBuffer const& buffer) {
+    if (!CaptureSession::Instance().Running()) return;
+    try {
+        uint64_t address = characteristic.Service().Device().BluetoothAddress();
+        CaptureSession::Instance().CommandWrite(address, buffer.data(), buffer.Length(), SteadyMicros(std::chrono::steady_clock::now()));
+    } catch (...) {}
+}
+
 inline void SendGenericCommand(GattCharacteristic const& characteristic, uint8_t cmdId, uint8_t subCmdId, const std::vector<uint8_t>& data) {
     if (!characteristic) return;
 
@@ -26,6 +39,7 @@ inline void SendGenericCommand(GattCharacteristic const& characteristic, uint8_t
     for (uint8_t b : data) writer.WriteByte(b);
 
     IBuffer buffer = writer.DetachBuffer();
+    CaptureCommandWrite(characteristic, buffer);
     characteristic.WriteValueAsync(buffer, GattWriteOption::WriteWithoutResponse).get();
     std::this_thread::sleep_for(std::chrono::milliseconds(35));
 }
@@ -40,6 +54,7 @@ inline void SendCustomCommands(GattCharacteristic const& characteristic) {
         auto writer = DataWriter();
         writer.WriteBytes(cmd);
         IBuffer buffer = writer.DetachBuffer();
+        CaptureCommandWrite(characteristic, buffer);
         characteristic.WriteValueAsync(buffer, GattWriteOption::WriteWithoutResponse).get();
         std::this_thread::sleep_for(std::chrono::milliseconds(300));
     }
@@ -57,18 +72,6 @@ inline void SetPlayerLEDs(GattCharacteristic const& characteristic, uint8_t patt
     SendGenericCommand(characteristic, 0x09, 0x07, data);
 }
 
-// Vibration sample IDs (from protocol reverse engineering)
-enum VibrationSample : uint8_t {
-    VIB_NONE        = 0x00,  // No sound / stop
-    VIB_BUZZ        = 0x01,  // 1s sustained buzz
-    VIB_FIND        = 0x02,  // Find controller (high pitch + beeps)
-    VIB_CONNECT     = 0x03,  // Button click sound
-    VIB_PAIRING     = 0x04,  // Pairing sound
-    VIB_STRONG_THUNK= 0x05,  // Strong thunk impact
-    VIB_DUN         = 0x06,  // Short dun
-    VIB_DING        = 0x07,  // Short ding
-};
-
 // Send a predefined vibration sample via the command channel
 inline void SendVibrationSample(GattCharacteristic const& characteristic, uint8_t sampleId) {
     std::vector<uint8_t> data(8, 0x00);
@@ -92,6 +95,7 @@ inline void SendRawVibration(GattCharacteristic const& characteristic,
     writer.WriteByte(0x00);                                      // [15] padding
 
     IBuffer buffer = writer.DetachBuffer();
+    CaptureCommandWrite(characteristic, buffer);
     characteristic.WriteValueAsync(buffer, GattWriteOption::WriteWithoutResponse).get();
     // No sleep — raw vibration needs low latency
 }
@@ -0,0 +1,206 @@
+#include "BatchDecoder.h"
+#include "BatchDecoderKernels.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JOYCON2_HAVE_SSE2_KERNEL 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(JOYCON2_HAVE_AVX2_KERNEL)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+static_assert(BATCH_FRAME_STRIDE == JOYCON_FRAME_SIZE, "batch kernels assume 64-byte frames");
+
+void FrameBatch::Resize(size_t n) {
+    count = n;
+    buttons.resize(n);
+    leftX.resize(n); leftY.resize(n);
+    rightX.resize(n); rightY.resize(n);
+    accelX.resize(n); accelY.resize(n); accelZ.resize(n);
+    gyroX.resize(n); gyroY.resize(n); gyroZ.resize(n);
+    triggerL.resize(n); triggerR.resize(n);
+}
+
+static bool cpu_has_avx2() {
+#if !defined(JOYCON2_HAVE_AVX2_KERNEL)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+BatchKernel ResolveBatchKernel(BatchKernel requested) {
+    static const bool avx2 = cpu_has_avx2();
+    if (requested == BatchKernel::Auto || requested == BatchKernel::AVX2) {
+        if (avx2) return BatchKernel::AVX2;
+        requested = BatchKernel::SSE2;
+    }
+#ifdef JOYCON2_HAVE_SSE2_KERNEL
+    if (requested == BatchKernel::SSE2) return BatchKernel::SSE2;
+#endif
+    return BatchKernel::Scalar;
+}
+
+const char* BatchKernelName(BatchKernel kernel) {
+    switch (kernel) {
+    case BatchKernel::Auto: return "auto";
+    case BatchKernel::Scalar: return "scalar";
+    case BatchKernel::SSE2: return "sse2";
+    case BatchKernel::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+// Recorded streams use the Joy-Con 2 layout. The SIMD kernels load fixed 16-byte blocks
+// (sticks in the block at 0x00, IMU and triggers in the block at 0x30), so a layout that
+// moves these fields needs new kernels, not just a new descriptor row.
+constexpr FrameLayout BATCH_LAYOUT = FindFrameLayout(ControllerFamily::JoyCon2);
+static_assert(BATCH_LAYOUT.leftStick == 10 && BATCH_LAYOUT.rightStick == 13 &&
+              BATCH_LAYOUT.motion == 0x30 && BATCH_LAYOUT.triggers == 0x3C,
+              "SIMD batch kernels are hardwired to this layout");
+
+// Same byte order and bit packing as unpack_stick / decode_motion in JoyConDecoder.cpp
+static void decode_batch_scalar(const uint8_t* frames, size_t begin, size_t end, const BatchColumns& out) {
+    constexpr FrameLayout L = BATCH_LAYOUT;
+    for (size_t i = begin; i < end; ++i) {
+        const uint8_t* f = frames + i * JOYCON_FRAME_SIZE;
+        const uint8_t* ls = f + L.leftStick;
+        const uint8_t* rs = f + L.rightStick;
+        const uint8_t* m = f + L.motion;
+        out.leftX[i] = static_cast<uint16_t>(((ls[1] & 0x0F) << 8) | ls[0]);
+        out.leftY[i] = static_cast<uint16_t>((ls[2] << 4) | (ls[1] >> 4));
+        out.rightX[i] = static_cast<uint16_t>(((rs[1] & 0x0F) << 8) | rs[0]);
+        out.rightY[i] = static_cast<uint16_t>((rs[2] << 4) | (rs[1] >> 4));
+        out.accelX[i] = static_cast<int16_t>(m[0] | (m[1] << 8));
+        out.accelY[i] = static_cast<int16_t>(m[2] | (m[3] << 8));
+        out.accelZ[i] = static_cast<int16_t>(m[4] | (m[5] << 8));
+        out.gyroX[i] = static_cast<int16_t>(m[6] | (m[7] << 8));
+        out.gyroY[i] = static_cast<int16_t>(m[8] | (m[9] << 8));
+        out.gyroZ[i] = static_cast<int16_t>(m[10] | (m[11] << 8));
+        out.triggerL[i] = f[L.triggers];
+        out.triggerR[i] = f[L.triggers + 1];
+    }
+}
+
+#ifdef JOYCON2_HAVE_SSE2_KERNEL
+// Transpose 8 rows of 8 x int16: afterwards r[k] holds word k of every row
+static inline void transpose_8x8_epi16(__m128i r[8]) {
+    __m128i t0 = _mm_unpacklo_epi16(r[0], r[1]), t1 = _mm_unpackhi_epi16(r[0], r[1]);
+    __m128i t2 = _mm_unpacklo_epi16(r[2], r[3]), t3 = _mm_unpackhi_epi16(r[2], r[3]);
+    __m128i t4 = _mm_unpacklo_epi16(r[4], r[5]), t5 = _mm_unpackhi_epi16(r[4], r[5]);
+    __m128i t6 = _mm_unpacklo_epi16(r[6], r[7]), t7 = _mm_unpackhi_epi16(r[6], r[7]);
+    __m128i u0 = _mm_unpacklo_epi32(t0, t2), u1 = _mm_unpackhi_epi32(t0, t2);
+    __m128i u2 = _mm_unpacklo_epi32(t1, t3), u3 = _mm_unpackhi_epi32(t1, t3);
+    __m128i u4 = _mm_unpacklo_epi32(t4, t6), u5 = _mm_unpackhi_epi32(t4, t6);
+    __m128i u6 = _mm_unpacklo_epi32(t5, t7), u7 = _mm_unpackhi_epi32(t5, t7);
+    r[0] = _mm_unpacklo_epi64(u0, u4); r[1] = _mm_unpackhi_epi64(u0, u4);
+    r[2] = _mm_unpacklo_epi64(u1, u5); r[3] = _mm_unpackhi_epi64(u1, u5);
+    r[4] = _mm_unpacklo_epi64(u2, u6); r[5] = _mm_unpackhi_epi64(u2, u6);
+    r[6] = _mm_unpacklo_epi64(u3, u7); r[7] = _mm_unpackhi_epi64(u3, u7);
+}
+
+static inline void store8(void* dst, __m128i v) {
+    _mm_storeu_si128(static_cast<__m128i*>(dst), v);
+}
+
+// 8 frames per step: the 16-byte blocks at 0x00 (sticks) and 0x30 (IMU + triggers) of each
+// frame are transposed so every field lands in its own register
+static size_t decode_batch_sse2(const uint8_t* frames, size_t count, const BatchColumns& out) {
+    const __m128i low8 = _mm_set1_epi16(0x00FF);
+    const __m128i low4 = _mm_set1_epi16(0x000F);
+    const __m128i low12 = _mm_set1_epi16(0x0FFF);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t* base = frames + i * JOYCON_FRAME_SIZE;
+        __m128i s[8], m[8];
+        for (int k = 0; k < 8; ++k) {
+            s[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + k * JOYCON_FRAME_SIZE));
+            m[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + k * JOYCON_FRAME_SIZE + 0x30));
+        }
+        transpose_8x8_epi16(s);
+        transpose_8x8_epi16(m);
+
+        // s[5] = bytes 10,11  s[6] = bytes 12,13  s[7] = bytes 14,15
+        __m128i lx = _mm_and_si128(s[5], low12);
+        __m128i ly = _mm_or_si128(_mm_srli_epi16(s[5], 12), _mm_slli_epi16(_mm_and_si128(s[6], low8), 4));
+        __m128i rx = _mm_or_si128(_mm_srli_epi16(s[6], 8), _mm_slli_epi16(_mm_and_si128(s[7], low4), 8));
+        __m128i ry = _mm_srli_epi16(s[7], 4);
+        store8(out.leftX + i, lx);
+        store8(out.leftY + i, ly);
+        store8(out.rightX + i, rx);
+        store8(out.rightY + i, ry);
+
+        store8(out.accelX + i, m[0]);
+        store8(out.accelY + i, m[1]);
+        store8(out.accelZ + i, m[2]);
+        store8(out.gyroX + i, m[3]);
+        store8(out.gyroY + i, m[4]);
+        store8(out.gyroZ + i, m[5]);
+
+        __m128i triggers = _mm_packus_epi16(_mm_and_si128(m[6], low8), _mm_srli_epi16(m[6], 8));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out.triggerL + i), triggers);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out.triggerR + i), _mm_srli_si128(triggers, 8));
+    }
+    return i;
+}
+#endif
+
+void DecodeFrameBatch(std::span<const uint8_t> frames, std::span<const uint32_t> lengths,
+                      FrameBatch& out, BatchKernel kernel) {
+    const size_t count = frames.size() / JOYCON_FRAME_SIZE;
+    out.Resize(count);
+    if (count == 0) return;
+    const uint8_t* data = frames.data();
+    const BatchColumns columns{
+        out.leftX.data(), out.leftY.data(), out.rightX.data(), out.rightY.data(),
+        out.accelX.data(), out.accelY.data(), out.accelZ.data(),
+        out.gyroX.data(), out.gyroY.data(), out.gyroZ.data(),
+        out.triggerL.data(), out.triggerR.data(),
+    };
+
+    size_t done = 0;
+    switch (ResolveBatchKernel(kernel)) {
+#ifdef JOYCON2_HAVE_AVX2_KERNEL
+    case BatchKernel::AVX2:
+        done = decode_batch_avx2(data, count, columns);
+        break;
+#endif
+#ifdef JOYCON2_HAVE_SSE2_KERNEL
+    case BatchKernel::SSE2:
+        done = decode_batch_sse2(data, count, columns);
+        break;
+#endif
+    default:
+        break;
+    }
+    decode_batch_scalar(data, done, count, columns);
+
+    // Buttons are 6 bytes big-endian
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* f = data + i * JOYCON_FRAME_SIZE + BATCH_LAYOUT.buttons;
+        out.buttons[i] = (uint64_t(f[0]) << 40) | (uint64_t(f[1]) << 32) | (uint64_t(f[2]) << 24) |
+                         (uint64_t(f[3]) << 16) | (uint64_t(f[4]) << 8) | uint64_t(f[5]);
+    }
+
+    // Short payloads keep centered sticks, as in DecodeInputFrame
+    if (lengths.size() >= count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (lengths[i] < BATCH_LAYOUT.minStickLength) {
+                out.leftX[i] = out.leftY[i] = 2048;
+                out.rightX[i] = out.rightY[i] = 2048;
+            }
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+// Batch decoding of recorded notification streams into structure-of-arrays output.
+// Produces the same raw values as DecodeInputFrame/DecodeMotion, many frames at a time.
+#include "JoyConDecoder.h"
+#include <span>
+#include <vector>
+
+enum class BatchKernel { Auto, Scalar, SSE2, AVX2 };
+
+// One array per field; index i holds frame i of the batch
+struct FrameBatch {
+    size_t count = 0;
+    std::vector<uint64_t> buttons;              // 48-bit button state, as JoyConInputFrame::buttons
+    std::vector<uint16_t> leftX, leftY;         // raw 12-bit sticks (2048 for frames shorter than 16 bytes)
+    std::vector<uint16_t> rightX, rightY;
+    std::vector<int16_t> accelX, accelY, accelZ;
+    std::vector<int16_t> gyroX, gyroY, gyroZ;
+    std::vector<uint8_t> triggerL, triggerR;
+
+    void Resize(size_t n);
+};
+
+// Best kernel the running CPU supports when Auto; unavailable kernels fall back to the next best
+BatchKernel ResolveBatchKernel(BatchKernel requested);
+const char* BatchKernelName(BatchKernel kernel);
+
+// frames: count * JOYCON_FRAME_SIZE bytes, each frame zero-padded past its received length.
+// lengths: received length per frame, or empty when every frame is a full notification.
+void DecodeFrameBatch(std::span<const uint8_t> frames, std::span<const uint32_t> lengths,
+                      FrameBatch& out, BatchKernel kernel = BatchKernel::Auto);
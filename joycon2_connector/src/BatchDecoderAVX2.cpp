@@ -0,0 +1,74 @@
+// AVX2 kernel for DecodeFrameBatch. Built with AVX2 code generation and only called after a
+// runtime CPU check (see BatchDecoderKernels.h).
+#include "BatchDecoderKernels.h"
+#include <immintrin.h>
+
+// Same transpose as the SSE2 kernel, run in both 128-bit lanes at once: lane 0 holds
+// frames 0..7 and lane 1 frames 8..15, so each result register is 16 consecutive frames
+static inline void transpose_8x8_epi16_x2(__m256i r[8]) {
+    __m256i t0 = _mm256_unpacklo_epi16(r[0], r[1]), t1 = _mm256_unpackhi_epi16(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi16(r[2], r[3]), t3 = _mm256_unpackhi_epi16(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi16(r[4], r[5]), t5 = _mm256_unpackhi_epi16(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi16(r[6], r[7]), t7 = _mm256_unpackhi_epi16(r[6], r[7]);
+    __m256i u0 = _mm256_unpacklo_epi32(t0, t2), u1 = _mm256_unpackhi_epi32(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi32(t1, t3), u3 = _mm256_unpackhi_epi32(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi32(t4, t6), u5 = _mm256_unpackhi_epi32(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi32(t5, t7), u7 = _mm256_unpackhi_epi32(t5, t7);
+    r[0] = _mm256_unpacklo_epi64(u0, u4); r[1] = _mm256_unpackhi_epi64(u0, u4);
+    r[2] = _mm256_unpacklo_epi64(u1, u5); r[3] = _mm256_unpackhi_epi64(u1, u5);
+    r[4] = _mm256_unpacklo_epi64(u2, u6); r[5] = _mm256_unpackhi_epi64(u2, u6);
+    r[6] = _mm256_unpacklo_epi64(u3, u7); r[7] = _mm256_unpackhi_epi64(u3, u7);
+}
+
+static inline __m256i load_pair(const uint8_t* lo, const uint8_t* hi) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+}
+
+static inline void store16(void* dst, __m256i v) {
+    _mm256_storeu_si256(static_cast<__m256i*>(dst), v);
+}
+
+size_t decode_batch_avx2(const uint8_t* frames, size_t count, const BatchColumns& out) {
+    const __m256i low8 = _mm256_set1_epi16(0x00FF);
+    const __m256i low4 = _mm256_set1_epi16(0x000F);
+    const __m256i low12 = _mm256_set1_epi16(0x0FFF);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8_t* base = frames + i * BATCH_FRAME_STRIDE;
+        __m256i s[8], m[8];
+        for (int k = 0; k < 8; ++k) {
+            const uint8_t* lo = base + k * BATCH_FRAME_STRIDE;
+            const uint8_t* hi = base + (k + 8) * BATCH_FRAME_STRIDE;
+            s[k] = load_pair(lo, hi);
+            m[k] = load_pair(lo + 0x30, hi + 0x30);
+        }
+        transpose_8x8_epi16_x2(s);
+        transpose_8x8_epi16_x2(m);
+
+        __m256i lx = _mm256_and_si256(s[5], low12);
+        __m256i ly = _mm256_or_si256(_mm256_srli_epi16(s[5], 12), _mm256_slli_epi16(_mm256_and_si256(s[6], low8), 4));
+        __m256i rx = _mm256_or_si256(_mm256_srli_epi16(s[6], 8), _mm256_slli_epi16(_mm256_and_si256(s[7], low4), 8));
+        __m256i ry = _mm256_srli_epi16(s[7], 4);
+        store16(out.leftX + i, lx);
+        store16(out.leftY + i, ly);
+        store16(out.rightX + i, rx);
+        store16(out.rightY + i, ry);
+
+        store16(out.accelX + i, m[0]);
+        store16(out.accelY + i, m[1]);
+        store16(out.accelZ + i, m[2]);
+        store16(out.gyroX + i, m[3]);
+        store16(out.gyroY + i, m[4]);
+        store16(out.gyroZ + i, m[5]);
+
+        // packus works per lane: [L0-7 R0-7 | L8-15 R8-15] -> reorder to [L0-15 | R0-15]
+        __m256i triggers = _mm256_packus_epi16(_mm256_and_si256(m[6], low8), _mm256_srli_epi16(m[6], 8));
+        triggers = _mm256_permute4x64_epi64(triggers, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.triggerL + i), _mm256_castsi256_si128(triggers));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.triggerR + i), _mm256_extracti128_si256(triggers, 1));
+    }
+    return i;
+}
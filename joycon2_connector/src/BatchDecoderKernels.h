@@ -0,0 +1,20 @@
+#pragma once
+// Internal to BatchDecoder.cpp / BatchDecoderAVX2.cpp. Kernels see only raw pointers so the
+// AVX2 translation unit never instantiates inline library code (std::vector etc.) that the
+// linker could pick over the baseline copy.
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t BATCH_FRAME_STRIDE = 64;
+
+struct BatchColumns {
+    uint16_t* leftX; uint16_t* leftY;
+    uint16_t* rightX; uint16_t* rightY;
+    int16_t* accelX; int16_t* accelY; int16_t* accelZ;
+    int16_t* gyroX; int16_t* gyroY; int16_t* gyroZ;
+    uint8_t* triggerL; uint8_t* triggerR;
+};
+
+// Each kernel decodes whole blocks from the start of the batch and returns how many frames it
+// handled; the caller finishes the tail with the scalar path
+size_t decode_batch_avx2(const uint8_t* frames, size_t count, const BatchColumns& out);
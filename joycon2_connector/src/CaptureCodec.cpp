@@ -0,0 +1,346 @@
+#include "CaptureCodec.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Binary range coder as in LZMA: 11-bit probabilities, adapting by 1/16 per decision so a
+// fresh block learns the controllers quickly
+constexpr int PROB_BITS = 11;
+constexpr uint16_t PROB_INIT = 1 << (PROB_BITS - 1);
+constexpr int MOVE_BITS = 4;
+constexpr uint32_t RANGE_TOP = 1u << 24;
+
+// Worst case for one record: kind, controller (4), interval length (7), same length and 9
+// decisions per payload byte, each costing under 8 bits; plus up to 73 direct bits
+constexpr size_t MAX_CODED_RECORD = (1 + 4 + 7 + 1 + 9 * CAPTURE_DELTA_MAX_PAYLOAD) + 10 + 16;
+
+// Notification context: byte position (positions past 63 share the last) and whether the
+// previous byte changed
+constexpr size_t DELTA_POSITIONS = 64;
+
+struct ControllerModel {
+    uint16_t zero[DELTA_POSITIONS][2];
+    uint16_t value[DELTA_POSITIONS][256];
+    uint16_t sameLength;
+    uint8_t prev[CAPTURE_DELTA_MAX_PAYLOAD];
+    size_t prevLength;
+    int64_t prevUs;
+    int64_t periodUs;           // running estimate of the notification interval
+    int64_t prevCommandUs;
+};
+
+} // namespace
+
+struct CaptureCodecModel {
+    uint16_t command;
+    uint16_t controller[16];
+    uint16_t intervalBits[128];
+    uint16_t commandBits[128];
+    uint16_t commandBytes[256];
+    ControllerModel controllers[CAPTURE_DELTA_MAX_CONTROLLERS];
+    uint32_t active = 0;        // controllers seen in this block
+    int64_t startUs = 0;
+
+    void Reset(int64_t blockStartUs) {
+        command = PROB_INIT;
+        std::fill(std::begin(controller), std::end(controller), PROB_INIT);
+        std::fill(std::begin(intervalBits), std::end(intervalBits), PROB_INIT);
+        std::fill(std::begin(commandBits), std::end(commandBits), PROB_INIT);
+        std::fill(std::begin(commandBytes), std::end(commandBytes), PROB_INIT);
+        active = 0;
+        startUs = blockStartUs;
+    }
+
+    // A controller's model is reset on its first record in the block, so a block only pays
+    // for the controllers it contains
+    ControllerModel& Controller(uint16_t id) {
+        ControllerModel& cm = controllers[id];
+        if (active & (1u << id)) return cm;
+        active |= 1u << id;
+        std::fill_n(&cm.zero[0][0], DELTA_POSITIONS * 2, PROB_INIT);
+        std::fill_n(&cm.value[0][0], DELTA_POSITIONS * 256, PROB_INIT);
+        cm.sameLength = PROB_INIT;
+        std::memset(cm.prev, 0, sizeof(cm.prev));
+        cm.prevLength = 0;
+        cm.prevUs = cm.prevCommandUs = startUs;
+        cm.periodUs = 0;
+        return cm;
+    }
+};
+
+class CaptureRangeEncoder {
+public:
+    static constexpr bool ENCODING = true;
+
+    void Begin(uint8_t* output) {
+        out = output;
+        size = 0;
+        low = 0;
+        range = 0xFFFFFFFFu;
+        cache = 0;
+        cacheSize = 1;
+    }
+
+    int Bit(uint16_t& p, int bit) {
+        uint32_t bound = (range >> PROB_BITS) * p;
+        if (!bit) {
+            range = bound;
+            p += ((1 << PROB_BITS) - p) >> MOVE_BITS;
+        } else {
+            low += bound;
+            range -= bound;
+            p -= p >> MOVE_BITS;
+        }
+        while (range < RANGE_TOP) {
+            range <<= 8;
+            ShiftLow();
+        }
+        return bit;
+    }
+
+    uint64_t Direct(uint64_t value, int bits) {
+        for (int i = bits - 1; i >= 0; --i) {
+            range >>= 1;
+            if ((value >> i) & 1) low += range;
+            while (range < RANGE_TOP) {
+                range <<= 8;
+                ShiftLow();
+            }
+        }
+        return value;
+    }
+
+    size_t Flush() {
+        for (int i = 0; i < 5; ++i) ShiftLow();
+        return size;
+    }
+
+    // Output size if the block were flushed now
+    size_t Pending() const { return size + cacheSize + 4; }
+
+private:
+    // Bytes of 0xFF wait in cacheSize until a carry can no longer reach them
+    void ShiftLow() {
+        if (static_cast<uint32_t>(low) < 0xFF000000u || (low >> 32) != 0) {
+            uint8_t carry = static_cast<uint8_t>(low >> 32);
+            uint8_t temp = cache;
+            do {
+                out[size++] = static_cast<uint8_t>(temp + carry);
+                temp = 0xFF;
+            } while (--cacheSize != 0);
+            cache = static_cast<uint8_t>(low >> 24);
+        }
+        ++cacheSize;
+        low = (low & 0x00FFFFFFu) << 8;
+    }
+
+    uint8_t* out = nullptr;
+    size_t size = 0;
+    uint64_t low = 0;
+    uint32_t range = 0xFFFFFFFFu;
+    uint8_t cache = 0;
+    uint64_t cacheSize = 1;
+};
+
+namespace {
+
+class RangeDecoder {
+public:
+    static constexpr bool ENCODING = false;
+
+    RangeDecoder(const uint8_t* input, size_t length) : in(input), size(length) {
+        for (int i = 0; i < 5; ++i) code = (code << 8) | NextByte();
+    }
+
+    int Bit(uint16_t& p, int) {
+        uint32_t bound = (range >> PROB_BITS) * p;
+        int bit;
+        if (code < bound) {
+            range = bound;
+            p += ((1 << PROB_BITS) - p) >> MOVE_BITS;
+            bit = 0;
+        } else {
+            code -= bound;
+            range -= bound;
+            p -= p >> MOVE_BITS;
+            bit = 1;
+        }
+        Normalize();
+        return bit;
+    }
+
+    uint64_t Direct(uint64_t, int bits) {
+        uint64_t value = 0;
+        for (int i = 0; i < bits; ++i) {
+            range >>= 1;
+            uint32_t bit = code >= range ? 1 : 0;
+            if (bit) code -= range;
+            value = (value << 1) | bit;
+            Normalize();
+        }
+        return value;
+    }
+
+    // Read past the coded bytes: the block is damaged
+    bool Overrun() const { return pos > size; }
+
+private:
+    uint8_t NextByte() { return pos < size ? in[pos++] : (++pos, uint8_t(0)); }
+    void Normalize() {
+        while (range < RANGE_TOP) {
+            range <<= 8;
+            code = (code << 8) | NextByte();
+        }
+    }
+
+    const uint8_t* in;
+    size_t size;
+    size_t pos = 0;
+    uint32_t code = 0;
+    uint32_t range = 0xFFFFFFFFu;
+};
+
+uint64_t Zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t Unzigzag(uint64_t z) { return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1); }
+
+// Encoding and decoding share the code below: Coder::Bit and Coder::Direct take the value to
+// encode and return the value coded, which the decoder ignores and reads from the stream
+
+template <class Coder>
+uint32_t CodeTree(Coder& c, uint16_t* probs, int bits, uint32_t value) {
+    uint32_t m = 1;
+    for (int i = bits - 1; i >= 0; --i) m = (m << 1) | static_cast<uint32_t>(c.Bit(probs[m], (value >> i) & 1));
+    return m - (1u << bits);
+}
+
+// Bit length adaptively (small values are common), then the bits below the leading one
+template <class Coder>
+uint64_t CodeMagnitude(Coder& c, uint16_t* lengthProbs, uint64_t value) {
+    uint32_t n = 0;
+    if (Coder::ENCODING)
+        while (n < 64 && (value >> n) != 0) ++n;
+    n = (std::min)(CodeTree(c, lengthProbs, 7, n), 64u);
+    if (n <= 1) return n;
+    return (1ull << (n - 1)) | c.Direct(value & ((1ull << (n - 1)) - 1), static_cast<int>(n - 1));
+}
+
+struct CodedRecord {
+    uint16_t controller = 0;
+    CaptureRecordKind kind = CaptureRecordKind::Notification;
+    int64_t timestampUs = 0;
+    size_t length = 0;
+    const uint8_t* input = nullptr;   // encoding
+    uint8_t* output = nullptr;        // decoding: CAPTURE_DELTA_MAX_PAYLOAD bytes
+};
+
+template <class Coder>
+void CodeRecord(Coder& c, CaptureCodecModel& m, CodedRecord& r) {
+    bool command = c.Bit(m.command, r.kind == CaptureRecordKind::CommandWrite) != 0;
+    r.kind = command ? CaptureRecordKind::CommandWrite : CaptureRecordKind::Notification;
+    r.controller = static_cast<uint16_t>(CodeTree(c, m.controller, 4, r.controller));
+    ControllerModel& cm = m.Controller(r.controller);
+
+    if (command) {
+        // Commands follow the output threads, not the radio: interval from the previous command
+        r.timestampUs = cm.prevCommandUs + Unzigzag(CodeMagnitude(c, m.commandBits, Zigzag(r.timestampUs - cm.prevCommandUs)));
+        cm.prevCommandUs = r.timestampUs;
+        r.length = (std::min)(static_cast<size_t>(c.Direct(r.length, 9)), CAPTURE_DELTA_MAX_PAYLOAD);
+        for (size_t i = 0; i < r.length; ++i) {
+            uint8_t v = static_cast<uint8_t>(CodeTree(c, m.commandBytes, 8, Coder::ENCODING ? r.input[i] : 0));
+            if (!Coder::ENCODING) r.output[i] = v;
+        }
+        return;
+    }
+
+    // Arrival interval against the running period estimate: only the jitter is coded
+    int64_t residual = r.timestampUs - cm.prevUs - cm.periodUs;
+    residual = Unzigzag(CodeMagnitude(c, m.intervalBits, Zigzag(residual)));
+    int64_t interval = cm.periodUs + residual;
+    r.timestampUs = cm.prevUs + interval;
+    cm.prevUs = r.timestampUs;
+    cm.periodUs += (interval - cm.periodUs) / 8;
+
+    if (c.Bit(cm.sameLength, r.length == cm.prevLength))
+        r.length = cm.prevLength;
+    else
+        r.length = (std::min)(static_cast<size_t>(c.Direct(r.length, 9)), CAPTURE_DELTA_MAX_PAYLOAD);
+
+    int changed = 0;
+    for (size_t i = 0; i < r.length; ++i) {
+        size_t ctx = (std::min)(i, DELTA_POSITIONS - 1);
+        uint8_t delta = Coder::ENCODING ? static_cast<uint8_t>(r.input[i] ^ cm.prev[i]) : 0;
+        changed = c.Bit(cm.zero[ctx][changed], delta != 0);
+        delta = changed ? static_cast<uint8_t>(CodeTree(c, cm.value[ctx], 8, delta)) : 0;
+        cm.prev[i] ^= delta;
+        if (!Coder::ENCODING) r.output[i] = cm.prev[i];
+    }
+    if (r.length < cm.prevLength) std::memset(cm.prev + r.length, 0, cm.prevLength - r.length);
+    cm.prevLength = r.length;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------- encoder
+
+CaptureBlockEncoder::CaptureBlockEncoder()
+    : model(std::make_unique<CaptureCodecModel>()),
+      buffer(sizeof(CaptureBlockHeader) + CAPTURE_BLOCK_BYTES),
+      coder(std::make_unique<CaptureRangeEncoder>()) {
+    Begin(0);
+}
+
+CaptureBlockEncoder::~CaptureBlockEncoder() = default;
+
+void CaptureBlockEncoder::Begin(int64_t startUs) {
+    model->Reset(startUs);
+    coder->Begin(buffer.data() + sizeof(CaptureBlockHeader));
+    recordCount = 0;
+}
+
+bool CaptureBlockEncoder::HasRoom() const {
+    return recordCount < CAPTURE_BLOCK_RECORDS && coder->Pending() + MAX_CODED_RECORD <= CAPTURE_BLOCK_BYTES;
+}
+
+void CaptureBlockEncoder::Add(uint16_t controller, CaptureRecordKind kind, const uint8_t* data, size_t length, int64_t timestampUs) {
+    CodedRecord r;
+    r.controller = controller;
+    r.kind = kind;
+    r.timestampUs = timestampUs;
+    r.length = length;
+    r.input = data;
+    CodeRecord(*coder, *model, r);
+    ++recordCount;
+}
+
+const uint8_t* CaptureBlockEncoder::Finish(size_t& length) {
+    CaptureBlockHeader header{ recordCount, 0 };
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    length = sizeof(header) + coder->Flush();
+    return buffer.data();
+}
+
+// ---------------------------------------------------------------- decoder
+
+CaptureBlockDecoder::CaptureBlockDecoder() : model(std::make_unique<CaptureCodecModel>()) {}
+
+CaptureBlockDecoder::~CaptureBlockDecoder() = default;
+
+bool CaptureBlockDecoder::Decode(const uint8_t* payload, size_t length, int64_t startUs, std::vector<CaptureRecord>& records) {
+    records.clear();
+    CaptureBlockHeader header{};
+    if (length < sizeof(header)) return false;
+    std::memcpy(&header, payload, sizeof(header));
+    if (header.recordCount > CAPTURE_BLOCK_RECORDS) return false;
+
+    storage.resize(static_cast<size_t>(header.recordCount) * CAPTURE_DELTA_MAX_PAYLOAD);
+    model->Reset(startUs);
+    RangeDecoder decoder(payload + sizeof(header), length - sizeof(header));
+    for (uint32_t i = 0; i < header.recordCount; ++i) {
+        CodedRecord r;
+        r.output = storage.data() + static_cast<size_t>(i) * CAPTURE_DELTA_MAX_PAYLOAD;
+        CodeRecord(decoder, *model, r);
+        records.push_back({ r.timestampUs, r.controller, r.kind, r.output, static_cast<uint16_t>(r.length) });
+    }
+    return !decoder.Overrun();
+}
@@ -0,0 +1,74 @@
+#pragma once
+// Delta coding for long session captures (see CaptureFile.h). Records are grouped into blocks.
+// Within a block each notification is XORed with the same controller's previous notification
+// and the difference is coded with an adaptive binary range coder, so bytes that did not change
+// cost a fraction of a bit; timestamps are coded as the change in arrival interval.
+// Each block starts from a fresh model and zeroed previous frames, so it is a keyframe: the
+// reader can start decoding at any block. The encoder never allocates after construction and
+// codes a record with a fixed upper bound of binary decisions.
+#include "CaptureFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+constexpr uint32_t CAPTURE_BLOCK_RECORDS = 4096;        // keyframe interval, in records...
+constexpr int64_t CAPTURE_BLOCK_US = 5000000;           // ...or in time, whichever comes first
+constexpr size_t CAPTURE_BLOCK_BYTES = 60000;           // coded bytes per block at most
+constexpr size_t CAPTURE_DELTA_MAX_PAYLOAD = 256;       // longer records are stored raw
+constexpr uint16_t CAPTURE_DELTA_MAX_CONTROLLERS = 16;  // controllers past this are stored raw
+
+// Payload of a Block record, followed by the coded bytes. The record's timestamp is the
+// first coded record's.
+struct CaptureBlockHeader {
+    uint32_t recordCount;
+    uint32_t reserved;
+};
+static_assert(sizeof(CaptureBlockHeader) == 8, "capture block layout");
+
+struct CaptureCodecModel;
+class CaptureRangeEncoder;
+
+class CaptureBlockEncoder {
+public:
+    CaptureBlockEncoder();
+    ~CaptureBlockEncoder();
+    CaptureBlockEncoder(const CaptureBlockEncoder&) = delete;
+    CaptureBlockEncoder& operator=(const CaptureBlockEncoder&) = delete;
+
+    static bool Codable(uint16_t controller, size_t length) {
+        return controller < CAPTURE_DELTA_MAX_CONTROLLERS && length <= CAPTURE_DELTA_MAX_PAYLOAD;
+    }
+
+    // Starts a block whose first record is at startUs
+    void Begin(int64_t startUs);
+    uint32_t RecordCount() const { return recordCount; }
+    // Room for one more record of any size; otherwise Finish the block first
+    bool HasRoom() const;
+
+    void Add(uint16_t controller, CaptureRecordKind kind, const uint8_t* data, size_t length, int64_t timestampUs);
+    // The block payload (CaptureBlockHeader + coded bytes), valid until the next Begin
+    const uint8_t* Finish(size_t& length);
+
+private:
+    std::unique_ptr<CaptureCodecModel> model;
+    std::vector<uint8_t> buffer;
+    std::unique_ptr<CaptureRangeEncoder> coder;
+    uint32_t recordCount = 0;
+};
+
+class CaptureBlockDecoder {
+public:
+    CaptureBlockDecoder();
+    ~CaptureBlockDecoder();
+    CaptureBlockDecoder(const CaptureBlockDecoder&) = delete;
+    CaptureBlockDecoder& operator=(const CaptureBlockDecoder&) = delete;
+
+    // Decodes a Block record's payload. The records point into the decoder's storage and stay
+    // valid until the next Decode. False if the block is damaged.
+    bool Decode(const uint8_t* payload, size_t length, int64_t startUs, std::vector<CaptureRecord>& records);
+
+private:
+    std::unique_ptr<CaptureCodecModel> model;
+    std::vector<uint8_t> storage;
+};
@@ -0,0 +1,517 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "CaptureFile.h"
+#include "CaptureCodec.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+static constexpr uint64_t padded(uint64_t length) { return (length + 7) & ~uint64_t(7); }
+
+static CaptureFileHeader empty_header(CaptureCompression compression) {
+    CaptureFileHeader h{};
+    std::memcpy(h.magic, CAPTURE_MAGIC, sizeof(h.magic));
+    bool delta = compression == CaptureCompression::Delta;
+    h.version = delta ? CAPTURE_VERSION_DELTA : CAPTURE_VERSION;
+    h.headerSize = sizeof(CaptureFileHeader);
+    h.indexInterval = delta ? CAPTURE_BLOCK_RECORDS : CAPTURE_INDEX_INTERVAL;
+    return h;
+}
+
+// ---------------------------------------------------------------- writer
+
+CaptureWriter::CaptureWriter() = default;
+
+CaptureWriter::~CaptureWriter() { Close(); }
+
+bool CaptureWriter::Open(const std::string& path, CaptureCompression mode) {
+    Close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 16);
+    compression = mode;
+    // The encoder's model and block buffer are the only large allocations; after this the
+    // capture path does not allocate until the index outgrows its reservation
+    if (compression == CaptureCompression::Delta && !encoder) encoder = std::make_unique<CaptureBlockEncoder>();
+    if (encoder) encoder->Begin(0);
+    CaptureFileHeader header = empty_header(compression);
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    offset = sizeof(header);
+    recordCount = 0;
+    startUs = 0;
+    controllers.clear();
+    index.clear();
+    index.reserve(1024);
+    return true;
+}
+
+bool CaptureWriter::Close() {
+    if (!file) return false;
+    FlushBlock();
+    CaptureFileHeader header = empty_header(compression);
+    header.recordCount = recordCount;
+    header.startUs = startUs;
+    header.controllerCount = static_cast<uint32_t>(controllers.size());
+    header.controllerOffset = offset;
+    bool ok = controllers.empty() || std::fwrite(controllers.data(), sizeof(CaptureController), controllers.size(), file) == controllers.size();
+    header.indexOffset = offset + controllers.size() * sizeof(CaptureController);
+    header.indexCount = index.size();
+    ok &= index.empty() || std::fwrite(index.data(), sizeof(CaptureIndexEntry), index.size(), file) == index.size();
+    ok &= std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok &= std::fclose(file) == 0;
+    file = nullptr;
+    return ok;
+}
+
+void CaptureWriter::Append(int64_t timestampUs, uint16_t controller, CaptureRecordKind kind, const void* payload, size_t length) {
+    static constexpr uint8_t zeros[8] = {};
+    length = (std::min)(length, static_cast<size_t>(UINT16_MAX));
+    if (offset == sizeof(CaptureFileHeader)) startUs = timestampUs;
+    if (kind == CaptureRecordKind::Notification || kind == CaptureRecordKind::CommandWrite) {
+        if (recordCount % CAPTURE_INDEX_INTERVAL == 0) index.push_back({ timestampUs, offset, recordCount });
+        ++recordCount;
+    }
+    CaptureRecordHeader header{ timestampUs, controller, kind, 0, static_cast<uint16_t>(length), 0 };
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(payload, 1, length, file);
+    std::fwrite(zeros, 1, padded(length) - length, file);
+    offset += sizeof(header) + padded(length);
+}
+
+uint16_t CaptureWriter::ControllerId(uint64_t address, uint8_t family, int64_t timestampUs) {
+    for (size_t i = 0; i < controllers.size(); ++i) {
+        CaptureController& c = controllers[i];
+        if (c.address != address) continue;
+        if (c.family == CAPTURE_FAMILY_UNKNOWN && family != CAPTURE_FAMILY_UNKNOWN) {
+            c.family = family;
+            Append(timestampUs, static_cast<uint16_t>(i), CaptureRecordKind::Controller, &c, sizeof(c));
+        }
+        return static_cast<uint16_t>(i);
+    }
+    CaptureController c{ address, family, {} };
+    controllers.push_back(c);
+    uint16_t id = static_cast<uint16_t>(controllers.size() - 1);
+    Append(timestampUs, id, CaptureRecordKind::Controller, &c, sizeof(c));
+    return id;
+}
+
+void CaptureWriter::Record(int64_t timestampUs, uint16_t controller, CaptureRecordKind kind, const uint8_t* data, size_t length) {
+    if (compression == CaptureCompression::Delta && CaptureBlockEncoder::Codable(controller, length)) {
+        if (encoder->RecordCount() > 0 && (!encoder->HasRoom() || timestampUs - blockStartUs >= CAPTURE_BLOCK_US)) FlushBlock();
+        if (encoder->RecordCount() == 0) {
+            encoder->Begin(timestampUs);
+            blockStartUs = timestampUs;
+        }
+        encoder->Add(controller, kind, data, length, timestampUs);
+        return;
+    }
+    // Stored raw; the open block goes first so the file keeps arrival order
+    FlushBlock();
+    Append(timestampUs, controller, kind, data, length);
+}
+
+uint64_t CaptureWriter::RecordCount() const {
+    return recordCount + (encoder ? encoder->RecordCount() : 0);
+}
+
+void CaptureWriter::FlushBlock() {
+    if (!encoder || encoder->RecordCount() == 0) return;
+    uint32_t count = encoder->RecordCount();
+    size_t length = 0;
+    const uint8_t* payload = encoder->Finish(length);
+    index.push_back({ blockStartUs, offset, recordCount });
+    Append(blockStartUs, 0, CaptureRecordKind::Block, payload, length);
+    recordCount += count;
+    encoder->Begin(0);
+}
+
+void CaptureWriter::RecordNotification(uint64_t address, ControllerFamily family, const uint8_t* data, size_t length, int64_t timestampUs) {
+    if (!file) return;
+    uint16_t id = ControllerId(address, static_cast<uint8_t>(family), timestampUs);
+    Record(timestampUs, id, CaptureRecordKind::Notification, data, length);
+}
+
+void CaptureWriter::RecordCommandWrite(uint64_t address, const uint8_t* data, size_t length, int64_t timestampUs) {
+    if (!file) return;
+    uint16_t id = ControllerId(address, CAPTURE_FAMILY_UNKNOWN, timestampUs);
+    Record(timestampUs, id, CaptureRecordKind::CommandWrite, data, length);
+}
+
+// ---------------------------------------------------------------- reader
+
+CaptureReader::CaptureReader() = default;
+
+CaptureReader::~CaptureReader() { Close(); }
+
+bool CaptureReader::Open(const std::string& path) {
+    Close();
+#ifdef _WIN32
+    // Shared for writing, so a capture still being recorded can be inspected
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize{};
+    HANDLE map = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0
+        ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (!map) return false;
+    const void* view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(map);
+        return false;
+    }
+    mapping = map;
+    data = static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st {};
+    void* view = (::fstat(fd, &st) == 0 && st.st_size > 0)
+        ? ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    data = static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(st.st_size);
+#endif
+
+    CaptureFileHeader header{};
+    if (size < sizeof(header)) {
+        Close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        (header.version != CAPTURE_VERSION && header.version != CAPTURE_VERSION_DELTA) ||
+        header.headerSize < sizeof(header) || header.headerSize > size) {
+        Close();
+        return false;
+    }
+    version = header.version;
+    if (Compressed() && !decoder) decoder = std::make_unique<CaptureBlockDecoder>();
+    recordBegin = header.headerSize;
+
+    uint64_t tableBytes = uint64_t(header.controllerCount) * sizeof(CaptureController);
+    uint64_t indexBytes = header.indexCount * sizeof(CaptureIndexEntry);
+    bool closed = header.indexOffset != 0 && header.controllerOffset >= recordBegin &&
+                  header.controllerOffset + tableBytes == header.indexOffset && header.indexOffset + indexBytes <= size;
+    if (closed) {
+        recordEnd = header.controllerOffset;
+        recordCount = header.recordCount;
+        startUs = header.startUs;
+        controllers.resize(header.controllerCount);
+        if (tableBytes) std::memcpy(controllers.data(), data + header.controllerOffset, tableBytes);
+        index.resize(header.indexCount);
+        if (indexBytes) std::memcpy(index.data(), data + header.indexOffset, indexBytes);
+    } else {
+        recordEnd = size;
+        Scan();
+    }
+    recovered = !closed;
+    Rewind();
+    return true;
+}
+
+void CaptureReader::Close() {
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mapping));
+#else
+        ::munmap(const_cast<uint8_t*>(data), size);
+#endif
+    }
+    data = nullptr;
+    mapping = nullptr;
+    size = 0;
+    version = 0;
+    recordBegin = recordEnd = recordCount = 0;
+    startUs = 0;
+    recovered = false;
+    controllers.clear();
+    index.clear();
+    cursor = position = 0;
+    block.clear();
+    blockPos = 0;
+}
+
+bool CaptureReader::ReadAt(uint64_t at, CaptureRecordHeader& header, const uint8_t*& payload, uint64_t& next) const {
+    if (at + sizeof(header) > recordEnd) return false;
+    std::memcpy(&header, data + at, sizeof(header));
+    if (header.kind > CaptureRecordKind::Block) return false;
+    next = at + sizeof(header) + padded(header.length);
+    // A record cut short by a crash ends the capture
+    if (at + sizeof(header) + header.length > recordEnd) return false;
+    payload = data + at + sizeof(header);
+    return true;
+}
+
+void CaptureReader::Scan() {
+    uint64_t at = recordBegin, next = 0;
+    CaptureRecordHeader header{};
+    const uint8_t* payload = nullptr;
+    bool first = true;
+    while (ReadAt(at, header, payload, next)) {
+        if (first) startUs = header.timestampUs;
+        first = false;
+        if (header.kind == CaptureRecordKind::Controller) {
+            if (header.length < sizeof(CaptureController) || header.controller > controllers.size()) break;
+            CaptureController c;
+            std::memcpy(&c, payload, sizeof(c));
+            if (header.controller == controllers.size()) controllers.push_back(c);
+            else controllers[header.controller] = c;
+        } else if (header.kind == CaptureRecordKind::Block) {
+            CaptureBlockHeader block{};
+            if (!Compressed() || header.length < sizeof(block)) break;
+            std::memcpy(&block, payload, sizeof(block));
+            index.push_back({ header.timestampUs, at, recordCount });
+            recordCount += block.recordCount;
+        } else {
+            if (header.controller >= controllers.size()) break;
+            if (recordCount % CAPTURE_INDEX_INTERVAL == 0) index.push_back({ header.timestampUs, at, recordCount });
+            ++recordCount;
+        }
+        at = next;
+    }
+    recordEnd = at;
+}
+
+bool CaptureReader::DecodeBlock(const CaptureRecordHeader& header, const uint8_t* payload) {
+    blockPos = 0;
+    if (decoder && decoder->Decode(payload, header.length, header.timestampUs, block)) return true;
+    block.clear();
+    return false;
+}
+
+bool CaptureReader::Next(CaptureRecord& record) {
+    CaptureRecordHeader header{};
+    const uint8_t* payload = nullptr;
+    uint64_t next = 0;
+    for (;;) {
+        if (blockPos < block.size()) {
+            record = block[blockPos++];
+            ++position;
+            return true;
+        }
+        if (!ReadAt(cursor, header, payload, next)) return false;
+        cursor = next;
+        if (header.kind == CaptureRecordKind::Controller) continue;
+        // A damaged block ends the capture, like a damaged record
+        if (header.kind == CaptureRecordKind::Block) {
+            if (!DecodeBlock(header, payload)) return false;
+            continue;
+        }
+        record.timestampUs = header.timestampUs;
+        record.controller = header.controller;
+        record.kind = header.kind;
+        record.data = payload;
+        record.length = header.length;
+        ++position;
+        return true;
+    }
+    return false;
+}
+
+void CaptureReader::Rewind() {
+    cursor = recordBegin;
+    position = 0;
+    block.clear();
+    blockPos = 0;
+}
+
+void CaptureReader::Seek(int64_t timestampUs) {
+    auto after = std::upper_bound(index.begin(), index.end(), timestampUs,
+                                  [](int64_t t, const CaptureIndexEntry& e) { return t < e.timestampUs; });
+    if (after == index.begin()) {
+        Rewind();
+    } else {
+        cursor = std::prev(after)->offset;
+        position = std::prev(after)->recordIndex;
+        block.clear();
+        blockPos = 0;
+    }
+    CaptureRecordHeader header{};
+    const uint8_t* payload = nullptr;
+    uint64_t next = 0;
+    while (ReadAt(cursor, header, payload, next)) {
+        if (header.kind == CaptureRecordKind::Block) {
+            if (!DecodeBlock(header, payload)) return;
+            cursor = next;
+            for (; blockPos < block.size(); ++blockPos, ++position)
+                if (block[blockPos].timestampUs >= timestampUs) return;
+            block.clear();
+            blockPos = 0;
+            continue;
+        }
+        if (header.kind != CaptureRecordKind::Controller) {
+            if (header.timestampUs >= timestampUs) return;
+            ++position;
+        }
+        cursor = next;
+    }
+}
+
+// ---------------------------------------------------------------- session
+
+// How often the writer thread wakes to drain the channels; well inside a channel's capacity
+constexpr auto CAPTURE_WRITE_PERIOD = std::chrono::milliseconds(10);
+
+bool CaptureSession::Start(const std::string& newPath, CaptureCompression compression) {
+    Stop();
+    auto w = std::make_unique<CaptureWriter>();
+    if (!w->Open(newPath, compression)) return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Late notifications from before the last Stop are not part of this session
+        for (auto& channel : channels)
+            while (channel->Front()) channel->Pop();
+        writer = std::move(w);
+        path = newPath;
+        droppedAtStart = DroppedTotal();
+    }
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        commands.clear();
+    }
+    stopWriter = false;
+    running.store(true, std::memory_order_relaxed);
+    writerThread = std::thread([this] { WriterLoop(); });
+    return true;
+}
+
+void CaptureSession::Stop() {
+    running.store(false, std::memory_order_relaxed);
+    if (writerThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopWriter = true;
+        }
+        wake.notify_all();
+        writerThread.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (writer) writer->Close();
+    writer.reset();
+}
+
+std::string CaptureSession::Path() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return path;
+}
+
+std::shared_ptr<CaptureChannel> CaptureSession::OpenChannel(uint64_t address, ControllerFamily family) {
+    auto channel = std::make_shared<CaptureChannel>(address, family, running);
+    std::lock_guard<std::mutex> lock(mutex);
+    channels.push_back(channel);
+    return channel;
+}
+
+void CaptureSession::CommandWrite(uint64_t address, const uint8_t* data, size_t length, int64_t timestampUs) {
+    if (!Running()) return;
+    PendingCommand c{ timestampUs, address, static_cast<uint16_t>((std::min)(length, CaptureChannel::SLOT_BYTES)), {} };
+    std::memcpy(c.data, data, c.length);
+    std::lock_guard<std::mutex> lock(commandMutex);
+    commands.push_back(c);
+}
+
+void CaptureSession::Flush() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    if (!writerThread.joinable() || stopWriter) return;
+    // The round in progress may have passed this caller's records already; the next one has not
+    uint64_t target = rounds + 2;
+    flushRequested = true;
+    wake.notify_all();
+    written.wait(lock, [&] { return rounds >= target || stopWriter; });
+}
+
+uint64_t CaptureSession::DroppedTotal() const {
+    uint64_t dropped = releasedDropped;
+    for (const auto& channel : channels) dropped += channel->Dropped();
+    return dropped;
+}
+
+uint64_t CaptureSession::Dropped() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return DroppedTotal() - droppedAtStart;
+}
+
+void CaptureSession::WriterLoop() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!stopWriter) {
+        wake.wait_for(lock, CAPTURE_WRITE_PERIOD, [&] { return stopWriter || flushRequested; });
+        flushRequested = false;
+        lock.unlock();
+        WriteQueued();
+        lock.lock();
+        ++rounds;
+        written.notify_all();
+    }
+    lock.unlock();
+    WriteQueued();   // what was queued before Stop
+}
+
+void CaptureSession::WriteQueued() {
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        writing.swap(commands);   // both keep their capacity
+    }
+    // Commands come from several threads, so they may be slightly out of order
+    auto earlier = [](const PendingCommand& a, const PendingCommand& b) { return a.timestampUs < b.timestampUs; };
+    if (!std::is_sorted(writing.begin(), writing.end(), earlier))
+        std::stable_sort(writing.begin(), writing.end(), earlier);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t nextCommand = 0;
+    for (;;) {
+        // The oldest record at the front of any channel or the command queue
+        CaptureChannel* oldest = nullptr;
+        int64_t oldestUs = 0;
+        for (auto& channel : channels) {
+            const CaptureChannel::Slot* s = channel->Front();
+            if (s && (!oldest || s->arrivalUs < oldestUs)) {
+                oldest = channel.get();
+                oldestUs = s->arrivalUs;
+            }
+        }
+        if (nextCommand < writing.size() && (!oldest || writing[nextCommand].timestampUs <= oldestUs)) {
+            const PendingCommand& c = writing[nextCommand++];
+            if (writer) writer->RecordCommandWrite(c.address, c.data, c.length, c.timestampUs);
+            continue;
+        }
+        if (!oldest) break;
+        const CaptureChannel::Slot* s = oldest->Front();
+        if (writer) writer->RecordNotification(oldest->address, oldest->family, s->data, s->length, s->arrivalUs);
+        oldest->Pop();
+    }
+    writing.clear();
+    // A channel only the session still holds gets no more notifications
+    channels.erase(std::remove_if(channels.begin(), channels.end(), [&](const std::shared_ptr<CaptureChannel>& c) {
+        if (c.use_count() > 1 || c->Front()) return false;
+        releasedDropped += c->Dropped();
+        return true;
+    }), channels.end());
+}
+
+std::string DefaultCapturePath() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    char name[64];
+    std::strftime(name, sizeof(name), "joycon2_capture_%Y%m%d_%H%M%S.jc2cap", &local);
+    return name;
+}
@@ -0,0 +1,317 @@
+#pragma once
+// Session capture: every input notification and command write with its controller and host
+// timestamp, in a flat binary file that is read through a memory mapping.
+//
+// Layout (little-endian, every structure 8-byte aligned):
+//   CaptureFileHeader
+//   records: CaptureRecordHeader + payload, padded to 8 bytes
+//   controller table: CaptureController[controllerCount]
+//   seek index: CaptureIndexEntry[indexCount], one per CAPTURE_INDEX_INTERVAL records or block
+// The header is rewritten when the capture is closed. A file that was never closed (crash)
+// has no table or index; the reader rebuilds both by scanning the records.
+//
+// Version 2 files are delta-compressed: notifications and command writes are coded into Block
+// records (see CaptureCodec.h), about a tenth of the raw size. Records the codec does not take
+// are stored raw between blocks.
+#include "FrameLayout.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CaptureBlockEncoder;
+class CaptureBlockDecoder;
+
+constexpr char CAPTURE_MAGIC[8] = { 'J', 'C', '2', 'C', 'A', 'P', 0x1A, 0 };
+constexpr uint32_t CAPTURE_VERSION = 1;
+constexpr uint32_t CAPTURE_VERSION_DELTA = 2;
+constexpr uint32_t CAPTURE_INDEX_INTERVAL = 256;
+constexpr uint8_t CAPTURE_FAMILY_UNKNOWN = 0xFF;   // only command writes seen so far
+
+enum class CaptureRecordKind : uint8_t {
+    Notification = 0,   // payload: raw notification bytes
+    CommandWrite = 1,   // payload: bytes written to the command characteristic
+    Controller = 2,     // payload: CaptureController, when a controller is first seen or updated
+    Block = 3           // payload: CaptureBlockHeader + coded records (version 2)
+};
+
+enum class CaptureCompression {
+    None,               // raw records, version 1
+    Delta               // delta-coded blocks, version 2
+};
+
+struct CaptureFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t recordCount;        // notifications and command writes
+    uint64_t controllerOffset;   // 0 until closed
+    uint32_t controllerCount;
+    uint32_t indexInterval;
+    uint64_t indexOffset;        // 0 until closed
+    uint64_t indexCount;
+    int64_t startUs;             // timestamp of the first record
+};
+static_assert(sizeof(CaptureFileHeader) == 64, "capture header layout");
+
+struct CaptureRecordHeader {
+    int64_t timestampUs;         // host steady clock (see SensorClock.h)
+    uint16_t controller;         // index into the controller table
+    CaptureRecordKind kind;
+    uint8_t reserved;
+    uint16_t length;             // payload bytes, before padding
+    uint16_t reserved2;
+};
+static_assert(sizeof(CaptureRecordHeader) == 16, "capture record layout");
+
+struct CaptureController {
+    uint64_t address;            // 48-bit Bluetooth address
+    uint8_t family;              // ControllerFamily, or CAPTURE_FAMILY_UNKNOWN
+    uint8_t reserved[7];
+};
+static_assert(sizeof(CaptureController) == 16, "capture controller layout");
+
+struct CaptureIndexEntry {
+    int64_t timestampUs;
+    uint64_t offset;             // file offset of the record
+    uint64_t recordIndex;        // counts notifications and command writes
+};
+static_assert(sizeof(CaptureIndexEntry) == 24, "capture index layout");
+
+// One notification or command write, pointing into the mapping (or, for a compressed capture,
+// into the reader's decoded block, valid until the cursor moves to another block)
+struct CaptureRecord {
+    int64_t timestampUs = 0;
+    uint16_t controller = 0;
+    CaptureRecordKind kind = CaptureRecordKind::Notification;
+    const uint8_t* data = nullptr;
+    uint16_t length = 0;
+};
+
+// Appends records to a capture file. Not thread-safe: a session uses it from its writer thread.
+class CaptureWriter {
+public:
+    CaptureWriter();
+    ~CaptureWriter();
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool Open(const std::string& path, CaptureCompression compression = CaptureCompression::None);
+    // Writes the controller table and index, then the final header
+    bool Close();
+    bool IsOpen() const { return file != nullptr; }
+
+    void RecordNotification(uint64_t address, ControllerFamily family, const uint8_t* data, size_t length, int64_t timestampUs);
+    void RecordCommandWrite(uint64_t address, const uint8_t* data, size_t length, int64_t timestampUs);
+
+    // Notifications and command writes, including those in the open block
+    uint64_t RecordCount() const;
+    // Bytes written so far; a compressed capture's open block is not counted until it is full
+    uint64_t Bytes() const { return offset; }
+
+private:
+    uint16_t ControllerId(uint64_t address, uint8_t family, int64_t timestampUs);
+    void Record(int64_t timestampUs, uint16_t controller, CaptureRecordKind kind, const uint8_t* data, size_t length);
+    void Append(int64_t timestampUs, uint16_t controller, CaptureRecordKind kind, const void* data, size_t length);
+    void FlushBlock();
+
+    FILE* file = nullptr;
+    CaptureCompression compression = CaptureCompression::None;
+    std::unique_ptr<CaptureBlockEncoder> encoder;   // created on the first compressed Open
+    int64_t blockStartUs = 0;
+    uint64_t offset = 0;
+    uint64_t recordCount = 0;
+    int64_t startUs = 0;
+    std::vector<CaptureController> controllers;
+    std::vector<CaptureIndexEntry> index;
+};
+
+// Memory-mapped, read-only view of a capture with a cursor
+class CaptureReader {
+public:
+    CaptureReader();
+    ~CaptureReader();
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    // The file was not closed cleanly; table and index were rebuilt by scanning
+    bool Recovered() const { return recovered; }
+    bool Compressed() const { return version == CAPTURE_VERSION_DELTA; }
+    uint64_t RecordCount() const { return recordCount; }
+    int64_t StartUs() const { return startUs; }
+    const std::vector<CaptureController>& Controllers() const { return controllers; }
+
+    // The record at the cursor (notifications and command writes only); false at the end
+    bool Next(CaptureRecord& record);
+    void Rewind();
+    // Moves the cursor to the first record at or after timestampUs
+    void Seek(int64_t timestampUs);
+    // Records before the cursor
+    uint64_t Position() const { return position; }
+
+private:
+    // Parses the record at offset; false past the end or on a damaged record
+    bool ReadAt(uint64_t at, CaptureRecordHeader& header, const uint8_t*& payload, uint64_t& next) const;
+    bool DecodeBlock(const CaptureRecordHeader& header, const uint8_t* payload);
+    void Scan();
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    void* mapping = nullptr;       // platform handle
+    uint32_t version = 0;
+    uint64_t recordBegin = 0;
+    uint64_t recordEnd = 0;
+    uint64_t recordCount = 0;
+    int64_t startUs = 0;
+    bool recovered = false;
+    std::vector<CaptureController> controllers;
+    std::vector<CaptureIndexEntry> index;
+    uint64_t cursor = 0;
+    uint64_t position = 0;
+    std::unique_ptr<CaptureBlockDecoder> decoder;
+    std::vector<CaptureRecord> block;   // decoded block at the cursor
+    size_t blockPos = 0;
+};
+
+// One controller's notifications on their way to the capture file: a lock-free SPSC ring whose
+// producer is the controller's notification callback and whose consumer is the session's
+// writer thread. The callback only copies into a preallocated slot.
+class CaptureChannel {
+public:
+    static constexpr uint32_t CAPACITY = 128;   // power of two; over half a second of notifications
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    static constexpr size_t SLOT_BYTES = 256;   // longer notifications are cut
+
+    CaptureChannel(uint64_t address, ControllerFamily family, const std::atomic<bool>& recording)
+        : address(address), family(family), recording(recording) {}
+    CaptureChannel(const CaptureChannel&) = delete;
+    CaptureChannel& operator=(const CaptureChannel&) = delete;
+
+    // Producer: one relaxed load while nothing is recording. A full ring drops the notification.
+    void Notification(const uint8_t* data, size_t length, int64_t arrivalUs) {
+        if (!recording.load(std::memory_order_relaxed)) return;
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tailCache == CAPACITY) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h - tailCache == CAPACITY) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        Slot& s = slots[h & (CAPACITY - 1)];
+        s.arrivalUs = arrivalUs;
+        s.length = static_cast<uint16_t>((std::min)(length, SLOT_BYTES));
+        std::memcpy(s.data, data, s.length);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    uint64_t Address() const { return address; }
+    ControllerFamily Family() const { return family; }
+    // Notifications dropped because the writer fell behind
+    uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    friend class CaptureSession;
+
+    struct Slot {
+        int64_t arrivalUs;
+        uint16_t length;
+        uint8_t data[SLOT_BYTES];
+    };
+
+    // Consumer: the oldest queued notification, or nullptr
+    const Slot* Front() const {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        return head.load(std::memory_order_acquire) != t ? &slots[t & (CAPACITY - 1)] : nullptr;
+    }
+    void Pop() { tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    const uint64_t address;
+    const ControllerFamily family;
+    const std::atomic<bool>& recording;
+    Slot slots[CAPACITY];
+
+    alignas(64) std::atomic<uint32_t> head{ 0 };
+    uint32_t tailCache = 0;                        // producer only
+    alignas(64) std::atomic<uint32_t> tail{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+};
+
+// Process-wide recording started from the dashboard. The notification callbacks feed their
+// CaptureChannel; command writes (rare, from several threads) are queued under a lock. A writer
+// thread, running while recording, merges both by timestamp into the CaptureWriter, so neither
+// the BLE callbacks nor the output threads ever wait for the file or the range coder.
+class CaptureSession {
+public:
+    static CaptureSession& Instance() {
+        static CaptureSession inst;
+        return inst;
+    }
+    ~CaptureSession() { Stop(); }
+
+    // Long sessions are recorded delta-compressed
+    bool Start(const std::string& path, CaptureCompression compression = CaptureCompression::Delta);
+    // Writes what is still queued, then closes the file
+    void Stop();
+    bool Running() const { return running.load(std::memory_order_relaxed); }
+    std::string Path() const;
+
+    // A channel for one controller's notification callback. The session keeps it until the
+    // caller has released it and everything in it is written.
+    std::shared_ptr<CaptureChannel> OpenChannel(uint64_t address, ControllerFamily family);
+    void CommandWrite(uint64_t address, const uint8_t* data, size_t length, int64_t timestampUs);
+
+    // Blocks until everything queued before the call has reached the writer
+    void Flush();
+    // Notifications dropped by full channels (commands are never dropped)
+    uint64_t Dropped() const;
+
+private:
+    CaptureSession() = default;
+
+    struct PendingCommand {
+        int64_t timestampUs;
+        uint64_t address;
+        uint16_t length;
+        uint8_t data[CaptureChannel::SLOT_BYTES];
+    };
+
+    void WriterLoop();
+    // Writes every queued record in timestamp order and releases drained channels nobody feeds
+    void WriteQueued();
+    uint64_t DroppedTotal() const;   // since the process started; needs mutex
+
+    mutable std::mutex mutex;   // writer, path and channel list
+    std::unique_ptr<CaptureWriter> writer;
+    std::string path;
+    std::vector<std::shared_ptr<CaptureChannel>> channels;
+    uint64_t releasedDropped = 0;   // drops of channels already released
+    uint64_t droppedAtStart = 0;
+    std::atomic<bool> running{ false };
+
+    std::mutex commandMutex;
+    std::vector<PendingCommand> commands;    // filled by CommandWrite
+    std::vector<PendingCommand> writing;     // swapped in by the writer thread
+
+    std::thread writerThread;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable written;
+    bool stopWriter = false;
+    bool flushRequested = false;
+    uint64_t rounds = 0;
+};
+
+// "joycon2_capture_YYYYMMDD_HHMMSS.jc2cap" for the current local time
+std::string DefaultCapturePath();
@@ -0,0 +1,75 @@
+#include "CaptureReplay.h"
+#include <chrono>
+#include <thread>
+
+bool ReplayTransport::Subscribe(NotificationHandler h) {
+    std::lock_guard<std::mutex> lock(handlerMutex);
+    handler = std::move(h);
+    return true;
+}
+
+void ReplayTransport::Unsubscribe() {
+    std::lock_guard<std::mutex> lock(handlerMutex);
+    handler = nullptr;
+}
+
+bool ReplayTransport::Write(const uint8_t* data, size_t length) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    commands.emplace_back(data, data + length);
+    return true;
+}
+
+std::vector<std::vector<uint8_t>> ReplayTransport::Commands() const {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    return commands;
+}
+
+void ReplayTransport::Deliver(const CaptureRecord& record) {
+    std::lock_guard<std::mutex> lock(handlerMutex);
+    if (!handler) return;
+    ++delivered;
+    handler(record.data, record.length, record.timestampUs);
+}
+
+CaptureReplay::CaptureReplay(CaptureReader& reader) : reader(reader) {
+    for (const CaptureController& c : reader.Controllers())
+        transports.push_back(std::make_unique<ReplayTransport>(c));
+}
+
+bool CaptureReplay::NextNotification(CaptureRecord& record) {
+    while (reader.Next(record)) {
+        if (record.kind == CaptureRecordKind::Notification && record.controller < transports.size()) return true;
+    }
+    return false;
+}
+
+bool CaptureReplay::Step() {
+    CaptureRecord record;
+    if (!NextNotification(record)) return false;
+    currentUs = record.timestampUs;
+    transports[record.controller]->Deliver(record);
+    return true;
+}
+
+uint64_t CaptureReplay::Run(double speed, const std::atomic<bool>* stop) {
+    using clock = std::chrono::steady_clock;
+    uint64_t count = 0;
+    CaptureRecord record;
+    clock::time_point wallStart{};
+    int64_t captureStart = 0;
+    while ((!stop || !stop->load(std::memory_order_relaxed)) && NextNotification(record)) {
+        if (count == 0) {
+            wallStart = clock::now();
+            captureStart = record.timestampUs;
+        }
+        // Notifications from different BLE threads can be recorded slightly out of order
+        if (speed > 0.0 && record.timestampUs > captureStart) {
+            auto offset = std::chrono::duration<double, std::micro>((record.timestampUs - captureStart) / speed);
+            std::this_thread::sleep_until(wallStart + std::chrono::duration_cast<clock::duration>(offset));
+        }
+        currentUs = record.timestampUs;
+        transports[record.controller]->Deliver(record);
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,71 @@
+#pragma once
+// CaptureReplay - Feeds a capture back through the input pipeline. Each captured controller gets
+// a ReplayTransport; the pipeline subscribes to it as it would to a live controller and sees the
+// captured bytes and timestamps, so every replay of a capture through the same pipeline state
+// produces the same reports.
+// Captured command writes are not replayed; the pipeline's own writes are recorded instead.
+#include "CaptureFile.h"
+#include "InputTransport.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ReplayTransport : public IInputTransport {
+public:
+    explicit ReplayTransport(const CaptureController& controller) : controller(controller) {}
+
+    // Joy-Con 2 when the capture saw only command writes from this controller
+    ControllerFamily Family() const override {
+        return controller.family == CAPTURE_FAMILY_UNKNOWN ? ControllerFamily::JoyCon2 : static_cast<ControllerFamily>(controller.family);
+    }
+    uint64_t Address() const override { return controller.address; }
+
+    // Delivery happens on the thread that calls CaptureReplay::Step or Run
+    bool Subscribe(NotificationHandler h) override;
+    void Unsubscribe() override;
+    bool Write(const uint8_t* data, size_t length) override;
+
+    std::vector<std::vector<uint8_t>> Commands() const;
+    uint64_t Delivered() const { return delivered; }
+
+private:
+    friend class CaptureReplay;
+    void Deliver(const CaptureRecord& record);
+
+    const CaptureController controller;
+    std::mutex handlerMutex;
+    NotificationHandler handler;
+    uint64_t delivered = 0;
+    mutable std::mutex commandMutex;
+    std::vector<std::vector<uint8_t>> commands;
+};
+
+class CaptureReplay {
+public:
+    // The reader must stay open for the replay's lifetime; replay starts at its cursor
+    explicit CaptureReplay(CaptureReader& reader);
+
+    size_t ControllerCount() const { return transports.size(); }
+    ReplayTransport& Transport(size_t controller) { return *transports[controller]; }
+
+    // Single step: delivers the next notification; false at the end of the capture
+    bool Step();
+    // Delivers the rest of the capture paced at speed times the captured rate (1 = real time,
+    // 0 = as fast as the pipeline takes it). Stops early when stop becomes true. Returns the
+    // notifications delivered.
+    uint64_t Run(double speed = 1.0, const std::atomic<bool>* stop = nullptr);
+    void Seek(int64_t timestampUs) { reader.Seek(timestampUs); }
+    void Rewind() { reader.Rewind(); }
+
+    // Captured timestamp of the last delivered notification
+    int64_t CurrentUs() const { return currentUs; }
+
+private:
+    // Next notification record; command writes are skipped
+    bool NextNotification(CaptureRecord& record);
+
+    CaptureReader& reader;
+    std::vector<std::unique_ptr<ReplayTransport>> transports;
+    int64_t currentUs = 0;
+};
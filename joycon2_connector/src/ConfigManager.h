@@ -1,9 +1,19 @@
 #pragma once
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <atomic>
+#include <mutex>
+#include "StickCalibration.h"
+#include "GyroCalibration.h"
+#include "StickCurve.h"
+#include "GyroMouse.h"
+#include "GyroStick.h"
+#include "DsuServer.h"
+#include "DualMerge.h"
 
 // GL/GR Button Mapping Configuration
 enum class ButtonMapping {
@@ -35,6 +45,8 @@ struct MouseConfig {
     float scrollSpeed = 40.0f;
     bool interpolationEnabled = true;
     int interpolationRateHz = 125;
+    MouseSource source = MouseSource::Optical;
+    GyroMouseSettings gyro;
 };
 
 struct VibrationConfig {
@@ -42,10 +54,35 @@ struct VibrationConfig {
     float intensity = 1.0f;    // 0.0 - 1.0 scale factor
 };
 
+// Cemuhook DSU motion server for emulators (localhost only)
+struct DsuConfig {
+    bool enabled = false;
+    int port = DsuServer::DEFAULT_PORT;
+};
+
+// Notification pipeline: latestOnly lets a lagging processing stage skip to the newest frame
+// instead of working through the backlog; dualMerge picks when paired Joy-Cons emit a report
+struct PipelineConfig {
+    bool latestOnly = false;
+    DualMergePolicy dualMerge = DualMergePolicy::AnyChange;
+    int dualMergeDeadlineUs = static_cast<int>(DUAL_MERGE_DEFAULT_DEADLINE_US);
+};
+
+struct StickConfig {
+    std::vector<StickProfile> profiles;
+    int activeProfileIndex = 0;
+};
+
 struct AppConfig {
     ProControllerConfig proConfig;
     MouseConfig mouseConfig;
     VibrationConfig vibrationConfig;
+    DsuConfig dsuConfig;
+    PipelineConfig pipelineConfig;
+    GyroStickSettings gyroStickConfig;
+    StickConfig stickConfig;
+    std::vector<StickCalibrationRecord> stickCalibrations;  // learned per controller
+    std::vector<GyroCalibrationRecord> gyroCalibrations;    // learned per controller
     std::string language;  // "en", "zh", or "" (auto-detect)
 };
 
@@ -117,12 +154,86 @@ inline std::string ConfigToJSON(const AppConfig& config) {
     oss << "    \"slowSensitivity\": " << config.mouseConfig.slowSensitivity << ",\n";
     oss << "    \"scrollSpeed\": " << config.mouseConfig.scrollSpeed << ",\n";
     oss << "    \"interpolationEnabled\": " << (config.mouseConfig.interpolationEnabled ? "true" : "false") << ",\n";
-    oss << "    \"interpolationRateHz\": " << config.mouseConfig.interpolationRateHz << "\n";
+    oss << "    \"interpolationRateHz\": " << config.mouseConfig.interpolationRateHz << ",\n";
+    const GyroMouseSettings& gyro = config.mouseConfig.gyro;
+    oss << "    \"source\": \"" << MouseSourceToString(config.mouseConfig.source) << "\",\n";
+    oss << "    \"gyroSpace\": \"" << GyroSpaceToString(gyro.space) << "\",\n";
+    oss << "    \"gyroMinSens\": " << gyro.minSens << ",\n";
+    oss << "    \"gyroMaxSens\": " << gyro.maxSens << ",\n";
+    oss << "    \"gyroMinThreshold\": " << gyro.minThresholdDps << ",\n";
+    oss << "    \"gyroMaxThreshold\": " << gyro.maxThresholdDps << ",\n";
+    oss << "    \"gyroDeadband\": " << gyro.deadbandDps << ",\n";
+    oss << "    \"countsPer360\": " << gyro.countsPer360 << ",\n";
+    oss << "    \"flickThreshold\": " << gyro.flickThreshold << ",\n";
+    oss << "    \"flickTimeMs\": " << gyro.flickTimeMs << "\n";
     oss << "  },\n";
     oss << "  \"vibration\": {\n";
     oss << "    \"enabled\": " << (config.vibrationConfig.enabled ? "true" : "false") << ",\n";
     oss << "    \"intensity\": " << config.vibrationConfig.intensity << "\n";
     oss << "  },\n";
+    const GyroStickSettings& gyroStick = config.gyroStickConfig;
+    oss << "  \"gyroStick\": {\n";
+    oss << "    \"mode\": \"" << GyroStickModeToString(gyroStick.mode) << "\",\n";
+    oss << "    \"space\": \"" << GyroSpaceToString(gyroStick.space) << "\",\n";
+    oss << "    \"fullDeflectionDps\": " << gyroStick.fullDeflectionDps << ",\n";
+    oss << "    \"deadzoneDps\": " << gyroStick.deadzoneDps << ",\n";
+    oss << "    \"minDeflection\": " << gyroStick.minDeflection << ",\n";
+    oss << "    \"smoothingMs\": " << gyroStick.smoothingMs << "\n";
+    oss << "  },\n";
+    oss << "  \"dsu\": {\n";
+    oss << "    \"enabled\": " << (config.dsuConfig.enabled ? "true" : "false") << ",\n";
+    oss << "    \"port\": " << config.dsuConfig.port << "\n";
+    oss << "  },\n";
+    oss << "  \"pipeline\": {\n";
+    oss << "    \"latestOnly\": " << (config.pipelineConfig.latestOnly ? "true" : "false") << ",\n";
+    oss << "    \"dualMerge\": \"" << DualMergePolicyToString(config.pipelineConfig.dualMerge) << "\",\n";
+    oss << "    \"dualMergeDeadlineUs\": " << config.pipelineConfig.dualMergeDeadlineUs << "\n";
+    oss << "  },\n";
+    oss << "  \"activeStickProfile\": " << config.stickConfig.activeProfileIndex << ",\n";
+    oss << "  \"stickProfiles\": [\n";
+    for (size_t i = 0; i < config.stickConfig.profiles.size(); ++i) {
+        const auto& p = config.stickConfig.profiles[i];
+        oss << "    { \"name\": \"" << p.name << "\"";
+        for (int s = 0; s < 2; ++s) {
+            const StickCurve& c = (s == 0) ? p.left : p.right;
+            const char* k = (s == 0) ? "l" : "r";
+            oss << ", \"" << k << "Mode\": \"" << StickDeadzoneModeToString(c.mode)
+                << "\", \"" << k << "Inner\": " << c.innerDeadzone
+                << ", \"" << k << "Outer\": " << c.outerDeadzone
+                << ", \"" << k << "Anti\": " << c.antiDeadzone
+                << ", \"" << k << "Exp\": " << c.exponent
+                << ", \"" << k << "Points\": \"" << StickCurvePointsToString(c.points) << "\"";
+        }
+        oss << " }";
+        if (i + 1 < config.stickConfig.profiles.size()) oss << ",";
+        oss << "\n";
+    }
+    oss << "  ],\n";
+    oss << "  \"stickCalibration\": [\n";
+    bool firstStick = true;
+    for (const auto& rec : config.stickCalibrations) {
+        for (int i = 0; i < 2; ++i) {
+            const StickCalibration& c = (i == 0) ? rec.left : rec.right;
+            if (!c.valid) continue;
+            if (!firstStick) oss << ",\n";
+            firstStick = false;
+            oss << "    { \"device\": \"" << rec.deviceId << "\", \"stick\": \"" << (i == 0 ? "L" : "R")
+                << "\", \"cx\": " << c.centerX << ", \"cy\": " << c.centerY
+                << ", \"minX\": " << c.minX << ", \"maxX\": " << c.maxX
+                << ", \"minY\": " << c.minY << ", \"maxY\": " << c.maxY
+                << ", \"noise\": " << c.noise << " }";
+        }
+    }
+    oss << (firstStick ? "  ],\n" : "\n  ],\n");
+    oss << "  \"gyroCalibration\": [\n";
+    for (size_t i = 0; i < config.gyroCalibrations.size(); ++i) {
+        const GyroCalibrationRecord& rec = config.gyroCalibrations[i];
+        oss << "    { \"device\": \"" << rec.deviceId << "\", \"gx\": " << rec.bias.x
+            << ", \"gy\": " << rec.bias.y << ", \"gz\": " << rec.bias.z << " }";
+        if (i + 1 < config.gyroCalibrations.size()) oss << ",";
+        oss << "\n";
+    }
+    oss << "  ],\n";
     oss << "  \"language\": \"" << config.language << "\"\n";
     oss << "}";
     return oss.str();
@@ -208,6 +319,17 @@ inline bool JSONToConfig(const std::string& json, AppConfig& config) {
             config.mouseConfig.scrollSpeed = (float)ExtractJsonNumber(mouseStr, "scrollSpeed", 40.0);
             config.mouseConfig.interpolationEnabled = ExtractJsonBool(mouseStr, "interpolationEnabled", true);
             config.mouseConfig.interpolationRateHz = static_cast<int>(ExtractJsonNumber(mouseStr, "interpolationRateHz", 500));
+            config.mouseConfig.source = StringToMouseSource(ExtractJsonString(mouseStr, "source"));
+            GyroMouseSettings& gyro = config.mouseConfig.gyro;
+            gyro.space = StringToGyroSpace(ExtractJsonString(mouseStr, "gyroSpace"));
+            gyro.minSens = (float)ExtractJsonNumber(mouseStr, "gyroMinSens", 1.0);
+            gyro.maxSens = (float)ExtractJsonNumber(mouseStr, "gyroMaxSens", 2.0);
+            gyro.minThresholdDps = (float)ExtractJsonNumber(mouseStr, "gyroMinThreshold", 10.0);
+            gyro.maxThresholdDps = (float)ExtractJsonNumber(mouseStr, "gyroMaxThreshold", 120.0);
+            gyro.deadbandDps = (float)ExtractJsonNumber(mouseStr, "gyroDeadband", 0.5);
+            gyro.countsPer360 = (float)ExtractJsonNumber(mouseStr, "countsPer360", 3600.0);
+            gyro.flickThreshold = (float)ExtractJsonNumber(mouseStr, "flickThreshold", 0.9);
+            gyro.flickTimeMs = (float)ExtractJsonNumber(mouseStr, "flickTimeMs", 100.0);
         }
     }
 
@@ -223,6 +345,152 @@ inline bool JSONToConfig(const std::string& json, AppConfig& config) {
         }
     }
 
+    // Parse gyro-to-stick config
+    auto gsPos = json.find("\"gyroStick\"");
+    if (gsPos != std::string::npos) {
+        auto gsStart = json.find('{', gsPos);
+        auto gsEnd = json.find('}', gsStart);
+        if (gsStart != std::string::npos && gsEnd != std::string::npos) {
+            std::string gsStr = json.substr(gsStart, gsEnd - gsStart + 1);
+            GyroStickSettings& gyroStick = config.gyroStickConfig;
+            gyroStick.mode = StringToGyroStickMode(ExtractJsonString(gsStr, "mode"));
+            gyroStick.space = StringToGyroSpace(ExtractJsonString(gsStr, "space"));
+            gyroStick.fullDeflectionDps = (float)ExtractJsonNumber(gsStr, "fullDeflectionDps", 180.0);
+            gyroStick.deadzoneDps = (float)ExtractJsonNumber(gsStr, "deadzoneDps", 2.0);
+            gyroStick.minDeflection = (float)ExtractJsonNumber(gsStr, "minDeflection", 0.1);
+            gyroStick.smoothingMs = (float)ExtractJsonNumber(gsStr, "smoothingMs", 15.0);
+        }
+    }
+
+    // Parse DSU server config
+    auto dsuPos = json.find("\"dsu\"");
+    if (dsuPos != std::string::npos) {
+        auto dsuStart = json.find('{', dsuPos);
+        auto dsuEnd = json.find('}', dsuStart);
+        if (dsuStart != std::string::npos && dsuEnd != std::string::npos) {
+            std::string dsuStr = json.substr(dsuStart, dsuEnd - dsuStart + 1);
+            config.dsuConfig.enabled = ExtractJsonBool(dsuStr, "enabled", false);
+            int port = static_cast<int>(ExtractJsonNumber(dsuStr, "port", DsuServer::DEFAULT_PORT));
+            config.dsuConfig.port = (port > 0 && port <= 65535) ? port : DsuServer::DEFAULT_PORT;
+        }
+    }
+
+    // Parse notification pipeline config
+    auto pipelinePos = json.find("\"pipeline\"");
+    if (pipelinePos != std::string::npos) {
+        auto pipelineStart = json.find('{', pipelinePos);
+        auto pipelineEnd = json.find('}', pipelineStart);
+        if (pipelineStart != std::string::npos && pipelineEnd != std::string::npos) {
+            std::string pipelineStr = json.substr(pipelineStart, pipelineEnd - pipelineStart + 1);
+            config.pipelineConfig.latestOnly = ExtractJsonBool(pipelineStr, "latestOnly", false);
+            config.pipelineConfig.dualMerge = StringToDualMergePolicy(ExtractJsonString(pipelineStr, "dualMerge"));
+            config.pipelineConfig.dualMergeDeadlineUs = std::clamp(static_cast<int>(ExtractJsonNumber(
+                pipelineStr, "dualMergeDeadlineUs", static_cast<double>(DUAL_MERGE_DEFAULT_DEADLINE_US))), 0, 50000);
+        }
+    }
+
+    // Parse stick response profiles (curve points are a flat "in:out;in:out" string)
+    config.stickConfig.activeProfileIndex = static_cast<int>(ExtractJsonNumber(json, "activeStickProfile", 0));
+    config.stickConfig.profiles.clear();
+    auto profilesPos = json.find("\"stickProfiles\"");
+    if (profilesPos != std::string::npos) {
+        auto arrStart = json.find('[', profilesPos);
+        auto arrEnd = json.find(']', arrStart);
+        if (arrStart != std::string::npos && arrEnd != std::string::npos) {
+            std::string arrStr = json.substr(arrStart, arrEnd - arrStart + 1);
+            size_t objPos = 0;
+            while ((objPos = arrStr.find('{', objPos)) != std::string::npos) {
+                auto objEnd = arrStr.find('}', objPos);
+                if (objEnd == std::string::npos) break;
+                std::string objStr = arrStr.substr(objPos, objEnd - objPos + 1);
+                objPos = objEnd + 1;
+
+                StickProfile profile;
+                profile.name = ExtractJsonString(objStr, "name");
+                for (int s = 0; s < 2; ++s) {
+                    StickCurve& c = (s == 0) ? profile.left : profile.right;
+                    std::string k = (s == 0) ? "l" : "r";
+                    c.mode = StringToStickDeadzoneMode(ExtractJsonString(objStr, k + "Mode"));
+                    c.innerDeadzone = (float)ExtractJsonNumber(objStr, k + "Inner", 0.08);
+                    c.outerDeadzone = (float)ExtractJsonNumber(objStr, k + "Outer", 0.04);
+                    c.antiDeadzone = (float)ExtractJsonNumber(objStr, k + "Anti", 0.0);
+                    c.exponent = (float)ExtractJsonNumber(objStr, k + "Exp", 1.0);
+                    c.points = StringToStickCurvePoints(ExtractJsonString(objStr, k + "Points"));
+                }
+                config.stickConfig.profiles.push_back(profile);
+            }
+        }
+    }
+
+    // Parse learned stick calibration (one object per stick, grouped back per device)
+    config.stickCalibrations.clear();
+    auto calPos = json.find("\"stickCalibration\"");
+    if (calPos != std::string::npos) {
+        auto arrStart = json.find('[', calPos);
+        auto arrEnd = json.find(']', arrStart);
+        if (arrStart != std::string::npos && arrEnd != std::string::npos) {
+            std::string arrStr = json.substr(arrStart, arrEnd - arrStart + 1);
+            size_t objPos = 0;
+            while ((objPos = arrStr.find('{', objPos)) != std::string::npos) {
+                auto objEnd = arrStr.find('}', objPos);
+                if (objEnd == std::string::npos) break;
+                std::string objStr = arrStr.substr(objPos, objEnd - objPos + 1);
+                objPos = objEnd + 1;
+
+                std::string device = ExtractJsonString(objStr, "device");
+                if (device.empty()) continue;
+                StickCalibration c;
+                c.valid = true;
+                c.centerX = static_cast<uint16_t>(ExtractJsonNumber(objStr, "cx", STICK_RAW_CENTER));
+                c.centerY = static_cast<uint16_t>(ExtractJsonNumber(objStr, "cy", STICK_RAW_CENTER));
+                c.minX = static_cast<uint16_t>(ExtractJsonNumber(objStr, "minX", 0));
+                c.maxX = static_cast<uint16_t>(ExtractJsonNumber(objStr, "maxX", STICK_RAW_RANGE - 1));
+                c.minY = static_cast<uint16_t>(ExtractJsonNumber(objStr, "minY", 0));
+                c.maxY = static_cast<uint16_t>(ExtractJsonNumber(objStr, "maxY", STICK_RAW_RANGE - 1));
+                c.noise = static_cast<uint16_t>(ExtractJsonNumber(objStr, "noise", 0));
+                // Reject anything that is not a plausible center inside its extents
+                if (c.maxX >= STICK_RAW_RANGE || c.maxY >= STICK_RAW_RANGE ||
+                    !(c.minX < c.centerX && c.centerX < c.maxX) || !(c.minY < c.centerY && c.centerY < c.maxY)) continue;
+
+                StickCalibrationRecord* rec = nullptr;
+                for (auto& r : config.stickCalibrations)
+                    if (r.deviceId == device) rec = &r;
+                if (!rec) {
+                    config.stickCalibrations.push_back({ device, {}, {} });
+                    rec = &config.stickCalibrations.back();
+                }
+                (ExtractJsonString(objStr, "stick") == "R" ? rec->right : rec->left) = c;
+            }
+        }
+    }
+
+    // Parse learned gyro bias (one object per controller)
+    config.gyroCalibrations.clear();
+    auto gyroPos = json.find("\"gyroCalibration\"");
+    if (gyroPos != std::string::npos) {
+        auto arrStart = json.find('[', gyroPos);
+        auto arrEnd = json.find(']', arrStart);
+        if (arrStart != std::string::npos && arrEnd != std::string::npos) {
+            std::string arrStr = json.substr(arrStart, arrEnd - arrStart + 1);
+            size_t objPos = 0;
+            while ((objPos = arrStr.find('{', objPos)) != std::string::npos) {
+                auto objEnd = arrStr.find('}', objPos);
+                if (objEnd == std::string::npos) break;
+                std::string objStr = arrStr.substr(objPos, objEnd - objPos + 1);
+                objPos = objEnd + 1;
+
+                GyroCalibrationRecord rec;
+                rec.deviceId = ExtractJsonString(objStr, "device");
+                if (rec.deviceId.empty()) continue;
+                rec.bias.valid = true;
+                rec.bias.x = static_cast<int16_t>(std::clamp(ExtractJsonNumber(objStr, "gx", 0), -32768.0, 32767.0));
+                rec.bias.y = static_cast<int16_t>(std::clamp(ExtractJsonNumber(objStr, "gy", 0), -32768.0, 32767.0));
+                rec.bias.z = static_cast<int16_t>(std::clamp(ExtractJsonNumber(objStr, "gz", 0), -32768.0, 32767.0));
+                config.gyroCalibrations.push_back(rec);
+            }
+        }
+    }
+
     // Parse language
     config.language = ExtractJsonString(json, "language");
 
@@ -244,7 +512,9 @@ public:
         if (!file.is_open()) return false;
         std::stringstream ss;
         ss << file.rdbuf();
-        return JSONToConfig(ss.str(), config);
+        bool ok = JSONToConfig(ss.str(), config);
+        PublishStickProfile();
+        return ok;
     }
 
     void Save() {
@@ -254,6 +524,60 @@ public:
         }
     }
 
+    const StickCalibrationRecord* FindStickCalibration(const std::string& deviceId) const {
+        for (const auto& rec : config.stickCalibrations)
+            if (rec.deviceId == deviceId) return &rec;
+        return nullptr;
+    }
+
+    // Replace the saved calibration for rec.deviceId (sticks not learned this session keep the old values)
+    void StoreStickCalibration(const StickCalibrationRecord& rec) {
+        for (auto& existing : config.stickCalibrations) {
+            if (existing.deviceId != rec.deviceId) continue;
+            if (rec.left.valid) existing.left = rec.left;
+            if (rec.right.valid) existing.right = rec.right;
+            return;
+        }
+        config.stickCalibrations.push_back(rec);
+    }
+
+    const GyroCalibrationRecord* FindGyroCalibration(const std::string& deviceId) const {
+        for (const auto& rec : config.gyroCalibrations)
+            if (rec.deviceId == deviceId) return &rec;
+        return nullptr;
+    }
+
+    void StoreGyroCalibration(const GyroCalibrationRecord& rec) {
+        if (!rec.bias.valid) return;
+        for (auto& existing : config.gyroCalibrations) {
+            if (existing.deviceId != rec.deviceId) continue;
+            existing.bias = rec.bias;
+            return;
+        }
+        config.gyroCalibrations.push_back(rec);
+    }
+
+    // The active stick profile as seen by the report threads. The UI edits config.stickConfig and
+    // calls PublishStickProfile; each controller rebuilds its tables when the revision changes.
+    void PublishStickProfile() {
+        StickProfile active;
+        const auto& sc = config.stickConfig;
+        if (sc.activeProfileIndex >= 0 && sc.activeProfileIndex < (int)sc.profiles.size())
+            active = sc.profiles[sc.activeProfileIndex];
+        std::lock_guard<std::mutex> lock(stickProfileMutex);
+        publishedStickProfile = active;
+        stickProfileRevision.fetch_add(1, std::memory_order_release);
+    }
+
+    uint32_t StickProfileRevision() const {
+        return stickProfileRevision.load(std::memory_order_acquire);
+    }
+
+    StickProfile ActiveStickProfile() const {
+        std::lock_guard<std::mutex> lock(stickProfileMutex);
+        return publishedStickProfile;
+    }
+
     void EnsureDefaults() {
         if (config.proConfig.layouts.empty()) {
             GLGRLayout defaultLayout;
@@ -263,8 +587,19 @@ public:
             config.proConfig.layouts.push_back(defaultLayout);
             config.proConfig.activeLayoutIndex = 0;
         }
+        if (config.stickConfig.profiles.empty()) {
+            StickProfile defaultProfile;
+            defaultProfile.name = "Default";
+            config.stickConfig.profiles.push_back(defaultProfile);
+            config.stickConfig.activeProfileIndex = 0;
+            PublishStickProfile();
+        }
     }
 
 private:
     ConfigManager() = default;
+
+    mutable std::mutex stickProfileMutex;
+    StickProfile publishedStickProfile;
+    std::atomic<uint32_t> stickProfileRevision{ 1 };
 };
@@ -0,0 +1,138 @@
+#pragma once
+// DS4Report - DualShock 4 report types for the platform-neutral core
+// Windows builds take the definitions from ViGEm; other platforms get a layout-compatible copy of
+// the DS4 subset of ViGEm/Common.h so the decoder builds without Windows headers.
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <ViGEm/Client.h>
+#else
+#include <cstring>
+
+typedef uint8_t BYTE;
+typedef uint8_t UCHAR;
+typedef int16_t SHORT;
+typedef uint16_t USHORT;
+
+typedef enum _DS4_BUTTONS
+{
+    DS4_BUTTON_THUMB_RIGHT      = 1 << 15,
+    DS4_BUTTON_THUMB_LEFT       = 1 << 14,
+    DS4_BUTTON_OPTIONS          = 1 << 13,
+    DS4_BUTTON_SHARE            = 1 << 12,
+    DS4_BUTTON_TRIGGER_RIGHT    = 1 << 11,
+    DS4_BUTTON_TRIGGER_LEFT     = 1 << 10,
+    DS4_BUTTON_SHOULDER_RIGHT   = 1 << 9,
+    DS4_BUTTON_SHOULDER_LEFT    = 1 << 8,
+    DS4_BUTTON_TRIANGLE         = 1 << 7,
+    DS4_BUTTON_CIRCLE           = 1 << 6,
+    DS4_BUTTON_CROSS            = 1 << 5,
+    DS4_BUTTON_SQUARE           = 1 << 4
+} DS4_BUTTONS, *PDS4_BUTTONS;
+
+typedef enum _DS4_SPECIAL_BUTTONS
+{
+    DS4_SPECIAL_BUTTON_PS           = 1 << 0,
+    DS4_SPECIAL_BUTTON_TOUCHPAD     = 1 << 1
+} DS4_SPECIAL_BUTTONS, *PDS4_SPECIAL_BUTTONS;
+
+typedef enum _DS4_DPAD_DIRECTIONS
+{
+    DS4_BUTTON_DPAD_NONE        = 0x8,
+    DS4_BUTTON_DPAD_NORTHWEST   = 0x7,
+    DS4_BUTTON_DPAD_WEST        = 0x6,
+    DS4_BUTTON_DPAD_SOUTHWEST   = 0x5,
+    DS4_BUTTON_DPAD_SOUTH       = 0x4,
+    DS4_BUTTON_DPAD_SOUTHEAST   = 0x3,
+    DS4_BUTTON_DPAD_EAST        = 0x2,
+    DS4_BUTTON_DPAD_NORTHEAST   = 0x1,
+    DS4_BUTTON_DPAD_NORTH       = 0x0
+} DS4_DPAD_DIRECTIONS, *PDS4_DPAD_DIRECTIONS;
+
+typedef struct _DS4_REPORT
+{
+    BYTE bThumbLX;
+    BYTE bThumbLY;
+    BYTE bThumbRX;
+    BYTE bThumbRY;
+    USHORT wButtons;
+    BYTE bSpecial;
+    BYTE bTriggerL;
+    BYTE bTriggerR;
+} DS4_REPORT, *PDS4_REPORT;
+
+inline void DS4_SET_DPAD(PDS4_REPORT Report, DS4_DPAD_DIRECTIONS Dpad)
+{
+    Report->wButtons &= ~0xF;
+    Report->wButtons |= (USHORT)Dpad;
+}
+
+inline void DS4_REPORT_INIT(PDS4_REPORT Report)
+{
+    std::memset(Report, 0, sizeof(DS4_REPORT));
+
+    Report->bThumbLX = 0x80;
+    Report->bThumbLY = 0x80;
+    Report->bThumbRX = 0x80;
+    Report->bThumbRY = 0x80;
+
+    DS4_SET_DPAD(Report, DS4_BUTTON_DPAD_NONE);
+}
+
+#pragma pack(push, 1)
+typedef struct _DS4_TOUCH
+{
+    BYTE bPacketCounter;
+    BYTE bIsUpTrackingNum1;
+    BYTE bTouchData1[3];
+    BYTE bIsUpTrackingNum2;
+    BYTE bTouchData2[3];
+} DS4_TOUCH, *PDS4_TOUCH;
+
+typedef struct _DS4_REPORT_EX
+{
+    union
+    {
+        struct
+        {
+            BYTE bThumbLX;
+            BYTE bThumbLY;
+            BYTE bThumbRX;
+            BYTE bThumbRY;
+            USHORT wButtons;
+            BYTE bSpecial;
+            BYTE bTriggerL;
+            BYTE bTriggerR;
+            USHORT wTimestamp;
+            BYTE bBatteryLvl;
+            SHORT wGyroX;
+            SHORT wGyroY;
+            SHORT wGyroZ;
+            SHORT wAccelX;
+            SHORT wAccelY;
+            SHORT wAccelZ;
+            BYTE _bUnknown1[5];
+            BYTE bBatteryLvlSpecial;
+            BYTE _bUnknown2[2];
+            BYTE bTouchPacketsN;
+            DS4_TOUCH sCurrentTouch;
+            DS4_TOUCH sPreviousTouch[2];
+        } Report;
+
+        UCHAR ReportBuffer[63];
+    };
+} DS4_REPORT_EX, *PDS4_REPORT_EX;
+#pragma pack(pop)
+#endif
+
+// The shim must stay byte-compatible with what ViGEm hands to the driver
+static_assert(sizeof(DS4_TOUCH) == 9, "DS4_TOUCH layout");
+static_assert(sizeof(DS4_REPORT_EX) == 63, "DS4_REPORT_EX layout");
+static_assert(offsetof(DS4_REPORT_EX, Report.wButtons) == 4, "DS4_REPORT_EX layout");
+static_assert(offsetof(DS4_REPORT_EX, Report.wTimestamp) == 9, "DS4_REPORT_EX layout");
+static_assert(offsetof(DS4_REPORT_EX, Report.wGyroX) == 12, "DS4_REPORT_EX layout");
+static_assert(offsetof(DS4_REPORT_EX, Report.wAccelX) == 18, "DS4_REPORT_EX layout");
+static_assert(offsetof(DS4_REPORT_EX, Report.bTouchPacketsN) == 32, "DS4_REPORT_EX layout");
+static_assert(offsetof(DS4_REPORT_EX, Report.sCurrentTouch) == 33, "DS4_REPORT_EX layout");
@@ -0,0 +1,345 @@
+#ifdef _WIN32
+// Must precede Windows.h (pulled in by DS4Report.h), which would otherwise bring in winsock 1
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+#include "DsuServer.h"
+#include "SensorClock.h"
+#include <array>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+using socklen_t = int;
+static void close_socket(socket_t s) { closesocket(s); }
+#else
+using socket_t = int;
+static void close_socket(socket_t s) { close(s); }
+#endif
+
+constexpr int RECEIVE_TIMEOUT_MS = 100;   // how often the receive thread checks for Stop
+constexpr uint8_t SLOT_CONNECTED = 2;
+constexpr uint8_t MODEL_FULL_GYRO = 2;
+constexpr uint8_t CONNECTION_BLUETOOTH = 2;
+
+// Pad-data request flags
+constexpr uint8_t REQUEST_BY_SLOT = 1;
+constexpr uint8_t REQUEST_BY_MAC = 2;
+
+static constexpr std::array<uint32_t, 256> make_crc_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+    return table;
+}
+static constexpr std::array<uint32_t, 256> CRC_TABLE = make_crc_table();
+
+uint32_t DsuCrc32(const uint8_t* data, size_t length) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) c = CRC_TABLE[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+// The protocol is little-endian throughout
+static void put16(uint8_t* p, uint16_t v) { p[0] = uint8_t(v); p[1] = uint8_t(v >> 8); }
+static void put32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; ++i) p[i] = uint8_t(v >> (8 * i)); }
+static void put64(uint8_t* p, uint64_t v) { for (int i = 0; i < 8; ++i) p[i] = uint8_t(v >> (8 * i)); }
+static void put_float(uint8_t* p, float v) { uint32_t u; std::memcpy(&u, &v, 4); put32(p, u); }
+static uint16_t get16(const uint8_t* p) { return uint16_t(p[0] | p[1] << 8); }
+static uint32_t get32(const uint8_t* p) { return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24; }
+
+bool DsuPacketValid(const uint8_t* data, size_t length, const char* magic) {
+    uint8_t copy[256];
+    if (length < DSU_HEADER_SIZE + 4 || length > sizeof(copy) || std::memcmp(data, magic, 4) != 0) return false;
+    size_t total = get16(data + 6) + DSU_HEADER_SIZE;
+    if (get16(data + 4) != DSU_PROTOCOL_VERSION || total > length) return false;
+
+    std::memcpy(copy, data, total);
+    std::memset(copy + 8, 0, 4);
+    return DsuCrc32(copy, total) == get32(data + 8);
+}
+
+// Header, message type and CRC around a payload that is already in place
+static void finish_packet(uint8_t* p, size_t length, uint32_t serverId, uint32_t type) {
+    std::memcpy(p, "DSUS", 4);
+    put16(p + 4, DSU_PROTOCOL_VERSION);
+    put16(p + 6, uint16_t(length - DSU_HEADER_SIZE));
+    put32(p + 8, 0);
+    put32(p + 12, serverId);
+    put32(p + 16, type);
+    put32(p + 8, DsuCrc32(p, length));
+}
+
+// Slot state shared by port-info and pad-data packets (11 bytes at offset 20)
+static void put_slot_info(uint8_t* p, int slot, bool connected, const uint8_t* mac) {
+    p[0] = uint8_t(slot);
+    p[1] = connected ? SLOT_CONNECTED : 0;
+    p[2] = connected ? MODEL_FULL_GYRO : 0;
+    p[3] = connected ? CONNECTION_BLUETOOTH : 0;
+    std::memcpy(p + 4, mac, 6);
+    p[10] = 0;   // battery: not reported
+}
+
+// DS4 d-pad hat value -> up, right, down, left
+static void dpad_directions(int hat, bool* dir) {
+    dir[0] = hat == 7 || hat == 0 || hat == 1;
+    dir[1] = hat >= 1 && hat <= 3;
+    dir[2] = hat >= 3 && hat <= 5;
+    dir[3] = hat >= 5 && hat <= 7;
+}
+
+static void put_touch(uint8_t* p, uint8_t upTracking, const BYTE* data) {
+    p[0] = (upTracking & 0x80) ? 0 : 1;
+    p[1] = upTracking & 0x7F;
+    put16(p + 2, uint16_t(data[0] | (data[1] & 0x0F) << 8));
+    put16(p + 4, uint16_t((data[1] >> 4) | data[2] << 4));
+}
+
+bool DsuServer::Start(uint16_t port) {
+    Stop();
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    auto fail = [](socket_t s) {
+        if (s != socket_t(-1)) close_socket(s);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    };
+    socket_t s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == socket_t(-1)) return fail(s);
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+#ifdef _WIN32
+    DWORD timeout = RECEIVE_TIMEOUT_MS;
+#else
+    timeval timeout{ 0, RECEIVE_TIMEOUT_MS * 1000 };
+#endif
+    socklen_t addrLen = sizeof(addr);
+    if (bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout)) != 0 ||
+        getsockname(s, reinterpret_cast<sockaddr*>(&addr), &addrLen) != 0)
+        return fail(s);
+
+    sock = intptr_t(s);
+    boundPort = ntohs(addr.sin_port);
+    // Clients notice a restarted server by its id
+    serverId = uint32_t(SteadyMicros(std::chrono::steady_clock::now())) | 1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Client& c : clients) c = Client{};
+    }
+    running.store(true, std::memory_order_release);
+    receiver = std::thread(&DsuServer::ReceiveLoop, this);
+    return true;
+}
+
+void DsuServer::Stop() {
+    if (!running.exchange(false, std::memory_order_acq_rel)) return;
+    if (receiver.joinable()) receiver.join();
+    std::unique_lock<std::shared_mutex> lock(socketMutex);
+    close_socket(socket_t(sock));
+    sock = -1;
+    boundPort = 0;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+int DsuServer::AcquireSlot(uint64_t mac) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < SLOTS; ++i) {
+        if (slots[i].connected) continue;
+        slots[i].connected = true;
+        for (int b = 0; b < 6; ++b) slots[i].mac[b] = uint8_t(mac >> (8 * (5 - b)));
+        return i;
+    }
+    return -1;
+}
+
+void DsuServer::ReleaseSlot(int slot) {
+    if (slot < 0 || slot >= SLOTS) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    slots[slot] = Slot{};
+}
+
+int DsuServer::ClientCount() const {
+    int64_t now = SteadyMicros(std::chrono::steady_clock::now());
+    std::lock_guard<std::mutex> lock(mutex);
+    int n = 0;
+    for (const Client& c : clients)
+        if (c.slotMask && now - c.lastRequestUs < CLIENT_TIMEOUT_US) ++n;
+    return n;
+}
+
+void DsuServer::SendTo(const uint8_t* data, size_t length, uint32_t addr, uint16_t port) {
+    sockaddr_in to{};
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = addr;
+    to.sin_port = port;
+    sendto(socket_t(sock), reinterpret_cast<const char*>(data), int(length), 0, reinterpret_cast<sockaddr*>(&to), sizeof(to));
+}
+
+void DsuServer::Publish(int slot, const DS4_REPORT_EX& report, const DsuMotion& motion) {
+    if (slot < 0 || slot >= SLOTS) return;
+    // Keeps Stop from closing the socket mid-send
+    std::shared_lock<std::shared_mutex> socketLock(socketMutex);
+    if (!Running()) return;
+
+    // Snapshot the recipients so the lock is not held across sendto
+    Client targets[MAX_CLIENTS];
+    int targetCount = 0;
+    uint8_t mac[6];
+    int64_t now = SteadyMicros(std::chrono::steady_clock::now());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!slots[slot].connected) return;
+        std::memcpy(mac, slots[slot].mac, 6);
+        for (const Client& c : clients)
+            if ((c.slotMask & (1 << slot)) && now - c.lastRequestUs < CLIENT_TIMEOUT_US) targets[targetCount++] = c;
+    }
+    if (targetCount == 0) return;
+
+    const auto& r = report.Report;
+    std::array<uint8_t, DSU_PAD_DATA_SIZE> p{};
+    put_slot_info(&p[20], slot, true, mac);
+    p[31] = 1;
+    put32(&p[32], packetCounters[slot].fetch_add(1, std::memory_order_relaxed));
+
+    bool dir[4];   // up, right, down, left
+    dpad_directions(r.wButtons & 0xF, dir);
+    auto held = [&](int mask) { return (r.wButtons & mask) != 0; };
+    p[36] = uint8_t(dir[3] << 7 | dir[2] << 6 | dir[1] << 5 | dir[0] << 4 |
+                    held(DS4_BUTTON_OPTIONS) << 3 | held(DS4_BUTTON_THUMB_RIGHT) << 2 |
+                    held(DS4_BUTTON_THUMB_LEFT) << 1 | held(DS4_BUTTON_SHARE));
+    p[37] = uint8_t(held(DS4_BUTTON_SQUARE) << 7 | held(DS4_BUTTON_CROSS) << 6 |
+                    held(DS4_BUTTON_CIRCLE) << 5 | held(DS4_BUTTON_TRIANGLE) << 4 |
+                    held(DS4_BUTTON_SHOULDER_RIGHT) << 3 | held(DS4_BUTTON_SHOULDER_LEFT) << 2 |
+                    held(DS4_BUTTON_TRIGGER_RIGHT) << 1 | held(DS4_BUTTON_TRIGGER_LEFT));
+    p[38] = (r.bSpecial & DS4_SPECIAL_BUTTON_PS) ? 1 : 0;
+    p[39] = (r.bSpecial & DS4_SPECIAL_BUTTON_TOUCHPAD) ? 1 : 0;
+    // DSU sticks are positive up, DS4 positive down
+    p[40] = r.bThumbLX;
+    p[41] = uint8_t(255 - r.bThumbLY);
+    p[42] = r.bThumbRX;
+    p[43] = uint8_t(255 - r.bThumbRY);
+
+    // Analog buttons: d-pad left, down, right, up, then square, cross, circle, triangle, R1, L1, R2, L2
+    const bool digital[10] = { dir[3], dir[2], dir[1], dir[0],
+                               held(DS4_BUTTON_SQUARE), held(DS4_BUTTON_CROSS), held(DS4_BUTTON_CIRCLE),
+                               held(DS4_BUTTON_TRIANGLE), held(DS4_BUTTON_SHOULDER_RIGHT), held(DS4_BUTTON_SHOULDER_LEFT) };
+    for (int i = 0; i < 10; ++i) p[44 + i] = digital[i] ? 255 : 0;
+    p[54] = r.bTriggerR;
+    p[55] = r.bTriggerL;
+
+    // The newest touch packet: a report carrying several has them oldest first
+    const DS4_TOUCH* packets[3] = { &r.sCurrentTouch, &r.sPreviousTouch[0], &r.sPreviousTouch[1] };
+    const DS4_TOUCH& touch = *packets[r.bTouchPacketsN > 3 ? 2 : r.bTouchPacketsN > 0 ? r.bTouchPacketsN - 1 : 0];
+    put_touch(&p[56], touch.bIsUpTrackingNum1, touch.bTouchData1);
+    put_touch(&p[62], touch.bIsUpTrackingNum2, touch.bTouchData2);
+
+    put64(&p[68], motion.timestampUs);
+    for (int i = 0; i < 3; ++i) {
+        put_float(&p[76 + 4 * i], motion.accelG[i]);
+        put_float(&p[88 + 4 * i], motion.gyroDps[i]);
+    }
+    finish_packet(p.data(), p.size(), serverId, DSU_MSG_PAD_DATA);
+
+    for (int i = 0; i < targetCount; ++i) SendTo(p.data(), p.size(), targets[i].addr, targets[i].port);
+}
+
+// Pad-data request: flags, slot, MAC. Subscriptions expire unless renewed
+void DsuServer::Subscribe(uint32_t addr, uint16_t port, const uint8_t* request, size_t length) {
+    if (length < 28) return;
+    uint8_t flags = request[20];
+    int slot = request[21];
+    const uint8_t* mac = request + 22;
+
+    int64_t now = SteadyMicros(std::chrono::steady_clock::now());
+    std::lock_guard<std::mutex> lock(mutex);
+    uint8_t mask = 0;
+    if (flags == 0) mask = (1 << SLOTS) - 1;
+    if ((flags & REQUEST_BY_SLOT) && slot < SLOTS) mask |= uint8_t(1 << slot);
+    if (flags & REQUEST_BY_MAC) {
+        for (int i = 0; i < SLOTS; ++i)
+            if (slots[i].connected && std::memcmp(slots[i].mac, mac, 6) == 0) mask |= uint8_t(1 << i);
+    }
+    if (!mask) return;
+
+    // Same client, else a free or expired entry, else the stalest one
+    Client* target = nullptr;
+    for (Client& c : clients) {
+        if (c.slotMask && c.addr == addr && c.port == port) { target = &c; break; }
+    }
+    if (!target) {
+        target = &clients[0];
+        for (Client& c : clients) {
+            if (c.lastRequestUs < target->lastRequestUs) target = &c;
+        }
+        *target = Client{ addr, port, 0, now };
+    }
+    if (now - target->lastRequestUs >= CLIENT_TIMEOUT_US) target->slotMask = 0;
+    target->slotMask |= mask;
+    target->lastRequestUs = now;
+}
+
+void DsuServer::ReceiveLoop() {
+    uint8_t buf[256];
+    while (running.load(std::memory_order_acquire)) {
+        sockaddr_in from{};
+        socklen_t fromLen = sizeof(from);
+        int n = int(recvfrom(socket_t(sock), reinterpret_cast<char*>(buf), sizeof(buf), 0,
+                             reinterpret_cast<sockaddr*>(&from), &fromLen));
+        if (n <= 0 || !DsuPacketValid(buf, size_t(n), "DSUC")) continue;
+
+        uint32_t addr = from.sin_addr.s_addr;
+        uint16_t port = from.sin_port;
+        switch (get32(buf + 16)) {
+        case DSU_MSG_VERSION: {
+            uint8_t out[DSU_VERSION_SIZE] = {};
+            put16(out + 20, DSU_PROTOCOL_VERSION);
+            finish_packet(out, sizeof(out), serverId, DSU_MSG_VERSION);
+            SendTo(out, sizeof(out), addr, port);
+            break;
+        }
+        case DSU_MSG_PORTS: {
+            if (n < 24) break;
+            int count = int(get32(buf + 20));
+            for (int i = 0; i < count && i < SLOTS && 24 + i < n; ++i) {
+                int slot = buf[24 + i];
+                if (slot >= SLOTS) continue;
+                Slot info;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    info = slots[slot];
+                }
+                uint8_t out[DSU_PORT_INFO_SIZE] = {};
+                put_slot_info(out + 20, slot, info.connected, info.mac);
+                finish_packet(out, sizeof(out), serverId, DSU_MSG_PORTS);
+                SendTo(out, sizeof(out), addr, port);
+            }
+            break;
+        }
+        case DSU_MSG_PAD_DATA:
+            Subscribe(addr, port, buf, size_t(n));
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+// Cemuhook DSU server: streams each controller's buttons, sticks and full-resolution motion to
+// emulators (Cemu, Yuzu/Ryujinx forks, Dolphin) over UDP on localhost, one packet per BLE
+// notification. Publish builds the packet on the stack and sends it from the calling thread.
+#include "DS4Report.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+constexpr uint16_t DSU_PROTOCOL_VERSION = 1001;
+constexpr uint32_t DSU_MSG_VERSION = 0x100000;
+constexpr uint32_t DSU_MSG_PORTS = 0x100001;
+constexpr uint32_t DSU_MSG_PAD_DATA = 0x100002;
+
+// Packet sizes including the 16-byte header
+constexpr size_t DSU_HEADER_SIZE = 16;
+constexpr size_t DSU_VERSION_SIZE = 22;
+constexpr size_t DSU_PORT_INFO_SIZE = 32;
+constexpr size_t DSU_PAD_DATA_SIZE = 100;
+
+// zlib CRC-32, as the protocol computes it over the whole packet with the CRC field zeroed
+uint32_t DsuCrc32(const uint8_t* data, size_t length);
+// Magic, protocol version, length and CRC of a received packet; magic is "DSUS" or "DSUC"
+bool DsuPacketValid(const uint8_t* data, size_t length, const char* magic);
+
+// One motion sample in DS4 axes (see ImuNormalization.h), unquantized
+struct DsuMotion {
+    uint64_t timestampUs = 0;
+    float accelG[3] = {};
+    float gyroDps[3] = {};   // pitch (X), yaw (Y), roll (Z)
+};
+
+class DsuServer {
+public:
+    static constexpr int SLOTS = 4;
+    static constexpr int MAX_CLIENTS = 16;
+    static constexpr uint16_t DEFAULT_PORT = 26760;
+    static constexpr int64_t CLIENT_TIMEOUT_US = 5000000;   // clients re-request about once a second
+
+    DsuServer() = default;
+    ~DsuServer() { Stop(); }
+    DsuServer(const DsuServer&) = delete;
+    DsuServer& operator=(const DsuServer&) = delete;
+
+    // Binds 127.0.0.1:port (0 picks a free port) and starts answering requests
+    bool Start(uint16_t port = DEFAULT_PORT);
+    void Stop();
+    bool Running() const { return running.load(std::memory_order_acquire); }
+    uint16_t Port() const { return boundPort; }
+
+    // A controller takes a slot for its lifetime; -1 when all are taken. mac is the 48-bit
+    // Bluetooth address clients use to tell controllers apart
+    int AcquireSlot(uint64_t mac);
+    void ReleaseSlot(int slot);
+
+    // From a BLE callback: one pad-data packet to every client subscribed to the slot
+    void Publish(int slot, const DS4_REPORT_EX& report, const DsuMotion& motion);
+
+    int ClientCount() const;
+    uint32_t PacketCount(int slot) const { return packetCounters[slot & (SLOTS - 1)].load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        bool connected = false;
+        uint8_t mac[6] = {};
+    };
+    struct Client {
+        uint32_t addr = 0;        // IPv4, network order
+        uint16_t port = 0;        // network order
+        uint8_t slotMask = 0;     // subscribed slots
+        int64_t lastRequestUs = 0;
+    };
+
+    void ReceiveLoop();
+    void Subscribe(uint32_t addr, uint16_t port, const uint8_t* request, size_t length);
+    void SendTo(const uint8_t* data, size_t length, uint32_t addr, uint16_t port);
+
+    intptr_t sock = -1;
+    uint16_t boundPort = 0;
+    uint32_t serverId = 0;
+    std::atomic<bool> running{ false };
+    std::thread receiver;
+
+    std::shared_mutex socketMutex;   // shared by senders, exclusive while closing
+    mutable std::mutex mutex;        // slots and clients; never held while sending
+    Slot slots[SLOTS];
+    Client clients[MAX_CLIENTS];
+    std::atomic<uint32_t> packetCounters[SLOTS] = {};
+};
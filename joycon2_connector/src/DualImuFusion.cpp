@@ -0,0 +1,124 @@
+#include "DualImuFusion.h"
+#include <algorithm>
+#include <cmath>
+
+// Noise floor (counts^2) keeps the weights finite and equal until noise is measured
+constexpr float NOISE_FLOOR = 4.0f;
+constexpr float NOISE_SMOOTHING = 32.0f;   // EMA over ~32 samples
+// The second difference of white noise has 6x its variance; smooth motion mostly cancels out
+constexpr float SECOND_DIFF_GAIN = 6.0f;
+
+DualImuFusion::DualImuFusion(ImuMount left, ImuMount right) {
+    streams[0].mount = left;
+    streams[1].mount = right;
+    Reset();
+}
+
+void DualImuFusion::Reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Stream& s : streams) {
+        s.count = 0;
+        s.noise = NOISE_FLOOR;
+    }
+}
+
+void DualImuFusion::Push(int side, int64_t arrivalUs, const MotionData& m) {
+    const SHORT raw[6] = { m.gyroX, m.gyroY, m.gyroZ, m.accelX, m.accelY, m.accelZ };
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Stream& s = streams[side & 1];
+    Entry e;
+    e.us = arrivalUs;
+    for (int k = 0; k < 3; ++k) {
+        e.v[k] = float(s.mount.sign[k] * raw[s.mount.axis[k]]);
+        e.v[3 + k] = float(s.mount.sign[k] * raw[3 + s.mount.axis[k]]);
+    }
+
+    if (s.count > 0) {
+        const Entry* p1 = &Newest(s, 0);
+        // Interpolation needs strictly increasing times
+        if (e.us <= p1->us) e.us = p1->us + 1;
+        if (s.count > 1) {
+            const Entry* p2 = &Newest(s, 1);
+            float sq = 0.0f;
+            for (int k = 0; k < 3; ++k) {
+                float d = e.v[k] - 2.0f * p1->v[k] + p2->v[k];
+                sq += d * d;
+            }
+            s.noise += (sq / (3.0f * SECOND_DIFF_GAIN) - s.noise) / NOISE_SMOOTHING;
+        }
+    }
+
+    s.history[s.count % HISTORY] = e;
+    // Wraps within a multiple of HISTORY so the ring position is preserved
+    if (++s.count == 2 * HISTORY) s.count = HISTORY;
+}
+
+// Linear interpolation between the two samples around `us`; clamps to the oldest/newest sample
+void DualImuFusion::At(const Stream& s, int64_t us, float* v) {
+    uint32_t n = std::min<uint32_t>(s.count, HISTORY);
+    const Entry* newer = &Newest(s, 0);
+    for (uint32_t i = 1; i < n && newer->us > us; ++i) {
+        const Entry* older = &Newest(s, i);
+        if (older->us <= us) {
+            float t = float(us - older->us) / float(newer->us - older->us);
+            for (int k = 0; k < 6; ++k) v[k] = older->v[k] + (newer->v[k] - older->v[k]) * t;
+            return;
+        }
+        newer = older;
+    }
+    std::copy(newer->v, newer->v + 6, v);
+}
+
+// Inverse-variance weighting
+float DualImuFusion::WeightLocked(int side) const {
+    float inv0 = 1.0f / (streams[0].noise + NOISE_FLOOR);
+    float inv1 = 1.0f / (streams[1].noise + NOISE_FLOOR);
+    return ((side & 1) ? inv1 : inv0) / (inv0 + inv1);
+}
+
+float DualImuFusion::Weight(int side) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return WeightLocked(side);
+}
+
+static SHORT to_counts(float v) {
+    return static_cast<SHORT>(std::clamp(std::lround(v), -32768L, 32767L));
+}
+
+bool DualImuFusion::Sample(MotionData& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool live[2] = { streams[0].count > 0, streams[1].count > 0 };
+    if (!live[0] && !live[1]) return false;
+
+    int64_t newest[2] = {};
+    for (int i = 0; i < 2; ++i)
+        if (live[i]) newest[i] = Newest(streams[i], 0).us;
+    if (live[0] && live[1]) {
+        if (newest[0] + STALE_US < newest[1]) live[0] = false;
+        else if (newest[1] + STALE_US < newest[0]) live[1] = false;
+    }
+
+    float v[6];
+    if (live[0] && live[1]) {
+        // The newest instant both streams have seen: interpolating there never extrapolates
+        int64_t us = (std::min)(newest[0], newest[1]);
+        float left[6], right[6];
+        At(streams[0], us, left);
+        At(streams[1], us, right);
+        float w = WeightLocked(0);
+        for (int k = 0; k < 6; ++k) v[k] = left[k] * w + right[k] * (1.0f - w);
+    } else {
+        const Stream& s = streams[live[0] ? 0 : 1];
+        const Entry* e = &Newest(s, 0);
+        std::copy(e->v, e->v + 6, v);
+    }
+
+    out.gyroX = to_counts(v[0]);
+    out.gyroY = to_counts(v[1]);
+    out.gyroZ = to_counts(v[2]);
+    out.accelX = to_counts(v[3]);
+    out.accelY = to_counts(v[4]);
+    out.accelZ = to_counts(v[5]);
+    return true;
+}
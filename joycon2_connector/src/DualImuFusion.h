@@ -0,0 +1,55 @@
+#pragma once
+// Dual Joy-Con IMU fusion (GyroSource::Both): both BLE callbacks push their bias-corrected
+// samples with arrival times; the merge thread reads one body-frame sample interpolated to the
+// newest instant both streams cover, with each side weighted by its measured noise.
+#include "JoyConDecoder.h"
+#include <cstdint>
+#include <mutex>
+
+// Axis remap from a Joy-Con's IMU frame to the shared body frame:
+// body[k] = sign[k] * sensor[axis[k]]
+struct ImuMount {
+    int8_t axis[3];
+    int8_t sign[3];
+};
+
+// The left and right raw IMU frames share the Switch axis convention, so the body frame is
+// either side's own; a mirrored mount is a change to one of these
+constexpr ImuMount JOYCON_LEFT_IMU_MOUNT{ { 0, 1, 2 }, { 1, 1, 1 } };
+constexpr ImuMount JOYCON_RIGHT_IMU_MOUNT{ { 0, 1, 2 }, { 1, 1, 1 } };
+
+class DualImuFusion {
+public:
+    static constexpr int HISTORY = 8;                 // samples kept per side for interpolation
+    static constexpr int64_t STALE_US = 100000;       // a side this far behind is treated as gone
+
+    explicit DualImuFusion(ImuMount left = JOYCON_LEFT_IMU_MOUNT, ImuMount right = JOYCON_RIGHT_IMU_MOUNT);
+
+    // From a BLE callback; side 0 = left, 1 = right
+    void Push(int side, int64_t arrivalUs, const MotionData& motion);
+    // From the merge thread; false until any side has reported
+    bool Sample(MotionData& out);
+    // Current share of a side in the fused gyro (0..1)
+    float Weight(int side) const;
+    void Reset();
+
+private:
+    struct Entry {
+        int64_t us;
+        float v[6];   // gyro x/y/z, accel x/y/z in body frame
+    };
+    struct Stream {
+        ImuMount mount;
+        Entry history[HISTORY];
+        uint32_t count = 0;
+        float noise = 0.0f;   // gyro noise variance estimate, counts^2
+    };
+
+    // i = 0 is the newest sample; requires i < min(count, HISTORY)
+    static const Entry& Newest(const Stream& s, uint32_t i) { return s.history[(s.count - 1 - i) % HISTORY]; }
+    static void At(const Stream& s, int64_t us, float* v);
+    float WeightLocked(int side) const;
+
+    Stream streams[2];
+    mutable std::mutex mutex;
+};
@@ -0,0 +1,64 @@
+#include "DualMerge.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Longer gaps are idle stretches, not the notification interval
+constexpr int64_t IDLE_GAP_US = 100000;
+
+const char* DualMergePolicyToString(DualMergePolicy policy) {
+    switch (policy) {
+    case DualMergePolicy::NearestArrival: return "nearest";
+    case DualMergePolicy::WaitForBoth:    return "both";
+    default: return "any";
+    }
+}
+
+DualMergePolicy StringToDualMergePolicy(const std::string& str) {
+    if (str == "nearest") return DualMergePolicy::NearestArrival;
+    if (str == "both") return DualMergePolicy::WaitForBoth;
+    return DualMergePolicy::AnyChange;
+}
+
+void DualFramePairer::Arrive(int side, int64_t arrivalUs) {
+    Side& s = sides[side];
+    int64_t gap = arrivalUs - s.arrivalUs;
+    if (s.arrivalUs && gap > 0 && gap < IDLE_GAP_US)
+        s.periodUs = s.periodUs > 0.0 ? s.periodUs + (gap - s.periodUs) / 8.0 : static_cast<double>(gap);
+    s.arrivalUs = arrivalUs;
+    if (!s.firstFreshUs) s.firstFreshUs = arrivalUs;
+}
+
+int64_t DualFramePairer::WaitEndUs(const Side& fresh, const Side& other) const {
+    int64_t deadline = fresh.firstFreshUs + deadlineUs;
+    if (policy == DualMergePolicy::WaitForBoth) return deadline;
+    // NearestArrival: the other side's held frame is `held` older than the new one. Its next
+    // frame is worth waiting for only if it is due sooner than that after the new one, and only
+    // until it could no longer land closer than the held frame.
+    int64_t held = fresh.arrivalUs - other.arrivalUs;
+    if (held <= 0 || other.periodUs <= 0.0) return 0;
+    int64_t due = other.arrivalUs + static_cast<int64_t>(other.periodUs);
+    if (due - fresh.arrivalUs >= held) return 0;
+    return (std::min)(deadline, fresh.arrivalUs + held);
+}
+
+bool DualFramePairer::Ready(int64_t nowUs, int64_t& wakeAtUs) const {
+    wakeAtUs = 0;
+    bool leftFresh = sides[0].firstFreshUs != 0, rightFresh = sides[1].firstFreshUs != 0;
+    if (!leftFresh && !rightFresh) return false;
+    if (!sides[0].arrivalUs || !sides[1].arrivalUs) return false;   // no pair yet
+    if ((leftFresh && rightFresh) || policy == DualMergePolicy::AnyChange) return true;
+    int64_t end = leftFresh ? WaitEndUs(sides[0], sides[1]) : WaitEndUs(sides[1], sides[0]);
+    if (nowUs >= end) return true;
+    wakeAtUs = end;
+    return false;
+}
+
+void DualFramePairer::Emitted(int64_t nowUs, LatencyHistogram& skew) {
+    bool leftFresh = sides[0].firstFreshUs != 0, rightFresh = sides[1].firstFreshUs != 0;
+    if (leftFresh != rightFresh && policy != DualMergePolicy::AnyChange) {
+        const Side& fresh = leftFresh ? sides[0] : sides[1];
+        if (nowUs - fresh.firstFreshUs >= deadlineUs) ++expired;
+    }
+    skew.Record(std::llabs(sides[0].arrivalUs - sides[1].arrivalUs));
+    sides[0].firstFreshUs = sides[1].firstFreshUs = 0;
+}
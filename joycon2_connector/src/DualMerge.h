@@ -0,0 +1,53 @@
+#pragma once
+// When the dual Joy-Con merge thread emits a report. The two halves notify independently, so a
+// report built the moment one side changes combines a fresh frame with one up to a notification
+// period old. The pairer trades a little latency for halves sampled closer together; the report
+// always uses each side's newest frame, only its timing changes. Used by the merge thread only.
+#include "LatencyHistogram.h"
+#include <cstdint>
+#include <string>
+
+enum class DualMergePolicy {
+    AnyChange,        // emit as soon as either side has a new frame
+    NearestArrival,   // hold a new frame while the other side's next one is due closer to it
+    WaitForBoth       // emit once both sides have a new frame, or when the deadline passes
+};
+
+const char* DualMergePolicyToString(DualMergePolicy policy);
+DualMergePolicy StringToDualMergePolicy(const std::string& str);
+
+constexpr int64_t DUAL_MERGE_DEFAULT_DEADLINE_US = 4000;
+
+class DualFramePairer {
+public:
+    DualFramePairer(DualMergePolicy policy, int64_t deadlineUs) : policy(policy), deadlineUs(deadlineUs) {}
+
+    // A new frame from side 0 (left) or 1 (right), stamped at its arrival
+    void Arrive(int side, int64_t arrivalUs);
+
+    // Whether to emit now. If not, wakeAtUs is when to ask again without new data (0 = only
+    // when a frame arrives).
+    bool Ready(int64_t nowUs, int64_t& wakeAtUs) const;
+
+    // The report was emitted: records the skew between the halves into skew
+    void Emitted(int64_t nowUs, LatencyHistogram& skew);
+
+    DualMergePolicy Policy() const { return policy; }
+    // Reports emitted with only one side new because the wait ran out
+    uint64_t Expired() const { return expired; }
+
+private:
+    struct Side {
+        int64_t arrivalUs = 0;      // newest frame
+        int64_t firstFreshUs = 0;   // oldest frame not yet emitted; 0 = nothing new
+        double periodUs = 0.0;      // smoothed notification interval
+    };
+
+    // When the held side's wait ends under the current policy (fresh is the only new side)
+    int64_t WaitEndUs(const Side& fresh, const Side& other) const;
+
+    const DualMergePolicy policy;
+    const int64_t deadlineUs;
+    Side sides[2];
+    uint64_t expired = 0;
+};
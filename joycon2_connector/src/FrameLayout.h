@@ -0,0 +1,91 @@
+#pragma once
+// Where each field sits in an input notification, per controller family and firmware revision.
+// The frame decoder is instantiated once per distinct layout (see SelectFrameDecoder), so the
+// offsets below become immediates in the per-frame path.
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+enum class ControllerFamily { JoyCon2, ProController2, NSOGC };
+
+struct FrameLayout {
+    uint8_t buttons = 3;           // 6-byte big-endian button state
+    uint8_t leftStick = 10;        // 12-bit X/Y packed into 3 bytes
+    uint8_t rightStick = 13;
+    uint8_t optical = 0x10;        // optical X, Y (int16 LE)
+    uint8_t motion = 0x30;         // accel X/Y/Z then gyro X/Y/Z (int16 LE)
+    uint8_t triggers = 0x3C;       // analog L, R (NSO GC)
+    uint8_t minStickLength = 16;   // shorter payloads keep centered sticks
+};
+
+struct FrameLayoutEntry {
+    ControllerFamily family;
+    uint32_t minFirmware;          // first firmware revision with this layout (0 = any)
+    const char* name;
+    FrameLayout layout;
+};
+
+// Ordered by family, then firmware. Every family seen so far uses the layout documented in the
+// README; a controller variant or firmware that moves a field only needs a row here.
+inline constexpr FrameLayoutEntry FRAME_LAYOUTS[] = {
+    { ControllerFamily::JoyCon2,        0, "joycon2", {} },
+    { ControllerFamily::ProController2, 0, "pro2",    {} },
+    { ControllerFamily::NSOGC,          0, "nsogc",   {} },
+};
+inline constexpr size_t FRAME_LAYOUT_COUNT = std::size(FRAME_LAYOUTS);
+
+// Index of the newest layout of family that firmware is at least as new as
+constexpr size_t FindFrameLayoutIndex(ControllerFamily family, uint32_t firmware = 0) {
+    size_t found = 0;
+    for (size_t i = 0; i < FRAME_LAYOUT_COUNT; ++i) {
+        if (FRAME_LAYOUTS[i].family == family && FRAME_LAYOUTS[i].minFirmware <= firmware) found = i;
+    }
+    return found;
+}
+
+constexpr const FrameLayout& FindFrameLayout(ControllerFamily family, uint32_t firmware = 0) {
+    return FRAME_LAYOUTS[FindFrameLayoutIndex(family, firmware)].layout;
+}
+
+// Button bits of the 24-bit single Joy-Con word (JoyConInputFrame::JoyConButtons)
+constexpr uint32_t BUTTON_A_MASK_RIGHT = 0x000800;
+constexpr uint32_t BUTTON_B_MASK_RIGHT = 0x000200;
+constexpr uint32_t BUTTON_X_MASK_RIGHT = 0x000400;
+constexpr uint32_t BUTTON_Y_MASK_RIGHT = 0x000100;
+constexpr uint32_t BUTTON_PLUS_MASK_RIGHT = 0x000002;
+constexpr uint32_t BUTTON_R_MASK_RIGHT = 0x004000;
+constexpr uint32_t BUTTON_STICK_MASK_RIGHT = 0x000004;
+constexpr uint32_t BUTTON_ZR_MASK_RIGHT = 0x008000;
+constexpr uint32_t BUTTON_CHAT_MASK_RIGHT = 0x000040;
+
+constexpr uint32_t BUTTON_UP_MASK_LEFT = 0x000002;
+constexpr uint32_t BUTTON_DOWN_MASK_LEFT = 0x000001;
+constexpr uint32_t BUTTON_LEFT_MASK_LEFT = 0x000008;
+constexpr uint32_t BUTTON_RIGHT_MASK_LEFT = 0x000004;
+constexpr uint32_t BUTTON_MINUS_MASK_LEFT = 0x000100;
+constexpr uint32_t BUTTON_L_MASK_LEFT = 0x000040;
+constexpr uint32_t BUTTON_STICK_MASK_LEFT = 0x000800;
+
+// Button bits of the full 48-bit state (Pro Controller 2 / NSO GC)
+constexpr uint64_t BUTTON_A_MASK = 0x000800000000;
+constexpr uint64_t BUTTON_B_MASK = 0x000400000000;
+constexpr uint64_t BUTTON_X_MASK = 0x000200000000;
+constexpr uint64_t BUTTON_Y_MASK = 0x000100000000;
+constexpr uint64_t BUTTON_R_SHOULDER = 0x004000000000;
+constexpr uint64_t BUTTON_L_SHOULDER = 0x000000400000;
+constexpr uint64_t BUTTON_DPAD_UP = 0x000000020000;
+constexpr uint64_t BUTTON_DPAD_RIGHT = 0x000000040000;
+constexpr uint64_t BUTTON_DPAD_DOWN = 0x000000010000;
+constexpr uint64_t BUTTON_DPAD_LEFT = 0x000000080000;
+constexpr uint64_t BUTTON_GUIDE = 0x000010000000;
+constexpr uint64_t BUTTON_BACK = 0x000001000000;
+constexpr uint64_t BUTTON_START = 0x000002000000;
+constexpr uint64_t BUTTON_R_THUMB = 0x000004000000;
+constexpr uint64_t BUTTON_L_THUMB = 0x000008000000;
+
+constexpr uint64_t TRIGGER_LT_MASK = 0x000000800000;
+constexpr uint64_t TRIGGER_RT_MASK = 0x008000000000;
+constexpr uint64_t BUTTON_GR_MASK = 0x000000000100;
+constexpr uint64_t BUTTON_GL_MASK = 0x000000000200;
+constexpr uint64_t BUTTON_SCREENSHOT_MASK = 0x000000000400;
+constexpr uint64_t BUTTON_C_MASK = 0x000000000800;
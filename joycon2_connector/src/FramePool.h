@@ -0,0 +1,221 @@
+#pragma once
+// FramePool - Lock-free pool of fixed 64-byte frame slots with reference-counted handles.
+// A producer takes a slot, fills it and hands the FrameRef on; every holder (merge thread,
+// touchpad, capture, telemetry) shares the same slot, and the last one to let go returns it
+// to the pool. Slots are allocated with the pool, so steady-state handoff never touches the heap.
+//
+// FrameMailbox passes the newest frame from one producer to one consumer: publishing replaces
+// a frame the consumer has not taken yet, and taking empties the mailbox, so "new data" is
+// simply a non-empty mailbox. Publish and Take are a single atomic exchange each (wait-free).
+//
+// FrameSignal wakes the consumer of one or more mailboxes only when something was published,
+// and remembers when the first unclaimed publish happened so the consumer can time its handoff.
+// Timed waits fall back to a condition variable that producers touch only while one is pending.
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+constexpr size_t FRAME_SLOT_SIZE = 64;
+
+template <class T, uint32_t Capacity>
+class FramePool;
+
+template <class T, uint32_t Capacity>
+class FrameRef {
+public:
+    FrameRef() = default;
+    FrameRef(const FrameRef& o) : pool(o.pool), index(o.index) {
+        if (pool) pool->AddRef(index);
+    }
+    FrameRef(FrameRef&& o) noexcept : pool(std::exchange(o.pool, nullptr)), index(o.index) {}
+    FrameRef& operator=(FrameRef o) noexcept {
+        std::swap(pool, o.pool);
+        std::swap(index, o.index);
+        return *this;
+    }
+    ~FrameRef() { Reset(); }
+
+    void Reset() {
+        if (pool) std::exchange(pool, nullptr)->Release(index);
+    }
+
+    explicit operator bool() const { return pool != nullptr; }
+    // Written by the producer before the frame is shared; read-only afterwards
+    T& operator*() const { return pool->At(index); }
+    T* operator->() const { return &pool->At(index); }
+    bool operator==(const FrameRef& o) const { return pool == o.pool && (!pool || index == o.index); }
+
+private:
+    friend class FramePool<T, Capacity>;
+    template <class, uint32_t> friend class FrameMailbox;
+    FrameRef(FramePool<T, Capacity>* pool, uint32_t index) : pool(pool), index(index) {}
+    uint32_t Detach() {
+        pool = nullptr;
+        return index;
+    }
+
+    FramePool<T, Capacity>* pool = nullptr;
+    uint32_t index = 0;
+};
+
+template <class T, uint32_t Capacity>
+class FramePool {
+    static_assert(sizeof(T) <= FRAME_SLOT_SIZE, "frame does not fit a slot");
+    static_assert(std::is_trivially_copyable_v<T>, "slots are reused without construction");
+    static_assert(Capacity > 0 && Capacity < UINT32_MAX, "bad pool capacity");
+
+public:
+    using Ref = FrameRef<T, Capacity>;
+
+    FramePool() {
+        for (uint32_t i = 0; i < Capacity; ++i) next[i].store(i + 1, std::memory_order_relaxed);
+        head.store(0, std::memory_order_relaxed);   // tag 0, first slot
+    }
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // An empty Ref when every slot is held; counted in Exhausted()
+    Ref Acquire() {
+        uint64_t h = head.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t index = static_cast<uint32_t>(h);
+            if (index == NONE) {
+                exhausted.fetch_add(1, std::memory_order_relaxed);
+                return Ref();
+            }
+            // The tag in the high half makes a pop/push/pop of the same slot fail the CAS
+            uint64_t replacement = Tagged(h, next[index].load(std::memory_order_relaxed));
+            if (head.compare_exchange_weak(h, replacement, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                refs[index].store(1, std::memory_order_relaxed);
+                acquired.fetch_add(1, std::memory_order_relaxed);
+                return Ref(this, index);
+            }
+        }
+    }
+
+    uint32_t InUse() const {
+        return static_cast<uint32_t>(acquired.load(std::memory_order_relaxed) - returned.load(std::memory_order_relaxed));
+    }
+    uint64_t Acquired() const { return acquired.load(std::memory_order_relaxed); }
+    // Acquires that found no free slot (the frame was dropped)
+    uint64_t Exhausted() const { return exhausted.load(std::memory_order_relaxed); }
+
+private:
+    friend class FrameRef<T, Capacity>;
+    static constexpr uint32_t NONE = Capacity;
+
+    static uint64_t Tagged(uint64_t previous, uint32_t index) {
+        return (((previous >> 32) + 1) << 32) | index;
+    }
+
+    T& At(uint32_t index) { return slots[index].value; }
+    void AddRef(uint32_t index) { refs[index].fetch_add(1, std::memory_order_relaxed); }
+    void Release(uint32_t index) {
+        if (refs[index].fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        returned.fetch_add(1, std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_relaxed);
+        do {
+            next[index].store(static_cast<uint32_t>(h), std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(h, Tagged(h, index), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    struct alignas(FRAME_SLOT_SIZE) Slot {
+        T value;
+    };
+    static_assert(sizeof(Slot) == FRAME_SLOT_SIZE, "slots are one cache line");
+
+    Slot slots[Capacity];
+    std::atomic<uint32_t> refs[Capacity] = {};
+    std::atomic<uint32_t> next[Capacity];          // free-list links
+    alignas(64) std::atomic<uint64_t> head{ 0 };   // tag << 32 | first free slot
+    alignas(64) std::atomic<uint64_t> acquired{ 0 };
+    std::atomic<uint64_t> returned{ 0 };
+    std::atomic<uint64_t> exhausted{ 0 };
+};
+
+template <class T, uint32_t Capacity>
+class FrameMailbox {
+public:
+    using Ref = FrameRef<T, Capacity>;
+
+    explicit FrameMailbox(FramePool<T, Capacity>& pool) : pool(pool) {}
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+    ~FrameMailbox() { Take(); }
+
+    // Producer. Returns true if it replaced a frame the consumer never took.
+    bool Publish(Ref frame) {
+        if (!frame) return false;
+        uint32_t old = slot.exchange(frame.Detach(), std::memory_order_acq_rel);
+        if (old == EMPTY) return false;
+        Ref(&pool, old).Reset();
+        replaced.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer: the newest frame since the last Take, or an empty Ref
+    Ref Take() {
+        uint32_t index = slot.exchange(EMPTY, std::memory_order_acq_rel);
+        return index == EMPTY ? Ref() : Ref(&pool, index);
+    }
+
+    bool HasNew() const { return slot.load(std::memory_order_acquire) != EMPTY; }
+    // Frames published over before the consumer took them
+    uint64_t Replaced() const { return replaced.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    FramePool<T, Capacity>& pool;
+    alignas(64) std::atomic<uint32_t> slot{ EMPTY };
+    std::atomic<uint64_t> replaced{ 0 };
+};
+
+class FrameSignal {
+public:
+    // Producer, after Publish: nowUs stamps the wake unless an earlier one is still unclaimed
+    void Notify(int64_t nowUs) {
+        int64_t none = 0;
+        notifiedUs.compare_exchange_strong(none, nowUs, std::memory_order_relaxed);
+        generation.fetch_add(1);   // seq_cst: either WaitUntil sees it or this sees the waiter
+        generation.notify_one();
+        if (timedWaiters.load()) {
+            std::lock_guard<std::mutex> lock(timedMutex);
+            timedCV.notify_one();
+        }
+    }
+    // Any thread: releases the consumer without data (used to stop it)
+    void Wake() {
+        generation.fetch_add(1);
+        generation.notify_all();
+        std::lock_guard<std::mutex> lock(timedMutex);
+        timedCV.notify_all();
+    }
+
+    // Consumer: read Generation before taking from the mailboxes, and Wait on it only if they
+    // were all empty; a Notify in between changes it, so no publish is slept through.
+    uint32_t Generation() const { return generation.load(std::memory_order_acquire); }
+    void Wait(uint32_t observed) const { generation.wait(observed, std::memory_order_acquire); }
+    // Wait, giving up at deadline
+    void WaitUntil(uint32_t observed, std::chrono::steady_clock::time_point deadline) {
+        timedWaiters.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(timedMutex);
+            timedCV.wait_until(lock, deadline, [&] { return generation.load() != observed; });
+        }
+        timedWaiters.fetch_sub(1);
+    }
+    // Consumer, after taking: stamp of the earliest Notify not yet claimed, or 0
+    int64_t Claim() { return notifiedUs.exchange(0, std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<uint32_t> generation{ 0 };
+    std::atomic<int64_t> notifiedUs{ 0 };
+    std::atomic<uint32_t> timedWaiters{ 0 };
+    std::mutex timedMutex;
+    std::condition_variable timedCV;
+};
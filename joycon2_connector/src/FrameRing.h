@@ -0,0 +1,107 @@
+#pragma once
+// FrameRing - Lock-free single-producer/single-consumer ring of raw BLE notifications.
+// The WinRT callback only copies the notification into a preallocated 64-byte slot; the
+// player's processing thread drains the ring and does the decoding and all output, so a slow
+// consumer never stalls radio delivery.
+#include "JoyConDecoder.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+enum class FrameRingMode {
+    Queue,        // every frame is processed in order
+    LatestOnly    // the consumer jumps to the newest frame; older queued ones are skipped
+};
+
+class FrameRing {
+public:
+    static constexpr uint32_t CAPACITY = 64;   // power of two
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+    explicit FrameRing(FrameRingMode mode = FrameRingMode::Queue) : mode(mode) {}
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    // Producer. Zero-pads the slot past length (the decoders rely on it). A full ring drops the
+    // new frame and counts an overrun.
+    bool Push(const uint8_t* data, size_t length, int64_t arrivalUs) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tailCache == CAPACITY) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h - tailCache == CAPACITY) {
+                overruns.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        Slot& s = slots[h & (CAPACITY - 1)];
+        size_t n = (std::min)(length, JOYCON_FRAME_SIZE);
+        std::memcpy(s.data, data, n);
+        std::memset(s.data + n, 0, JOYCON_FRAME_SIZE - n);
+        meta[h & (CAPACITY - 1)] = { arrivalUs, static_cast<uint32_t>(n) };
+        head.store(h + 1, std::memory_order_release);
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_one();
+        return true;
+    }
+
+    // Consumer: calls process(JoyConFrameView, length, arrivalUs) for each queued frame (only
+    // the newest in LatestOnly mode) straight from its slot. Returns the frames processed.
+    template <class Process>
+    uint32_t Drain(Process&& process) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t h = head.load(std::memory_order_acquire);
+        if (h == t) return 0;
+        if (mode == FrameRingMode::LatestOnly && h - t > 1) {
+            skipped.fetch_add(h - t - 1, std::memory_order_relaxed);
+            t = h - 1;
+        }
+        uint32_t count = h - t;
+        for (; t != h; ++t) {
+            const Meta& m = meta[t & (CAPACITY - 1)];
+            process(JoyConFrameView(slots[t & (CAPACITY - 1)].data, JOYCON_FRAME_SIZE), m.length, m.arrivalUs);
+        }
+        tail.store(h, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: blocks until a frame is queued or Wake is called
+    void Wait() {
+        uint32_t observed = signal.load(std::memory_order_acquire);
+        if (head.load(std::memory_order_acquire) != tail.load(std::memory_order_relaxed)) return;
+        signal.wait(observed, std::memory_order_acquire);
+    }
+    // Any thread: releases a blocked Wait (used to stop the consumer)
+    void Wake() {
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_all();
+    }
+
+    uint32_t Size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    FrameRingMode Mode() const { return mode; }
+    // Frames dropped because the ring was full
+    uint64_t Overruns() const { return overruns.load(std::memory_order_relaxed); }
+    // Frames skipped by LatestOnly draining
+    uint64_t Skipped() const { return skipped.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot {
+        uint8_t data[JOYCON_FRAME_SIZE];
+    };
+    struct Meta {
+        int64_t arrivalUs;
+        uint32_t length;
+    };
+
+    Slot slots[CAPACITY];
+    Meta meta[CAPACITY] = {};
+    const FrameRingMode mode;
+
+    // Producer and consumer indices on their own cache lines; the producer caches the tail
+    alignas(64) std::atomic<uint32_t> head{ 0 };
+    uint32_t tailCache = 0;                        // producer only
+    alignas(64) std::atomic<uint32_t> tail{ 0 };
+    alignas(64) std::atomic<uint32_t> signal{ 0 };
+    std::atomic<uint64_t> overruns{ 0 };
+    std::atomic<uint64_t> skipped{ 0 };
+};
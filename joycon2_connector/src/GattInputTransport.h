@@ -0,0 +1,51 @@
+#pragma once
+// GattInputTransport - IInputTransport over the WinRT GATT characteristics found by the scan
+#include "CaptureFile.h"
+#include "DeviceManager.h"
+#include "InputTransport.h"
+#include "SensorClock.h"
+#include <chrono>
+
+class GattInputTransport : public IInputTransport {
+public:
+    GattInputTransport(ConnectedJoyCon cj, ControllerFamily family) : cj(std::move(cj)), family(family) {}
+    ~GattInputTransport() override { Unsubscribe(); }
+
+    ControllerFamily Family() const override { return family; }
+    uint64_t Address() const override { return cj.device ? cj.device.BluetoothAddress() : 0; }
+
+    bool Subscribe(NotificationHandler handler) override {
+        Unsubscribe();
+        if (!cj.inputChar) return false;
+        token = cj.inputChar.ValueChanged([handler = std::move(handler)](GattCharacteristic const&, GattValueChangedEventArgs const& args) {
+            int64_t arrivalUs = SteadyMicros(std::chrono::steady_clock::now());
+            IBuffer value = args.CharacteristicValue();
+            handler(value.data(), value.Length(), arrivalUs);
+        });
+        subscribed = true;
+        auto status = cj.inputChar.WriteClientCharacteristicConfigurationDescriptorAsync(
+            GattClientCharacteristicConfigurationDescriptorValue::Notify).get();
+        return status == GattCommunicationStatus::Success;
+    }
+
+    void Unsubscribe() override {
+        if (!subscribed) return;
+        cj.inputChar.ValueChanged(token);
+        subscribed = false;
+    }
+
+    bool Write(const uint8_t* data, size_t length) override {
+        if (!cj.writeChar) return false;
+        DataWriter writer;
+        writer.WriteBytes(array_view<const uint8_t>(data, data + length));
+        CaptureSession::Instance().CommandWrite(Address(), data, length, SteadyMicros(std::chrono::steady_clock::now()));
+        auto status = cj.writeChar.WriteValueAsync(writer.DetachBuffer(), GattWriteOption::WriteWithoutResponse).get();
+        return status == GattCommunicationStatus::Success;
+    }
+
+private:
+    ConnectedJoyCon cj;
+    ControllerFamily family;
+    event_token token{};
+    bool subscribed = false;
+};
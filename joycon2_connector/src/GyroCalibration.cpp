@@ -0,0 +1,97 @@
+#include "GyroCalibration.h"
+#include "ImuNormalization.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Stillness thresholds: per-axis standard deviation over the window
+constexpr float GYRO_STILL_DPS = 1.0f;
+constexpr float ACCEL_STILL_G = 0.01f;
+// A steady slow turn has no variance either: a window averaging faster than this is motion
+constexpr float MAX_BIAS_DPS = 6.0f;
+
+// The same in raw counts (squared for the variances)
+constexpr int64_t GYRO_STILL_VARIANCE = int64_t(GYRO_STILL_DPS * IMU_GYRO_COUNTS_PER_DPS * GYRO_STILL_DPS * IMU_GYRO_COUNTS_PER_DPS);
+constexpr int64_t ACCEL_STILL_VARIANCE = int64_t(ACCEL_STILL_G * IMU_ACCEL_COUNTS_PER_G * ACCEL_STILL_G * IMU_ACCEL_COUNTS_PER_G);
+constexpr int32_t MAX_BIAS = int32_t(MAX_BIAS_DPS * IMU_GYRO_COUNTS_PER_DPS);
+constexpr int BIAS_SHIFT = 5;   // EMA over ~32 resting samples after the first estimate
+
+GyroCalibration::GyroCalibration(std::string id, const GyroCalibrationRecord* saved)
+    : deviceId(std::move(id)) {
+    published.deviceId = deviceId;
+    if (saved && saved->bias.valid) {
+        published.bias = saved->bias;
+        valid = true;
+        applied[0] = saved->bias.x;
+        applied[1] = saved->bias.y;
+        applied[2] = saved->bias.z;
+        for (int k = 0; k < 3; ++k) biasQ[k] = applied[k] * 256;
+    }
+}
+
+void GyroCalibration::Observe(const MotionData& m) {
+    const int16_t v[6] = { m.gyroX, m.gyroY, m.gyroZ, m.accelX, m.accelY, m.accelZ };
+    int16_t (&slot)[6] = samples[count % WINDOW];
+    for (int k = 0; k < 6; ++k) {
+        if (count >= WINDOW) {
+            sum[k] -= slot[k];
+            sumSq[k] -= int64_t(slot[k]) * slot[k];
+        }
+        slot[k] = v[k];
+        sum[k] += v[k];
+        sumSq[k] += int64_t(v[k]) * v[k];
+    }
+    // Wraps within a multiple of WINDOW so the ring position is preserved
+    if (++count == 2 * WINDOW) count = WINDOW;
+    still = false;
+    if (count < WINDOW) return;
+
+    // WINDOW^2 * variance = WINDOW * sum(x^2) - sum(x)^2, compared without dividing
+    constexpr int64_t N = WINDOW;
+    for (int k = 0; k < 6; ++k) {
+        int64_t limit = (k < 3 ? GYRO_STILL_VARIANCE : ACCEL_STILL_VARIANCE) * N * N;
+        if (N * sumSq[k] - sum[k] * sum[k] > limit) return;
+    }
+    int32_t meanQ[3];
+    for (int k = 0; k < 3; ++k) {
+        meanQ[k] = static_cast<int32_t>(sum[k] * 256 / N);
+        if (std::abs(meanQ[k]) > MAX_BIAS * 256) return;
+    }
+    still = true;
+
+    // The first resting window is taken as is; after that the estimate follows slowly (drift
+    // with temperature) so one odd window cannot throw it off
+    for (int k = 0; k < 3; ++k)
+        biasQ[k] = valid ? biasQ[k] + ((meanQ[k] - biasQ[k]) >> BIAS_SHIFT) : meanQ[k];
+    valid = true;
+
+    int16_t next[3];
+    for (int k = 0; k < 3; ++k) next[k] = static_cast<int16_t>((biasQ[k] + 128) >> 8);
+    if (learned && std::equal(next, next + 3, applied)) return;
+    std::copy(next, next + 3, applied);
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    published.bias = Bias();
+    learned = true;
+}
+
+static SHORT subtract_bias(SHORT v, int16_t bias) {
+    return static_cast<SHORT>(std::clamp(v - bias, -32768, 32767));
+}
+
+void GyroCalibration::Process(MotionData& motion) {
+    Observe(motion);
+    if (!valid) return;
+    motion.gyroX = subtract_bias(motion.gyroX, applied[0]);
+    motion.gyroY = subtract_bias(motion.gyroY, applied[1]);
+    motion.gyroZ = subtract_bias(motion.gyroZ, applied[2]);
+}
+
+GyroCalibrationRecord GyroCalibration::Snapshot() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return published;
+}
+
+bool GyroCalibration::Learned() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return learned;
+}
@@ -0,0 +1,53 @@
+#pragma once
+// Online gyro bias calibration: detects stillness from accelerometer and gyro variance over a
+// sliding window and tracks each axis' zero-rate offset whenever the controller rests. The
+// correction itself is an integer subtract on the report path.
+#include "JoyConDecoder.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Zero-rate offset of one IMU, in raw gyro counts
+struct GyroBias {
+    bool valid = false;
+    int16_t x = 0, y = 0, z = 0;
+};
+
+// Saved bias for one controller (keyed by Bluetooth address)
+struct GyroCalibrationRecord {
+    std::string deviceId;
+    GyroBias bias;
+};
+
+// Calibration for one IMU. Process belongs to the thread that decodes the controller's
+// notifications; Snapshot may be called from any thread.
+class GyroCalibration {
+public:
+    static constexpr int WINDOW = 32;   // samples per stillness decision
+
+    explicit GyroCalibration(std::string deviceId, const GyroCalibrationRecord* saved = nullptr);
+
+    // Learn from one sample, then subtract the current bias from its gyro axes in place
+    void Process(MotionData& motion);
+
+    GyroBias Bias() const { return { valid, applied[0], applied[1], applied[2] }; }
+    bool Still() const { return still; }   // the last full window was at rest
+
+    GyroCalibrationRecord Snapshot() const;
+    bool Learned() const;   // true once a bias was estimated from live data
+
+private:
+    void Observe(const MotionData& motion);
+
+    std::string deviceId;
+    int16_t samples[WINDOW][6] = {};   // gyro x/y/z, accel x/y/z
+    int64_t sum[6] = {}, sumSq[6] = {};
+    uint32_t count = 0;
+    bool still = false;
+    bool valid = false;
+    int32_t biasQ[3] = {};   // Q8 running bias
+    int16_t applied[3] = {};
+    GyroCalibrationRecord published;
+    bool learned = false;
+    mutable std::mutex snapshotMutex;
+};
@@ -0,0 +1,104 @@
+#include "GyroMouse.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr float PI = 3.14159265358979f;
+constexpr float RAD_TO_DEG = 180.0f / PI;
+constexpr float FLICK_RELEASE = 0.8f;   // a flick ends below this share of the threshold
+
+const char* MouseSourceToString(MouseSource source) {
+    switch (source) {
+    case MouseSource::Gyro:      return "gyro";
+    case MouseSource::GyroFlick: return "gyro_flick";
+    default: return "optical";
+    }
+}
+
+MouseSource StringToMouseSource(const std::string& str) {
+    if (str == "gyro") return MouseSource::Gyro;
+    if (str == "gyro_flick") return MouseSource::GyroFlick;
+    return MouseSource::Optical;
+}
+
+const char* GyroSpaceToString(GyroSpace space) {
+    return space == GyroSpace::Local ? "local" : "world";
+}
+
+GyroSpace StringToGyroSpace(const std::string& str) {
+    return str == "local" ? GyroSpace::Local : GyroSpace::World;
+}
+
+// Component of v along the controller axis that row picks (rows are signed unit vectors)
+static float along(const int32_t (&row)[3], const Vec3& v) {
+    auto sign = [](int32_t m) { return float((m > 0) - (m < 0)); };
+    return sign(row[0]) * v.x + sign(row[1]) * v.y + sign(row[2]) * v.z;
+}
+
+AimRate GyroAimRate(const MotionFusion& fusion, GyroSpace space, const ImuTransform& t) {
+    const Vec3& rate = fusion.AngularVelocity();
+    float yaw = along(t.gyro[1], rate);
+    if (space == GyroSpace::World) {
+        const Vec3& up = fusion.Gravity();
+        yaw = rate.x * up.x + rate.y * up.y + rate.z * up.z;
+    }
+    return { yaw * RAD_TO_DEG, along(t.gyro[0], rate) * RAD_TO_DEG };
+}
+
+float GyroSensitivity(const GyroMouseSettings& s, float speedDps) {
+    if (s.maxThresholdDps <= s.minThresholdDps) return speedDps < s.minThresholdDps ? s.minSens : s.maxSens;
+    float t = std::clamp((speedDps - s.minThresholdDps) / (s.maxThresholdDps - s.minThresholdDps), 0.0f, 1.0f);
+    return s.minSens + (s.maxSens - s.minSens) * t;
+}
+
+MouseDelta GyroMouseDelta(const MotionFusion& fusion, const ImuTransform& transform,
+                          const GyroMouseSettings& s, bool ratchetHeld) {
+    if (ratchetHeld) return {};
+
+    AimRate aim = GyroAimRate(fusion, s.space, transform);
+    float speedDps = std::sqrt(aim.yaw * aim.yaw + aim.pitch * aim.pitch);
+    if (speedDps < s.deadbandDps) return {};
+
+    // Real degrees turned this sample -> in-game degrees -> mouse counts
+    float scale = fusion.SamplePeriod() * GyroSensitivity(s, speedDps) * s.countsPer360 / 360.0f;
+    // Turning left (counter-clockwise seen from above) and tilting up move the pointer left and up
+    return { -aim.yaw * scale, -aim.pitch * scale };
+}
+
+static float wrap_degrees(float a) {
+    while (a > 180.0f) a -= 360.0f;
+    while (a < -180.0f) a += 360.0f;
+    return a;
+}
+
+// Fast start, gentle stop
+static float ease_out(float t) {
+    return 1.0f - (1.0f - t) * (1.0f - t);
+}
+
+float FlickStick::Update(float x, float y, float dt, const GyroMouseSettings& s) {
+    float magnitude = std::sqrt(x * x + y * y);
+    float angle = std::atan2(x, -y) * RAD_TO_DEG;
+    float turn = 0.0f;
+
+    if (magnitude >= s.flickThreshold || (active && magnitude >= s.flickThreshold * FLICK_RELEASE)) {
+        if (!active) {
+            // Flick: turn to face the direction the stick points (relative to straight ahead)
+            active = true;
+            flickTarget = angle;
+            flickProgress = 0.0f;
+        } else {
+            // Held: rotating the stick turns the camera by the same angle, immediately
+            turn += wrap_degrees(angle - lastAngle);
+        }
+        lastAngle = angle;
+    } else {
+        active = false;
+    }
+
+    if (flickProgress < 1.0f) {
+        float before = ease_out(flickProgress);
+        flickProgress = s.flickTimeMs > 0.0f ? (std::min)(1.0f, flickProgress + dt * 1000.0f / s.flickTimeMs) : 1.0f;
+        turn += flickTarget * (ease_out(flickProgress) - before);
+    }
+    return turn;
+}
@@ -0,0 +1,74 @@
+#pragma once
+// Gyro aiming: converts the IMU's angular velocity into mouse counts (gyro pointer) and turns
+// the right stick's direction into camera turns (flick stick). Both produce one delta per BLE
+// notification; the mouse interpolation thread spreads it over its output ticks.
+#include "MotionFusion.h"
+#include <string>
+
+enum class MouseSource {
+    Optical,     // Joy-Con 2 optical sensor (original mouse mode)
+    Gyro,        // gyro pointer
+    GyroFlick    // gyro pointer plus flick stick on the right stick
+};
+
+enum class GyroSpace {
+    Local,   // yaw and pitch about the controller's own up and right axes (for its grip)
+    World    // yaw about gravity, so the controller's roll does not leak into horizontal aim
+};
+
+struct GyroMouseSettings {
+    GyroSpace space = GyroSpace::World;
+    // Acceleration: turning slower than minThreshold uses minSens, faster than maxThreshold
+    // uses maxSens, blended in between. Sensitivities are in-game degrees per real degree.
+    float minSens = 1.0f;
+    float maxSens = 2.0f;
+    float minThresholdDps = 10.0f;
+    float maxThresholdDps = 120.0f;
+    float deadbandDps = 0.5f;      // slower rotation is treated as hand tremor and dropped
+    float countsPer360 = 3600.0f;  // mouse counts for one full in-game turn (game-specific)
+    float flickThreshold = 0.9f;   // stick deflection (0-1) that starts a flick
+    float flickTimeMs = 100.0f;    // how long a flick takes to reach the stick's direction
+};
+
+struct MouseDelta {
+    float dx = 0.0f;
+    float dy = 0.0f;
+};
+
+const char* MouseSourceToString(MouseSource source);
+MouseSource StringToMouseSource(const std::string& str);
+const char* GyroSpaceToString(GyroSpace space);
+GyroSpace StringToGyroSpace(const std::string& str);
+
+// Aiming rotation of the fusion's last sample in deg/s: yaw positive turning left, pitch
+// positive tilting the far edge up. The grip's transform says which controller axes are up and
+// right (rows 1 and 0 of the DS4 mapping).
+struct AimRate {
+    float yaw = 0.0f;
+    float pitch = 0.0f;
+};
+AimRate GyroAimRate(const MotionFusion& fusion, GyroSpace space, const ImuTransform& transform);
+
+// Gyro sensitivity at a given rotation speed (deg/s)
+float GyroSensitivity(const GyroMouseSettings& settings, float speedDps);
+
+// Angular velocity of the fusion's last sample -> mouse counts. Holding the ratchet button
+// lifts the "mouse" (returns nothing) so the controller can be re-centered.
+MouseDelta GyroMouseDelta(const MotionFusion& fusion, const ImuTransform& transform,
+                          const GyroMouseSettings& settings, bool ratchetHeld);
+
+// Flick stick: tilting the stick past the threshold turns the camera to face that direction
+// within flickTime; rotating the held stick then turns by the same angle. Returns the yaw to
+// turn this sample in degrees (positive = right).
+class FlickStick {
+public:
+    // x/y: stick position in [-1, 1], y positive down (DS4 convention)
+    float Update(float x, float y, float dt, const GyroMouseSettings& settings);
+    bool Active() const { return active; }
+
+private:
+    bool active = false;
+    float lastAngle = 0.0f;      // degrees, 0 = up, clockwise
+    float flickTarget = 0.0f;    // total turn of the current flick
+    float flickProgress = 1.0f;  // 0..1, 1 = done
+};
@@ -0,0 +1,64 @@
+#include "GyroStick.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr float STICK_CENTER = 127.5f;
+
+const char* GyroStickModeToString(GyroStickMode mode) {
+    switch (mode) {
+    case GyroStickMode::Replace: return "replace";
+    case GyroStickMode::Blend:   return "blend";
+    default: return "off";
+    }
+}
+
+GyroStickMode StringToGyroStickMode(const std::string& str) {
+    if (str == "replace") return GyroStickMode::Replace;
+    if (str == "blend") return GyroStickMode::Blend;
+    return GyroStickMode::Off;
+}
+
+void GyroStick::Update(const MotionFusion& fusion, const ImuTransform& transform, const GyroStickSettings& s) {
+    AimRate aim = GyroAimRate(fusion, s.space, transform);
+    float speed = std::sqrt(aim.yaw * aim.yaw + aim.pitch * aim.pitch);
+
+    float targetX = 0.0f, targetY = 0.0f;
+    if (speed > s.deadzoneDps) {
+        float range = s.fullDeflectionDps - s.deadzoneDps;
+        float m = range > 0.0f ? (std::min)((speed - s.deadzoneDps) / range, 1.0f) : 1.0f;
+        m = s.minDeflection + (1.0f - s.minDeflection) * m;
+        // Turning left and tilting up push the stick left and up, like the gyro pointer
+        targetX = -aim.yaw / speed * m;
+        targetY = -aim.pitch / speed * m;
+    }
+
+    float dt = fusion.SamplePeriod();
+    float alpha = s.smoothingMs > 0.0f ? dt / (dt + s.smoothingMs * 0.001f) : 1.0f;
+    x += (targetX - x) * alpha;
+    y += (targetY - y) * alpha;
+}
+
+void GyroStick::Process(const MotionFusion& fusion, const ImuTransform& transform, const GyroStickSettings& s,
+                        DS4_REPORT_EX& report) {
+    if (s.mode == GyroStickMode::Off) {
+        Reset();
+        return;
+    }
+    Update(fusion, transform, s);
+    Apply(report, s);
+}
+
+static BYTE to_axis(float v) {
+    return static_cast<BYTE>(std::lround(STICK_CENTER + std::clamp(v, -1.0f, 1.0f) * STICK_CENTER));
+}
+
+void GyroStick::Apply(DS4_REPORT_EX& report, const GyroStickSettings& s) const {
+    if (s.mode == GyroStickMode::Off) return;
+    float baseX = 0.0f, baseY = 0.0f;
+    if (s.mode == GyroStickMode::Blend) {
+        baseX = (report.Report.bThumbRX - STICK_CENTER) / STICK_CENTER;
+        baseY = (report.Report.bThumbRY - STICK_CENTER) / STICK_CENTER;
+    }
+    report.Report.bThumbRX = to_axis(baseX + x);
+    report.Report.bThumbRY = to_axis(baseY + y);
+}
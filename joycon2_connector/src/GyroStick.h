@@ -0,0 +1,43 @@
+#pragma once
+// Gyro to right stick, for games that read only sticks: the fused angular velocity becomes
+// right-stick deflection in the report, alone or added to the physical stick. Updated by the
+// thread that builds the report, once per report.
+#include "GyroMouse.h"
+#include <string>
+
+enum class GyroStickMode {
+    Off,
+    Replace,   // the gyro drives the right stick on its own
+    Blend      // the gyro is added to the physical right stick
+};
+
+struct GyroStickSettings {
+    GyroStickMode mode = GyroStickMode::Off;
+    GyroSpace space = GyroSpace::World;
+    float fullDeflectionDps = 180.0f;   // gain: turning this fast deflects the stick fully
+    float deadzoneDps = 2.0f;           // slower rotation (tremor) leaves the stick centered
+    float minDeflection = 0.1f;         // first output past the deadzone, to clear the game's own
+    float smoothingMs = 15.0f;          // output low-pass time constant; 0 = none
+};
+
+const char* GyroStickModeToString(GyroStickMode mode);
+GyroStickMode StringToGyroStickMode(const std::string& str);
+
+class GyroStick {
+public:
+    // One report: the fusion's last sample -> smoothed deflection
+    void Update(const MotionFusion& fusion, const ImuTransform& transform, const GyroStickSettings& settings);
+    // Writes the right stick of a generated report
+    void Apply(DS4_REPORT_EX& report, const GyroStickSettings& settings) const;
+    // Update and Apply for one report; while the mode is Off the stick rests centered
+    void Process(const MotionFusion& fusion, const ImuTransform& transform, const GyroStickSettings& settings, DS4_REPORT_EX& report);
+    void Reset() { x = y = 0.0f; }
+
+    // Current deflection in [-1, 1], y positive down (DS4 convention)
+    float X() const { return x; }
+    float Y() const { return y; }
+
+private:
+    float x = 0.0f;
+    float y = 0.0f;
+};
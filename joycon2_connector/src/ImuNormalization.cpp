@@ -0,0 +1,92 @@
+#include "ImuNormalization.h"
+#include <algorithm>
+
+// Axis maps are signed unit matrices: row i picks the controller axis that becomes DS4 axis i
+using AxisMap = int8_t[3][3];
+
+// Upright / Pro: right = -Y, up = Z, towards the player = -X
+constexpr AxisMap UPRIGHT_AXES = {
+    { 0, -1, 0 },
+    { 0,  0, 1 },
+    { -1, 0, 0 },
+};
+// Left Joy-Con sideways: turned a quarter counter-clockwise seen from above (top edge to the
+// left, like the stick decoder), so right = -X and towards the player = Y
+constexpr AxisMap LEFT_SIDEWAYS_AXES = {
+    { -1, 0, 0 },
+    { 0,  0, 1 },
+    { 0,  1, 0 },
+};
+// Right Joy-Con sideways: a quarter clockwise (top edge to the right), so right = X and
+// towards the player = -Y
+constexpr AxisMap RIGHT_SIDEWAYS_AXES = {
+    { 1, 0,  0 },
+    { 0, 0,  1 },
+    { 0, -1, 0 },
+};
+
+constexpr int32_t to_q14(double v) {
+    return static_cast<int32_t>(v * (1 << IMU_TRANSFORM_SHIFT) + (v < 0 ? -0.5 : 0.5));
+}
+
+constexpr ImuTransform make_transform(const AxisMap& axes, float gyroCountsPerDps, float accelCountsPerG) {
+    ImuTransform t{};
+    int32_t gyroScale = to_q14(double(DS4_GYRO_COUNTS_PER_DPS) / gyroCountsPerDps);
+    int32_t accelScale = to_q14(double(DS4_ACCEL_COUNTS_PER_G) / accelCountsPerG);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            t.gyro[i][j] = axes[i][j] * gyroScale;
+            t.accel[i][j] = axes[i][j] * accelScale;
+        }
+    }
+    return t;
+}
+
+constexpr ImuTransform JOYCON_TRANSFORMS[2][2] = {
+    { make_transform(UPRIGHT_AXES, IMU_GYRO_COUNTS_PER_DPS, IMU_ACCEL_COUNTS_PER_G),
+      make_transform(LEFT_SIDEWAYS_AXES, IMU_GYRO_COUNTS_PER_DPS, IMU_ACCEL_COUNTS_PER_G) },
+    { make_transform(UPRIGHT_AXES, IMU_GYRO_COUNTS_PER_DPS, IMU_ACCEL_COUNTS_PER_G),
+      make_transform(RIGHT_SIDEWAYS_AXES, IMU_GYRO_COUNTS_PER_DPS, IMU_ACCEL_COUNTS_PER_G) },
+};
+constexpr ImuTransform PRO_TRANSFORM = make_transform(UPRIGHT_AXES, IMU_GYRO_COUNTS_PER_DPS, IMU_ACCEL_COUNTS_PER_G);
+
+const ImuTransform& SelectImuTransform(ControllerFamily family, JoyConSide side, JoyConOrientation orientation) {
+    if (family != ControllerFamily::JoyCon2) return PRO_TRANSFORM;
+    return JOYCON_TRANSFORMS[static_cast<int>(side)][static_cast<int>(orientation)];
+}
+
+static void apply(const int32_t (&m)[3][3], const SHORT (&in)[3], SHORT (&out)[3]) {
+    constexpr int32_t round = 1 << (IMU_TRANSFORM_SHIFT - 1);
+    for (int i = 0; i < 3; ++i) {
+        int64_t sum = int64_t(m[i][0]) * in[0] + int64_t(m[i][1]) * in[1] + int64_t(m[i][2]) * in[2];
+        out[i] = static_cast<SHORT>(std::clamp<int64_t>((sum + round) >> IMU_TRANSFORM_SHIFT, -32768, 32767));
+    }
+}
+
+MotionData NormalizeMotion(const MotionData& raw, const ImuTransform& t) {
+    const SHORT gyro[3] = { raw.gyroX, raw.gyroY, raw.gyroZ };
+    const SHORT accel[3] = { raw.accelX, raw.accelY, raw.accelZ };
+    SHORT g[3], a[3];
+    apply(t.gyro, gyro, g);
+    apply(t.accel, accel, a);
+    return MotionData{ g[0], g[1], g[2], a[0], a[1], a[2] };
+}
+
+void NormalizeMotionUnits(const MotionData& raw, const ImuTransform& t, float accelG[3], float gyroDps[3]) {
+    const float gyro[3] = { float(raw.gyroX), float(raw.gyroY), float(raw.gyroZ) };
+    const float accel[3] = { float(raw.accelX), float(raw.accelY), float(raw.accelZ) };
+    constexpr float unit = 1.0f / (1 << IMU_TRANSFORM_SHIFT);
+    for (int i = 0; i < 3; ++i) {
+        gyroDps[i] = (t.gyro[i][0] * gyro[0] + t.gyro[i][1] * gyro[1] + t.gyro[i][2] * gyro[2]) * unit / DS4_GYRO_COUNTS_PER_DPS;
+        accelG[i] = (t.accel[i][0] * accel[0] + t.accel[i][1] * accel[1] + t.accel[i][2] * accel[2]) * unit / DS4_ACCEL_COUNTS_PER_G;
+    }
+}
+
+void WriteDS4Motion(DS4_REPORT_EX& report, const MotionData& motion) {
+    report.Report.wAccelX = motion.accelX;
+    report.Report.wAccelY = motion.accelY;
+    report.Report.wAccelZ = motion.accelZ;
+    report.Report.wGyroX = motion.gyroX;
+    report.Report.wGyroY = motion.gyroY;
+    report.Report.wGyroZ = motion.gyroZ;
+}
@@ -0,0 +1,35 @@
+#pragma once
+// IMU normalization: maps a controller's raw motion sample (its own axes and units) to the DS4
+// convention with one precomputed fixed-point matrix per (controller, side, grip).
+//
+// Controller frame (Switch convention, lying flat face up): X towards the top edge, Y to the
+// left, Z up. DS4 frame: X to the right, Y up, Z towards the player.
+#include "JoyConDecoder.h"
+
+// IMU scale of the Joy-Con 2 / Pro Controller 2 (README frame table: 48000 = 360 dps, 4096 = 1 g)
+constexpr float IMU_GYRO_COUNTS_PER_DPS = 48000.0f / 360.0f;
+constexpr float IMU_ACCEL_COUNTS_PER_G = 4096.0f;
+
+// DS4 motion units
+constexpr float DS4_GYRO_COUNTS_PER_DPS = 16.0f;
+constexpr float DS4_ACCEL_COUNTS_PER_G = 8192.0f;
+
+constexpr int IMU_TRANSFORM_SHIFT = 14;
+
+// Rotation and unit scale in Q14: ds4[i] = sum_j m[i][j] * raw[j]
+struct ImuTransform {
+    int32_t gyro[3][3];
+    int32_t accel[3][3];
+};
+
+// NSO GC units are assumed to match the Pro Controller 2; the dual player uses the upright
+// Joy-Con transform for its merged IMU
+const ImuTransform& SelectImuTransform(ControllerFamily family, JoyConSide side = JoyConSide::Left,
+                                       JoyConOrientation orientation = JoyConOrientation::Upright);
+
+// Saturates instead of wrapping (the DS4 accel range is smaller in g than the controller's)
+MotionData NormalizeMotion(const MotionData& raw, const ImuTransform& transform);
+// Same axes in g and deg/s, without the DS4 quantization or range limit (for the DSU server)
+void NormalizeMotionUnits(const MotionData& raw, const ImuTransform& transform, float accelG[3], float gyroDps[3]);
+
+void WriteDS4Motion(DS4_REPORT_EX& report, const MotionData& motion);
@@ -0,0 +1,29 @@
+#pragma once
+// InputTransport - The link between a player and one controller: notifications in, command
+// writes out. GattInputTransport (Windows) wraps the WinRT characteristics; SimulatedController
+// generates frames without hardware, so everything above the radio runs on any platform.
+#include "FrameLayout.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Runs on the transport's delivery thread; data is only valid during the call and holds length
+// bytes of one notification. arrivalUs is steady-clock microseconds (see SensorClock.h).
+using NotificationHandler = std::function<void(const uint8_t* data, size_t length, int64_t arrivalUs)>;
+
+class IInputTransport {
+public:
+    virtual ~IInputTransport() = default;
+
+    virtual ControllerFamily Family() const = 0;
+    // 48-bit Bluetooth address (0 when unknown)
+    virtual uint64_t Address() const = 0;
+
+    // Replaces any previous handler and enables notifications; false when the device refused
+    virtual bool Subscribe(NotificationHandler handler) = 0;
+    // Stops delivery; a handler call already in progress may still finish
+    virtual void Unsubscribe() = 0;
+
+    // One packet on the command characteristic (see BLECommands.h), without response
+    virtual bool Write(const uint8_t* data, size_t length) = 0;
+};
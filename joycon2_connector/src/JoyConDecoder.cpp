@@ -1,11 +1,12 @@
 #include "JoyConDecoder.h"
+#include "ImuNormalization.h"
 #include <cmath>
 #include <algorithm>
-#include <ViGEm/Client.h>
-#include <ViGEm/Common.h>
 
+#include <array>
 #include <cstdint>
 #include <cstdio>
+#include <utility>
 #include <vector>
 #include <algorithm> // for clamp
 
@@ -13,68 +14,253 @@ int16_t to_signed_16(uint8_t lsb, uint8_t msb) {
     return static_cast<int16_t>((msb << 8) | lsb);
 }
 
-constexpr uint32_t BUTTON_A_MASK_RIGHT = 0x000800;
-constexpr uint32_t BUTTON_B_MASK_RIGHT = 0x000200;
-constexpr uint32_t BUTTON_X_MASK_RIGHT = 0x000400;
-constexpr uint32_t BUTTON_Y_MASK_RIGHT = 0x000100;
-constexpr uint32_t BUTTON_PLUS_MASK_RIGHT = 0x000002;
-constexpr uint32_t BUTTON_R_MASK_RIGHT = 0x004000;
-constexpr uint32_t BUTTON_STICK_MASK_RIGHT = 0x000004;
-
-constexpr uint32_t BUTTON_UP_MASK_LEFT = 0x000002;
-constexpr uint32_t BUTTON_DOWN_MASK_LEFT = 0x000001;
-constexpr uint32_t BUTTON_LEFT_MASK_LEFT = 0x000008;
-constexpr uint32_t BUTTON_RIGHT_MASK_LEFT = 0x000004;
-constexpr uint32_t BUTTON_MINUS_MASK_LEFT = 0x000100;
-constexpr uint32_t BUTTON_L_MASK_LEFT = 0x000040;
-constexpr uint32_t BUTTON_STICK_MASK_LEFT = 0x000800;
-
-StickData DecodeJoystick(const std::vector<uint8_t>& buffer, JoyConSide side, JoyConOrientation orientation) {
-    if (buffer.size() < 16) {
-        return { 0, 0, 0, 0 };
+// Button translation tables
+// Each Nintendo button bit sets its DS4 bits independently of the others, so every byte of the
+// button state gets a 256-entry table generated at compile time and a report needs only a few
+// table loads and ORs. The four D-pad bits of each layout share one byte, so the 8-way hat
+// resolution is folded into that byte's table.
+template <typename T, size_t Bytes>
+using ButtonByteTable = std::array<std::array<T, 256>, Bytes>;
+
+constexpr uint16_t resolve_dpad(bool up, bool down, bool left, bool right) {
+    if (up && left) return DS4_BUTTON_DPAD_NORTHWEST;
+    if (up && right) return DS4_BUTTON_DPAD_NORTHEAST;
+    if (down && left) return DS4_BUTTON_DPAD_SOUTHWEST;
+    if (down && right) return DS4_BUTTON_DPAD_SOUTHEAST;
+    if (up) return DS4_BUTTON_DPAD_NORTH;
+    if (down) return DS4_BUTTON_DPAD_SOUTH;
+    if (left) return DS4_BUTTON_DPAD_WEST;
+    if (right) return DS4_BUTTON_DPAD_EAST;
+    return DS4_BUTTON_DPAD_NONE;
+}
+
+// wButtons for a single Joy-Con button word (withDpad: add the hat nibble)
+constexpr uint16_t map_single_joycon_buttons(uint64_t state, bool isLeft, bool upright, bool withDpad) {
+    uint16_t buttons = 0;
+    if (isLeft) {
+        if (withDpad) {
+            buttons |= resolve_dpad((state & BUTTON_UP_MASK_LEFT) != 0, (state & BUTTON_DOWN_MASK_LEFT) != 0,
+                                    (state & BUTTON_LEFT_MASK_LEFT) != 0, (state & BUTTON_RIGHT_MASK_LEFT) != 0);
+        }
+        if (state & BUTTON_MINUS_MASK_LEFT)   buttons |= DS4_BUTTON_SHARE;
+        if (state & BUTTON_L_MASK_LEFT)       buttons |= DS4_BUTTON_SHOULDER_LEFT;
+        if (state & BUTTON_STICK_MASK_LEFT)   buttons |= DS4_BUTTON_THUMB_LEFT;
+    }
+    else {
+        if (withDpad) buttons |= DS4_BUTTON_DPAD_NONE;
+        if (state & BUTTON_A_MASK_RIGHT)      buttons |= DS4_BUTTON_CIRCLE;
+        if (state & BUTTON_B_MASK_RIGHT)      buttons |= DS4_BUTTON_TRIANGLE;
+        if (state & BUTTON_X_MASK_RIGHT)      buttons |= DS4_BUTTON_CROSS;
+        if (state & BUTTON_Y_MASK_RIGHT)      buttons |= DS4_BUTTON_SQUARE;
+        if (state & BUTTON_PLUS_MASK_RIGHT)   buttons |= DS4_BUTTON_OPTIONS;
+        if (state & BUTTON_R_MASK_RIGHT)      buttons |= DS4_BUTTON_SHOULDER_RIGHT;
+        if (state & BUTTON_STICK_MASK_RIGHT)  buttons |= DS4_BUTTON_THUMB_RIGHT;
     }
 
-    bool isLeft = (side == JoyConSide::Left);
-    bool upright = (orientation == JoyConOrientation::Upright);
+    // Triggers are digital on Joy-Cons; sideways grips use SL/SR as shoulders
+    if (state & 0x000080) buttons |= DS4_BUTTON_TRIGGER_LEFT;
+    if (state & 0x008000) buttons |= DS4_BUTTON_TRIGGER_RIGHT;
+    if (upright) {
+        if (state & 0x000040) buttons |= DS4_BUTTON_SHOULDER_LEFT;
+        if (state & 0x004000) buttons |= DS4_BUTTON_SHOULDER_RIGHT;
+    }
+    else {
+        if (state & (isLeft ? 0x000020 : 0x002000)) buttons |= DS4_BUTTON_SHOULDER_LEFT;
+        if (state & (isLeft ? 0x000010 : 0x001000)) buttons |= DS4_BUTTON_SHOULDER_RIGHT;
+    }
+    return buttons;
+}
 
-    const uint8_t* data = isLeft ? &buffer[10] : &buffer[13];
+// wButtons in the low 16 bits, bSpecial in bits 16..23
+constexpr uint32_t map_pro_buttons(uint64_t state, bool withDpad) {
+    uint32_t buttons = 0, special = 0;
+    if (state & BUTTON_A_MASK)        buttons |= DS4_BUTTON_CIRCLE;
+    if (state & BUTTON_B_MASK)        buttons |= DS4_BUTTON_CROSS;
+    if (state & BUTTON_X_MASK)        buttons |= DS4_BUTTON_TRIANGLE;
+    if (state & BUTTON_Y_MASK)        buttons |= DS4_BUTTON_SQUARE;
+    if (state & BUTTON_L_SHOULDER)    buttons |= DS4_BUTTON_SHOULDER_LEFT;
+    if (state & BUTTON_R_SHOULDER)    buttons |= DS4_BUTTON_SHOULDER_RIGHT;
+    if (state & BUTTON_L_THUMB)       buttons |= DS4_BUTTON_THUMB_LEFT;
+    if (state & BUTTON_R_THUMB)       buttons |= DS4_BUTTON_THUMB_RIGHT;
+    if (state & BUTTON_BACK)          special |= DS4_SPECIAL_BUTTON_TOUCHPAD;
+    if (state & BUTTON_START)         buttons |= DS4_BUTTON_OPTIONS;
+    if (state & BUTTON_GUIDE)         special |= DS4_SPECIAL_BUTTON_PS;
+    if (withDpad) {
+        buttons |= resolve_dpad((state & BUTTON_DPAD_UP) != 0, (state & BUTTON_DPAD_DOWN) != 0,
+                                (state & BUTTON_DPAD_LEFT) != 0, (state & BUTTON_DPAD_RIGHT) != 0);
+    }
+    return buttons | (special << 16);
+}
 
-    int x_raw = ((data[1] & 0x0F) << 8) | data[0];
-    int y_raw = (data[2] << 4) | ((data[1] & 0xF0) >> 4);
+constexpr uint32_t map_nsogc_buttons(uint64_t state, bool withDpad) {
+    uint32_t buttons = 0, special = 0;
+    if (state & BUTTON_A_MASK)        buttons |= DS4_BUTTON_CIRCLE;
+    if (state & BUTTON_B_MASK)        buttons |= DS4_BUTTON_TRIANGLE;
+    if (state & BUTTON_X_MASK)        buttons |= DS4_BUTTON_CROSS;
+    if (state & BUTTON_Y_MASK)        buttons |= DS4_BUTTON_SQUARE;
+    if (state & BUTTON_L_SHOULDER)    buttons |= DS4_BUTTON_SHOULDER_LEFT;
+    if (state & BUTTON_R_SHOULDER)    buttons |= DS4_BUTTON_SHOULDER_RIGHT;
+    if (state & TRIGGER_LT_MASK)      buttons |= DS4_BUTTON_TRIGGER_LEFT;
+    if (state & TRIGGER_RT_MASK)      buttons |= DS4_BUTTON_TRIGGER_RIGHT;
+    if (state & BUTTON_L_THUMB)       buttons |= DS4_BUTTON_THUMB_LEFT;
+    if (state & BUTTON_R_THUMB)       buttons |= DS4_BUTTON_THUMB_RIGHT;
+    if (state & BUTTON_BACK)          buttons |= DS4_BUTTON_SHARE;
+    if (state & BUTTON_START)         buttons |= DS4_BUTTON_OPTIONS;
+    if (state & BUTTON_GUIDE)         special |= DS4_SPECIAL_BUTTON_PS;
+    if (withDpad) {
+        buttons |= resolve_dpad((state & BUTTON_DPAD_UP) != 0, (state & BUTTON_DPAD_DOWN) != 0,
+                                (state & BUTTON_DPAD_LEFT) != 0, (state & BUTTON_DPAD_RIGHT) != 0);
+    }
+    return buttons | (special << 16);
+}
 
-    float x = (x_raw - 2048) / 2048.0f;
-    float y = (y_raw - 2048) / 2048.0f;
+template <typename T, size_t Bytes, typename Map>
+constexpr ButtonByteTable<T, Bytes> make_button_table(size_t dpadByte, Map map) {
+    ButtonByteTable<T, Bytes> table{};
+    for (size_t k = 0; k < Bytes; ++k) {
+        for (uint32_t b = 0; b < 256; ++b) {
+            table[k][b] = static_cast<T>(map(static_cast<uint64_t>(b) << (8 * k), k == dpadByte));
+        }
+    }
+    return table;
+}
 
-    if (!upright) {
-        float tx = x, ty = y;
-        x = isLeft ? -ty : ty;
-        y = isLeft ? tx : -tx;
+constexpr ButtonByteTable<uint16_t, 3> make_single_joycon_table(bool isLeft, bool upright) {
+    return make_button_table<uint16_t, 3>(0, [=](uint64_t state, bool withDpad) {
+        return map_single_joycon_buttons(state, isLeft, upright, withDpad);
+    });
+}
+
+// Indexed [left, right][upright, sideways]
+constexpr ButtonByteTable<uint16_t, 3> SINGLE_JOYCON_TABLES[2][2] = {
+    { make_single_joycon_table(true, true),  make_single_joycon_table(true, false) },
+    { make_single_joycon_table(false, true), make_single_joycon_table(false, false) },
+};
+constexpr ButtonByteTable<uint32_t, 6> PRO_BUTTON_TABLE = make_button_table<uint32_t, 6>(2, map_pro_buttons);
+constexpr ButtonByteTable<uint32_t, 6> NSOGC_BUTTON_TABLE = make_button_table<uint32_t, 6>(2, map_nsogc_buttons);
+
+template <typename T, size_t Bytes>
+static T lookup_buttons(const ButtonByteTable<T, Bytes>& table, uint64_t state) {
+    T bits = 0;
+    for (size_t k = 0; k < Bytes; ++k) {
+        bits |= table[k][(state >> (8 * k)) & 0xFF];
     }
+    return bits;
+}
 
-    const float deadzone = 0.08f;
-    if (std::abs(x) < deadzone && std::abs(y) < deadzone) {
+// 0xFF when any bit of mask is set, without branching on the state
+static BYTE full_if(uint64_t state, uint64_t mask) {
+    return static_cast<BYTE>(0u - static_cast<uint32_t>((state & mask) != 0));
+}
+
+static RawStick unpack_stick(const uint8_t* data) {
+    RawStick s;
+    s.x = static_cast<uint16_t>(((data[1] & 0x0F) << 8) | data[0]);
+    s.y = static_cast<uint16_t>((data[2] << 4) | ((data[1] & 0xF0) >> 4));
+    return s;
+}
+
+static MotionData decode_motion(const uint8_t* data) {
+    MotionData m{};
+    m.accelX = to_signed_16(data[0], data[1]);
+    m.accelY = to_signed_16(data[2], data[3]);
+    m.accelZ = to_signed_16(data[4], data[5]);
+    m.gyroX  = to_signed_16(data[6], data[7]);
+    m.gyroY  = to_signed_16(data[8], data[9]);
+    m.gyroZ  = to_signed_16(data[10], data[11]);
+    return m;
+}
+
+MotionData DecodeMotion(JoyConFrameView raw) {
+    return decode_motion(&raw[FindFrameLayout(ControllerFamily::JoyCon2).motion]);
+}
+
+// One instantiation per distinct layout: every offset is a compile-time constant
+template <FrameLayout L>
+static JoyConInputFrame decode_frame(JoyConFrameView raw, size_t length) {
+    static_assert(L.buttons + 6 <= JOYCON_FRAME_SIZE && L.leftStick + 3 <= JOYCON_FRAME_SIZE &&
+                  L.rightStick + 3 <= JOYCON_FRAME_SIZE && L.optical + 4 <= JOYCON_FRAME_SIZE &&
+                  L.motion + 12 <= JOYCON_FRAME_SIZE && L.triggers + 2 <= JOYCON_FRAME_SIZE,
+                  "layout field outside the frame");
+    JoyConInputFrame frame;
+    frame.length = static_cast<uint32_t>(length < JOYCON_FRAME_SIZE ? length : JOYCON_FRAME_SIZE);
+
+    uint64_t state = 0;
+    for (int i = 0; i < 6; ++i) {
+        state = (state << 8) | raw[L.buttons + i];
+    }
+    frame.buttons = state;
+
+    // Short payloads keep centered sticks instead of unpacking zero padding as full deflection
+    if (frame.length >= L.minStickLength) {
+        frame.leftStick = unpack_stick(&raw[L.leftStick]);
+        frame.rightStick = unpack_stick(&raw[L.rightStick]);
+    }
+
+    frame.opticalX = to_signed_16(raw[L.optical], raw[L.optical + 1]);
+    frame.opticalY = to_signed_16(raw[L.optical + 2], raw[L.optical + 3]);
+    frame.motion = decode_motion(&raw[L.motion]);
+    frame.triggerL = raw[L.triggers];
+    frame.triggerR = raw[L.triggers + 1];
+    return frame;
+}
+
+template <size_t... I>
+constexpr std::array<FrameDecoder, FRAME_LAYOUT_COUNT> make_frame_decoders(std::index_sequence<I...>) {
+    return { decode_frame<FRAME_LAYOUTS[I].layout>... };
+}
+
+// Parallel to FRAME_LAYOUTS
+constexpr auto FRAME_DECODERS = make_frame_decoders(std::make_index_sequence<FRAME_LAYOUT_COUNT>{});
+
+FrameDecoder SelectFrameDecoder(ControllerFamily family, uint32_t firmware) {
+    return FRAME_DECODERS[FindFrameLayoutIndex(family, firmware)];
+}
+
+JoyConInputFrame DecodeInputFrame(JoyConFrameView raw, size_t length) {
+    return decode_frame<FindFrameLayout(ControllerFamily::JoyCon2)>(raw, length);
+}
+
+// Configuration is a template parameter: every per-frame branch below is on frame data only
+template <JoyConSide Side, JoyConOrientation Orientation>
+static StickData decode_joystick(const JoyConInputFrame& frame, const StickLUT& lut) {
+    constexpr bool isLeft = (Side == JoyConSide::Left);
+    if (frame.length < 16) {
         return { 0, 0, 0, 0 };
     }
 
-    x = std::clamp(x * 1.7f, -1.0f, 1.0f);
-    y = std::clamp(y * 1.7f, -1.0f, 1.0f);
+    const RawStick& stick = isLeft ? frame.leftStick : frame.rightStick;
+    // Square deadzone and radial stage happen before rotation; neither depends on it
+    auto [x, y] = MapStick(lut, stick.x, stick.y);
+
+    if constexpr (Orientation == JoyConOrientation::Sideways) {
+        int16_t tx = x, ty = y;
+        x = isLeft ? -ty : ty;
+        y = isLeft ? tx : -tx;
+    }
+
+    return { x, static_cast<int16_t>(-y), 0, 0 };
+}
 
-    int16_t outX = static_cast<int16_t>(x * 32767);
-    int16_t outY = static_cast<int16_t>(-y * 32767);
+// [side][orientation], matching the enum order
+constexpr JoystickDecoder JOYSTICK_DECODERS[2][2] = {
+    { decode_joystick<JoyConSide::Left, JoyConOrientation::Upright>, decode_joystick<JoyConSide::Left, JoyConOrientation::Sideways> },
+    { decode_joystick<JoyConSide::Right, JoyConOrientation::Upright>, decode_joystick<JoyConSide::Right, JoyConOrientation::Sideways> },
+};
 
-    return { outX, outY, 0, 0 };
+JoystickDecoder SelectJoystickDecoder(JoyConSide side, JoyConOrientation orientation) {
+    return JOYSTICK_DECODERS[static_cast<int>(side)][static_cast<int>(orientation)];
 }
 
-static std::pair<int16_t, int16_t> decode_joystick(const std::vector<uint8_t>& buffer, bool isLeft, bool upright) {
-    auto res = DecodeJoystick(buffer, isLeft ? JoyConSide::Left : JoyConSide::Right, upright ? JoyConOrientation::Upright : JoyConOrientation::Sideways);
-    return { res.x, res.y };
+StickData DecodeJoystick(const JoyConInputFrame& frame, JoyConSide side, JoyConOrientation orientation, const StickLUT& lut) {
+    return SelectJoystickDecoder(side, orientation)(frame, lut);
 }
 
-std::pair<uint16_t, uint16_t> DecodeMouseCoords(const std::vector<uint8_t>& buffer) {
-    if (buffer.size() < 0x18) return { 960, 471 };
+std::pair<uint16_t, uint16_t> DecodeMouseCoords(const JoyConInputFrame& frame) {
+    if (frame.length < 0x18) return { 960, 471 };
 
-    int16_t raw_x = to_signed_16(buffer[0x10], buffer[0x11]);
-    int16_t raw_y = to_signed_16(buffer[0x12], buffer[0x13]);
+    int16_t raw_x = frame.opticalX;
+    int16_t raw_y = frame.opticalY;
 
     float norm_x = std::clamp(raw_x / 32767.0f, -1.0f, 1.0f);
     float norm_y = std::clamp(raw_y / 32767.0f, -1.0f, 1.0f);
@@ -92,116 +278,77 @@ void EncodeDS4Touch(DS4_TOUCH& touch, uint8_t trackingId, uint16_t x, uint16_t y
     touch.bTouchData1[2] = (y >> 4) & 0xFF;
 }
 
-static void decode_triggers_shoulders(uint32_t state, bool isLeft, bool upright,
+// Upright layout, the same for both sides (the dual player always holds its Joy-Cons upright)
+static void decode_triggers_shoulders(uint32_t state,
     BYTE& leftTrigger, BYTE& rightTrigger,
     bool& leftShoulder, bool& rightShoulder) {
 
     leftTrigger = (state & 0x000080) ? 255 : 0;
     rightTrigger = (state & 0x008000) ? 255 : 0;
 
-    if (upright) {
-        leftShoulder = (state & 0x000040) != 0;
-        rightShoulder = (state & 0x004000) != 0;
-    }
-    else {
-        leftShoulder = (state & (isLeft ? 0x000020 : 0x002000)) != 0;
-        rightShoulder = (state & (isLeft ? 0x000010 : 0x001000)) != 0;
-    }
+    leftShoulder = (state & 0x000040) != 0;
+    rightShoulder = (state & 0x004000) != 0;
 }
 
-DS4_REPORT_EX GenerateDS4Report(const std::vector<uint8_t>& buffer, JoyConSide side, JoyConOrientation orientation) {
+template <JoyConSide Side, JoyConOrientation Orientation>
+static DS4_REPORT_EX generate_single_report(const JoyConInputFrame& frame, const StickLUT& stick) {
     DS4_REPORT_EX report{};
     DS4_REPORT_INIT(reinterpret_cast<PDS4_REPORT>(&report.Report));
 
-    if (buffer.size() < 0x3C) return report;
-
-    bool isLeft = (side == JoyConSide::Left);
-    bool upright = (orientation == JoyConOrientation::Upright);
+    if (frame.length < 0x3C) return report;
 
-    int btnOffset = isLeft ? 4 : 3;
-    uint32_t state = (buffer[btnOffset] << 16) | (buffer[btnOffset + 1] << 8) | buffer[btnOffset + 2];
+    uint32_t state = frame.JoyConButtons(Side);
 
-    auto [stickX, stickY] = decode_joystick(buffer, isLeft, upright);
+    StickData thumb = decode_joystick<Side, Orientation>(frame, stick);
 
-    if (isLeft) {
-        bool up = (state & BUTTON_UP_MASK_LEFT) != 0;
-        bool down = (state & BUTTON_DOWN_MASK_LEFT) != 0;
-        bool left = (state & BUTTON_LEFT_MASK_LEFT) != 0;
-        bool right = (state & BUTTON_RIGHT_MASK_LEFT) != 0;
-
-        uint8_t dpad = DS4_BUTTON_DPAD_NONE;
-        if (up && left) dpad = DS4_BUTTON_DPAD_NORTHWEST;
-        else if (up && right) dpad = DS4_BUTTON_DPAD_NORTHEAST;
-        else if (down && left) dpad = DS4_BUTTON_DPAD_SOUTHWEST;
-        else if (down && right) dpad = DS4_BUTTON_DPAD_SOUTHEAST;
-        else if (up) dpad = DS4_BUTTON_DPAD_NORTH;
-        else if (down) dpad = DS4_BUTTON_DPAD_SOUTH;
-        else if (left) dpad = DS4_BUTTON_DPAD_WEST;
-        else if (right) dpad = DS4_BUTTON_DPAD_EAST;
-
-        DS4_SET_DPAD(reinterpret_cast<PDS4_REPORT>(&report.Report), static_cast<DS4_DPAD_DIRECTIONS>(dpad));
-
-        if (state & BUTTON_MINUS_MASK_LEFT)   report.Report.wButtons |= DS4_BUTTON_SHARE;
-        if (state & BUTTON_L_MASK_LEFT)       report.Report.wButtons |= DS4_BUTTON_SHOULDER_LEFT;
-        if (state & BUTTON_STICK_MASK_LEFT)   report.Report.wButtons |= DS4_BUTTON_THUMB_LEFT;
-    }
-    else {
-        DS4_SET_DPAD(reinterpret_cast<PDS4_REPORT>(&report.Report), DS4_BUTTON_DPAD_NONE);
-
-        if (state & BUTTON_A_MASK_RIGHT)      report.Report.wButtons |= DS4_BUTTON_CIRCLE;
-        if (state & BUTTON_B_MASK_RIGHT)      report.Report.wButtons |= DS4_BUTTON_TRIANGLE;
-        if (state & BUTTON_X_MASK_RIGHT)      report.Report.wButtons |= DS4_BUTTON_CROSS;
-        if (state & BUTTON_Y_MASK_RIGHT)      report.Report.wButtons |= DS4_BUTTON_SQUARE;
-        if (state & BUTTON_PLUS_MASK_RIGHT)   report.Report.wButtons |= DS4_BUTTON_OPTIONS;
-        if (state & BUTTON_R_MASK_RIGHT)      report.Report.wButtons |= DS4_BUTTON_SHOULDER_RIGHT;
-        if (state & BUTTON_STICK_MASK_RIGHT)  report.Report.wButtons |= DS4_BUTTON_THUMB_RIGHT;
-    }
+    const auto& table = SINGLE_JOYCON_TABLES[static_cast<int>(Side)][static_cast<int>(Orientation)];
+    report.Report.wButtons = lookup_buttons(table, state);
 
-    auto [touchX, touchY] = DecodeMouseCoords(buffer);
+    auto [touchX, touchY] = DecodeMouseCoords(frame);
     report.Report.bTouchPacketsN = 1;
     report.Report.sCurrentTouch.bPacketCounter++;
     EncodeDS4Touch(report.Report.sCurrentTouch, 1, touchX, touchY);
 
-    BYTE leftTrigger = 0, rightTrigger = 0;
-    bool leftShoulder = false, rightShoulder = false;
-    decode_triggers_shoulders(state, isLeft, upright, leftTrigger, rightTrigger, leftShoulder, rightShoulder);
+    report.Report.bThumbLX = StickToByte(thumb.x);
+    report.Report.bThumbLY = StickToByte(thumb.y);
 
-    if (leftShoulder)  report.Report.wButtons |= DS4_BUTTON_SHOULDER_LEFT;
-    if (rightShoulder) report.Report.wButtons |= DS4_BUTTON_SHOULDER_RIGHT;
-    if (leftTrigger)   report.Report.wButtons |= DS4_BUTTON_TRIGGER_LEFT;
-    if (rightTrigger)  report.Report.wButtons |= DS4_BUTTON_TRIGGER_RIGHT;
+    WriteDS4Motion(report, NormalizeMotion(frame.motion, SelectImuTransform(ControllerFamily::JoyCon2, Side, Orientation)));
 
-    report.Report.bThumbLX = static_cast<BYTE>((stickX / 32767.0f) * 127 + 128);
-    report.Report.bThumbLY = static_cast<BYTE>((stickY / 32767.0f) * 127 + 128);
+    return report;
+}
 
-    report.Report.wAccelX = to_signed_16(buffer[0x30], buffer[0x31]);
-    report.Report.wAccelY = to_signed_16(buffer[0x32], buffer[0x33]);
-    report.Report.wAccelZ = to_signed_16(buffer[0x34], buffer[0x35]);
+constexpr SingleReportGenerator SINGLE_REPORT_GENERATORS[2][2] = {
+    { generate_single_report<JoyConSide::Left, JoyConOrientation::Upright>, generate_single_report<JoyConSide::Left, JoyConOrientation::Sideways> },
+    { generate_single_report<JoyConSide::Right, JoyConOrientation::Upright>, generate_single_report<JoyConSide::Right, JoyConOrientation::Sideways> },
+};
 
-    report.Report.wGyroX = to_signed_16(buffer[0x36], buffer[0x37]);
-    report.Report.wGyroY = to_signed_16(buffer[0x38], buffer[0x39]);
-    report.Report.wGyroZ = to_signed_16(buffer[0x3A], buffer[0x3B]);
+SingleReportGenerator SelectDS4ReportGenerator(JoyConSide side, JoyConOrientation orientation) {
+    return SINGLE_REPORT_GENERATORS[static_cast<int>(side)][static_cast<int>(orientation)];
+}
 
-    return report;
+DS4_REPORT_EX GenerateDS4Report(const JoyConInputFrame& frame, JoyConSide side, JoyConOrientation orientation, const StickLUT& stick) {
+    return SelectDS4ReportGenerator(side, orientation)(frame, stick);
 }
 
-DS4_REPORT_EX GenerateDualJoyConDS4Report(const std::vector<uint8_t>& leftBuffer, const std::vector<uint8_t>& rightBuffer, GyroSource gyroSource)
+template <GyroSource Gyro>
+static DS4_REPORT_EX generate_dual_report(const JoyConInputFrame& left, const JoyConInputFrame& right,
+    const StickLUT& leftStick, const StickLUT& rightStick)
 {
     DS4_REPORT_EX report{};
     DS4_REPORT_INIT(reinterpret_cast<PDS4_REPORT>(&report.Report));
 
-    if (leftBuffer.size() < 0x3C && rightBuffer.size() < 0x3C) {
+    if (left.length < 0x3C && right.length < 0x3C) {
         return report;
     }
 
     DS4_REPORT_EX leftReport{};
-    if (leftBuffer.size() >= 0x3C) {
-        leftReport = GenerateDS4Report(leftBuffer, JoyConSide::Left, JoyConOrientation::Upright);
+    if (left.length >= 0x3C) {
+        leftReport = generate_single_report<JoyConSide::Left, JoyConOrientation::Upright>(left, leftStick);
     }
 
     DS4_REPORT_EX rightReport{};
-    if (rightBuffer.size() >= 0x3C) {
-        rightReport = GenerateDS4Report(rightBuffer, JoyConSide::Right, JoyConOrientation::Upright);
+    if (right.length >= 0x3C) {
+        rightReport = generate_single_report<JoyConSide::Right, JoyConOrientation::Upright>(right, rightStick);
     }
 
     USHORT leftDpad = leftReport.Report.wButtons & 0xF;
@@ -213,8 +360,8 @@ DS4_REPORT_EX GenerateDualJoyConDS4Report(const std::vector<uint8_t>& leftBuffer
 
     report.Report.bSpecial = leftReport.Report.bSpecial | rightReport.Report.bSpecial;
 
-    auto [x1, y1] = DecodeMouseCoords(leftBuffer);
-    auto [x2, y2] = DecodeMouseCoords(rightBuffer);
+    auto [x1, y1] = DecodeMouseCoords(left);
+    auto [x2, y2] = DecodeMouseCoords(right);
 
     report.Report.bTouchPacketsN = 1;
     report.Report.sCurrentTouch.bPacketCounter++;
@@ -224,23 +371,18 @@ DS4_REPORT_EX GenerateDualJoyConDS4Report(const std::vector<uint8_t>& leftBuffer
     report.Report.sCurrentTouch.bTouchData2[1] = ((x2 >> 8) & 0x0F) | ((y2 & 0x0F) << 4);
     report.Report.sCurrentTouch.bTouchData2[2] = (y2 >> 4) & 0xFF;
 
-    // Guard individual buffer sizes before direct byte access
-    uint32_t leftState = (leftBuffer.size() >= 7)
-        ? ((leftBuffer[4] << 16) | (leftBuffer[5] << 8) | leftBuffer[6])
-        : 0;
-    uint32_t rightState = (rightBuffer.size() >= 6)
-        ? ((rightBuffer[3] << 16) | (rightBuffer[4] << 8) | rightBuffer[5])
-        : 0;
+    uint32_t leftState = left.JoyConButtons(JoyConSide::Left);
+    uint32_t rightState = right.JoyConButtons(JoyConSide::Right);
 
     BYTE lt = 0, rt = 0;
     bool ls = false, rs = false;
 
-    decode_triggers_shoulders(leftState, true, true, lt, rt, ls, rs);
+    decode_triggers_shoulders(leftState, lt, rt, ls, rs);
     report.Report.bTriggerL = lt;
     if (ls) report.Report.wButtons |= DS4_BUTTON_SHOULDER_LEFT;
     if (lt) report.Report.wButtons |= DS4_BUTTON_TRIGGER_LEFT;
 
-    decode_triggers_shoulders(rightState, false, true, lt, rt, ls, rs);
+    decode_triggers_shoulders(rightState, lt, rt, ls, rs);
     report.Report.bTriggerR = rt;
     if (rs) report.Report.wButtons |= DS4_BUTTON_SHOULDER_RIGHT;
     if (rt) report.Report.wButtons |= DS4_BUTTON_TRIGGER_RIGHT;
@@ -250,107 +392,67 @@ DS4_REPORT_EX GenerateDualJoyConDS4Report(const std::vector<uint8_t>& leftBuffer
     report.Report.bThumbRX = rightReport.Report.bThumbLX;
     report.Report.bThumbRY = rightReport.Report.bThumbLY;
 
-    switch (gyroSource) {
-        case GyroSource::Left:
-            report.Report.wAccelX = leftReport.Report.wAccelX;
-            report.Report.wAccelY = leftReport.Report.wAccelY;
-            report.Report.wAccelZ = leftReport.Report.wAccelZ;
-
-            report.Report.wGyroX = leftReport.Report.wGyroX;
-            report.Report.wGyroY = leftReport.Report.wGyroY;
-            report.Report.wGyroZ = leftReport.Report.wGyroZ;
-            break;
-
-        case GyroSource::Right:
-            report.Report.wAccelX = rightReport.Report.wAccelX;
-            report.Report.wAccelY = rightReport.Report.wAccelY;
-            report.Report.wAccelZ = rightReport.Report.wAccelZ;
-
-            report.Report.wGyroX = rightReport.Report.wGyroX;
-            report.Report.wGyroY = rightReport.Report.wGyroY;
-            report.Report.wGyroZ = rightReport.Report.wGyroZ;
-            break;
-
-        case GyroSource::Both:
-        default:
-            auto combine_16 = [](int16_t a, int16_t b) -> int16_t {
-                if (a == 0) return b;
-                if (b == 0) return a;
-                return static_cast<int16_t>((a / 2) + (b / 2));
-                };
-
-            report.Report.wAccelX = combine_16(leftReport.Report.wAccelX, rightReport.Report.wAccelX);
-            report.Report.wAccelY = combine_16(leftReport.Report.wAccelY, rightReport.Report.wAccelY);
-            report.Report.wAccelZ = combine_16(leftReport.Report.wAccelZ, rightReport.Report.wAccelZ);
-
-            report.Report.wGyroX = combine_16(leftReport.Report.wGyroX, rightReport.Report.wGyroX);
-            report.Report.wGyroY = combine_16(leftReport.Report.wGyroY, rightReport.Report.wGyroY);
-            report.Report.wGyroZ = combine_16(leftReport.Report.wGyroZ, rightReport.Report.wGyroZ);
-            break;
+    // Raw motion of the selected side(s), normalized once in the upright Joy-Con frame
+    MotionData leftMotion = left.length >= 0x3C ? left.motion : MotionData{};
+    MotionData rightMotion = right.length >= 0x3C ? right.motion : MotionData{};
+    MotionData motion;
+    if constexpr (Gyro == GyroSource::Left) {
+        motion = leftMotion;
     }
-
+    else if constexpr (Gyro == GyroSource::Right) {
+        motion = rightMotion;
+    }
+    else {
+        // Stateless per-frame average; the dual player overwrites it with DualImuFusion, which
+        // aligns the two streams in time and weights them by noise
+        auto combine_16 = [](int16_t a, int16_t b) -> int16_t {
+            if (a == 0) return b;
+            if (b == 0) return a;
+            return static_cast<int16_t>((a / 2) + (b / 2));
+            };
+
+        motion.accelX = combine_16(leftMotion.accelX, rightMotion.accelX);
+        motion.accelY = combine_16(leftMotion.accelY, rightMotion.accelY);
+        motion.accelZ = combine_16(leftMotion.accelZ, rightMotion.accelZ);
+
+        motion.gyroX = combine_16(leftMotion.gyroX, rightMotion.gyroX);
+        motion.gyroY = combine_16(leftMotion.gyroY, rightMotion.gyroY);
+        motion.gyroZ = combine_16(leftMotion.gyroZ, rightMotion.gyroZ);
+    }
+    WriteDS4Motion(report, NormalizeMotion(motion, SelectImuTransform(ControllerFamily::JoyCon2)));
 
     return report;
 }
 
-static std::pair<int16_t, int16_t> decode_pro_joystick(const uint8_t* data)
-{
-    if (!data) {
-        return { 0, 0 };
-    }
-
-    int x_raw = ((data[1] & 0x0F) << 8) | data[0];
-    int y_raw = (data[2] << 4) | ((data[1] & 0xF0) >> 4);
-
-    float x = (x_raw - 2048) / 2048.0f;
-    float y = (y_raw - 2048) / 2048.0f;
-
-    constexpr float deadzone = 0.08f;
-    if (std::abs(x) < deadzone && std::abs(y) < deadzone) {
-        return { 0, 0 };
+DualReportGenerator SelectDualReportGenerator(GyroSource gyroSource) {
+    switch (gyroSource) {
+    case GyroSource::Left:  return generate_dual_report<GyroSource::Left>;
+    case GyroSource::Right: return generate_dual_report<GyroSource::Right>;
+    default:                return generate_dual_report<GyroSource::Both>;
     }
+}
 
-    x = std::clamp(x * 1.7f, -1.0f, 1.0f);
-    y = std::clamp(y * 1.7f, -1.0f, 1.0f);
-
-    int16_t outX = static_cast<int16_t>(x * 32767);
-    int16_t outY = static_cast<int16_t>(y * 32767);
+DS4_REPORT_EX GenerateDualJoyConDS4Report(const JoyConInputFrame& left, const JoyConInputFrame& right, GyroSource gyroSource,
+    const StickLUT& leftStick, const StickLUT& rightStick)
+{
+    return SelectDualReportGenerator(gyroSource)(left, right, leftStick, rightStick);
+}
 
-    return { outX, outY };
+static std::pair<int16_t, int16_t> decode_pro_joystick(const RawStick& stick, const StickLUT& lut)
+{
+    return MapStick(lut, stick.x, stick.y);
 }
 
-constexpr uint64_t BUTTON_A_MASK = 0x000800000000;
-constexpr uint64_t BUTTON_B_MASK = 0x000400000000;
-constexpr uint64_t BUTTON_X_MASK = 0x000200000000;
-constexpr uint64_t BUTTON_Y_MASK = 0x000100000000;
-constexpr uint64_t BUTTON_R_SHOULDER = 0x004000000000;
-constexpr uint64_t BUTTON_L_SHOULDER = 0x000000400000;
-constexpr uint64_t BUTTON_DPAD_UP = 0x000000020000;
-constexpr uint64_t BUTTON_DPAD_RIGHT = 0x000000040000;
-constexpr uint64_t BUTTON_DPAD_DOWN = 0x000000010000;
-constexpr uint64_t BUTTON_DPAD_LEFT = 0x000000080000;
-constexpr uint64_t BUTTON_GUIDE = 0x000010000000;
-constexpr uint64_t BUTTON_BACK = 0x000001000000;
-constexpr uint64_t BUTTON_START = 0x000002000000;
-constexpr uint64_t BUTTON_R_THUMB = 0x000004000000;
-constexpr uint64_t BUTTON_L_THUMB = 0x000008000000;
-
-constexpr uint64_t TRIGGER_LT_MASK = 0x000000800000;
-constexpr uint64_t TRIGGER_RT_MASK = 0x008000000000;
-
-DS4_REPORT_EX GenerateProControllerReport(const std::vector<uint8_t>& buffer)
+DS4_REPORT_EX GenerateProControllerReport(const JoyConInputFrame& frame, const StickLUT& leftStick, const StickLUT& rightStick)
 {
     DS4_REPORT_EX report{};
     DS4_REPORT_INIT(reinterpret_cast<PDS4_REPORT>(&report.Report));
 
-    if (buffer.size() < 0x3C) {
+    if (frame.length < 0x3C) {
         return report;
     }
 
-    uint64_t state = 0;
-    for (int i = 3; i <= 8; ++i) {
-        state = (state << 8) | buffer[i];
-    }
+    uint64_t state = frame.buttons;
 
 	// Debug logging for key pressed/released events
     //static uint64_t lastState = 0;
@@ -371,148 +473,59 @@ DS4_REPORT_EX GenerateProControllerReport(const std::vector<uint8_t>& buffer)
     //}
     
 
-    if (state & BUTTON_A_MASK)        report.Report.wButtons |= DS4_BUTTON_CIRCLE;
-    if (state & BUTTON_B_MASK)        report.Report.wButtons |= DS4_BUTTON_CROSS;
-    if (state & BUTTON_X_MASK)        report.Report.wButtons |= DS4_BUTTON_TRIANGLE;
-    if (state & BUTTON_Y_MASK)        report.Report.wButtons |= DS4_BUTTON_SQUARE;
-    if (state & BUTTON_L_SHOULDER)    report.Report.wButtons |= DS4_BUTTON_SHOULDER_LEFT;
-    if (state & BUTTON_R_SHOULDER)    report.Report.wButtons |= DS4_BUTTON_SHOULDER_RIGHT;
-    if (state & BUTTON_L_THUMB)       report.Report.wButtons |= DS4_BUTTON_THUMB_LEFT;
-    if (state & BUTTON_R_THUMB)       report.Report.wButtons |= DS4_BUTTON_THUMB_RIGHT;
-    if (state & BUTTON_BACK)          report.Report.bSpecial |= DS4_SPECIAL_BUTTON_TOUCHPAD;
-    if (state & BUTTON_START)         report.Report.wButtons |= DS4_BUTTON_OPTIONS;
-    if (state & BUTTON_GUIDE)         report.Report.bSpecial |= DS4_SPECIAL_BUTTON_PS;
-
-    bool up = (state & BUTTON_DPAD_UP) != 0;
-    bool down = (state & BUTTON_DPAD_DOWN) != 0;
-    bool left = (state & BUTTON_DPAD_LEFT) != 0;
-    bool right = (state & BUTTON_DPAD_RIGHT) != 0;
-
-    uint8_t dpad = DS4_BUTTON_DPAD_NONE;
-    if (up && left) dpad = DS4_BUTTON_DPAD_NORTHWEST;
-    else if (up && right) dpad = DS4_BUTTON_DPAD_NORTHEAST;
-    else if (down && left) dpad = DS4_BUTTON_DPAD_SOUTHWEST;
-    else if (down && right) dpad = DS4_BUTTON_DPAD_SOUTHEAST;
-    else if (up) dpad = DS4_BUTTON_DPAD_NORTH;
-    else if (down) dpad = DS4_BUTTON_DPAD_SOUTH;
-    else if (left) dpad = DS4_BUTTON_DPAD_WEST;
-    else if (right) dpad = DS4_BUTTON_DPAD_EAST;
-
-    DS4_SET_DPAD(reinterpret_cast<PDS4_REPORT>(&report.Report), static_cast<DS4_DPAD_DIRECTIONS>(dpad));
-
-    report.Report.bTriggerL = (state & TRIGGER_LT_MASK) ? 255 : 0;
-    report.Report.bTriggerR = (state & TRIGGER_RT_MASK) ? 255 : 0;
-
-    auto [lx, ly] = decode_pro_joystick(&buffer[10]);
+    uint32_t mapped = lookup_buttons(PRO_BUTTON_TABLE, state);
+    report.Report.wButtons = static_cast<USHORT>(mapped);
+    report.Report.bSpecial = static_cast<BYTE>(mapped >> 16);
+
+    report.Report.bTriggerL = full_if(state, TRIGGER_LT_MASK);
+    report.Report.bTriggerR = full_if(state, TRIGGER_RT_MASK);
+
+    auto [lx, ly] = decode_pro_joystick(frame.leftStick, leftStick);
     ly = -ly;
-    auto [rx, ry] = decode_pro_joystick(&buffer[13]);
+    auto [rx, ry] = decode_pro_joystick(frame.rightStick, rightStick);
     ry = -ry;
 
-    report.Report.bThumbLX = static_cast<uint8_t>((lx / 32767.0f) * 127 + 128);
-    report.Report.bThumbLY = static_cast<uint8_t>((ly / 32767.0f) * 127 + 128);
-    report.Report.bThumbRX = static_cast<uint8_t>((rx / 32767.0f) * 127 + 128);
-    report.Report.bThumbRY = static_cast<uint8_t>((ry / 32767.0f) * 127 + 128);
+    report.Report.bThumbLX = StickToByte(lx);
+    report.Report.bThumbLY = StickToByte(ly);
+    report.Report.bThumbRX = StickToByte(rx);
+    report.Report.bThumbRY = StickToByte(ry);
 
-    report.Report.wAccelX = to_signed_16(buffer[0x30], buffer[0x31]);
-    report.Report.wAccelY = to_signed_16(buffer[0x32], buffer[0x33]);
-    report.Report.wAccelZ = to_signed_16(buffer[0x34], buffer[0x35]);
-    report.Report.wGyroX = to_signed_16(buffer[0x36], buffer[0x37]);
-    report.Report.wGyroY = to_signed_16(buffer[0x38], buffer[0x39]);
-    report.Report.wGyroZ = to_signed_16(buffer[0x3A], buffer[0x3B]);
+    WriteDS4Motion(report, NormalizeMotion(frame.motion, SelectImuTransform(ControllerFamily::ProController2)));
 
     return report;
 }
 
-DS4_REPORT_EX GenerateNSOGCReport(const std::vector<uint8_t>& buffer)
+DS4_REPORT_EX GenerateNSOGCReport(const JoyConInputFrame& frame, const StickLUT& leftStick, const StickLUT& rightStick)
 {
     DS4_REPORT_EX report{};
     DS4_REPORT_INIT(reinterpret_cast<PDS4_REPORT>(&report.Report));
 
-    // Need at least 0x3E bytes: indices 0x3c and 0x3d are accessed for trigger values
-    if (buffer.size() < 0x3E) {
+    // Need at least 0x3E bytes: indices 0x3c and 0x3d carry the analog trigger values
+    if (frame.length < 0x3E) {
         return report;
     }
 
-    uint64_t state = 0;
-    for (int i = 3; i <= 8; ++i) {
-        state = (state << 8) | buffer[i];
-    }
+    uint64_t state = frame.buttons;
+
+    uint32_t mapped = lookup_buttons(NSOGC_BUTTON_TABLE, state);
+    report.Report.wButtons = static_cast<USHORT>(mapped);
+    report.Report.bSpecial = static_cast<BYTE>(mapped >> 16);
 
-    if (state & BUTTON_A_MASK)        report.Report.wButtons |= DS4_BUTTON_CIRCLE;
-    if (state & BUTTON_B_MASK)        report.Report.wButtons |= DS4_BUTTON_TRIANGLE;
-    if (state & BUTTON_X_MASK)        report.Report.wButtons |= DS4_BUTTON_CROSS;
-    if (state & BUTTON_Y_MASK)        report.Report.wButtons |= DS4_BUTTON_SQUARE;
-    if (state & BUTTON_L_SHOULDER)    report.Report.wButtons |= DS4_BUTTON_SHOULDER_LEFT;
-    if (state & BUTTON_R_SHOULDER)    report.Report.wButtons |= DS4_BUTTON_SHOULDER_RIGHT;
-    if (state & TRIGGER_LT_MASK)      report.Report.wButtons |= DS4_BUTTON_TRIGGER_LEFT;
-    if (state & TRIGGER_RT_MASK)      report.Report.wButtons |= DS4_BUTTON_TRIGGER_RIGHT;
-    if (state & BUTTON_L_THUMB)       report.Report.wButtons |= DS4_BUTTON_THUMB_LEFT;
-    if (state & BUTTON_R_THUMB)       report.Report.wButtons |= DS4_BUTTON_THUMB_RIGHT;
-    if (state & BUTTON_BACK)          report.Report.wButtons |= DS4_BUTTON_SHARE;
-    if (state & BUTTON_START)         report.Report.wButtons |= DS4_BUTTON_OPTIONS;
-    if (state & BUTTON_GUIDE)         report.Report.bSpecial |= DS4_SPECIAL_BUTTON_PS;
-
-    bool up = (state & BUTTON_DPAD_UP) != 0;
-    bool down = (state & BUTTON_DPAD_DOWN) != 0;
-    bool left = (state & BUTTON_DPAD_LEFT) != 0;
-    bool right = (state & BUTTON_DPAD_RIGHT) != 0;
-
-    uint8_t dpad = DS4_BUTTON_DPAD_NONE;
-    if (up && left) dpad = DS4_BUTTON_DPAD_NORTHWEST;
-    else if (up && right) dpad = DS4_BUTTON_DPAD_NORTHEAST;
-    else if (down && left) dpad = DS4_BUTTON_DPAD_SOUTHWEST;
-    else if (down && right) dpad = DS4_BUTTON_DPAD_SOUTHEAST;
-    else if (up) dpad = DS4_BUTTON_DPAD_NORTH;
-    else if (down) dpad = DS4_BUTTON_DPAD_SOUTH;
-    else if (left) dpad = DS4_BUTTON_DPAD_WEST;
-    else if (right) dpad = DS4_BUTTON_DPAD_EAST;
-
-    DS4_SET_DPAD(reinterpret_cast<PDS4_REPORT>(&report.Report), static_cast<DS4_DPAD_DIRECTIONS>(dpad));
-
-    report.Report.bTriggerL = buffer[0x3c];
-    report.Report.bTriggerR = buffer[0x3d];
-
-    auto [lx, ly] = decode_pro_joystick(&buffer[10]);
+    report.Report.bTriggerL = frame.triggerL;
+    report.Report.bTriggerR = frame.triggerR;
+
+    auto [lx, ly] = decode_pro_joystick(frame.leftStick, leftStick);
     ly = -ly;
-    auto [rx, ry] = decode_pro_joystick(&buffer[13]);
+    auto [rx, ry] = decode_pro_joystick(frame.rightStick, rightStick);
     ry = -ry;
 
-    report.Report.bThumbLX = static_cast<uint8_t>((lx / 32767.0f) * 127 + 128);
-    report.Report.bThumbLY = static_cast<uint8_t>((ly / 32767.0f) * 127 + 128);
-    report.Report.bThumbRX = static_cast<uint8_t>((rx / 32767.0f) * 127 + 128);
-    report.Report.bThumbRY = static_cast<uint8_t>((ry / 32767.0f) * 127 + 128);
+    report.Report.bThumbLX = StickToByte(lx);
+    report.Report.bThumbLY = StickToByte(ly);
+    report.Report.bThumbRX = StickToByte(rx);
+    report.Report.bThumbRY = StickToByte(ry);
 
-    report.Report.wAccelX = to_signed_16(buffer[0x30], buffer[0x31]);
-    report.Report.wAccelY = to_signed_16(buffer[0x32], buffer[0x33]);
-    report.Report.wAccelZ = to_signed_16(buffer[0x34], buffer[0x35]);
-    report.Report.wGyroX = to_signed_16(buffer[0x36], buffer[0x37]);
-    report.Report.wGyroY = to_signed_16(buffer[0x38], buffer[0x39]);
-    report.Report.wGyroZ = to_signed_16(buffer[0x3A], buffer[0x3B]);
+    WriteDS4Motion(report, NormalizeMotion(frame.motion, SelectImuTransform(ControllerFamily::NSOGC)));
 
     return report;
 }
 
-
-uint32_t ExtractButtonState(const std::vector<uint8_t>& buffer) {
-    if (buffer.size() < 6) return 0;
-    return (buffer[3] << 16) | (buffer[4] << 8) | buffer[5];
-}
-
-std::pair<int16_t, int16_t> GetRawOpticalMouse(const std::vector<uint8_t>& buffer) {
-    if (buffer.size() < 0x18) return { 0, 0 };
-    int16_t raw_x = to_signed_16(buffer[0x10], buffer[0x11]);
-    int16_t raw_y = to_signed_16(buffer[0x12], buffer[0x13]);
-    return { raw_x, raw_y };
-}
-
-MotionData DecodeMotion(const std::vector<uint8_t>& buffer) {
-    MotionData m{};
-    if (buffer.size() < 0x3C) return m;
-    m.accelX = to_signed_16(buffer[0x30], buffer[0x31]);
-    m.accelY = to_signed_16(buffer[0x32], buffer[0x33]);
-    m.accelZ = to_signed_16(buffer[0x34], buffer[0x35]);
-    m.gyroX  = to_signed_16(buffer[0x36], buffer[0x37]);
-    m.gyroY  = to_signed_16(buffer[0x38], buffer[0x39]);
-    m.gyroZ  = to_signed_16(buffer[0x3A], buffer[0x3B]);
-    return m;
-}
@@ -2,8 +2,11 @@
 #include <vector>
 #include <utility>
 #include <cstdint>
-#include <Windows.h>
-#include <ViGEm/Client.h>
+#include <cstddef>
+#include <span>
+#include "DS4Report.h"
+#include "StickCalibration.h"
+#include "FrameLayout.h"
 
 enum class JoyConSide { Left, Right };
 enum class JoyConOrientation { Upright, Sideways };
@@ -21,13 +24,66 @@ struct MotionData {
     SHORT accelX, accelY, accelZ;
 };
 
-// Pass side and orientation explicitly now:
-DS4_REPORT_EX GenerateDS4Report(const std::vector<uint8_t>& buffer, JoyConSide side, JoyConOrientation orientation);
-DS4_REPORT_EX GenerateDualJoyConDS4Report(const std::vector<uint8_t>& leftBuffer, const std::vector<uint8_t>& rightBuffer, GyroSource gyroSource);
-DS4_REPORT_EX GenerateProControllerReport(const std::vector<uint8_t>& buffer);
-DS4_REPORT_EX GenerateNSOGCReport(const std::vector<uint8_t>& buffer);
+// Notifications are decoded from a fixed-size view; bytes past the received length must be zero
+constexpr size_t JOYCON_FRAME_SIZE = 64;
+using JoyConFrameView = std::span<const uint8_t, JOYCON_FRAME_SIZE>;
 
-uint32_t ExtractButtonState(const std::vector<uint8_t>& buffer);
-std::pair<int16_t, int16_t> GetRawOpticalMouse(const std::vector<uint8_t>& buffer);
-StickData DecodeJoystick(const std::vector<uint8_t>& buffer, JoyConSide side, JoyConOrientation orientation);
-MotionData DecodeMotion(const std::vector<uint8_t>& buffer);
+// Raw 12-bit stick position as packed in the notification (center ~2048)
+struct RawStick {
+    uint16_t x = 2048;
+    uint16_t y = 2048;
+};
+
+// Canonical input frame: every field of a notification, decoded exactly once
+struct JoyConInputFrame {
+    uint32_t length = 0;        // payload bytes received (capped at JOYCON_FRAME_SIZE)
+    uint64_t buttons = 0;       // 48-bit button state, bytes 3..8 big-endian
+    RawStick leftStick;         // bytes 10..12
+    RawStick rightStick;        // bytes 13..15
+    int16_t opticalX = 0;       // bytes 0x10..0x13
+    int16_t opticalY = 0;
+    MotionData motion{};        // bytes 0x30..0x3B
+    uint8_t triggerL = 0;       // bytes 0x3C..0x3D (NSO GC analog triggers)
+    uint8_t triggerR = 0;
+
+    // 24-bit single Joy-Con button word: the left layout starts one byte later than the right
+    uint32_t JoyConButtons(JoyConSide side) const {
+        return static_cast<uint32_t>(buttons >> (side == JoyConSide::Left ? 16 : 24)) & 0xFFFFFF;
+    }
+};
+
+// Decodes with the Joy-Con 2 layout; SelectFrameDecoder picks the decoder for another family
+JoyConInputFrame DecodeInputFrame(JoyConFrameView raw, size_t length);
+
+using FrameDecoder = JoyConInputFrame (*)(JoyConFrameView raw, size_t length);
+FrameDecoder SelectFrameDecoder(ControllerFamily family, uint32_t firmware = 0);
+
+// Pass side and orientation explicitly now. Sticks map through per-stick lookup tables
+// (see StickCalibration.h); the defaults reproduce the uncalibrated behavior.
+DS4_REPORT_EX GenerateDS4Report(const JoyConInputFrame& frame, JoyConSide side, JoyConOrientation orientation,
+    const StickLUT& stick = DefaultStickLUT());
+DS4_REPORT_EX GenerateDualJoyConDS4Report(const JoyConInputFrame& left, const JoyConInputFrame& right, GyroSource gyroSource,
+    const StickLUT& leftStick = DefaultStickLUT(), const StickLUT& rightStick = DefaultStickLUT());
+DS4_REPORT_EX GenerateProControllerReport(const JoyConInputFrame& frame,
+    const StickLUT& leftStick = DefaultStickLUT(), const StickLUT& rightStick = DefaultStickLUT());
+DS4_REPORT_EX GenerateNSOGCReport(const JoyConInputFrame& frame,
+    const StickLUT& leftStick = DefaultStickLUT(), const StickLUT& rightStick = DefaultStickLUT());
+
+StickData DecodeJoystick(const JoyConInputFrame& frame, JoyConSide side, JoyConOrientation orientation,
+    const StickLUT& lut = DefaultStickLUT());
+
+// Optical sensor position on the 1920x943 DS4 touchpad (centered when the frame has no optical data)
+std::pair<uint16_t, uint16_t> DecodeMouseCoords(const JoyConInputFrame& frame);
+
+// Generators specialized for one side/orientation/gyro source. Players select theirs once at
+// connect time, so the per-frame path carries no configuration branches; the functions above
+// dispatch through the same tables.
+using SingleReportGenerator = DS4_REPORT_EX (*)(const JoyConInputFrame& frame, const StickLUT& stick);
+using DualReportGenerator = DS4_REPORT_EX (*)(const JoyConInputFrame& left, const JoyConInputFrame& right,
+    const StickLUT& leftStick, const StickLUT& rightStick);
+using JoystickDecoder = StickData (*)(const JoyConInputFrame& frame, const StickLUT& lut);
+
+SingleReportGenerator SelectDS4ReportGenerator(JoyConSide side, JoyConOrientation orientation);
+DualReportGenerator SelectDualReportGenerator(GyroSource gyroSource);
+JoystickDecoder SelectJoystickDecoder(JoyConSide side, JoyConOrientation orientation);
+MotionData DecodeMotion(JoyConFrameView raw);
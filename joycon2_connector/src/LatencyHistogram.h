@@ -0,0 +1,69 @@
+#pragma once
+// LatencyHistogram - Log-linear histogram of microsecond durations. One thread records, any
+// thread reads (the dashboard); recording is a few relaxed atomic adds, no locks, no allocation.
+// Each power of two is split into SUB_BUCKETS, so percentiles are within 1/SUB_BUCKETS (12.5%).
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+class LatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKETS = 8;
+    static constexpr uint32_t SUB_BITS = 3;
+    static constexpr int64_t MAX_US = (int64_t(1) << 31) - 1;   // larger values are clamped
+    static constexpr uint32_t BUCKETS = SUB_BUCKETS + (31 - SUB_BITS) * SUB_BUCKETS;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Writer
+    void Record(int64_t us) {
+        us = std::clamp<int64_t>(us, 0, MAX_US);
+        buckets[BucketOf(static_cast<uint32_t>(us))].fetch_add(1, std::memory_order_relaxed);
+        totalUs.fetch_add(static_cast<uint64_t>(us), std::memory_order_relaxed);
+        if (us > maxUs.load(std::memory_order_relaxed)) maxUs.store(us, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_release);
+    }
+
+    uint64_t Count() const { return count.load(std::memory_order_acquire); }
+    int64_t MaxUs() const { return maxUs.load(std::memory_order_relaxed); }
+    double MeanUs() const {
+        uint64_t n = Count();
+        return n ? static_cast<double>(totalUs.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    // Upper bound of the bucket holding the p-th fraction (0..1) of samples; 0 when empty
+    int64_t PercentileUs(double p) const {
+        uint64_t n = 0;
+        uint64_t counts[BUCKETS];
+        for (uint32_t i = 0; i < BUCKETS; ++i) n += counts[i] = buckets[i].load(std::memory_order_relaxed);
+        if (n == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(std::clamp(p, 0.0, 1.0) * (n - 1)) + 1;
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return (std::min)(UpperBound(i), MaxUs());
+        }
+        return MaxUs();
+    }
+
+    static uint32_t BucketOf(uint32_t us) {
+        if (us < SUB_BUCKETS) return us;
+        uint32_t shift = std::bit_width(us) - 1 - SUB_BITS;
+        return SUB_BUCKETS + shift * SUB_BUCKETS + ((us >> shift) & (SUB_BUCKETS - 1));
+    }
+    static int64_t UpperBound(uint32_t bucket) {
+        if (bucket < SUB_BUCKETS) return bucket;
+        uint32_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+        int64_t lower = static_cast<int64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return lower + (int64_t(1) << shift) - 1;
+    }
+
+private:
+    std::atomic<uint64_t> buckets[BUCKETS] = {};
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> totalUs{ 0 };
+    std::atomic<int64_t> maxUs{ 0 };
+};
@@ -0,0 +1,57 @@
+#include "MotionFusion.h"
+#include <cmath>
+
+constexpr float DEG_TO_RAD = 3.14159265358979f / 180.0f;
+constexpr float GYRO_TO_RAD_S = DEG_TO_RAD / IMU_GYRO_COUNTS_PER_DPS;
+constexpr float ACCEL_TO_G = 1.0f / IMU_ACCEL_COUNTS_PER_G;
+// Outside this band the accelerometer sees more than gravity (shaking, swinging) and is ignored
+constexpr float MIN_GRAVITY_G = 0.7f;
+constexpr float MAX_GRAVITY_G = 1.3f;
+
+static Vec3 gravity_of(const Quaternion& q) {
+    return { 2.0f * (q.x * q.z - q.w * q.y),
+             2.0f * (q.w * q.x + q.y * q.z),
+             q.w * q.w - q.x * q.x - q.y * q.y + q.z * q.z };
+}
+
+void MotionFusion::Update(const MotionData& m) {
+    Vec3 g{ m.gyroX * GYRO_TO_RAD_S, m.gyroY * GYRO_TO_RAD_S, m.gyroZ * GYRO_TO_RAD_S };
+    rate = g;
+
+    Vec3 a{ m.accelX * ACCEL_TO_G, m.accelY * ACCEL_TO_G, m.accelZ * ACCEL_TO_G };
+    float norm = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+    if (norm > MIN_GRAVITY_G && norm < MAX_GRAVITY_G) {
+        a.x /= norm; a.y /= norm; a.z /= norm;
+        // Error between measured and estimated up, as a rotation axis scaled by its sine
+        Vec3 e{ a.y * gravity.z - a.z * gravity.y,
+                a.z * gravity.x - a.x * gravity.z,
+                a.x * gravity.y - a.y * gravity.x };
+        if (ki > 0.0f) {
+            integral.x += ki * e.x * period;
+            integral.y += ki * e.y * period;
+            integral.z += ki * e.z * period;
+        }
+        g.x += kp * e.x + integral.x;
+        g.y += kp * e.y + integral.y;
+        g.z += kp * e.z + integral.z;
+    }
+
+    // q += 0.5 * q * (0, g) * dt
+    float hx = 0.5f * period * g.x, hy = 0.5f * period * g.y, hz = 0.5f * period * g.z;
+    Quaternion p = q;
+    q.w += -p.x * hx - p.y * hy - p.z * hz;
+    q.x += p.w * hx + p.y * hz - p.z * hy;
+    q.y += p.w * hy - p.x * hz + p.z * hx;
+    q.z += p.w * hz + p.x * hy - p.y * hx;
+    float inv = 1.0f / std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    q.w *= inv; q.x *= inv; q.y *= inv; q.z *= inv;
+
+    gravity = gravity_of(q);
+}
+
+void MotionFusion::Reset() {
+    q = Quaternion{};
+    gravity = Vec3{ 0.0f, 0.0f, 1.0f };
+    rate = Vec3{};
+    integral = Vec3{};
+}
@@ -0,0 +1,45 @@
+#pragma once
+// Orientation fusion (Mahony complementary filter): integrates the gyro into a quaternion and
+// pulls it towards the accelerometer's gravity direction. One per IMU, updated on every frame
+// with a fixed step; no allocation.
+#include "ImuNormalization.h"
+
+struct Vec3 {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+// Rotation from the sensor frame to the world frame (world Z is up)
+struct Quaternion {
+    float w = 1.0f, x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+class MotionFusion {
+public:
+    static constexpr float DEFAULT_PERIOD_S = 0.015f;
+
+    // kp: how hard the accelerometer pulls (1/s); ki: gyro bias the filter may absorb on its own
+    explicit MotionFusion(float kp = 0.5f, float ki = 0.0f) : kp(kp), ki(ki) {}
+
+    // Integration step; the players keep it at the measured notification period
+    void SetSamplePeriod(float seconds) { if (seconds > 0.0f) period = seconds; }
+    void SetSamplePeriodUs(double us) { SetSamplePeriod(static_cast<float>(us * 1e-6)); }
+    float SamplePeriod() const { return period; }
+
+    // One fixed step with a bias-corrected sample in raw counts
+    void Update(const MotionData& motion);
+    void Reset();
+
+    const Quaternion& Orientation() const { return q; }
+    // Unit "up" direction in the sensor frame (what a resting accelerometer reads)
+    const Vec3& Gravity() const { return gravity; }
+    // Angular rate of the last sample in rad/s, sensor frame
+    const Vec3& AngularVelocity() const { return rate; }
+
+private:
+    float kp, ki;
+    float period = DEFAULT_PERIOD_S;
+    Quaternion q;
+    Vec3 gravity{ 0.0f, 0.0f, 1.0f };
+    Vec3 rate;
+    Vec3 integral;
+};
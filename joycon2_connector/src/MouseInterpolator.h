@@ -0,0 +1,94 @@
+#pragma once
+// MouseInterpolator - Spreads each BLE optical-mouse delta across high-rate output ticks
+#include <algorithm>
+#include <chrono>
+
+// Output rates the interpolation thread supports
+inline int ClampInterpolationRate(int rateHz) {
+    return (std::min)((std::max)(rateHz, 100), 1000);
+}
+
+// Exponential moving average of the BLE report interval (outliers are ignored)
+inline float SmoothReportInterval(float prevMs, float dtMs) {
+    if (dtMs > 1.0f && dtMs < 100.0f) return prevMs * 0.7f + dtMs * 0.3f;
+    return prevMs;
+}
+
+struct MouseMove {
+    int dx = 0;
+    int dy = 0;
+};
+
+// Per-player interpolation state, driven by the interpolation thread
+struct MouseInterpolator {
+    float remainX = 0.0f, remainY = 0.0f;
+    float accumX = 0.0f, accumY = 0.0f;
+    int ticksLeft = 0;
+    float perTickX = 0.0f, perTickY = 0.0f;
+    std::chrono::steady_clock::time_point lastActivity{};
+
+    // Start distributing a new BLE delta over the ticks that fit into one report interval
+    void OnReport(float dx, float dy, float reportIntervalMs, float tickMs,
+                  std::chrono::steady_clock::time_point now) {
+        // Replace old remainder — new report cancels any unfinished old movement
+        // This prevents inertia when the user stops suddenly
+        remainX = dx;
+        remainY = dy;
+
+        if (dx == 0.0f && dy == 0.0f) {
+            // Zero movement: immediately stop all interpolation
+            ticksLeft = 0;
+            perTickX = 0.0f;
+            perTickY = 0.0f;
+        } else {
+            float interval = (std::min)((std::max)(reportIntervalMs, 5.0f), 50.0f);
+            int ticks = (std::max)(1, static_cast<int>(interval / tickMs));
+
+            perTickX = remainX / ticks;
+            perTickY = remainY / ticks;
+            ticksLeft = ticks;
+        }
+        lastActivity = now;
+    }
+
+    // Advance one output tick and return the whole-pixel movement to emit
+    MouseMove Tick(std::chrono::steady_clock::time_point now) {
+        MouseMove move;
+        if (ticksLeft > 0) {
+            accumX += perTickX;
+            accumY += perTickY;
+            remainX -= perTickX;
+            remainY -= perTickY;
+            ticksLeft--;
+
+            move.dx = static_cast<int>(accumX);
+            move.dy = static_cast<int>(accumY);
+            accumX -= move.dx;
+            accumY -= move.dy;
+
+            // When done distributing, send any final remainder (clears floating point dust)
+            if (ticksLeft == 0) {
+                accumX += remainX;
+                accumY += remainY;
+                int finalX = static_cast<int>(accumX);
+                int finalY = static_cast<int>(accumY);
+                accumX -= finalX;
+                accumY -= finalY;
+                move.dx += finalX;
+                move.dy += finalY;
+                remainX = 0.0f;
+                remainY = 0.0f;
+            }
+        } else {
+            // Decay any residual accumulation after inactivity (>50ms)
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastActivity).count();
+            if (elapsed > 50) {
+                accumX = 0.0f;
+                accumY = 0.0f;
+                remainX = 0.0f;
+                remainY = 0.0f;
+            }
+        }
+        return move;
+    }
+};
@@ -5,13 +5,34 @@
 #include "BLECommands.h"
 #include "ConfigManager.h"
 #include "JoyConDecoder.h"
+#include "StickCalibrator.h"
+#include "GyroCalibration.h"
+#include "MotionFusion.h"
+#include "PlayerPipeline.h"
+#include "GyroMouse.h"
+#include "GyroStick.h"
+#include "DualImuFusion.h"
+#include "ImuNormalization.h"
+#include "DsuServer.h"
+#include "DualMerge.h"
+#include "CaptureFile.h"
+#include "FramePool.h"
+#include "LatencyHistogram.h"
+#include "FrameRing.h"
+#include "GattInputTransport.h"
+#include "MouseInterpolator.h"
+#include "TouchpadEncoder.h"
+#include "SensorClock.h"
+#include "VibrationMapping.h"
 #include <vector>
+#include <array>
+#include <cstring>
 #include <memory>
 #include <thread>
 #include <atomic>
 #include <mutex>
-#include <condition_variable>
 #include <string>
+#include <cstdio>
 #include <Windows.h>
 
 // Vibration callback context passed to ViGEm as UserData
@@ -45,23 +66,11 @@ inline VOID CALLBACK DS4VibrationCallback(
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - ctx->lastSendTime).count();
     if (elapsed < VibrationContext::MIN_INTERVAL_MS) return;
 
-    // Apply intensity scaling
-    float scaledLarge = LargeMotor * vibConfig.intensity;
-    float scaledSmall = SmallMotor * vibConfig.intensity;
-    uint8_t motorL = static_cast<uint8_t>((std::min)(scaledLarge, 255.0f));
-    uint8_t motorR = static_cast<uint8_t>((std::min)(scaledSmall, 255.0f));
-
-    // Map motor values to predefined vibration samples
-    uint8_t sample;
-    if (motorL == 0 && motorR == 0) {
-        sample = VIB_NONE;
-    } else if (motorL > 180 || motorR > 180) {
-        sample = VIB_BUZZ;           // Strong sustained vibration
-    } else if (motorL > 80 || motorR > 80) {
-        sample = VIB_STRONG_THUNK;   // Medium impact
-    } else {
-        sample = VIB_DUN;            // Light feedback
-    }
+    // Apply intensity scaling and map motor values to predefined vibration samples
+    VibrationMotors motors = ScaleVibration(LargeMotor, SmallMotor, vibConfig.intensity);
+    uint8_t motorL = motors.left;
+    uint8_t motorR = motors.right;
+    uint8_t sample = SelectVibrationSample(motors);
 
     // Skip if same sample as last sent
     if (sample == ctx->lastSample && sample != VIB_NONE) return;
@@ -87,6 +96,116 @@ inline VOID CALLBACK DS4VibrationCallback(
     }
 }
 
+// Processing stage of one controller: the BLE callback only stamps the arrival time and copies
+// the notification into the ring; this thread decodes it and does all the output (ViGEm,
+// SendInput, DSU, config saves), so a slow consumer never holds up the WinRT callback thread.
+struct FrameStage {
+    FrameRing ring;
+    std::atomic<bool> running{ false };
+    std::thread thread;
+
+    explicit FrameStage(FrameRingMode mode) : ring(mode) {}
+    ~FrameStage() { Stop(); }
+
+    // process(JoyConFrameView raw, uint32_t length, int64_t arrivalUs) runs on the stage thread
+    template <class Process>
+    void Start(Process process, int priority) {
+        running.store(true, std::memory_order_release);
+        thread = std::thread([this, process = std::move(process), priority]() mutable {
+            SetThreadPriority(GetCurrentThread(), priority);
+            while (running.load(std::memory_order_acquire)) {
+                ring.Drain(process);
+                ring.Wait();
+            }
+        });
+    }
+    // Frames still queued are dropped
+    void Stop() {
+        running.store(false, std::memory_order_release);
+        ring.Wake();
+        if (thread.joinable()) thread.join();
+    }
+};
+
+inline std::shared_ptr<FrameStage> CreateFrameStage() {
+    bool latestOnly = ConfigManager::Instance().config.pipelineConfig.latestOnly;
+    return std::make_shared<FrameStage>(latestOnly ? FrameRingMode::LatestOnly : FrameRingMode::Queue);
+}
+
+// The notification handler shares ownership of the stage, so a notification still in flight
+// while the player is removed lands in a valid (stopped) ring. It also copies each notification
+// into the controller's capture channel; the capture writer thread does the file work.
+inline bool FeedFrameStage(IInputTransport& transport, std::shared_ptr<FrameStage> stage) {
+    return transport.Subscribe([stage = std::move(stage),
+                                capture = CaptureSession::Instance().OpenChannel(transport.Address(), transport.Family())]
+                               (const uint8_t* data, size_t length, int64_t arrivalUs) {
+        capture->Notification(data, length, arrivalUs);
+        stage->ring.Push(data, length, arrivalUs);
+    });
+}
+
+// Calibration is learned per physical controller, keyed by its Bluetooth address
+inline std::string ControllerDeviceId(const ConnectedJoyCon& cj) {
+    char id[17];
+    std::snprintf(id, sizeof(id), "%012llX", static_cast<unsigned long long>(cj.device ? cj.device.BluetoothAddress() : 0));
+    return id;
+}
+
+inline std::unique_ptr<ControllerStickCalibration> CreateStickCalibration(const ConnectedJoyCon& cj, bool hasLeft, bool hasRight) {
+    std::string id = ControllerDeviceId(cj);
+    const StickCalibrationRecord* saved = ConfigManager::Instance().FindStickCalibration(id);
+    return std::make_unique<ControllerStickCalibration>(id, hasLeft, hasRight, saved);
+}
+
+inline std::unique_ptr<GyroCalibration> CreateGyroCalibration(const ConnectedJoyCon& cj) {
+    std::string id = ControllerDeviceId(cj);
+    return std::make_unique<GyroCalibration>(id, ConfigManager::Instance().FindGyroCalibration(id));
+}
+
+inline std::unique_ptr<PlayerPipeline> CreatePlayerPipeline(const ConnectedJoyCon& cj, ControllerFamily family,
+                                                            JoyConSide side = JoyConSide::Left,
+                                                            JoyConOrientation orientation = JoyConOrientation::Upright) {
+    std::string id = ControllerDeviceId(cj);
+    auto& cm = ConfigManager::Instance();
+    return std::make_unique<PlayerPipeline>(family, side, orientation, id, cm.FindStickCalibration(id), cm.FindGyroCalibration(id));
+}
+
+// Rebuild the stick tables on the report thread when the active stick profile was edited
+inline void RefreshStickCurves(ControllerStickCalibration* sticks) {
+    auto& cm = ConfigManager::Instance();
+    uint32_t revision = cm.StickProfileRevision();
+    if (revision == sticks->CurveRevision()) return;
+    StickProfile profile = cm.ActiveStickProfile();
+    sticks->SetCurves(profile.left, profile.right, revision);
+}
+
+inline void SaveStickCalibration(const ControllerStickCalibration* sticks) {
+    if (!sticks || !sticks->Learned()) return;
+    ConfigManager::Instance().StoreStickCalibration(sticks->Snapshot());
+    ConfigManager::Instance().Save();
+}
+
+inline void SaveGyroCalibration(const GyroCalibration* gyro) {
+    if (!gyro || !gyro->Learned()) return;
+    ConfigManager::Instance().StoreGyroCalibration(gyro->Snapshot());
+    ConfigManager::Instance().Save();
+}
+
+// Gyro to right stick, on the thread that builds the report
+inline void ApplyGyroStick(GyroStick& stick, const MotionFusion& fusion, const ImuTransform& transform, DS4_REPORT_EX& report) {
+    stick.Process(fusion, transform, ConfigManager::Instance().config.gyroStickConfig, report);
+}
+
+// Cemuhook DSU: the finished report plus the bias-corrected motion at full resolution
+inline void PublishDsu(DsuServer& dsu, int slot, const DS4_REPORT_EX& report, const MotionData& motion,
+                       const ImuTransform& transform, int64_t arrivalUs) {
+    if (slot < 0 || !dsu.Running()) return;
+    DsuMotion m;
+    m.timestampUs = static_cast<uint64_t>(arrivalUs);
+    NormalizeMotionUnits(motion, transform, m.accelG, m.gyroDps);
+    dsu.Publish(slot, report, m);
+}
+
 enum class ControllerType {
     SingleJoyCon = 1,
     DualJoyCon = 2,
@@ -121,6 +240,8 @@ struct SingleJoyConPlayer {
     // Sub-pixel accumulation for smooth mouse movement (direct mode fallback)
     float accumX = 0.0f;
     float accumY = 0.0f;
+    // Flick stick state (gyro mouse modes)
+    FlickStick flickStick;
     // Vibration context for ViGEm callback
     std::unique_ptr<VibrationContext> vibCtx;
     // Interpolation state for high-frequency mouse output
@@ -131,6 +252,14 @@ struct SingleJoyConPlayer {
     std::chrono::steady_clock::time_point lastBLETimestamp{};
     std::atomic<float> reportIntervalMs{ 15.0f };
     bool bleTimestampInitialized = false;
+    // Calibration, fusion, gyro stick, touchpad and sensor clock (owned here, used by the stage)
+    std::unique_ptr<PlayerPipeline> pipeline;
+    // Cemuhook DSU slot (-1 when all are taken)
+    int dsuSlot = -1;
+    // Delivers the notifications into the stage
+    std::unique_ptr<IInputTransport> transport;
+    // Decodes and reports the notifications queued by the BLE callback
+    std::shared_ptr<FrameStage> stage;
 
     // Move constructor & assignment (std::atomic is non-copyable)
     SingleJoyConPlayer() = default;
@@ -145,12 +274,15 @@ struct SingleJoyConPlayer {
           mb4Pressed(o.mb4Pressed), mb5Pressed(o.mb5Pressed),
           leftBtnPressed(o.leftBtnPressed), rightBtnPressed(o.rightBtnPressed),
           middleBtnPressed(o.middleBtnPressed), accumX(o.accumX), accumY(o.accumY),
+          flickStick(o.flickStick),
           vibCtx(std::move(o.vibCtx)),
           pendingDX(o.pendingDX.load()), pendingDY(o.pendingDY.load()),
           newReportReady(o.newReportReady.load()), mouseInterpolActive(o.mouseInterpolActive.load()),
           lastBLETimestamp(o.lastBLETimestamp),
           reportIntervalMs(o.reportIntervalMs.load()),
-          bleTimestampInitialized(o.bleTimestampInitialized) {}
+          bleTimestampInitialized(o.bleTimestampInitialized),
+          pipeline(std::move(o.pipeline)), dsuSlot(o.dsuSlot),
+          transport(std::move(o.transport)), stage(std::move(o.stage)) {}
     SingleJoyConPlayer& operator=(SingleJoyConPlayer&& o) noexcept {
         if (this != &o) {
             joycon = std::move(o.joycon); ds4Controller = o.ds4Controller;
@@ -161,12 +293,17 @@ struct SingleJoyConPlayer {
             mb4Pressed = o.mb4Pressed; mb5Pressed = o.mb5Pressed;
             leftBtnPressed = o.leftBtnPressed; rightBtnPressed = o.rightBtnPressed;
             middleBtnPressed = o.middleBtnPressed; accumX = o.accumX; accumY = o.accumY;
+            flickStick = o.flickStick;
             vibCtx = std::move(o.vibCtx);
             pendingDX.store(o.pendingDX.load()); pendingDY.store(o.pendingDY.load());
             newReportReady.store(o.newReportReady.load()); mouseInterpolActive.store(o.mouseInterpolActive.load());
             lastBLETimestamp = o.lastBLETimestamp;
             reportIntervalMs.store(o.reportIntervalMs.load());
             bleTimestampInitialized = o.bleTimestampInitialized;
+            pipeline = std::move(o.pipeline);
+            dsuSlot = o.dsuSlot;
+            transport = std::move(o.transport);
+            stage = std::move(o.stage);
         }
         return *this;
     }
@@ -174,6 +311,12 @@ struct SingleJoyConPlayer {
     SingleJoyConPlayer& operator=(const SingleJoyConPlayer&) = delete;
 };
 
+// One side's decoded frame as handed to the dual merge thread
+struct DualSideFrame {
+    JoyConInputFrame input;
+    int64_t arrivalUs;
+};
+
 struct DualJoyConPlayer {
     ConnectedJoyCon leftJoyCon;
     ConnectedJoyCon rightJoyCon;
@@ -181,11 +324,37 @@ struct DualJoyConPlayer {
     PVIGEM_TARGET ds4Controller = nullptr;
     std::atomic<bool> running{ false };
     std::thread updateThread;
-    std::atomic<std::shared_ptr<std::vector<uint8_t>>> leftBufferAtomic{ std::make_shared<std::vector<uint8_t>>() };
-    std::atomic<std::shared_ptr<std::vector<uint8_t>>> rightBufferAtomic{ std::make_shared<std::vector<uint8_t>>() };
-    std::mutex bufferMutex;
-    std::condition_variable bufferCV;
+    // Decoded frames live in pool slots; each side's stage publishes its newest to the merge thread
+    FramePool<DualSideFrame, 16> framePool;
+    FrameMailbox<DualSideFrame, 16> leftMailbox{ framePool };
+    FrameMailbox<DualSideFrame, 16> rightMailbox{ framePool };
+    // Wakes the merge thread when either side publishes; it sleeps while both are idle
+    FrameSignal mergeSignal;
+    // From the first side's publish to the merged report reaching ViGEm
+    LatencyHistogram mergeLatency;
+    // Arrival gap between the halves of each merged report, and reports whose pairing wait ran out
+    LatencyHistogram mergeSkew;
+    std::atomic<uint64_t> mergeExpired{ 0 };
     std::unique_ptr<VibrationContext> vibCtx;
+    std::unique_ptr<ControllerStickCalibration> leftSticks;
+    std::unique_ptr<ControllerStickCalibration> rightSticks;
+    // Each side's gyro bias is applied by that side's BLE callback
+    std::unique_ptr<GyroCalibration> leftGyro;
+    std::unique_ptr<GyroCalibration> rightGyro;
+    // GyroSource::Both: time-aligned, noise-weighted merge of the two IMUs
+    DualImuFusion imu;
+    // Both BLE callbacks queue optical samples; the merge thread encodes them into its reports
+    std::mutex touchMutex;
+    DS4TouchpadEncoder touchpad;
+    // Newest notification arrival from either side (steady clock, us), stamped by the merge thread
+    std::atomic<int64_t> lastArrivalUs{ 0 };
+    DS4SensorClock sensorClock;
+    int dsuSlot = -1;
+    // One transport and stage per side feed the merge thread
+    std::unique_ptr<IInputTransport> leftTransport;
+    std::unique_ptr<IInputTransport> rightTransport;
+    std::shared_ptr<FrameStage> leftStage;
+    std::shared_ptr<FrameStage> rightStage;
 };
 
 struct ProControllerPlayer {
@@ -193,6 +362,10 @@ struct ProControllerPlayer {
     PVIGEM_TARGET ds4Controller = nullptr;
     ControllerType type = ControllerType::ProController; // can also be NSOGCController
     std::unique_ptr<VibrationContext> vibCtx;
+    std::unique_ptr<PlayerPipeline> pipeline;
+    int dsuSlot = -1;
+    std::unique_ptr<IInputTransport> transport;
+    std::shared_ptr<FrameStage> stage;
 };
 
 // Button mapping application
@@ -229,8 +402,7 @@ inline void SendKeyboardInput(WORD virtualKey, bool keyDown) {
 }
 
 // GL/GR application for Pro controllers
-inline void ApplyGLGRMappings(DS4_REPORT_EX& report, const std::vector<uint8_t>& buffer) {
-    if (buffer.size() < 9) return;
+inline void ApplyGLGRMappings(DS4_REPORT_EX& report, const JoyConInputFrame& frame) {
     auto& config = ConfigManager::Instance().config.proConfig;
     if (config.layouts.empty()) return;
 
@@ -241,11 +413,7 @@ inline void ApplyGLGRMappings(DS4_REPORT_EX& report, const std::vector<uint8_t>&
     }
 
     const GLGRLayout& activeLayout = config.layouts[layoutIndex];
-    uint64_t state = 0;
-    for (int i = 3; i <= 8; ++i) state = (state << 8) | buffer[i];
-
-    constexpr uint64_t BUTTON_GL_MASK = 0x000000000200;
-    constexpr uint64_t BUTTON_GR_MASK = 0x000000000100;
+    uint64_t state = frame.buttons;
 
     if (state & BUTTON_GL_MASK) ApplyButtonMapping(report, activeLayout.glMapping);
     if (state & BUTTON_GR_MASK) ApplyButtonMapping(report, activeLayout.grMapping);
@@ -257,29 +425,21 @@ static bool g_cButtonPressed = false;
 static bool g_comboPressed = false;
 static std::atomic<bool> g_openManagementWindow(false);
 
-inline void HandleSpecialProButtons(const std::vector<uint8_t>& buffer) {
-    if (buffer.size() < 9) return;
-    uint64_t state = 0;
-    for (int i = 3; i <= 8; ++i) state = (state << 8) | buffer[i];
+inline void HandleSpecialProButtons(const JoyConInputFrame& frame) {
+    uint64_t state = frame.buttons;
 
     // Screenshot -> F12
-    constexpr uint64_t BUTTON_SCREENSHOT_MASK = 0x000000000400;
     bool screenshotPressed = (state & BUTTON_SCREENSHOT_MASK) != 0;
     if (screenshotPressed && !g_screenshotButtonPressed) SendKeyboardInput(VK_F12, true);
     else if (!screenshotPressed && g_screenshotButtonPressed) SendKeyboardInput(VK_F12, false);
     g_screenshotButtonPressed = screenshotPressed;
 
     // ZL+ZR+GL+GR combo
-    constexpr uint64_t TRIGGER_LT = 0x000000800000;
-    constexpr uint64_t TRIGGER_RT = 0x008000000000;
-    constexpr uint64_t GL_MASK = 0x000000000200;
-    constexpr uint64_t GR_MASK = 0x000000000100;
-    bool comboActive = (state & TRIGGER_LT) && (state & TRIGGER_RT) && (state & GL_MASK) && (state & GR_MASK);
+    bool comboActive = (state & TRIGGER_LT_MASK) && (state & TRIGGER_RT_MASK) && (state & BUTTON_GL_MASK) && (state & BUTTON_GR_MASK);
     if (comboActive && !g_comboPressed) g_openManagementWindow.store(true);
     g_comboPressed = comboActive;
 
     // C button -> cycle layout
-    constexpr uint64_t BUTTON_C_MASK = 0x000000000800;
     bool cPressed = (state & BUTTON_C_MASK) != 0;
     if (cPressed && !g_cButtonPressed) {
         auto& config = ConfigManager::Instance().config.proConfig;
@@ -323,25 +483,25 @@ public:
         vigem_target_ds4_register_notification(
             vigem.GetClient(), ds4, DS4VibrationCallback, player.vibCtx.get());
 
-        player.joycon.inputChar.ValueChanged(
-            [joyconSide = player.side, joyconOrientation = player.orientation,
-             playerPtr = &player, &mouseConfig]
-            (GattCharacteristic const&, GattValueChangedEventArgs const& args)
+        player.pipeline = CreatePlayerPipeline(cj, ControllerFamily::JoyCon2, side, orientation);
+        player.dsuSlot = AcquireDsuSlot(cj);
+        player.transport = std::make_unique<GattInputTransport>(player.joycon, ControllerFamily::JoyCon2);
+
+        player.stage = CreateFrameStage();
+        player.stage->Start(
+            [joyconSide = player.side, playerPtr = &player, pipeline = player.pipeline.get(), &mouseConfig,
+             decodeStick = SelectJoystickDecoder(side, orientation), dsu = &dsu, dsuSlot = player.dsuSlot]
+            (JoyConFrameView raw, uint32_t length, int64_t arrivalUs)
         {
-            // Boost BLE callback thread priority once for lower input latency
-            thread_local bool prioritySet = false;
-            if (!prioritySet) {
-                SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
-                prioritySet = true;
-            }
-            auto reader = DataReader::FromBuffer(args.CharacteristicValue());
-            std::vector<uint8_t> buffer(reader.UnconsumedBufferLength());
-            reader.ReadBytes(buffer);
+            RefreshStickCurves(&pipeline->Sticks());
+            JoyConInputFrame frame = pipeline->Decode(raw, length, arrivalUs);
+            const MotionFusion& fusion = pipeline->Fusion();
+            bool mouseStick = false;
 
             // Mouse mode (Right JoyCon only)
             if (joyconSide == JoyConSide::Right && mouseConfig.chatKeyEnabled) {
-                uint32_t btnState = ExtractButtonState(buffer);
-                bool chatPressed = (btnState & 0x000040) != 0;
+                uint32_t btnState = frame.JoyConButtons(JoyConSide::Right);
+                bool chatPressed = (btnState & BUTTON_CHAT_MASK_RIGHT) != 0;
 
                 if (chatPressed && !playerPtr->wasChatPressed) {
                     playerPtr->mouseMode = (playerPtr->mouseMode + 1) % 4;
@@ -357,70 +517,90 @@ public:
                 if (playerPtr->mouseMode > 0) {
                     playerPtr->mouseInterpolActive.store(true, std::memory_order_relaxed);
 
-                    // Optical mouse movement
-                    auto [rawX, rawY] = GetRawOpticalMouse(buffer);
-                    if (playerPtr->firstOpticalRead) {
-                        playerPtr->lastOpticalX = rawX;
-                        playerPtr->lastOpticalY = rawY;
-                        playerPtr->firstOpticalRead = false;
+                    float sensitivity = mouseConfig.fastSensitivity;
+                    if (playerPtr->mouseMode == 2) sensitivity = mouseConfig.normalSensitivity;
+                    else if (playerPtr->mouseMode == 3) sensitivity = mouseConfig.slowSensitivity;
+
+                    MouseSource source = mouseConfig.source;
+                    bool gyroAim = source != MouseSource::Optical;
+                    bool hasDelta = false;
+                    float scaledDX = 0.0f, scaledDY = 0.0f;
+                    auto stickData = decodeStick(frame, pipeline->Sticks().Side(joyconSide));
+
+                    if (gyroAim) {
+                        // Gyro pointer; Y ratchets. Flick stick turns are exact in-game degrees,
+                        // so only the gyro part follows the CHAT sensitivity mode.
+                        bool ratchet = (btnState & BUTTON_Y_MASK_RIGHT) != 0;
+                        MouseDelta delta = GyroMouseDelta(fusion, pipeline->Transform(), mouseConfig.gyro, ratchet);
+                        scaledDX = delta.dx * sensitivity;
+                        scaledDY = delta.dy * sensitivity;
+                        if (source == MouseSource::GyroFlick) {
+                            float turn = playerPtr->flickStick.Update(stickData.x / 32767.0f, stickData.y / 32767.0f,
+                                                                      fusion.SamplePeriod(), mouseConfig.gyro);
+                            scaledDX += turn * mouseConfig.gyro.countsPer360 / 360.0f;
+                        }
+                        hasDelta = true;
                     } else {
-                        int16_t dx = rawX - playerPtr->lastOpticalX;
-                        int16_t dy = rawY - playerPtr->lastOpticalY;
-                        playerPtr->lastOpticalX = rawX;
-                        playerPtr->lastOpticalY = rawY;
-
-                        {
-                            float sensitivity = mouseConfig.fastSensitivity;
-                            if (playerPtr->mouseMode == 2) sensitivity = mouseConfig.normalSensitivity;
-                            else if (playerPtr->mouseMode == 3) sensitivity = mouseConfig.slowSensitivity;
-
-                            float scaledDX = dx * sensitivity;
-                            float scaledDY = dy * sensitivity;
-
-                            if (mouseConfig.interpolationEnabled) {
-                                // Update BLE report interval estimate (exponential moving average)
-                                auto now = std::chrono::steady_clock::now();
-                                if (playerPtr->bleTimestampInitialized) {
-                                    float dtMs = std::chrono::duration<float, std::milli>(now - playerPtr->lastBLETimestamp).count();
-                                    if (dtMs > 1.0f && dtMs < 100.0f) {
-                                        float prev = playerPtr->reportIntervalMs.load(std::memory_order_relaxed);
-                                        playerPtr->reportIntervalMs.store(prev * 0.7f + dtMs * 0.3f, std::memory_order_relaxed);
-                                    }
-                                }
-                                playerPtr->lastBLETimestamp = now;
-                                playerPtr->bleTimestampInitialized = true;
-
-                                // Feed interpolation thread with new delta (replaces any pending)
-                                playerPtr->pendingDX.store(scaledDX, std::memory_order_relaxed);
-                                playerPtr->pendingDY.store(scaledDY, std::memory_order_relaxed);
-                                playerPtr->newReportReady.store(true, std::memory_order_release);
-                            } else if (dx != 0 || dy != 0) {
-                                // Direct mode (no interpolation): original behavior
-                                playerPtr->accumX += scaledDX;
-                                playerPtr->accumY += scaledDY;
-
-                                int moveX = static_cast<int>(playerPtr->accumX);
-                                int moveY = static_cast<int>(playerPtr->accumY);
-
-                                if (moveX != 0 || moveY != 0) {
-                                    playerPtr->accumX -= moveX;
-                                    playerPtr->accumY -= moveY;
-
-                                    INPUT input = {};
-                                    input.type = INPUT_MOUSE;
-                                    input.mi.dx = moveX;
-                                    input.mi.dy = moveY;
-                                    input.mi.dwFlags = MOUSEEVENTF_MOVE | 0x2000;
-                                    SendInput(1, &input, sizeof(INPUT));
-                                }
+                        // Optical mouse movement
+                        int16_t rawX = frame.opticalX;
+                        int16_t rawY = frame.opticalY;
+                        if (playerPtr->firstOpticalRead) {
+                            playerPtr->lastOpticalX = rawX;
+                            playerPtr->lastOpticalY = rawY;
+                            playerPtr->firstOpticalRead = false;
+                        } else {
+                            int16_t dx = rawX - playerPtr->lastOpticalX;
+                            int16_t dy = rawY - playerPtr->lastOpticalY;
+                            playerPtr->lastOpticalX = rawX;
+                            playerPtr->lastOpticalY = rawY;
+                            scaledDX = dx * sensitivity;
+                            scaledDY = dy * sensitivity;
+                            hasDelta = true;
+                        }
+                    }
+
+                    if (hasDelta) {
+                        if (mouseConfig.interpolationEnabled) {
+                            // Update BLE report interval estimate (exponential moving average)
+                            auto now = std::chrono::steady_clock::now();
+                            if (playerPtr->bleTimestampInitialized) {
+                                float dtMs = std::chrono::duration<float, std::milli>(now - playerPtr->lastBLETimestamp).count();
+                                float prev = playerPtr->reportIntervalMs.load(std::memory_order_relaxed);
+                                playerPtr->reportIntervalMs.store(SmoothReportInterval(prev, dtMs), std::memory_order_relaxed);
+                            }
+                            playerPtr->lastBLETimestamp = now;
+                            playerPtr->bleTimestampInitialized = true;
+
+                            // Feed interpolation thread with new delta (replaces any pending)
+                            playerPtr->pendingDX.store(scaledDX, std::memory_order_relaxed);
+                            playerPtr->pendingDY.store(scaledDY, std::memory_order_relaxed);
+                            playerPtr->newReportReady.store(true, std::memory_order_release);
+                        } else if (scaledDX != 0.0f || scaledDY != 0.0f) {
+                            // Direct mode (no interpolation): original behavior
+                            playerPtr->accumX += scaledDX;
+                            playerPtr->accumY += scaledDY;
+
+                            int moveX = static_cast<int>(playerPtr->accumX);
+                            int moveY = static_cast<int>(playerPtr->accumY);
+
+                            if (moveX != 0 || moveY != 0) {
+                                playerPtr->accumX -= moveX;
+                                playerPtr->accumY -= moveY;
+
+                                INPUT input = {};
+                                input.type = INPUT_MOUSE;
+                                input.mi.dx = moveX;
+                                input.mi.dy = moveY;
+                                input.mi.dwFlags = MOUSEEVENTF_MOVE | 0x2000;
+                                SendInput(1, &input, sizeof(INPUT));
                             }
                         }
                     }
 
                     // Mouse buttons
-                    bool rPressed = (btnState & 0x004000) != 0;
-                    bool zrPressed = (btnState & 0x008000) != 0;
-                    bool stickPressed = (btnState & 0x000004) != 0;
+                    bool rPressed = (btnState & BUTTON_R_MASK_RIGHT) != 0;
+                    bool zrPressed = (btnState & BUTTON_ZR_MASK_RIGHT) != 0;
+                    bool stickPressed = (btnState & BUTTON_STICK_MASK_RIGHT) != 0;
 
                     if (rPressed && !playerPtr->leftBtnPressed) {
                         INPUT input = {}; input.type = INPUT_MOUSE; input.mi.dwFlags = MOUSEEVENTF_LEFTDOWN; SendInput(1, &input, sizeof(INPUT));
@@ -443,10 +623,11 @@ public:
                     }
                     playerPtr->middleBtnPressed = stickPressed;
 
-                    // Scroll with configurable speed
-                    auto stickData = DecodeJoystick(buffer, joyconSide, joyconOrientation);
+                    // Scroll with configurable speed (the stick flicks instead in flick stick mode)
                     const int SCROLL_DEADZONE = 4000;
-                    if (abs(stickData.y) > SCROLL_DEADZONE) {
+                    if (source == MouseSource::GyroFlick) {
+                        playerPtr->scrollAccumulator = 0.0f;
+                    } else if (abs(stickData.y) > SCROLL_DEADZONE) {
                         float intensity = (abs(stickData.y) - SCROLL_DEADZONE) / (32767.0f - SCROLL_DEADZONE);
                         float speed = intensity * mouseConfig.scrollSpeed;
                         if (stickData.y > 0) playerPtr->scrollAccumulator -= speed;
@@ -467,7 +648,7 @@ public:
 
                     // Side buttons
                     const int BUTTON_THRESHOLD = 28000;
-                    if (stickData.x < -BUTTON_THRESHOLD) {
+                    if (source != MouseSource::GyroFlick && stickData.x < -BUTTON_THRESHOLD) {
                         if (!playerPtr->mb4Pressed) {
                             INPUT input = {}; input.type = INPUT_MOUSE; input.mi.mouseData = XBUTTON1; input.mi.dwFlags = MOUSEEVENTF_XDOWN; SendInput(1, &input, sizeof(INPUT));
                             INPUT input2 = {}; input2.type = INPUT_MOUSE; input2.mi.mouseData = XBUTTON1; input2.mi.dwFlags = MOUSEEVENTF_XUP; SendInput(1, &input2, sizeof(INPUT));
@@ -475,7 +656,7 @@ public:
                         }
                     } else { playerPtr->mb4Pressed = false; }
 
-                    if (stickData.x > BUTTON_THRESHOLD) {
+                    if (source != MouseSource::GyroFlick && stickData.x > BUTTON_THRESHOLD) {
                         if (!playerPtr->mb5Pressed) {
                             INPUT input = {}; input.type = INPUT_MOUSE; input.mi.mouseData = XBUTTON2; input.mi.dwFlags = MOUSEEVENTF_XDOWN; SendInput(1, &input, sizeof(INPUT));
                             INPUT input2 = {}; input2.type = INPUT_MOUSE; input2.mi.mouseData = XBUTTON2; input2.mi.dwFlags = MOUSEEVENTF_XUP; SendInput(1, &input2, sizeof(INPUT));
@@ -483,18 +664,17 @@ public:
                         }
                     } else { playerPtr->mb5Pressed = false; }
 
-                    // Suppress inputs in DS4 report when mouse mode active
-                    buffer[4] &= ~0x40;
-                    buffer[4] &= ~0x80;
-                    buffer[5] &= ~0x04;
-                    if (buffer.size() >= 16) {
-                        buffer[13] = 0x00;
-                        buffer[14] = 0x08;
-                        buffer[15] = 0x80;
-                    }
+                    // Suppress inputs in DS4 report when mouse mode active (R, ZR, stick click, right stick,
+                    // and the gyro ratchet button)
+                    uint32_t suppressed = BUTTON_R_MASK_RIGHT | BUTTON_ZR_MASK_RIGHT | BUTTON_STICK_MASK_RIGHT;
+                    if (gyroAim) suppressed |= BUTTON_Y_MASK_RIGHT;
+                    frame.buttons &= ~(static_cast<uint64_t>(suppressed) << 24);
+                    frame.rightStick = RawStick{};
+                    mouseStick = true;
                 } else {
                     playerPtr->mouseInterpolActive.store(false, std::memory_order_relaxed);
                     playerPtr->firstOpticalRead = true;
+                    playerPtr->flickStick = FlickStick{};
                     playerPtr->accumX = 0.0f;
                     playerPtr->accumY = 0.0f;
                     playerPtr->pendingDX.store(0.0f, std::memory_order_relaxed);
@@ -504,12 +684,12 @@ public:
                 }
             }
 
-            DS4_REPORT_EX report = GenerateDS4Report(buffer, joyconSide, joyconOrientation);
+            // The right stick belongs to the mouse while mouse mode is on
+            DS4_REPORT_EX report = pipeline->Report(frame, ConfigManager::Instance().config.gyroStickConfig, mouseStick);
             vigem_target_ds4_update_ex(ViGEmManager::Instance().GetClient(), playerPtr->ds4Controller, report);
-        });
-
-        auto status = player.joycon.inputChar.WriteClientCharacteristicConfigurationDescriptorAsync(
-            GattClientCharacteristicConfigurationDescriptorValue::Notify).get();
+            PublishDsu(*dsu, dsuSlot, report, frame.motion, pipeline->Transform(), arrivalUs);
+        }, THREAD_PRIORITY_HIGHEST);
+        bool subscribed = FeedFrameStage(*player.transport, player.stage);
 
         if (player.joycon.writeChar) {
             SendCustomCommands(player.joycon.writeChar);
@@ -521,7 +701,7 @@ public:
         // Start mouse interpolation thread (shared across all single joycons)
         StartMouseInterpolThread();
 
-        return (status == GattCommunicationStatus::Success);
+        return subscribed;
     }
 
     // Clear pending dual JoyCon state (release BLE references)
@@ -560,6 +740,13 @@ public:
         dp->rightJoyCon = pendingDualRight;
         dp->gyroSource = pendingDualGyro;
         dp->ds4Controller = ds4;
+        dp->leftSticks = CreateStickCalibration(leftJoyCon, true, false);
+        dp->rightSticks = CreateStickCalibration(pendingDualRight, false, true);
+        dp->leftGyro = CreateGyroCalibration(leftJoyCon);
+        dp->rightGyro = CreateGyroCalibration(pendingDualRight);
+        dp->dsuSlot = AcquireDsuSlot(pendingDualRight);
+        dp->leftTransport = std::make_unique<GattInputTransport>(leftJoyCon, ControllerFamily::JoyCon2);
+        dp->rightTransport = std::make_unique<GattInputTransport>(pendingDualRight, ControllerFamily::JoyCon2);
         dp->running.store(true);
 
         // Register vibration callback for dual JoyCon
@@ -570,46 +757,106 @@ public:
         vigem_target_ds4_register_notification(
             vigem.GetClient(), ds4, DS4VibrationCallback, dp->vibCtx.get());
 
-        dp->leftJoyCon.inputChar.ValueChanged([ptr = dp.get()](GattCharacteristic const&, GattValueChangedEventArgs const& args) {
-            auto reader = DataReader::FromBuffer(args.CharacteristicValue());
-            auto buf = std::make_shared<std::vector<uint8_t>>(reader.UnconsumedBufferLength());
-            reader.ReadBytes(*buf);
-            ptr->leftBufferAtomic.store(buf, std::memory_order_release);
-            ptr->bufferCV.notify_one();
-        });
-
-        dp->leftJoyCon.inputChar.WriteClientCharacteristicConfigurationDescriptorAsync(
-            GattClientCharacteristicConfigurationDescriptorValue::Notify).get();
-
-        dp->rightJoyCon.inputChar.ValueChanged([ptr = dp.get()](GattCharacteristic const&, GattValueChangedEventArgs const& args) {
-            auto reader = DataReader::FromBuffer(args.CharacteristicValue());
-            auto buf = std::make_shared<std::vector<uint8_t>>(reader.UnconsumedBufferLength());
-            reader.ReadBytes(*buf);
-            ptr->rightBufferAtomic.store(buf, std::memory_order_release);
-            ptr->bufferCV.notify_one();
-        });
-
-        dp->rightJoyCon.inputChar.WriteClientCharacteristicConfigurationDescriptorAsync(
-            GattClientCharacteristicConfigurationDescriptorValue::Notify).get();
-
-        dp->updateThread = std::thread([ptr = dp.get()]() {
+        dp->leftStage = CreateFrameStage();
+        dp->leftStage->Start([ptr = dp.get()](JoyConFrameView raw, uint32_t length, int64_t arrivalUs) {
+            ptr->lastArrivalUs.store(arrivalUs, std::memory_order_relaxed);
+            auto frame = ptr->framePool.Acquire();
+            if (!frame) return;  // every slot held; the next notification supersedes this one
+            frame->input = DecodeInputFrame(raw, length);
+            frame->arrivalUs = arrivalUs;
+            ptr->leftGyro->Process(frame->input.motion);
+            ptr->imu.Push(0, arrivalUs, frame->input.motion);
+            {
+                std::lock_guard<std::mutex> lock(ptr->touchMutex);
+                ptr->touchpad.Push(frame->input, 0);
+            }
+            ptr->leftMailbox.Publish(std::move(frame));
+            ptr->mergeSignal.Notify(SteadyMicros(std::chrono::steady_clock::now()));
+        }, THREAD_PRIORITY_HIGHEST);
+        FeedFrameStage(*dp->leftTransport, dp->leftStage);
+
+        dp->rightStage = CreateFrameStage();
+        dp->rightStage->Start([ptr = dp.get()](JoyConFrameView raw, uint32_t length, int64_t arrivalUs) {
+            ptr->lastArrivalUs.store(arrivalUs, std::memory_order_relaxed);
+            auto frame = ptr->framePool.Acquire();
+            if (!frame) return;
+            frame->input = DecodeInputFrame(raw, length);
+            frame->arrivalUs = arrivalUs;
+            ptr->rightGyro->Process(frame->input.motion);
+            ptr->imu.Push(1, arrivalUs, frame->input.motion);
+            {
+                std::lock_guard<std::mutex> lock(ptr->touchMutex);
+                ptr->touchpad.Push(frame->input, 1);
+            }
+            ptr->rightMailbox.Publish(std::move(frame));
+            ptr->mergeSignal.Notify(SteadyMicros(std::chrono::steady_clock::now()));
+        }, THREAD_PRIORITY_HIGHEST);
+        FeedFrameStage(*dp->rightTransport, dp->rightStage);
+
+        dp->updateThread = std::thread([ptr = dp.get(), generateReport = SelectDualReportGenerator(dp->gyroSource),
+                                        fuseImus = dp->gyroSource == GyroSource::Both,
+                                        rightImu = dp->gyroSource == GyroSource::Right, dsu = &dsu,
+                                        pipeline = ConfigManager::Instance().config.pipelineConfig]() {
             // Elevate merge thread priority for responsive dual JoyCon input
             SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
-            std::shared_ptr<std::vector<uint8_t>> prevLeft, prevRight;
+            // Gyro to right stick follows the merged motion, so it keeps its own fusion here
+            MotionFusion stickFusion;
+            GyroStick gyroStick;
+            FramePool<DualSideFrame, 16>::Ref leftFrame, rightFrame;
+            bool leftFresh = false, rightFresh = false;
+            DualFramePairer pairer(pipeline.dualMerge, pipeline.dualMergeDeadlineUs);
+            int64_t notifiedUs = 0;   // first publish not yet answered by a report
             while (ptr->running.load(std::memory_order_acquire)) {
+                uint32_t generation = ptr->mergeSignal.Generation();
+                if (auto frame = ptr->leftMailbox.Take()) {
+                    pairer.Arrive(0, frame->arrivalUs);
+                    leftFrame = std::move(frame);
+                    leftFresh = true;
+                }
+                if (auto frame = ptr->rightMailbox.Take()) {
+                    pairer.Arrive(1, frame->arrivalUs);
+                    rightFrame = std::move(frame);
+                    rightFresh = true;
+                }
+                if (int64_t claimed = ptr->mergeSignal.Claim(); claimed && !notifiedUs) notifiedUs = claimed;
+                // The policy decides whether a new frame on one side waits for the other's
+                int64_t wakeAtUs = 0;
+                if (!leftFrame || !rightFrame || !pairer.Ready(SteadyMicros(std::chrono::steady_clock::now()), wakeAtUs)) {
+                    if (!leftFrame || !rightFrame || (!leftFresh && !rightFresh)) notifiedUs = 0;
+                    if (wakeAtUs) ptr->mergeSignal.WaitUntil(generation,
+                        std::chrono::steady_clock::time_point(std::chrono::microseconds(wakeAtUs)));
+                    else ptr->mergeSignal.Wait(generation);
+                    continue;
+                }
+                // Calibration learns from each notification once, not from every merge
+                RefreshStickCurves(ptr->leftSticks.get());
+                RefreshStickCurves(ptr->rightSticks.get());
+                if (leftFresh) ptr->leftSticks->Observe(leftFrame->input);
+                if (rightFresh) ptr->rightSticks->Observe(rightFrame->input);
+                leftFresh = rightFresh = false;
+                DS4_REPORT_EX report = generateReport(leftFrame->input, rightFrame->input,
+                    ptr->leftSticks->Left(), ptr->rightSticks->Right());
+                const ImuTransform& imuTransform = SelectImuTransform(ControllerFamily::JoyCon2);
+                MotionData motion = rightImu ? rightFrame->input.motion : leftFrame->input.motion;
+                if (fuseImus && ptr->imu.Sample(motion))
+                    WriteDS4Motion(report, NormalizeMotion(motion, imuTransform));
+                int64_t arrivalUs = ptr->lastArrivalUs.load(std::memory_order_relaxed);
+                uint16_t timestamp = ptr->sensorClock.Stamp(arrivalUs);
+                stickFusion.SetSamplePeriodUs(ptr->sensorClock.PeriodUs());
+                stickFusion.Update(motion);
+                ApplyGyroStick(gyroStick, stickFusion, imuTransform, report);
                 {
-                    std::unique_lock<std::mutex> lock(ptr->bufferMutex);
-                    ptr->bufferCV.wait_for(lock, std::chrono::milliseconds(2));
+                    std::lock_guard<std::mutex> lock(ptr->touchMutex);
+                    ptr->touchpad.Encode(report);
                 }
-                auto leftBuf = ptr->leftBufferAtomic.load(std::memory_order_acquire);
-                auto rightBuf = ptr->rightBufferAtomic.load(std::memory_order_acquire);
-                if (leftBuf->empty() || rightBuf->empty()) continue;
-                // Submit update if either side has new data (don't wait for both)
-                if (leftBuf == prevLeft && rightBuf == prevRight) continue;
-                prevLeft = leftBuf;
-                prevRight = rightBuf;
-                DS4_REPORT_EX report = GenerateDualJoyConDS4Report(*leftBuf, *rightBuf, ptr->gyroSource);
+                report.Report.wTimestamp = timestamp;
                 vigem_target_ds4_update_ex(ViGEmManager::Instance().GetClient(), ptr->ds4Controller, report);
+                int64_t submittedUs = SteadyMicros(std::chrono::steady_clock::now());
+                if (notifiedUs) ptr->mergeLatency.Record(submittedUs - notifiedUs);
+                notifiedUs = 0;
+                pairer.Emitted(submittedUs, ptr->mergeSkew);
+                ptr->mergeExpired.store(pairer.Expired(), std::memory_order_relaxed);
+                PublishDsu(*dsu, ptr->dsuSlot, report, motion, imuTransform, arrivalUs);
             }
         });
 
@@ -629,32 +876,26 @@ public:
             ConfigManager::Instance().Save();
         }
 
-        if (type == ControllerType::ProController) {
-            controller.inputChar.ValueChanged([ds4](GattCharacteristic const&, GattValueChangedEventArgs const& args) mutable {
-                thread_local bool prioritySet = false;
-                if (!prioritySet) { SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL); prioritySet = true; }
-                auto reader = DataReader::FromBuffer(args.CharacteristicValue());
-                std::vector<uint8_t> buffer(reader.UnconsumedBufferLength());
-                reader.ReadBytes(buffer);
-                DS4_REPORT_EX report = GenerateProControllerReport(buffer);
-                ApplyGLGRMappings(report, buffer);
-                HandleSpecialProButtons(buffer);
-                vigem_target_ds4_update_ex(ViGEmManager::Instance().GetClient(), ds4, report);
-            });
-        } else {
-            controller.inputChar.ValueChanged([ds4](GattCharacteristic const&, GattValueChangedEventArgs const& args) mutable {
-                thread_local bool prioritySet = false;
-                if (!prioritySet) { SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL); prioritySet = true; }
-                auto reader = DataReader::FromBuffer(args.CharacteristicValue());
-                std::vector<uint8_t> buffer(reader.UnconsumedBufferLength());
-                reader.ReadBytes(buffer);
-                DS4_REPORT_EX report = GenerateNSOGCReport(buffer);
-                vigem_target_ds4_update_ex(ViGEmManager::Instance().GetClient(), ds4, report);
-            });
-        }
-
-        controller.inputChar.WriteClientCharacteristicConfigurationDescriptorAsync(
-            GattClientCharacteristicConfigurationDescriptorValue::Notify).get();
+        ControllerFamily family = type == ControllerType::ProController ? ControllerFamily::ProController2 : ControllerFamily::NSOGC;
+        auto pipeline = CreatePlayerPipeline(controller, family);
+        int dsuSlot = AcquireDsuSlot(controller);
+        auto transport = std::make_unique<GattInputTransport>(controller, family);
+        auto stage = CreateFrameStage();
+
+        // GL/GR layouts and the special buttons are Pro Controller only
+        stage->Start([ds4, pipeline = pipeline.get(), pro = type == ControllerType::ProController, dsu = &dsu, dsuSlot]
+                     (JoyConFrameView raw, uint32_t length, int64_t arrivalUs) {
+            RefreshStickCurves(&pipeline->Sticks());
+            JoyConInputFrame frame = pipeline->Decode(raw, length, arrivalUs);
+            DS4_REPORT_EX report = pipeline->Report(frame, ConfigManager::Instance().config.gyroStickConfig);
+            if (pro) {
+                ApplyGLGRMappings(report, frame);
+                HandleSpecialProButtons(frame);
+            }
+            vigem_target_ds4_update_ex(ViGEmManager::Instance().GetClient(), ds4, report);
+            PublishDsu(*dsu, dsuSlot, report, frame.motion, pipeline->Transform(), arrivalUs);
+        }, THREAD_PRIORITY_ABOVE_NORMAL);
+        FeedFrameStage(*transport, stage);
 
         if (controller.writeChar) {
             SendCustomCommands(controller.writeChar);
@@ -663,7 +904,7 @@ public:
             EmitSound(controller.writeChar);
         }
 
-        proPlayers.push_back({ controller, ds4, type, nullptr });
+        proPlayers.push_back({ controller, ds4, type, nullptr, std::move(pipeline), dsuSlot, std::move(transport), std::move(stage) });
 
         // Register vibration callback for pro/GC controller
         auto& pp = proPlayers.back();
@@ -679,24 +920,44 @@ public:
     void RemovePlayerByGlobalIndex(int globalIdx) {
         int idx = globalIdx;
         if (idx < (int)singlePlayers.size()) {
+            singlePlayers[idx].transport->Unsubscribe();
+            singlePlayers[idx].stage->Stop();
             vigem_target_ds4_unregister_notification(singlePlayers[idx].ds4Controller);
             ViGEmManager::Instance().RemoveTarget(singlePlayers[idx].ds4Controller);
+            SaveStickCalibration(&singlePlayers[idx].pipeline->Sticks());
+            SaveGyroCalibration(&singlePlayers[idx].pipeline->Gyro());
+            dsu.ReleaseSlot(singlePlayers[idx].dsuSlot);
             singlePlayers.erase(singlePlayers.begin() + idx);
             return;
         }
         idx -= (int)singlePlayers.size();
         if (idx < (int)dualPlayers.size()) {
+            dualPlayers[idx]->leftTransport->Unsubscribe();
+            dualPlayers[idx]->rightTransport->Unsubscribe();
+            dualPlayers[idx]->leftStage->Stop();
+            dualPlayers[idx]->rightStage->Stop();
             dualPlayers[idx]->running.store(false);
+            dualPlayers[idx]->mergeSignal.Wake();
             if (dualPlayers[idx]->updateThread.joinable()) dualPlayers[idx]->updateThread.join();
             vigem_target_ds4_unregister_notification(dualPlayers[idx]->ds4Controller);
             ViGEmManager::Instance().RemoveTarget(dualPlayers[idx]->ds4Controller);
+            SaveStickCalibration(dualPlayers[idx]->leftSticks.get());
+            SaveStickCalibration(dualPlayers[idx]->rightSticks.get());
+            SaveGyroCalibration(dualPlayers[idx]->leftGyro.get());
+            SaveGyroCalibration(dualPlayers[idx]->rightGyro.get());
+            dsu.ReleaseSlot(dualPlayers[idx]->dsuSlot);
             dualPlayers.erase(dualPlayers.begin() + idx);
             return;
         }
         idx -= (int)dualPlayers.size();
         if (idx < (int)proPlayers.size()) {
+            proPlayers[idx].transport->Unsubscribe();
+            proPlayers[idx].stage->Stop();
             vigem_target_ds4_unregister_notification(proPlayers[idx].ds4Controller);
             ViGEmManager::Instance().RemoveTarget(proPlayers[idx].ds4Controller);
+            SaveStickCalibration(&proPlayers[idx].pipeline->Sticks());
+            SaveGyroCalibration(&proPlayers[idx].pipeline->Gyro());
+            dsu.ReleaseSlot(proPlayers[idx].dsuSlot);
             proPlayers.erase(proPlayers.begin() + idx);
             return;
         }
@@ -706,34 +967,74 @@ public:
         // Stop mouse interpolation thread
         mouseInterpolRunning.store(false);
         if (mouseInterpolThread.joinable()) mouseInterpolThread.join();
+        dsu.Stop();
+        CaptureSession::Instance().Stop();
 
         for (auto& dp : dualPlayers) {
+            dp->leftTransport->Unsubscribe();
+            dp->rightTransport->Unsubscribe();
+            dp->leftStage->Stop();
+            dp->rightStage->Stop();
             dp->running.store(false);
+            dp->mergeSignal.Wake();
             if (dp->updateThread.joinable()) dp->updateThread.join();
             vigem_target_ds4_unregister_notification(dp->ds4Controller);
             ViGEmManager::Instance().RemoveTarget(dp->ds4Controller);
+            SaveStickCalibration(dp->leftSticks.get());
+            SaveStickCalibration(dp->rightSticks.get());
+            SaveGyroCalibration(dp->leftGyro.get());
+            SaveGyroCalibration(dp->rightGyro.get());
+            dsu.ReleaseSlot(dp->dsuSlot);
         }
         dualPlayers.clear();
         for (auto& sp : singlePlayers) {
+            sp.transport->Unsubscribe();
+            sp.stage->Stop();
             vigem_target_ds4_unregister_notification(sp.ds4Controller);
             ViGEmManager::Instance().RemoveTarget(sp.ds4Controller);
+            SaveStickCalibration(&sp.pipeline->Sticks());
+            SaveGyroCalibration(&sp.pipeline->Gyro());
+            dsu.ReleaseSlot(sp.dsuSlot);
         }
         singlePlayers.clear();
         for (auto& pp : proPlayers) {
+            pp.transport->Unsubscribe();
+            pp.stage->Stop();
             vigem_target_ds4_unregister_notification(pp.ds4Controller);
             ViGEmManager::Instance().RemoveTarget(pp.ds4Controller);
+            SaveStickCalibration(&pp.pipeline->Sticks());
+            SaveGyroCalibration(&pp.pipeline->Gyro());
+            dsu.ReleaseSlot(pp.dsuSlot);
         }
         proPlayers.clear();
     }
 
     ~PlayerManager() { Shutdown(); }
 
+    // Start, restart or stop the DSU server to match the config
+    void ApplyDsuConfig() {
+        const DsuConfig& cfg = ConfigManager::Instance().config.dsuConfig;
+        if (!cfg.enabled) {
+            dsu.Stop();
+            return;
+        }
+        if (dsu.Running() && dsu.Port() == cfg.port) return;
+        dsu.Start(static_cast<uint16_t>(cfg.port));
+    }
+    bool DsuRunning() const { return dsu.Running(); }
+
 private:
     PlayerManager() = default;
     std::vector<SingleJoyConPlayer> singlePlayers;
     std::vector<std::unique_ptr<DualJoyConPlayer>> dualPlayers;
     std::vector<ProControllerPlayer> proPlayers;
 
+    // Cemuhook DSU server; players keep their slot while connected
+    DsuServer dsu;
+    int AcquireDsuSlot(const ConnectedJoyCon& cj) {
+        return dsu.AcquireSlot(cj.device ? cj.device.BluetoothAddress() : 0);
+    }
+
     // Mouse interpolation thread
     std::thread mouseInterpolThread;
     std::atomic<bool> mouseInterpolRunning{ false };
@@ -746,19 +1047,11 @@ private:
             auto& mouseConfig = ConfigManager::Instance().config.mouseConfig;
 
             // Per-player interpolation state (indexed same as singlePlayers)
-            struct InterpState {
-                float remainX = 0.0f, remainY = 0.0f;
-                float accumX = 0.0f, accumY = 0.0f;
-                int ticksLeft = 0;
-                float perTickX = 0.0f, perTickY = 0.0f;
-                std::chrono::steady_clock::time_point lastActivity{};
-            };
-            std::vector<InterpState> states;
+            std::vector<MouseInterpolator> states;
+            auto nextTick = std::chrono::steady_clock::now();
 
             while (mouseInterpolRunning.load(std::memory_order_relaxed)) {
-                int rateHz = mouseConfig.interpolationRateHz;
-                if (rateHz < 100) rateHz = 100;
-                if (rateHz > 500) rateHz = 500;
+                int rateHz = ClampInterpolationRate(mouseConfig.interpolationRateHz);
                 float tickMs = 1000.0f / rateHz;
 
                 // Ensure states vector matches player count
@@ -779,88 +1072,28 @@ private:
                     if (player.newReportReady.exchange(false, std::memory_order_acquire)) {
                         float dx = player.pendingDX.exchange(0.0f, std::memory_order_relaxed);
                         float dy = player.pendingDY.exchange(0.0f, std::memory_order_relaxed);
-
-                        // Replace old remainder — new report cancels any unfinished old movement
-                        // This prevents inertia when the user stops suddenly
-                        st.remainX = dx;
-                        st.remainY = dy;
-
-                        if (dx == 0.0f && dy == 0.0f) {
-                            // Zero movement: immediately stop all interpolation
-                            st.ticksLeft = 0;
-                            st.perTickX = 0.0f;
-                            st.perTickY = 0.0f;
-                            st.remainX = 0.0f;
-                            st.remainY = 0.0f;
-                        } else {
-                            // Calculate how many ticks to spread this over
-                            float interval = player.reportIntervalMs.load(std::memory_order_relaxed);
-                            if (interval < 5.0f) interval = 5.0f;
-                            if (interval > 50.0f) interval = 50.0f;
-                            int ticks = (std::max)(1, static_cast<int>(interval / tickMs));
-
-                            st.perTickX = st.remainX / ticks;
-                            st.perTickY = st.remainY / ticks;
-                            st.ticksLeft = ticks;
-                        }
-                        st.lastActivity = now;
+                        float interval = player.reportIntervalMs.load(std::memory_order_relaxed);
+                        st.OnReport(dx, dy, interval, tickMs, now);
                     }
 
                     // Emit one interpolation tick
-                    if (st.ticksLeft > 0) {
-                        st.accumX += st.perTickX;
-                        st.accumY += st.perTickY;
-                        st.remainX -= st.perTickX;
-                        st.remainY -= st.perTickY;
-                        st.ticksLeft--;
-
-                        int moveX = static_cast<int>(st.accumX);
-                        int moveY = static_cast<int>(st.accumY);
-                        if (moveX != 0 || moveY != 0) {
-                            st.accumX -= moveX;
-                            st.accumY -= moveY;
-                            INPUT input = {};
-                            input.type = INPUT_MOUSE;
-                            input.mi.dx = moveX;
-                            input.mi.dy = moveY;
-                            input.mi.dwFlags = MOUSEEVENTF_MOVE | 0x2000;
-                            SendInput(1, &input, sizeof(INPUT));
-                        }
-
-                        // When done distributing, clear any floating point dust
-                        if (st.ticksLeft == 0) {
-                            // Send any final remainder
-                            st.accumX += st.remainX;
-                            st.accumY += st.remainY;
-                            int finalX = static_cast<int>(st.accumX);
-                            int finalY = static_cast<int>(st.accumY);
-                            if (finalX != 0 || finalY != 0) {
-                                st.accumX -= finalX;
-                                st.accumY -= finalY;
-                                INPUT input = {};
-                                input.type = INPUT_MOUSE;
-                                input.mi.dx = finalX;
-                                input.mi.dy = finalY;
-                                input.mi.dwFlags = MOUSEEVENTF_MOVE | 0x2000;
-                                SendInput(1, &input, sizeof(INPUT));
-                            }
-                            st.remainX = 0.0f;
-                            st.remainY = 0.0f;
-                        }
-                    } else {
-                        // Decay any residual accumulation after inactivity (>50ms)
-                        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - st.lastActivity).count();
-                        if (elapsed > 50) {
-                            st.accumX = 0.0f;
-                            st.accumY = 0.0f;
-                            st.remainX = 0.0f;
-                            st.remainY = 0.0f;
-                        }
+                    MouseMove move = st.Tick(now);
+                    if (move.dx != 0 || move.dy != 0) {
+                        INPUT input = {};
+                        input.type = INPUT_MOUSE;
+                        input.mi.dx = move.dx;
+                        input.mi.dy = move.dy;
+                        input.mi.dwFlags = MOUSEEVENTF_MOVE | 0x2000;
+                        SendInput(1, &input, sizeof(INPUT));
                     }
                 }
 
-                // Sleep for one tick interval
-                std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int>(tickMs * 1000)));
+                // Sleep until the next tick deadline, so the time spent sending does not stretch the
+                // period at 1 kHz; after a stall, skip ahead rather than bursting to catch up
+                nextTick += std::chrono::microseconds(static_cast<int>(tickMs * 1000));
+                auto after = std::chrono::steady_clock::now();
+                if (nextTick < after) nextTick = after;
+                std::this_thread::sleep_until(nextTick);
             }
         });
     }
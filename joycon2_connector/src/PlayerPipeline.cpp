@@ -0,0 +1,38 @@
+#include "PlayerPipeline.h"
+#include <utility>
+
+PlayerPipeline::PlayerPipeline(ControllerFamily family, JoyConSide side, JoyConOrientation orientation, std::string deviceId,
+                               const StickCalibrationRecord* savedSticks, const GyroCalibrationRecord* savedGyro)
+    : family(family), side(side), decode(SelectFrameDecoder(family)),
+      generateJoyCon(SelectDS4ReportGenerator(side, orientation)),
+      transform(SelectImuTransform(family, side, orientation)),
+      sticks(deviceId, family != ControllerFamily::JoyCon2 || side == JoyConSide::Left,
+             family != ControllerFamily::JoyCon2 || side == JoyConSide::Right, savedSticks),
+      gyro(std::move(deviceId), savedGyro) {}
+
+JoyConInputFrame PlayerPipeline::Decode(JoyConFrameView raw, uint32_t length, int64_t arrivalUs) {
+    timestamp = clock.Stamp(arrivalUs);
+    JoyConInputFrame frame = decode(raw, length);
+    gyro.Process(frame.motion);
+    fusion.SetSamplePeriodUs(clock.PeriodUs());
+    fusion.Update(frame.motion);
+    sticks.Observe(frame);
+    return frame;
+}
+
+DS4_REPORT_EX PlayerPipeline::Report(const JoyConInputFrame& frame, const GyroStickSettings& gyroStickSettings, bool mouseStick) {
+    DS4_REPORT_EX report;
+    switch (family) {
+    case ControllerFamily::ProController2: report = GenerateProControllerReport(frame, sticks.Left(), sticks.Right()); break;
+    case ControllerFamily::NSOGC:          report = GenerateNSOGCReport(frame, sticks.Left(), sticks.Right()); break;
+    default:
+        // Raw 2048 is only guaranteed to rest uncalibrated
+        report = generateJoyCon(frame, mouseStick ? DefaultStickLUT() : sticks.Side(side));
+        touchpad.Push(frame);
+        touchpad.Encode(report);
+        break;
+    }
+    if (!mouseStick) gyroStick.Process(fusion, transform, gyroStickSettings, report);
+    report.Report.wTimestamp = timestamp;
+    return report;
+}
@@ -0,0 +1,51 @@
+#pragma once
+// PlayerPipeline - What one single-controller player does with a notification short of platform
+// output: sensor clock, decode, gyro bias, fusion, stick calibration and curves, report, gyro to
+// right stick and touchpad. The app's stage thread sends the reports to ViGEm and DSU and drives
+// the mouse; the replay tool hashes them. Single Joy-Con 2, Pro Controller 2 and NSO GC players
+// (the dual Joy-Con merge thread builds its reports from two sides). One per player, used by the
+// thread that generates its reports.
+#include "JoyConDecoder.h"
+#include "StickCalibrator.h"
+#include "GyroCalibration.h"
+#include "MotionFusion.h"
+#include "GyroStick.h"
+#include "ImuNormalization.h"
+#include "SensorClock.h"
+#include "TouchpadEncoder.h"
+#include <string>
+
+class PlayerPipeline {
+public:
+    // side and orientation only matter for a Joy-Con 2
+    PlayerPipeline(ControllerFamily family, JoyConSide side, JoyConOrientation orientation, std::string deviceId,
+                   const StickCalibrationRecord* savedSticks = nullptr, const GyroCalibrationRecord* savedGyro = nullptr);
+
+    // One notification: stamps its arrival, decodes it, removes the gyro bias, updates the fusion
+    // and learns the sticks. The caller may edit the frame (mouse mode) before Report.
+    JoyConInputFrame Decode(JoyConFrameView raw, uint32_t length, int64_t arrivalUs);
+
+    // The DS4 report of the frame Decode returned. mouseStick: the right stick drives the mouse,
+    // so it is read uncalibrated and the gyro stick leaves it alone.
+    DS4_REPORT_EX Report(const JoyConInputFrame& frame, const GyroStickSettings& gyroStickSettings, bool mouseStick = false);
+
+    ControllerStickCalibration& Sticks() { return sticks; }
+    const GyroCalibration& Gyro() const { return gyro; }
+    const MotionFusion& Fusion() const { return fusion; }
+    const ImuTransform& Transform() const { return transform; }
+    ControllerFamily Family() const { return family; }
+
+private:
+    const ControllerFamily family;
+    const JoyConSide side;
+    const FrameDecoder decode;
+    const SingleReportGenerator generateJoyCon;
+    const ImuTransform& transform;
+    ControllerStickCalibration sticks;
+    GyroCalibration gyro;
+    MotionFusion fusion;
+    GyroStick gyroStick;
+    DS4TouchpadEncoder touchpad;
+    DS4SensorClock clock;
+    uint16_t timestamp = 0;   // of the frame Decode returned last
+};
@@ -0,0 +1,39 @@
+#include "SensorClock.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr int64_t STALL_US = 100000;     // a gap this long restarts the clock at the next arrival
+constexpr uint32_t MIN_PERIOD_SAMPLES = 4;
+constexpr double PHASE_GAIN = 1.0 / 8;   // share of the arrival error corrected per notification
+constexpr double MAX_ERROR_PERIODS = 4;  // further off than this: follow the arrival time again
+
+uint16_t DS4SensorClock::Stamp(int64_t arrivalUs) {
+    if (arrivalCount > 0) {
+        int64_t prev = arrivals[(arrivalCount - 1) % WINDOW];
+        // After a stall (or a clock step backwards) the old window says nothing about the rate;
+        // the last period is kept until the new window is long enough
+        if (arrivalUs - prev > STALL_US || arrivalUs < prev) arrivalCount = 0;
+    }
+    arrivals[arrivalCount % WINDOW] = arrivalUs;
+    ++arrivalCount;
+
+    // Mean interval across the window: bursts of notifications in one connection event average out
+    uint32_t n = std::min<uint32_t>(arrivalCount, WINDOW);
+    if (n >= MIN_PERIOD_SAMPLES)
+        periodUs = static_cast<double>(arrivalUs - arrivals[(arrivalCount - n) % WINDOW]) / (n - 1);
+
+    // Phase-locked: advance one period, then pull a fraction of the way towards the arrival time
+    if (arrivalCount == 1 || periodUs <= 0.0) {
+        stampUs = static_cast<double>(arrivalUs);
+    } else {
+        double predicted = stampUs + periodUs;
+        double error = static_cast<double>(arrivalUs) - predicted;
+        stampUs = std::fabs(error) > MAX_ERROR_PERIODS * periodUs ? static_cast<double>(arrivalUs)
+                                                                  : predicted + error * PHASE_GAIN;
+    }
+
+    int64_t ticks = static_cast<int64_t>(stampUs * DS4_TIMESTAMP_NUM / DS4_TIMESTAMP_DEN);
+    if (ticks <= lastTicks) ticks = lastTicks + 1;
+    lastTicks = ticks;
+    return static_cast<uint16_t>(ticks);
+}
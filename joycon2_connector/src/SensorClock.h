@@ -0,0 +1,35 @@
+#pragma once
+// Host-side DS4 sensor timestamps. The controllers carry no usable sample clock, so each
+// notification is stamped at arrival; BLE delivers them in connection-event bursts, so the
+// arrival times are smoothed onto a steady clock before they reach wTimestamp.
+#include <chrono>
+#include <cstdint>
+
+// DS4 wTimestamp counts 16/3 us units and wraps at 16 bits
+constexpr int64_t DS4_TIMESTAMP_NUM = 3;
+constexpr int64_t DS4_TIMESTAMP_DEN = 16;
+
+inline int64_t SteadyMicros(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+}
+
+// One per player, used by the thread that generates its reports. Stamps are strictly
+// increasing (mod 2^16) and advance at the measured notification rate.
+class DS4SensorClock {
+public:
+    // Arrival time of one notification (steady clock, microseconds) -> DS4 timestamp
+    uint16_t Stamp(int64_t arrivalUs);
+    uint16_t Stamp(std::chrono::steady_clock::time_point arrival) { return Stamp(SteadyMicros(arrival)); }
+
+    // Notification period measured over the last WINDOW arrivals (0 until two have arrived)
+    double PeriodUs() const { return periodUs; }
+
+    static constexpr int WINDOW = 16;
+
+private:
+    int64_t arrivals[WINDOW] = {};
+    uint32_t arrivalCount = 0;
+    double periodUs = 0.0;
+    double stampUs = 0.0;     // smoothed sample time of the previous notification
+    int64_t lastTicks = 0;
+};
@@ -0,0 +1,137 @@
+#include "SimulatedController.h"
+#include "ImuNormalization.h"
+#include "SensorClock.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+static void put_stick(uint8_t* p, RawStick s) {
+    p[0] = static_cast<uint8_t>(s.x & 0xFF);
+    p[1] = static_cast<uint8_t>(((s.x >> 8) & 0x0F) | ((s.y & 0x0F) << 4));
+    p[2] = static_cast<uint8_t>(s.y >> 4);
+}
+
+static void put_short(uint8_t* p, int16_t value) {
+    p[0] = static_cast<uint8_t>(value & 0xFF);
+    p[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+}
+
+// Physical units -> IMU counts, saturating like the sensor
+static int16_t to_counts(float value, float countsPerUnit) {
+    return static_cast<int16_t>(std::clamp(std::lround(value * countsPerUnit), -32768L, 32767L));
+}
+
+size_t EncodeInputFrame(const SimulatedInput& input, ControllerFamily family, uint8_t* out) {
+    const FrameLayout& L = FindFrameLayout(family);
+    std::memset(out, 0, JOYCON_FRAME_SIZE);
+
+    uint64_t state = input.buttons;
+    for (int i = 5; i >= 0; --i) {
+        out[L.buttons + i] = static_cast<uint8_t>(state & 0xFF);
+        state >>= 8;
+    }
+    put_stick(out + L.leftStick, input.leftStick);
+    put_stick(out + L.rightStick, input.rightStick);
+    put_short(out + L.optical, input.opticalX);
+    put_short(out + L.optical + 2, input.opticalY);
+    for (int axis = 0; axis < 3; ++axis) {
+        put_short(out + L.motion + axis * 2, to_counts(input.accelG[axis], IMU_ACCEL_COUNTS_PER_G));
+        put_short(out + L.motion + 6 + axis * 2, to_counts(input.gyroDps[axis], IMU_GYRO_COUNTS_PER_DPS));
+    }
+    out[L.triggers] = input.triggerL;
+    out[L.triggers + 1] = input.triggerR;
+    return SIMULATED_FRAME_LENGTH;
+}
+
+InputScript StepScript(std::vector<ScriptStep> steps) {
+    std::stable_sort(steps.begin(), steps.end(), [](const ScriptStep& a, const ScriptStep& b) { return a.atUs < b.atUs; });
+    return [steps = std::move(steps)](int64_t elapsedUs) {
+        auto next = std::upper_bound(steps.begin(), steps.end(), elapsedUs,
+                                     [](int64_t t, const ScriptStep& step) { return t < step.atUs; });
+        return next == steps.begin() ? SimulatedInput{} : std::prev(next)->input;
+    };
+}
+
+SimulatedController::SimulatedController(const SimulationSettings& settings, InputScript script)
+    : settings(settings), script(std::move(script)), rngState(settings.seed ? settings.seed : 1) {}
+
+// xorshift32: deterministic for a given seed
+uint32_t SimulatedController::Random() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+float SimulatedController::Noise(float amplitude) {
+    if (amplitude <= 0.0f) return 0.0f;
+    return amplitude * (static_cast<float>(Random() >> 8) / static_cast<float>(1u << 23) - 1.0f);
+}
+
+bool SimulatedController::NextFrame(uint8_t* frame, size_t& length, int64_t& arrivalOffsetUs) {
+    int64_t sampleUs = static_cast<int64_t>(static_cast<double>(sampleIndex++) * settings.periodUs);
+    SimulatedInput input = script ? script(sampleUs) : SimulatedInput{};
+    for (int axis = 0; axis < 3; ++axis) {
+        input.gyroDps[axis] += Noise(settings.gyroNoiseDps);
+        input.accelG[axis] += Noise(settings.accelNoiseG);
+    }
+    length = EncodeInputFrame(input, settings.family, frame);
+
+    // The radio delivers in order: a delayed notification holds back the ones behind it
+    double delay = settings.jitterUs * (static_cast<double>(Random()) / 4294967296.0);
+    arrivalOffsetUs = (std::max)(sampleUs + static_cast<int64_t>(delay), lastArrivalUs);
+    lastArrivalUs = arrivalOffsetUs;
+
+    if (static_cast<double>(Random()) / 4294967296.0 < settings.lossRate) {
+        lost.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool SimulatedController::Subscribe(NotificationHandler handler) {
+    Unsubscribe();
+    running.store(true, std::memory_order_release);
+    deliveryThread = std::thread([this, handler = std::move(handler)]() {
+        auto start = std::chrono::steady_clock::now() - std::chrono::microseconds(lastArrivalUs);
+        uint8_t frame[JOYCON_FRAME_SIZE];
+        while (running.load(std::memory_order_acquire)) {
+            size_t length = 0;
+            int64_t offsetUs = 0;
+            bool arrives = NextFrame(frame, length, offsetUs);
+            std::this_thread::sleep_until(start + std::chrono::microseconds(offsetUs));
+            if (!arrives || !running.load(std::memory_order_acquire)) continue;
+            delivered.fetch_add(1, std::memory_order_relaxed);
+            handler(frame, length, SteadyMicros(std::chrono::steady_clock::now()));
+        }
+    });
+    return true;
+}
+
+void SimulatedController::Unsubscribe() {
+    running.store(false, std::memory_order_release);
+    if (deliveryThread.joinable()) deliveryThread.join();
+}
+
+bool SimulatedController::Write(const uint8_t* data, size_t length) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    commands.emplace_back(data, data + length);
+    return true;
+}
+
+void SimulatedController::Generate(size_t count, const NotificationHandler& handler, int64_t startUs) {
+    uint8_t frame[JOYCON_FRAME_SIZE];
+    for (size_t i = 0; i < count; ++i) {
+        size_t length = 0;
+        int64_t offsetUs = 0;
+        if (!NextFrame(frame, length, offsetUs)) continue;
+        delivered.fetch_add(1, std::memory_order_relaxed);
+        handler(frame, length, startUs + offsetUs);
+    }
+}
+
+std::vector<std::vector<uint8_t>> SimulatedController::Commands() const {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    return commands;
+}
@@ -0,0 +1,99 @@
+#pragma once
+// SimulatedController - An IInputTransport that synthesizes Joy-Con 2, Pro Controller 2 and
+// NSO GC notifications from a script, at a configurable rate with delivery jitter and packet
+// loss, and records the command writes it receives. Drives the pipeline without hardware,
+// either in real time (Subscribe) or as fast as the consumer allows (Generate).
+#include "InputTransport.h"
+#include "JoyConDecoder.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Length of a real notification with IMU enabled
+constexpr size_t SIMULATED_FRAME_LENGTH = 63;
+
+// Controller state at one instant. Motion is in the controller's own axes (see
+// ImuNormalization.h) and physical units; buttons use the 48-bit notification layout.
+struct SimulatedInput {
+    uint64_t buttons = 0;
+    RawStick leftStick;
+    RawStick rightStick;
+    int16_t opticalX = 0;
+    int16_t opticalY = 0;
+    float gyroDps[3] = {};
+    float accelG[3] = { 0.0f, 0.0f, 1.0f };   // lying flat, face up
+    uint8_t triggerL = 0;
+    uint8_t triggerR = 0;
+};
+
+// Writes input with the family's layout into out (JOYCON_FRAME_SIZE bytes, zero-padded);
+// returns the notification length
+size_t EncodeInputFrame(const SimulatedInput& input, ControllerFamily family, uint8_t* out);
+
+// Input as a function of time since the first sample
+using InputScript = std::function<SimulatedInput(int64_t elapsedUs)>;
+
+// Holds each step's input from its start time until the next step
+struct ScriptStep {
+    int64_t atUs;
+    SimulatedInput input;
+};
+InputScript StepScript(std::vector<ScriptStep> steps);
+
+struct SimulationSettings {
+    ControllerFamily family = ControllerFamily::JoyCon2;
+    double periodUs = 15000.0;     // sample period
+    double jitterUs = 0.0;         // delivery delay, uniform in [0, jitterUs]; order is kept
+    double lossRate = 0.0;         // probability that a notification never arrives
+    float gyroNoiseDps = 0.0f;     // uniform noise amplitude added to each axis
+    float accelNoiseG = 0.0f;
+    uint64_t address = 0x98B6E9000000;
+    uint32_t seed = 1;
+};
+
+class SimulatedController : public IInputTransport {
+public:
+    SimulatedController(const SimulationSettings& settings, InputScript script);
+    ~SimulatedController() override { Unsubscribe(); }
+    SimulatedController(const SimulatedController&) = delete;
+    SimulatedController& operator=(const SimulatedController&) = delete;
+
+    ControllerFamily Family() const override { return settings.family; }
+    uint64_t Address() const override { return settings.address; }
+
+    // Real time: a delivery thread sleeps until each arrival and stamps it with the steady clock
+    bool Subscribe(NotificationHandler handler) override;
+    void Unsubscribe() override;
+
+    // Records the packet; always succeeds
+    bool Write(const uint8_t* data, size_t length) override;
+
+    // Offline: the next count samples delivered back to back on the calling thread, stamped with
+    // the simulated arrival times starting at startUs. Not while subscribed.
+    void Generate(size_t count, const NotificationHandler& handler, int64_t startUs = 0);
+
+    uint64_t Delivered() const { return delivered.load(std::memory_order_relaxed); }
+    uint64_t Lost() const { return lost.load(std::memory_order_relaxed); }
+    std::vector<std::vector<uint8_t>> Commands() const;
+
+private:
+    // The next sample from the script; false when its notification is lost
+    bool NextFrame(uint8_t* frame, size_t& length, int64_t& arrivalOffsetUs);
+    uint32_t Random();
+    float Noise(float amplitude);
+
+    const SimulationSettings settings;
+    const InputScript script;
+    uint64_t sampleIndex = 0;
+    int64_t lastArrivalUs = 0;
+    uint32_t rngState;
+
+    std::thread deliveryThread;
+    std::atomic<bool> running{ false };
+    std::atomic<uint64_t> delivered{ 0 };
+    std::atomic<uint64_t> lost{ 0 };
+
+    mutable std::mutex commandMutex;
+    std::vector<std::vector<uint8_t>> commands;
+};
@@ -0,0 +1,151 @@
+#include "StickCalibration.h"
+#include <algorithm>
+#include <cmath>
+
+// Calibrated sticks reach full deflection slightly before the learned edge, so a stick that
+// falls a few counts short on a given day still saturates
+constexpr float OUTER_MARGIN = 0.04f;
+
+// Uncalibrated sticks only reach about 60% of the raw range, which the original 1.7x gain
+// compensated for; curves use the same nominal extent so full deflection still saturates
+constexpr float LEGACY_EXTENT = 2048.0f / 1.7f;
+
+static int noise_deadzone(const StickCalibration& calibration) {
+    // Three times the resting jitter keeps a noisy stick from twitching out of the deadzone
+    return calibration.valid ? std::clamp(calibration.noise * 3 + 8, 16, 200) : 0;
+}
+
+// Normalized deflection of one raw value: 1.0 at the nominal edge in that direction
+static float normalize(int raw, int center, float posExtent, float negExtent) {
+    int d = raw - center;
+    return d >= 0 ? d / posExtent : d / negExtent;
+}
+
+static void build_legacy_axis(StickAxisLUT& axis) {
+    for (int raw = 0; raw < STICK_RAW_RANGE; ++raw) {
+        float v = (raw - 2048) / 2048.0f;
+        axis.rest[raw] = std::abs(v) < 0.08f;
+        v = std::clamp(v * 1.7f, -1.0f, 1.0f);
+        axis.value[raw] = static_cast<int16_t>(v * 32767);
+    }
+}
+
+static void build_calibrated_axis(StickAxisLUT& axis, int center, int minRaw, int maxRaw, int deadzone) {
+    const float posExtent = (std::max)(1.0f, (maxRaw - center) * (1.0f - OUTER_MARGIN));
+    const float negExtent = (std::max)(1.0f, (center - minRaw) * (1.0f - OUTER_MARGIN));
+
+    for (int raw = 0; raw < STICK_RAW_RANGE; ++raw) {
+        float v = normalize(raw, center, posExtent, negExtent);
+        axis.rest[raw] = std::abs(raw - center) < deadzone;
+        axis.value[raw] = static_cast<int16_t>(std::clamp(v, -1.0f, 1.0f) * 32767);
+    }
+}
+
+static void build_curve_axis(StickAxisLUT& axis, const StickCalibration& cal, bool isX,
+                             const StickCurve& curve, float noiseInner) {
+    int center = STICK_RAW_CENTER;
+    float posExtent = LEGACY_EXTENT, negExtent = LEGACY_EXTENT;
+    if (cal.valid) {
+        center = isX ? cal.centerX : cal.centerY;
+        posExtent = (std::max)(1.0f, float((isX ? cal.maxX : cal.maxY) - center));
+        negExtent = (std::max)(1.0f, float(center - (isX ? cal.minX : cal.minY)));
+    }
+
+    StickCurve axisCurve = curve;
+    axisCurve.innerDeadzone = (std::max)(curve.innerDeadzone, noiseInner);
+    for (int raw = 0; raw < STICK_RAW_RANGE; ++raw) {
+        float n = normalize(raw, center, posExtent, negExtent);
+        axis.rest[raw] = 0;
+        if (curve.mode == StickDeadzoneMode::Radial) {
+            axis.value[raw] = static_cast<int16_t>(std::clamp(n, -1.0f, 1.0f) * 32767);
+        } else {
+            float v = StickCurveResponse(axisCurve, std::abs(n));
+            axis.value[raw] = static_cast<int16_t>(std::copysign(std::min(v, 1.0f), n) * 32767);
+        }
+    }
+}
+
+static void build_radial_scale(StickLUT& lut, const StickCurve& curve, float noiseInner) {
+    StickCurve radialCurve = curve;
+    radialCurve.innerDeadzone = (std::max)(curve.innerDeadzone, noiseInner);
+    lut.radialScale[0] = 0;
+    for (int i = 1; i < STICK_RADIAL_STEPS; ++i) {
+        // Bucket midpoint, so the quantization error is split evenly
+        float m = ((i << STICK_RADIAL_SHIFT) + (1 << (STICK_RADIAL_SHIFT - 1))) / 32767.0f;
+        float out = (std::min)(StickCurveResponse(radialCurve, m), 1.0f);
+        lut.radialScale[i] = static_cast<uint32_t>(out / m * 65536.0f);
+    }
+}
+
+void BuildStickLUT(const StickCalibration& calibration, StickLUT& lut, const StickCurve& curve) {
+    lut.radial = false;
+    if (curve.mode != StickDeadzoneMode::Classic) {
+        // The noise deadzone is a raw count; express it against the shorter direction
+        float noiseInner = 0.0f;
+        if (calibration.valid) {
+            int shortest = (std::min)({ calibration.maxX - calibration.centerX, calibration.centerX - calibration.minX,
+                                      calibration.maxY - calibration.centerY, calibration.centerY - calibration.minY });
+            noiseInner = float(noise_deadzone(calibration)) / (std::max)(shortest, 1);
+        }
+        build_curve_axis(lut.x, calibration, true, curve, noiseInner);
+        build_curve_axis(lut.y, calibration, false, curve, noiseInner);
+        if (curve.mode == StickDeadzoneMode::Radial) {
+            build_radial_scale(lut, curve, noiseInner);
+            lut.radial = true;
+        }
+        return;
+    }
+
+    if (!calibration.valid) {
+        build_legacy_axis(lut.x);
+        build_legacy_axis(lut.y);
+        return;
+    }
+    const int deadzone = noise_deadzone(calibration);
+    build_calibrated_axis(lut.x, calibration.centerX, calibration.minX, calibration.maxX, deadzone);
+    build_calibrated_axis(lut.y, calibration.centerY, calibration.minY, calibration.maxY, deadzone);
+}
+
+static uint32_t isqrt(uint32_t v) {
+    uint32_t root = 0, bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+std::pair<int16_t, int16_t> MapStick(const StickLUT& lut, uint16_t xRaw, uint16_t yRaw) {
+    xRaw &= 0xFFF;
+    yRaw &= 0xFFF;
+    if (lut.x.rest[xRaw] && lut.y.rest[yRaw]) {
+        return { 0, 0 };
+    }
+    int32_t x = lut.x.value[xRaw];
+    int32_t y = lut.y.value[yRaw];
+    if (!lut.radial) {
+        return { static_cast<int16_t>(x), static_cast<int16_t>(y) };
+    }
+
+    uint32_t magnitude = isqrt(static_cast<uint32_t>(x * x + y * y));
+    int64_t scale = lut.radialScale[magnitude >> STICK_RADIAL_SHIFT];
+    auto apply = [scale](int32_t v) {
+        return static_cast<int16_t>(std::clamp<int64_t>(v * scale / 65536, -32767, 32767));
+    };
+    return { apply(x), apply(y) };
+}
+
+const StickLUT& DefaultStickLUT() {
+    static const StickLUT lut = [] {
+        StickLUT l;
+        BuildStickLUT(StickCalibration{}, l);
+        return l;
+    }();
+    return lut;
+}
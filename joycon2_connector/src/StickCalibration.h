@@ -0,0 +1,61 @@
+#pragma once
+// Per-stick calibration data and the lookup tables it and the response curve are baked into.
+// Report generation maps raw 12-bit stick values through these tables, so the per-frame path
+// is integer-only.
+#include "StickCurve.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+constexpr int STICK_RAW_RANGE = 4096;
+constexpr int STICK_RAW_CENTER = 2048;
+// Radial mode looks up a scale by vector magnitude (up to sqrt(2) * 32767) in steps of 8
+constexpr int STICK_RADIAL_SHIFT = 3;
+constexpr int STICK_RADIAL_STEPS = (46341 >> STICK_RADIAL_SHIFT) + 1;
+
+// Learned values for one physical stick, in raw 12-bit counts
+struct StickCalibration {
+    bool valid = false;        // false: legacy fixed center/gain/deadzone
+    uint16_t centerX = STICK_RAW_CENTER;
+    uint16_t centerY = STICK_RAW_CENTER;
+    uint16_t minX = 0, maxX = STICK_RAW_RANGE - 1;
+    uint16_t minY = 0, maxY = STICK_RAW_RANGE - 1;
+    uint16_t noise = 0;        // jitter amplitude at rest
+};
+
+// Saved calibration for one controller (keyed by Bluetooth address)
+struct StickCalibrationRecord {
+    std::string deviceId;
+    StickCalibration left;
+    StickCalibration right;
+};
+
+// Raw axis value -> output in [-32767, 32767]; rest[] marks values inside the deadzone
+struct StickAxisLUT {
+    std::array<int16_t, STICK_RAW_RANGE> value;
+    std::array<uint8_t, STICK_RAW_RANGE> rest;
+};
+
+struct StickLUT {
+    StickAxisLUT x;
+    StickAxisLUT y;
+    // Radial mode: x/y hold the linear position and the curve is applied to the magnitude;
+    // radialScale[magnitude >> STICK_RADIAL_SHIFT] is the Q16 factor applied to both axes
+    bool radial = false;
+    std::array<uint32_t, STICK_RADIAL_STEPS> radialScale;
+};
+
+// Classic curves on uncalibrated sticks reproduce the original mapping exactly: center 2048,
+// 0.08 square deadzone, 1.7x gain. Calibrated sticks scale each direction to its learned
+// extent. Axial and Radial curves replace the deadzone and gain with the curve's parameters.
+void BuildStickLUT(const StickCalibration& calibration, StickLUT& lut, const StickCurve& curve = {});
+const StickLUT& DefaultStickLUT();
+
+// Stick value -> DS4 thumb byte, identical to (v / 32767.0f) * 127 + 128 truncated
+constexpr uint8_t StickToByte(int16_t v) {
+    return static_cast<uint8_t>(v >= 0 ? 128 + (127 * v) / 32767 : 128 - (127 * -v + 32766) / 32767);
+}
+
+// Stick position after the table lookup (square deadzone, then the radial stage if enabled)
+std::pair<int16_t, int16_t> MapStick(const StickLUT& lut, uint16_t xRaw, uint16_t yRaw);
@@ -0,0 +1,139 @@
+#include "StickCalibrator.h"
+#include <algorithm>
+#include <cstdlib>
+
+// A sample counts as "at rest" when it is near the current center and barely moved since the
+// previous frame; only those feed the center and noise estimates
+constexpr int REST_WINDOW = 200;
+constexpr int STILL_DELTA = 24;
+constexpr int CENTER_SHIFT = 5;           // EMA over ~32 resting samples
+constexpr uint32_t MIN_REST_SAMPLES = 64;
+constexpr int MIN_EXTENT = 400;           // a direction counts as reached beyond this many counts
+
+// Republish checks run every CHECK_INTERVAL frames, and only rebuild the tables when the
+// estimate moved by more than these tolerances
+constexpr uint32_t CHECK_INTERVAL = 64;
+constexpr int CENTER_TOLERANCE = 4;
+constexpr int EXTENT_TOLERANCE = 16;
+constexpr int NOISE_TOLERANCE = 3;
+
+StickCalibrator::StickCalibrator(const StickCalibration& seed)
+    : centerXq(seed.centerX << 8), centerYq(seed.centerY << 8), noiseQ(seed.noise << 8) {
+    if (seed.valid) {
+        restSamples = MIN_REST_SAMPLES;
+        minX = seed.minX; maxX = seed.maxX;
+        minY = seed.minY; maxY = seed.maxY;
+    } else {
+        minX = maxX = seed.centerX;
+        minY = maxY = seed.centerY;
+    }
+}
+
+// New extents need two consecutive samples beyond the old one, so a single corrupt
+// notification cannot stretch the range
+static void track_extent(uint16_t v, uint16_t prev, uint16_t& lo, uint16_t& hi) {
+    if (v > hi && prev > hi) hi = (std::min)(v, prev);
+    if (v < lo && prev < lo) lo = (std::max)(v, prev);
+}
+
+void StickCalibrator::Observe(uint16_t x, uint16_t y) {
+    int dx = x - (centerXq >> 8);
+    int dy = y - (centerYq >> 8);
+    bool still = std::abs(x - prevX) <= STILL_DELTA && std::abs(y - prevY) <= STILL_DELTA;
+
+    if (still && std::abs(dx) <= REST_WINDOW && std::abs(dy) <= REST_WINDOW) {
+        centerXq += ((x << 8) - centerXq) >> CENTER_SHIFT;
+        centerYq += ((y << 8) - centerYq) >> CENTER_SHIFT;
+        int dev = (std::max)(std::abs(dx), std::abs(dy));
+        noiseQ += ((dev << 8) - noiseQ) >> CENTER_SHIFT;
+        if (restSamples < MIN_REST_SAMPLES) ++restSamples;
+    }
+
+    track_extent(x, prevX, minX, maxX);
+    track_extent(y, prevY, minY, maxY);
+    prevX = x;
+    prevY = y;
+}
+
+StickCalibration StickCalibrator::Current() const {
+    StickCalibration c;
+    c.centerX = static_cast<uint16_t>(centerXq >> 8);
+    c.centerY = static_cast<uint16_t>(centerYq >> 8);
+    c.minX = minX; c.maxX = maxX;
+    c.minY = minY; c.maxY = maxY;
+    c.noise = static_cast<uint16_t>(noiseQ >> 8);
+    c.valid = restSamples >= MIN_REST_SAMPLES &&
+              maxX - c.centerX >= MIN_EXTENT && c.centerX - minX >= MIN_EXTENT &&
+              maxY - c.centerY >= MIN_EXTENT && c.centerY - minY >= MIN_EXTENT;
+    return c;
+}
+
+static bool moved(const StickCalibration& a, const StickCalibration& b) {
+    auto far = [](int p, int q, int tol) { return std::abs(p - q) > tol; };
+    if (a.valid != b.valid) return true;
+    if (!a.valid) return false;
+    return far(a.centerX, b.centerX, CENTER_TOLERANCE) || far(a.centerY, b.centerY, CENTER_TOLERANCE) ||
+           far(a.minX, b.minX, EXTENT_TOLERANCE) || far(a.maxX, b.maxX, EXTENT_TOLERANCE) ||
+           far(a.minY, b.minY, EXTENT_TOLERANCE) || far(a.maxY, b.maxY, EXTENT_TOLERANCE) ||
+           far(a.noise, b.noise, NOISE_TOLERANCE);
+}
+
+ControllerStickCalibration::ControllerStickCalibration(std::string id, bool left_, bool right_,
+                                                       const StickCalibrationRecord* saved)
+    : deviceId(std::move(id)), hasLeft(left_), hasRight(right_),
+      left(saved ? saved->left : StickCalibration{}),
+      right(saved ? saved->right : StickCalibration{}),
+      leftLut(std::make_unique<StickLUT>()), rightLut(std::make_unique<StickLUT>()) {
+    published.deviceId = deviceId;
+    if (saved) {
+        published.left = saved->left;
+        published.right = saved->right;
+    }
+    BuildStickLUT(published.left, *leftLut);
+    BuildStickLUT(published.right, *rightLut);
+}
+
+void ControllerStickCalibration::Observe(const JoyConInputFrame& frame) {
+    if (frame.length < 16) return;
+    if (hasLeft) left.Observe(frame.leftStick.x, frame.leftStick.y);
+    if (hasRight) right.Observe(frame.rightStick.x, frame.rightStick.y);
+    if (++framesSinceCheck >= CHECK_INTERVAL) {
+        framesSinceCheck = 0;
+        Republish();
+    }
+}
+
+void ControllerStickCalibration::Republish() {
+    StickCalibration l = left.Current();
+    StickCalibration r = right.Current();
+    bool leftMoved = hasLeft && moved(l, published.left);
+    bool rightMoved = hasRight && moved(r, published.right);
+    if (!leftMoved && !rightMoved) return;
+
+    // Rebuilt in place: the tables are only read by this thread
+    if (leftMoved) BuildStickLUT(l, *leftLut, leftCurve);
+    if (rightMoved) BuildStickLUT(r, *rightLut, rightCurve);
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (leftMoved) published.left = l;
+    if (rightMoved) published.right = r;
+    learned = true;
+}
+
+void ControllerStickCalibration::SetCurves(const StickCurve& l, const StickCurve& r, uint32_t revision) {
+    leftCurve = l;
+    rightCurve = r;
+    curveRevision = revision;
+    BuildStickLUT(published.left, *leftLut, leftCurve);
+    BuildStickLUT(published.right, *rightLut, rightCurve);
+}
+
+StickCalibrationRecord ControllerStickCalibration::Snapshot() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return published;
+}
+
+bool ControllerStickCalibration::Learned() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return learned;
+}
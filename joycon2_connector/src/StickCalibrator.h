@@ -0,0 +1,60 @@
+#pragma once
+// Online stick calibration: learns each stick's resting center, per-direction extents and
+// noise floor from live frames, and rebuilds its lookup table when the estimate moves.
+#include "JoyConDecoder.h"
+#include "StickCalibration.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Learner for one physical stick. Integer-only per sample.
+class StickCalibrator {
+public:
+    explicit StickCalibrator(const StickCalibration& seed = {});
+
+    void Observe(uint16_t x, uint16_t y);
+    StickCalibration Current() const;
+
+private:
+    int32_t centerXq, centerYq;   // Q8 running center
+    int32_t noiseQ;               // Q8 mean absolute deviation at rest
+    uint32_t restSamples = 0;
+    uint16_t minX, maxX, minY, maxY;
+    uint16_t prevX = STICK_RAW_CENTER, prevY = STICK_RAW_CENTER;
+};
+
+// Calibration for one connected controller: learns whichever sticks it has and owns their
+// tables. Observe and the table accessors belong to the thread that generates reports;
+// Snapshot may be called from any thread.
+class ControllerStickCalibration {
+public:
+    ControllerStickCalibration(std::string deviceId, bool hasLeft, bool hasRight,
+                               const StickCalibrationRecord* saved = nullptr);
+
+    void Observe(const JoyConInputFrame& frame);
+
+    // Response curves are baked into the same tables; revision identifies the config they came from
+    void SetCurves(const StickCurve& left, const StickCurve& right, uint32_t revision);
+    uint32_t CurveRevision() const { return curveRevision; }
+
+    const StickLUT& Left() const { return *leftLut; }
+    const StickLUT& Right() const { return *rightLut; }
+    const StickLUT& Side(JoyConSide side) const { return side == JoyConSide::Left ? *leftLut : *rightLut; }
+
+    StickCalibrationRecord Snapshot() const;
+    bool Learned() const;   // true once a table was rebuilt from live data
+
+private:
+    void Republish();
+
+    std::string deviceId;
+    bool hasLeft, hasRight;
+    StickCalibrator left, right;
+    std::unique_ptr<StickLUT> leftLut, rightLut;
+    StickCurve leftCurve, rightCurve;
+    uint32_t curveRevision = 0;
+    StickCalibrationRecord published;
+    uint32_t framesSinceCheck = 0;
+    bool learned = false;
+    mutable std::mutex snapshotMutex;
+};
@@ -0,0 +1,98 @@
+#include "StickCurve.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+// Monotone cubic (Fritsch-Carlson) through (0,0), the user points and (1,1), so a
+// non-decreasing set of points never produces an overshooting curve
+static float evaluate_spline(const std::vector<std::pair<float, float>>& userPoints, float t) {
+    std::vector<std::pair<float, float>> p;
+    p.reserve(userPoints.size() + 2);
+    p.push_back({ 0.0f, 0.0f });
+    for (const auto& pt : userPoints)
+        if (pt.first > 0.0f && pt.first < 1.0f) p.push_back(pt);
+    p.push_back({ 1.0f, 1.0f });
+    std::sort(p.begin(), p.end());
+
+    const size_t n = p.size();
+    std::vector<float> slope(n - 1), tangent(n);
+    for (size_t i = 0; i + 1 < n; ++i) {
+        float dx = std::max(p[i + 1].first - p[i].first, 1e-6f);
+        slope[i] = (p[i + 1].second - p[i].second) / dx;
+    }
+    tangent[0] = slope[0];
+    tangent[n - 1] = slope[n - 2];
+    for (size_t i = 1; i + 1 < n; ++i)
+        tangent[i] = (slope[i - 1] * slope[i] <= 0.0f) ? 0.0f : (slope[i - 1] + slope[i]) * 0.5f;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        if (slope[i] == 0.0f) { tangent[i] = tangent[i + 1] = 0.0f; continue; }
+        float a = tangent[i] / slope[i], b = tangent[i + 1] / slope[i];
+        float h = a * a + b * b;
+        if (h > 9.0f) {
+            float s = 3.0f / std::sqrt(h);
+            tangent[i] = s * a * slope[i];
+            tangent[i + 1] = s * b * slope[i];
+        }
+    }
+
+    size_t k = 0;
+    while (k + 2 < n && t > p[k + 1].first) ++k;
+    float dx = std::max(p[k + 1].first - p[k].first, 1e-6f);
+    float u = std::clamp((t - p[k].first) / dx, 0.0f, 1.0f);
+    float u2 = u * u, u3 = u2 * u;
+    float h00 = 2 * u3 - 3 * u2 + 1, h10 = u3 - 2 * u2 + u;
+    float h01 = -2 * u3 + 3 * u2, h11 = u3 - u2;
+    return h00 * p[k].second + h10 * dx * tangent[k] + h01 * p[k + 1].second + h11 * dx * tangent[k + 1];
+}
+
+float EvaluateStickCurve(const StickCurve& curve, float t) {
+    t = std::clamp(t, 0.0f, 1.0f);
+    float shaped = curve.points.empty() ? std::pow(t, std::max(curve.exponent, 0.05f))
+                                        : evaluate_spline(curve.points, t);
+    return std::clamp(shaped, 0.0f, 1.0f);
+}
+
+float StickCurveResponse(const StickCurve& curve, float magnitude) {
+    float inner = std::clamp(curve.innerDeadzone, 0.0f, 0.9f);
+    float outer = std::clamp(curve.outerDeadzone, 0.0f, 0.9f - inner);
+    if (magnitude < inner) return 0.0f;
+    float t = (magnitude - inner) / std::max(1.0f - inner - outer, 0.01f);
+    float anti = std::clamp(curve.antiDeadzone, 0.0f, 0.9f);
+    return anti + (1.0f - anti) * EvaluateStickCurve(curve, t);
+}
+
+const char* StickDeadzoneModeToString(StickDeadzoneMode mode) {
+    switch (mode) {
+    case StickDeadzoneMode::Axial:  return "axial";
+    case StickDeadzoneMode::Radial: return "radial";
+    default: return "classic";
+    }
+}
+
+StickDeadzoneMode StringToStickDeadzoneMode(const std::string& str) {
+    if (str == "axial") return StickDeadzoneMode::Axial;
+    if (str == "radial") return StickDeadzoneMode::Radial;
+    return StickDeadzoneMode::Classic;
+}
+
+std::string StickCurvePointsToString(const std::vector<std::pair<float, float>>& points) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (i) oss << ';';
+        oss << points[i].first << ':' << points[i].second;
+    }
+    return oss.str();
+}
+
+std::vector<std::pair<float, float>> StringToStickCurvePoints(const std::string& str) {
+    std::vector<std::pair<float, float>> points;
+    std::istringstream iss(str);
+    std::string item;
+    while (std::getline(iss, item, ';')) {
+        float in = 0, out = 0;
+        if (std::sscanf(item.c_str(), "%f:%f", &in, &out) == 2 && in > 0.0f && in < 1.0f)
+            points.push_back({ in, std::clamp(out, 0.0f, 1.0f) });
+    }
+    return points;
+}
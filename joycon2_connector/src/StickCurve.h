@@ -0,0 +1,41 @@
+#pragma once
+// Stick response curves. Evaluated only when lookup tables are (re)built, never per frame.
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class StickDeadzoneMode {
+    Classic,   // original mapping: square deadzone, fixed 1.7x gain (curve parameters unused)
+    Axial,     // each axis has its own deadzone and curve
+    Radial     // deadzone and curve act on the stick's distance from center
+};
+
+struct StickCurve {
+    StickDeadzoneMode mode = StickDeadzoneMode::Classic;
+    float innerDeadzone = 0.08f;   // fraction of full deflection that reads as zero
+    float outerDeadzone = 0.04f;   // fraction near the edge that already reads as full deflection
+    float antiDeadzone = 0.0f;     // output the first step outside the deadzone jumps to
+    float exponent = 1.0f;         // response exponent (>1 = finer control near center)
+    // Custom curve through (input, output) points in (0, 1); (0,0) and (1,1) are implied.
+    // When set it replaces the exponent.
+    std::vector<std::pair<float, float>> points;
+};
+
+struct StickProfile {
+    std::string name;
+    StickCurve left;
+    StickCurve right;
+};
+
+// Shape applied between the inner and outer deadzones: t in [0, 1] -> [0, 1]
+float EvaluateStickCurve(const StickCurve& curve, float t);
+
+// Output magnitude for a normalized input magnitude (0 = center, 1 = nominal full deflection)
+float StickCurveResponse(const StickCurve& curve, float magnitude);
+
+const char* StickDeadzoneModeToString(StickDeadzoneMode mode);
+StickDeadzoneMode StringToStickDeadzoneMode(const std::string& str);
+
+// "0.25:0.1;0.5:0.35" <-> points (kept as a flat string so the config JSON stays one level deep)
+std::string StickCurvePointsToString(const std::vector<std::pair<float, float>>& points);
+std::vector<std::pair<float, float>> StringToStickCurvePoints(const std::string& str);
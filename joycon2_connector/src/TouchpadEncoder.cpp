@@ -0,0 +1,64 @@
+#include "TouchpadEncoder.h"
+
+void DS4TouchpadEncoder::Push(const JoyConInputFrame& frame, int finger) {
+    Finger& f = fingers[finger];
+    bool down = frame.length >= 0x18;   // same bound as DecodeMouseCoords
+    if (down && !f.down) f.trackingId = nextTrackingId++ & 0x7F;
+    f.down = down;
+    if (down) {
+        auto [x, y] = DecodeMouseCoords(frame);
+        f.x = x;
+        f.y = y;
+    }
+
+    // The other Joy-Con of a dual player produced the newest packet: fold this sample into it
+    // instead of spending a packet per notification
+    const uint8_t bit = static_cast<uint8_t>(1u << finger);
+    if (pendingCount > 0 && !(pending[pendingCount - 1].fresh & bit)) {
+        Packet& p = pending[pendingCount - 1];
+        p.fingers[finger] = f;
+        p.fresh |= bit;
+        return;
+    }
+
+    // More samples than one report can carry: only when reports stall, keep the newest
+    if (pendingCount == MAX_PACKETS) {
+        for (size_t i = 1; i < MAX_PACKETS; ++i) pending[i - 1] = pending[i];
+        --pendingCount;
+    }
+    Packet& p = pending[pendingCount++];
+    p.counter = ++packetCounter;
+    p.fresh = bit;
+    for (int i = 0; i < FINGERS; ++i) p.fingers[i] = fingers[i];
+}
+
+static void encode_finger(BYTE& isUpTrackingNum, BYTE (&data)[3], uint16_t x, uint16_t y, uint8_t trackingId, bool down) {
+    isUpTrackingNum = (down ? 0x00 : 0x80) | (trackingId & 0x7F);
+    data[0] = x & 0xFF;
+    data[1] = ((x >> 8) & 0x0F) | ((y & 0x0F) << 4);
+    data[2] = (y >> 4) & 0xFF;
+}
+
+void DS4TouchpadEncoder::Encode(DS4_REPORT_EX& report) {
+    if (pendingCount == 0) {
+        pending[0] = last;
+        pendingCount = 1;
+    }
+
+    DS4_TOUCH* slots[MAX_PACKETS] = {
+        &report.Report.sCurrentTouch, &report.Report.sPreviousTouch[0], &report.Report.sPreviousTouch[1] };
+    for (size_t i = 0; i < MAX_PACKETS; ++i) *slots[i] = DS4_TOUCH{};
+    for (size_t i = 0; i < pendingCount; ++i) {
+        const Packet& p = pending[i];
+        DS4_TOUCH& touch = *slots[i];
+        touch.bPacketCounter = p.counter;
+        encode_finger(touch.bIsUpTrackingNum1, touch.bTouchData1,
+            p.fingers[0].x, p.fingers[0].y, p.fingers[0].trackingId, p.fingers[0].down);
+        encode_finger(touch.bIsUpTrackingNum2, touch.bTouchData2,
+            p.fingers[1].x, p.fingers[1].y, p.fingers[1].trackingId, p.fingers[1].down);
+    }
+    report.Report.bTouchPacketsN = static_cast<BYTE>(pendingCount);
+
+    last = pending[pendingCount - 1];
+    pendingCount = 0;
+}
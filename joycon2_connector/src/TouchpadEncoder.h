@@ -0,0 +1,39 @@
+#pragma once
+// Stateful DS4 touchpad: every optical sample becomes a touch packet with its own packet
+// counter, and the packets queued since the last report go out together through the report's
+// touch history, so motion between two reports is not lost.
+#include "JoyConDecoder.h"
+
+// One per player. Push and Encode must not run concurrently; the dual player serializes them.
+class DS4TouchpadEncoder {
+public:
+    static constexpr size_t MAX_PACKETS = 3;   // sCurrentTouch + sPreviousTouch[2]
+    static constexpr int FINGERS = 2;
+
+    // Queue the optical sample of one notification. Finger 0 is the single (or left) Joy-Con,
+    // finger 1 the right Joy-Con of a dual player. Frames without optical data lift the finger.
+    void Push(const JoyConInputFrame& frame, int finger = 0);
+
+    // Write the queued packets into the report, oldest first (drivers replay them in order),
+    // and start a new batch. Without new samples the newest packet is repeated unchanged.
+    void Encode(DS4_REPORT_EX& report);
+
+private:
+    struct Finger {
+        uint16_t x = 0, y = 0;
+        uint8_t trackingId = 0;
+        bool down = false;
+    };
+    struct Packet {
+        uint8_t counter = 0;
+        uint8_t fresh = 0;   // fingers sampled into this packet, one bit each
+        Finger fingers[FINGERS];
+    };
+
+    Finger fingers[FINGERS];
+    Packet pending[MAX_PACKETS];
+    size_t pendingCount = 0;
+    Packet last;
+    uint8_t packetCounter = 0;
+    uint8_t nextTrackingId = 0;
+};
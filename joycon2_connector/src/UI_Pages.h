@@ -307,6 +307,41 @@ inline void RenderDashboard() {
             UITheme::ColorFromHex(0xF8D7DA), UITheme::Error);
     }
 
+    // Cemuhook DSU motion server for emulators
+    auto& dsuConfig = ConfigManager::Instance().config.dsuConfig;
+    ImGui::Spacing();
+    if (ImGui::Checkbox(T("dash_dsu"), &dsuConfig.enabled)) {
+        PlayerManager::Instance().ApplyDsuConfig();
+        ConfigManager::Instance().Save();
+    }
+    if (dsuConfig.enabled) {
+        ImGui::SameLine();
+        if (PlayerManager::Instance().DsuRunning())
+            ImGui::TextColored(UITheme::TextSecondary, "127.0.0.1:%d", dsuConfig.port);
+        else
+            ImGui::TextColored(UITheme::Error, T("dash_dsu_fail"), dsuConfig.port);
+    }
+
+    // Session capture: raw notifications and command writes, for replay with joycon2_replay
+    auto& capture = CaptureSession::Instance();
+    static bool captureFailed = false;
+    bool capturing = capture.Running();
+    if (ImGui::Checkbox(T("dash_capture"), &capturing)) {
+        if (capturing) captureFailed = !capture.Start(DefaultCapturePath());
+        else capture.Stop();
+    }
+    if (capture.Running()) {
+        ImGui::SameLine();
+        ImGui::TextColored(UITheme::TextSecondary, "%s", capture.Path().c_str());
+        if (uint64_t dropped = capture.Dropped()) {
+            ImGui::SameLine();
+            ImGui::TextColored(UITheme::Error, T("dash_capture_dropped"), static_cast<unsigned long long>(dropped));
+        }
+    } else if (captureFailed) {
+        ImGui::SameLine();
+        ImGui::TextColored(UITheme::Error, "%s", T("dash_capture_fail"));
+    }
+
     ImGui::Spacing(); ImGui::Spacing();
 
     auto& pm = PlayerManager::Instance();
@@ -388,6 +423,14 @@ inline void RenderDashboard() {
             if (p->gyroSource == GyroSource::Left) gyroName = T("dash_gyro_left");
             else if (p->gyroSource == GyroSource::Right) gyroName = T("dash_gyro_right");
             ImGui::TextColored(UITheme::TextSecondary, "%s  |  %s: %s", T("dash_mapping"), T("dash_gyro_source"), gyroName);
+            if (p->mergeLatency.Count() > 0) {
+                ImGui::TextColored(UITheme::TextSecondary, "%s: p50 %lld us  p99 %lld us  max %lld us", T("dash_merge_latency"),
+                    (long long)p->mergeLatency.PercentileUs(0.5), (long long)p->mergeLatency.PercentileUs(0.99),
+                    (long long)p->mergeLatency.MaxUs());
+                ImGui::TextColored(UITheme::TextSecondary, "%s: p50 %lld us  p99 %lld us  |  %s: %llu", T("dash_merge_skew"),
+                    (long long)p->mergeSkew.PercentileUs(0.5), (long long)p->mergeSkew.PercentileUs(0.99),
+                    T("dash_merge_expired"), (unsigned long long)p->mergeExpired.load(std::memory_order_relaxed));
+            }
             ImGui::EndGroup();
 
             ImGui::SameLine(ImGui::GetContentRegionAvail().x - S(80));
@@ -928,7 +971,7 @@ inline void RenderMouseSettings() {
     if (mouseConfig.interpolationEnabled) {
         ImGui::Text("%s", T("mouse_interp_rate"));
         ImGui::SetNextItemWidth(sliderW);
-        if (ImGui::SliderInt("##interpRate", &mouseConfig.interpolationRateHz, 100, 500, "%d Hz"))
+        if (ImGui::SliderInt("##interpRate", &mouseConfig.interpolationRateHz, 100, 1000, "%d Hz"))
             changed = true;
     }
 
@@ -936,6 +979,65 @@ inline void RenderMouseSettings() {
 
     ImGui::Spacing(); ImGui::Spacing();
 
+    // Pointer source and gyro aiming card
+    BeginCard();
+    const char* sourceNames[] = { T("mouse_source_optical"), T("mouse_source_gyro"), T("mouse_source_flick") };
+    int sourceIdx = static_cast<int>(mouseConfig.source);
+    ImGui::Text("%s", T("mouse_source"));
+    ImGui::SetNextItemWidth(S(220));
+    if (ImGui::Combo("##source", &sourceIdx, sourceNames, 3)) {
+        mouseConfig.source = static_cast<MouseSource>(sourceIdx);
+        changed = true;
+    }
+
+    if (mouseConfig.source != MouseSource::Optical) {
+        GyroMouseSettings& gyro = mouseConfig.gyro;
+        ImGui::TextColored(UITheme::TextTertiary, "%s", T("mouse_gyro_hint"));
+        ImGui::Spacing();
+
+        bool world = gyro.space == GyroSpace::World;
+        if (ImGui::Checkbox(T("mouse_gyro_world"), &world)) {
+            gyro.space = world ? GyroSpace::World : GyroSpace::Local;
+            changed = true;
+        }
+
+        ImGui::Text("%s", T("mouse_gyro_sens"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::DragFloatRange2("##gyroSens", &gyro.minSens, &gyro.maxSens, 0.01f, 0.1f, 10.0f, "%.2f", "%.2f"))
+            changed = true;
+
+        ImGui::Text("%s", T("mouse_gyro_threshold"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::DragFloatRange2("##gyroThreshold", &gyro.minThresholdDps, &gyro.maxThresholdDps, 1.0f, 0.0f, 720.0f, "%.0f", "%.0f"))
+            changed = true;
+
+        ImGui::Text("%s", T("mouse_gyro_deadband"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::SliderFloat("##gyroDeadband", &gyro.deadbandDps, 0.0f, 5.0f, "%.1f"))
+            changed = true;
+
+        ImGui::Text("%s", T("mouse_counts_per_360"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::DragFloat("##countsPer360", &gyro.countsPer360, 10.0f, 100.0f, 100000.0f, "%.0f"))
+            changed = true;
+
+        if (mouseConfig.source == MouseSource::GyroFlick) {
+            ImGui::Spacing();
+            ImGui::Text("%s", T("mouse_flick_threshold"));
+            ImGui::SetNextItemWidth(sliderW);
+            if (ImGui::SliderFloat("##flickThreshold", &gyro.flickThreshold, 0.5f, 1.0f, "%.2f"))
+                changed = true;
+
+            ImGui::Text("%s", T("mouse_flick_time"));
+            ImGui::SetNextItemWidth(sliderW);
+            if (ImGui::SliderFloat("##flickTime", &gyro.flickTimeMs, 0.0f, 300.0f, "%.0f ms"))
+                changed = true;
+        }
+    }
+    EndCard();
+
+    ImGui::Spacing(); ImGui::Spacing();
+
     // Current mode indicator card
     BeginCard();
     ImGui::Text("%s: ", T("mouse_current_mode"));
@@ -957,3 +1059,165 @@ inline void RenderMouseSettings() {
 
     ImGui::EndChild();
 }
+
+// =============================================================
+// PAGE: Stick Settings
+// =============================================================
+// Returns true when the curve was edited
+inline bool RenderStickCurveCard(const char* id, const char* titleKey, StickCurve& curve, float sliderW) {
+    bool changed = false;
+    ImGui::PushID(id);
+    BeginCard();
+    ImGui::TextColored(UITheme::Primary, "%s", T(titleKey));
+    ImGui::Spacing();
+
+    const char* modeNames[] = { T("stick_mode_classic"), T("stick_mode_axial"), T("stick_mode_radial") };
+    int modeIdx = static_cast<int>(curve.mode);
+    ImGui::Text("%s", T("stick_mode"));
+    ImGui::SetNextItemWidth(S(220));
+    if (ImGui::Combo("##mode", &modeIdx, modeNames, 3)) {
+        curve.mode = static_cast<StickDeadzoneMode>(modeIdx);
+        changed = true;
+    }
+
+    if (curve.mode == StickDeadzoneMode::Classic) {
+        ImGui::TextColored(UITheme::TextTertiary, "%s", T("stick_classic_hint"));
+    } else {
+        ImGui::Spacing();
+        ImGui::Text("%s", T("stick_inner"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::SliderFloat("##inner", &curve.innerDeadzone, 0.0f, 0.5f, "%.2f")) changed = true;
+
+        ImGui::Text("%s", T("stick_outer"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::SliderFloat("##outer", &curve.outerDeadzone, 0.0f, 0.3f, "%.2f")) changed = true;
+
+        ImGui::Text("%s", T("stick_anti"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::SliderFloat("##anti", &curve.antiDeadzone, 0.0f, 0.5f, "%.2f")) changed = true;
+
+        if (curve.points.empty()) {
+            ImGui::Text("%s", T("stick_exponent"));
+            ImGui::SetNextItemWidth(sliderW);
+            if (ImGui::SliderFloat("##exp", &curve.exponent, 0.3f, 3.0f, "%.2f")) changed = true;
+        } else {
+            ImGui::TextColored(UITheme::TextTertiary, "%s", T("stick_points_hint"));
+        }
+    }
+    EndCard();
+    ImGui::PopID();
+    return changed;
+}
+
+inline void RenderStickSettings() {
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(S(24), S(24)));
+    ImGui::BeginChild("StickContent", ImVec2(0, 0), ImGuiChildFlags_None);
+    ImGui::PopStyleVar();
+    ImGui::SetCursorPos(ImVec2(S(24), S(16)));
+
+    SectionLabel(T("stick_title"));
+
+    ImGui::TextColored(UITheme::TextTertiary, "%s", T("stick_hint"));
+    ImGui::Spacing(); ImGui::Spacing();
+
+    auto& stickConfig = ConfigManager::Instance().config.stickConfig;
+    if (stickConfig.profiles.empty()) {
+        ImGui::EndChild();
+        return;
+    }
+    int selected = std::clamp(stickConfig.activeProfileIndex, 0, (int)stickConfig.profiles.size() - 1);
+    bool changed = false;
+
+    // Profile selector card: the selected profile is the active one
+    BeginCard();
+    ImGui::Text("%s", T("stick_profile"));
+    ImGui::SetNextItemWidth(S(220));
+    if (ImGui::BeginCombo("##profile", stickConfig.profiles[selected].name.c_str())) {
+        for (int i = 0; i < (int)stickConfig.profiles.size(); ++i) {
+            ImGui::PushID(i);
+            if (ImGui::Selectable(stickConfig.profiles[i].name.c_str(), i == selected)) {
+                stickConfig.activeProfileIndex = selected = i;
+                changed = true;
+            }
+            ImGui::PopID();
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::SameLine();
+    if (PrimaryButton(T("stick_profile_add"))) {
+        StickProfile profile = stickConfig.profiles[selected];
+        profile.name = "Profile " + std::to_string(stickConfig.profiles.size() + 1);
+        stickConfig.profiles.push_back(profile);
+        stickConfig.activeProfileIndex = selected = (int)stickConfig.profiles.size() - 1;
+        changed = true;
+    }
+    ImGui::SameLine();
+    if (DangerButton(T("stick_profile_delete")) && stickConfig.profiles.size() > 1) {
+        stickConfig.profiles.erase(stickConfig.profiles.begin() + selected);
+        stickConfig.activeProfileIndex = selected =
+            (std::min)(selected, (int)stickConfig.profiles.size() - 1);
+        changed = true;
+    }
+    EndCard();
+
+    ImGui::Spacing(); ImGui::Spacing();
+
+    auto& profile = stickConfig.profiles[selected];
+    float sliderW = (std::max)(ImGui::GetContentRegionAvail().x - S(100), S(120));
+    if (RenderStickCurveCard("left", "stick_left", profile.left, sliderW)) changed = true;
+    ImGui::Spacing(); ImGui::Spacing();
+    if (RenderStickCurveCard("right", "stick_right", profile.right, sliderW)) changed = true;
+
+    ImGui::Spacing(); ImGui::Spacing();
+
+    // Gyro to right stick card (applies to every controller, not stored in the profile)
+    GyroStickSettings& gyroStick = ConfigManager::Instance().config.gyroStickConfig;
+    bool gyroStickChanged = false;
+    BeginCard();
+    ImGui::TextColored(UITheme::Primary, "%s", T("gyro_stick_title"));
+    ImGui::TextColored(UITheme::TextTertiary, "%s", T("gyro_stick_hint"));
+    ImGui::Spacing();
+    const char* gyroStickModes[] = { T("gyro_stick_off"), T("gyro_stick_replace"), T("gyro_stick_blend") };
+    int gyroStickMode = static_cast<int>(gyroStick.mode);
+    ImGui::SetNextItemWidth(S(220));
+    if (ImGui::Combo("##gyroStickMode", &gyroStickMode, gyroStickModes, 3)) {
+        gyroStick.mode = static_cast<GyroStickMode>(gyroStickMode);
+        gyroStickChanged = true;
+    }
+    if (gyroStick.mode != GyroStickMode::Off) {
+        bool world = gyroStick.space == GyroSpace::World;
+        if (ImGui::Checkbox(T("mouse_gyro_world"), &world)) {
+            gyroStick.space = world ? GyroSpace::World : GyroSpace::Local;
+            gyroStickChanged = true;
+        }
+
+        ImGui::Text("%s", T("gyro_stick_gain"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::SliderFloat("##gyroStickGain", &gyroStick.fullDeflectionDps, 30.0f, 720.0f, "%.0f dps"))
+            gyroStickChanged = true;
+
+        ImGui::Text("%s", T("gyro_stick_deadzone"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::SliderFloat("##gyroStickDeadzone", &gyroStick.deadzoneDps, 0.0f, 20.0f, "%.1f dps"))
+            gyroStickChanged = true;
+
+        ImGui::Text("%s", T("gyro_stick_min"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::SliderFloat("##gyroStickMin", &gyroStick.minDeflection, 0.0f, 0.5f, "%.2f"))
+            gyroStickChanged = true;
+
+        ImGui::Text("%s", T("gyro_stick_smoothing"));
+        ImGui::SetNextItemWidth(sliderW);
+        if (ImGui::SliderFloat("##gyroStickSmoothing", &gyroStick.smoothingMs, 0.0f, 100.0f, "%.0f ms"))
+            gyroStickChanged = true;
+    }
+    EndCard();
+    if (gyroStickChanged) ConfigManager::Instance().Save();
+
+    if (changed) {
+        ConfigManager::Instance().PublishStickProfile();
+        ConfigManager::Instance().Save();
+    }
+
+    ImGui::EndChild();
+}
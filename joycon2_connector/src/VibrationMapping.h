@@ -0,0 +1,39 @@
+#pragma once
+// VibrationMapping - Maps DS4 rumble motor levels onto the Joy-Con 2 predefined vibration samples
+#include <algorithm>
+#include <cstdint>
+
+// Vibration sample IDs (from protocol reverse engineering)
+enum VibrationSample : uint8_t {
+    VIB_NONE        = 0x00,  // No sound / stop
+    VIB_BUZZ        = 0x01,  // 1s sustained buzz
+    VIB_FIND        = 0x02,  // Find controller (high pitch + beeps)
+    VIB_CONNECT     = 0x03,  // Button click sound
+    VIB_PAIRING     = 0x04,  // Pairing sound
+    VIB_STRONG_THUNK= 0x05,  // Strong thunk impact
+    VIB_DUN         = 0x06,  // Short dun
+    VIB_DING        = 0x07,  // Short ding
+};
+
+struct VibrationMotors {
+    uint8_t left = 0;   // DS4 large motor
+    uint8_t right = 0;  // DS4 small motor
+};
+
+// Apply the user intensity factor (0.0 - 1.0) to the DS4 motor levels
+inline VibrationMotors ScaleVibration(uint8_t largeMotor, uint8_t smallMotor, float intensity) {
+    float scaledLarge = largeMotor * intensity;
+    float scaledSmall = smallMotor * intensity;
+    VibrationMotors motors;
+    motors.left = static_cast<uint8_t>((std::min)(scaledLarge, 255.0f));
+    motors.right = static_cast<uint8_t>((std::min)(scaledSmall, 255.0f));
+    return motors;
+}
+
+// Map motor values to predefined vibration samples
+inline uint8_t SelectVibrationSample(const VibrationMotors& motors) {
+    if (motors.left == 0 && motors.right == 0) return VIB_NONE;
+    if (motors.left > 180 || motors.right > 180) return VIB_BUZZ;          // Strong sustained vibration
+    if (motors.left > 80 || motors.right > 80) return VIB_STRONG_THUNK;    // Medium impact
+    return VIB_DUN;                                                        // Light feedback
+}
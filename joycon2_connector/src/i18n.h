@@ -27,6 +27,7 @@ inline const char* T(const char* key) {
         {"nav_add_device",      {{"en", "Add Device"},               {"zh", u8"添加设备"}}},
         {"nav_layout_mgr",     {{"en", "Layout Manager"},           {"zh", u8"背键布局"}}},
         {"nav_mouse_settings", {{"en", "Mouse Settings"},           {"zh", u8"鼠标设置"}}},
+        {"nav_stick_settings", {{"en", "Stick Settings"},           {"zh", u8"摇杆设置"}}},
         {"nav_language",        {{"en", "Language"},                  {"zh", u8"语言"}}},
 
         // Dashboard
@@ -37,6 +38,9 @@ inline const char* T(const char* key) {
         {"dash_player",         {{"en", "Player"},                   {"zh", u8"玩家"}}},
         {"dash_mapping",        {{"en", "Mapping: DS4"},             {"zh", u8"映射: DS4"}}},
         {"dash_gyro_source",    {{"en", "Gyro Source"},              {"zh", u8"体感源"}}},
+        {"dash_merge_latency",  {{"en", "Wake to submit"},           {"zh", u8"唤醒至提交"}}},
+        {"dash_merge_skew",     {{"en", "L/R skew"},                 {"zh", u8"左右时差"}}},
+        {"dash_merge_expired",  {{"en", "unpaired"},                 {"zh", u8"未配对"}}},
         {"dash_disconnect",     {{"en", "Disconnect"},               {"zh", u8"断开连接"}}},
         {"dash_side_left",      {{"en", "Left"},                     {"zh", u8"左"}}},
         {"dash_side_right",     {{"en", "Right"},                    {"zh", u8"右"}}},
@@ -45,6 +49,11 @@ inline const char* T(const char* key) {
         {"dash_gyro_both",      {{"en", "Both"},                     {"zh", u8"双侧"}}},
         {"dash_gyro_left",      {{"en", "Left"},                     {"zh", u8"左侧"}}},
         {"dash_gyro_right",     {{"en", "Right"},                    {"zh", u8"右侧"}}},
+        {"dash_dsu",            {{"en", "DSU motion server (Cemuhook)"}, {"zh", u8"DSU 体感服务器 (Cemuhook)"}}},
+        {"dash_dsu_fail",       {{"en", "Port %d unavailable"},      {"zh", u8"端口 %d 不可用"}}},
+        {"dash_capture",        {{"en", "Record session capture"},   {"zh", u8"录制会话数据"}}},
+        {"dash_capture_fail",   {{"en", "Cannot create capture file"}, {"zh", u8"无法创建录制文件"}}},
+        {"dash_capture_dropped", {{"en", "%llu notifications dropped"}, {"zh", u8"丢弃 %llu 条通知"}}},
 
         // Controller Types
         {"type_single_joycon",  {{"en", "Single Joy-Con"},           {"zh", u8"单 Joy-Con"}}},
@@ -106,6 +115,54 @@ inline const char* T(const char* key) {
                                                                      {"zh", u8"光标平滑（插值）"}}},
         {"mouse_interp_rate",    {{"en", "Interpolation Rate (Hz)"},
                                                                      {"zh", u8"插值频率 (Hz)"}}},
+        {"mouse_source",         {{"en", "Pointer Source"},          {"zh", u8"指针来源"}}},
+        {"mouse_source_optical", {{"en", "Optical Sensor"},          {"zh", u8"光学传感器"}}},
+        {"mouse_source_gyro",    {{"en", "Gyro"},                    {"zh", u8"陀螺仪"}}},
+        {"mouse_source_flick",   {{"en", "Gyro + Flick Stick"},      {"zh", u8"陀螺仪 + 甩动摇杆"}}},
+        {"mouse_gyro_hint",      {{"en", "Hold Y to lift the pointer and re-center the controller"},
+                                                                     {"zh", u8"按住 Y 键可暂停指针并重新摆正手柄"}}},
+        {"mouse_gyro_world",     {{"en", "Turn around gravity (ignore roll)"},
+                                                                     {"zh", u8"绕重力方向转向（忽略横滚）"}}},
+        {"mouse_gyro_sens",      {{"en", "Gyro Sensitivity (slow / fast)"},
+                                                                     {"zh", u8"陀螺仪灵敏度（慢 / 快）"}}},
+        {"mouse_gyro_threshold", {{"en", "Acceleration Range (deg/s)"},
+                                                                     {"zh", u8"加速区间（度/秒）"}}},
+        {"mouse_gyro_deadband",  {{"en", "Tremor Deadband (deg/s)"}, {"zh", u8"抖动死区（度/秒）"}}},
+        {"mouse_counts_per_360", {{"en", "Mouse Counts per 360"},    {"zh", u8"转身一周的鼠标计数"}}},
+        {"mouse_flick_threshold",{{"en", "Flick Threshold"},         {"zh", u8"甩动阈值"}}},
+        {"mouse_flick_time",     {{"en", "Flick Time"},              {"zh", u8"甩动时间"}}},
+
+        // Stick Settings
+        {"stick_title",         {{"en", "Stick Response"},           {"zh", u8"摇杆响应"}}},
+        {"stick_hint",          {{"en", "Changes apply immediately to all connected controllers"},
+                                                                     {"zh", u8"修改会立即应用到所有已连接的手柄"}}},
+        {"stick_profile",       {{"en", "Profile"},                  {"zh", u8"配置方案"}}},
+        {"stick_profile_add",   {{"en", "+ New Profile"},            {"zh", u8"+ 新建方案"}}},
+        {"stick_profile_delete",{{"en", "Delete"},                   {"zh", u8"删除"}}},
+        {"stick_left",          {{"en", "Left Stick"},               {"zh", u8"左摇杆"}}},
+        {"stick_right",         {{"en", "Right Stick"},              {"zh", u8"右摇杆"}}},
+        {"stick_mode",          {{"en", "Deadzone Mode"},            {"zh", u8"死区模式"}}},
+        {"stick_mode_classic",  {{"en", "Classic"},                  {"zh", u8"经典"}}},
+        {"stick_mode_axial",    {{"en", "Axial"},                    {"zh", u8"轴向"}}},
+        {"stick_mode_radial",   {{"en", "Radial"},                   {"zh", u8"径向"}}},
+        {"stick_inner",         {{"en", "Inner Deadzone"},           {"zh", u8"内死区"}}},
+        {"stick_outer",         {{"en", "Outer Deadzone"},           {"zh", u8"外死区"}}},
+        {"stick_anti",          {{"en", "Anti-Deadzone"},            {"zh", u8"反死区"}}},
+        {"stick_exponent",      {{"en", "Response Exponent"},        {"zh", u8"响应指数"}}},
+        {"stick_classic_hint",  {{"en", "Classic keeps the original fixed response"},
+                                                                     {"zh", u8"经典模式保持原有的固定响应"}}},
+        {"stick_points_hint",   {{"en", "Custom curve points are set (edit them in joycon2_config.json)"},
+                                                                     {"zh", u8"已设置自定义曲线点（可在 joycon2_config.json 中编辑）"}}},
+        {"gyro_stick_title",    {{"en", "Gyro to Right Stick"},      {"zh", u8"体感转右摇杆"}}},
+        {"gyro_stick_hint",     {{"en", "For games without motion controls: turning the controller moves the right stick"},
+                                                                     {"zh", u8"适用于不支持体感的游戏：转动手柄即推动右摇杆"}}},
+        {"gyro_stick_off",      {{"en", "Off"},                      {"zh", u8"关闭"}}},
+        {"gyro_stick_replace",  {{"en", "Replace right stick"},      {"zh", u8"替代右摇杆"}}},
+        {"gyro_stick_blend",    {{"en", "Add to right stick"},       {"zh", u8"叠加到右摇杆"}}},
+        {"gyro_stick_gain",     {{"en", "Full Deflection Speed"},    {"zh", u8"满偏转速"}}},
+        {"gyro_stick_deadzone", {{"en", "Deadzone"},                 {"zh", u8"死区"}}},
+        {"gyro_stick_min",      {{"en", "Minimum Deflection"},       {"zh", u8"最小偏移"}}},
+        {"gyro_stick_smoothing",{{"en", "Smoothing"},                {"zh", u8"平滑"}}},
 
     };
 
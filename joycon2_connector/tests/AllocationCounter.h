@@ -0,0 +1,26 @@
+#pragma once
+// Counts every heap allocation (and its bytes) in the test or benchmark executable, so a test
+// can show that a steady-state path makes none. Include from exactly one translation unit: it
+// replaces global operator new and delete.
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+inline std::atomic<uint64_t> g_allocations{ 0 };
+inline std::atomic<uint64_t> g_allocatedBytes{ 0 };
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+inline uint64_t AllocationCount() { return g_allocations.load(std::memory_order_relaxed); }
+inline uint64_t AllocatedBytes() { return g_allocatedBytes.load(std::memory_order_relaxed); }
@@ -0,0 +1,91 @@
+// Batch decoder parity: every kernel must match DecodeInputFrame/DecodeMotion field for field
+#include "TestUtil.h"
+#include "BatchDecoder.h"
+
+namespace {
+
+uint32_t g_rng = 0x1234567u;
+
+uint32_t NextRandom() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+// Random bytes everywhere (so every bit of every field is exercised), a mix of short
+// notifications, and a count that is not a multiple of any kernel's block size
+void BuildFrames(size_t count, std::vector<uint8_t>& frames, std::vector<uint32_t>& lengths) {
+    frames.assign(count * JOYCON_FRAME_SIZE, 0);
+    lengths.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t length = (NextRandom() % 8 == 0) ? NextRandom() % 20 : sizeof(SAMPLE_NOTIFICATION);
+        lengths[i] = length;
+        for (uint32_t b = 0; b < length; ++b)
+            frames[i * JOYCON_FRAME_SIZE + b] = static_cast<uint8_t>(NextRandom());
+    }
+}
+
+void CheckKernel(BatchKernel kernel, const std::vector<uint8_t>& frames, const std::vector<uint32_t>& lengths) {
+    FrameBatch batch;
+    DecodeFrameBatch(frames, lengths, batch, kernel);
+    const size_t count = lengths.size();
+    CHECK(batch.count == count);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        JoyConFrameView raw(frames.data() + i * JOYCON_FRAME_SIZE, JOYCON_FRAME_SIZE);
+        JoyConInputFrame f = DecodeInputFrame(raw, lengths[i]);
+        MotionData m = DecodeMotion(raw);
+        bool same =
+            batch.buttons[i] == f.buttons &&
+            batch.leftX[i] == f.leftStick.x && batch.leftY[i] == f.leftStick.y &&
+            batch.rightX[i] == f.rightStick.x && batch.rightY[i] == f.rightStick.y &&
+            batch.accelX[i] == m.accelX && batch.accelY[i] == m.accelY && batch.accelZ[i] == m.accelZ &&
+            batch.gyroX[i] == m.gyroX && batch.gyroY[i] == m.gyroY && batch.gyroZ[i] == m.gyroZ &&
+            batch.triggerL[i] == f.triggerL && batch.triggerR[i] == f.triggerR;
+        if (!same && mismatches++ < 5)
+            std::printf("  %s: frame %zu differs\n", BatchKernelName(kernel), i);
+    }
+    CHECK(mismatches == 0);
+}
+
+void TestAllKernels() {
+    std::vector<uint8_t> frames;
+    std::vector<uint32_t> lengths;
+    BuildFrames(100003, frames, lengths);
+
+    for (BatchKernel kernel : { BatchKernel::Scalar, BatchKernel::SSE2, BatchKernel::AVX2, BatchKernel::Auto }) {
+        BatchKernel resolved = ResolveBatchKernel(kernel);
+        std::printf("  kernel %s -> %s\n", BatchKernelName(kernel), BatchKernelName(resolved));
+        CheckKernel(kernel, frames, lengths);
+    }
+}
+
+void TestSmallAndEmptyBatches() {
+    std::vector<uint8_t> frames;
+    std::vector<uint32_t> lengths;
+    for (size_t count : { 0, 1, 7, 8, 15, 16, 17, 33 }) {
+        BuildFrames(count, frames, lengths);
+        CheckKernel(BatchKernel::Auto, frames, lengths);
+    }
+}
+
+void TestWithoutLengths() {
+    RawFrame raw = MakeSampleFrame();
+    std::vector<uint8_t> frames(raw.begin(), raw.end());
+    FrameBatch batch;
+    DecodeFrameBatch(frames, {}, batch);
+    CHECK(batch.count == 1);
+    CHECK(batch.rightX[0] == 2083 && batch.rightY[0] == 1954);
+    CHECK(batch.accelZ[0] == 4078 && batch.gyroY[0] == 4);
+}
+
+} // namespace
+
+int main() {
+    TestAllKernels();
+    TestSmallAndEmptyBatches();
+    TestWithoutLengths();
+    return TestSummary("batch_decoder_parity");
+}
@@ -0,0 +1,412 @@
+// Capture file tests: records written from three simulated controllers read back byte for byte
+// through the mapping, raw and delta-compressed, index seeks, recovery of a capture that was
+// never closed, the session recorder, deterministic replay single-stepped, unpaced and paced,
+// and a long eight-controller session: compressed size, coding time and allocations.
+#include "TestUtil.h"
+#include "AllocationCounter.h"
+#include "CaptureCodec.h"
+#include "CaptureFile.h"
+#include "CaptureReplay.h"
+#include "PlayerPipeline.h"
+#include "SimulatedController.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct SourceRecord {
+    int64_t timestampUs;
+    uint64_t address;
+    ControllerFamily family;
+    CaptureRecordKind kind;
+    std::vector<uint8_t> bytes;
+};
+
+constexpr int FRAMES_PER_CONTROLLER = 1500;
+constexpr uint64_t ADDRESSES[3] = { 0x98B6E9000001, 0x98B6E9000002, 0x98B6E9000003 };
+constexpr ControllerFamily FAMILIES[3] = { ControllerFamily::JoyCon2, ControllerFamily::ProController2, ControllerFamily::NSOGC };
+
+// Three controllers at different rates, interleaved by arrival time, with a few command writes
+std::vector<SourceRecord> MakeSession() {
+    std::vector<SourceRecord> records;
+    // The Pro Controller's setup commands go out before its first notification
+    const uint8_t led[] = { 0x09, 0x91, 0x01, 0x07, 0x00, 0x08, 0x00, 0x00, 0x02 };
+    records.push_back({ 1000000, ADDRESSES[1], FAMILIES[1], CaptureRecordKind::CommandWrite, { std::begin(led), std::end(led) } });
+    for (int c = 0; c < 3; ++c) {
+        SimulationSettings settings;
+        settings.family = FAMILIES[c];
+        settings.periodUs = 4000.0 + 1500.0 * c;
+        settings.jitterUs = 1500.0;
+        settings.gyroNoiseDps = 1.5f;
+        settings.seed = 11 + c;
+        SimulatedController sim(settings, [c](int64_t elapsedUs) {
+            SimulatedInput in;
+            in.buttons = (elapsedUs / 50000) % 2 ? BUTTON_A_MASK : 0;
+            in.leftStick.x = static_cast<uint16_t>(2048 + (elapsedUs / 1000 + c * 300) % 1500);
+            in.gyroDps[2] = 30.0f * c;
+            return in;
+        });
+        sim.Generate(FRAMES_PER_CONTROLLER, [&](const uint8_t* data, size_t length, int64_t arrivalUs) {
+            records.push_back({ arrivalUs, ADDRESSES[c], FAMILIES[c], CaptureRecordKind::Notification, { data, data + length } });
+        }, 1002000);
+    }
+    const uint8_t rumble[] = { 0x0A, 0x91, 0x01, 0x02, 0x00, 0x08, 0x00, 0x00, 0x04 };
+    records.push_back({ 1500000, ADDRESSES[0], FAMILIES[0], CaptureRecordKind::CommandWrite, { std::begin(rumble), std::end(rumble) } });
+    std::stable_sort(records.begin(), records.end(), [](const SourceRecord& a, const SourceRecord& b) { return a.timestampUs < b.timestampUs; });
+    return records;
+}
+
+void WriteSession(CaptureWriter& writer, const std::vector<SourceRecord>& records) {
+    for (const SourceRecord& r : records) {
+        if (r.kind == CaptureRecordKind::Notification)
+            writer.RecordNotification(r.address, r.family, r.bytes.data(), r.bytes.size(), r.timestampUs);
+        else
+            writer.RecordCommandWrite(r.address, r.bytes.data(), r.bytes.size(), r.timestampUs);
+    }
+}
+
+// Records in file order must match the source
+bool ReadMatches(CaptureReader& reader, const std::vector<SourceRecord>& source, size_t count) {
+    reader.Rewind();
+    CaptureRecord rec;
+    for (size_t i = 0; i < count; ++i) {
+        if (!reader.Next(rec)) return false;
+        const SourceRecord& s = source[i];
+        if (rec.timestampUs != s.timestampUs || rec.kind != s.kind) return false;
+        if (reader.Controllers()[rec.controller].address != s.address) return false;
+        if (rec.length != s.bytes.size() || std::memcmp(rec.data, s.bytes.data(), rec.length) != 0) return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void TestRoundTripAndSeek(const std::vector<SourceRecord>& source, const std::string& path, CaptureCompression compression) {
+    CaptureWriter writer;
+    CHECK(writer.Open(path, compression));
+    WriteSession(writer, source);
+    CHECK(writer.RecordCount() == source.size());
+    CHECK(writer.Close());
+
+    CaptureReader reader;
+    CHECK(reader.Open(path));
+    CHECK(!reader.Recovered());
+    CHECK(reader.Compressed() == (compression == CaptureCompression::Delta));
+    std::printf("  %s: %zu records in %zu bytes\n", compression == CaptureCompression::Delta ? "delta" : "raw",
+        source.size(), ReadFile(path).size());
+    CHECK(reader.RecordCount() == source.size());
+    CHECK(reader.StartUs() == source.front().timestampUs);
+    CHECK(reader.Controllers().size() == 3);
+    // Controllers are numbered in order of appearance; the Pro Controller's family is learned
+    // from its first notification after the command write
+    if (reader.Controllers().size() == 3) {
+        CHECK(reader.Controllers()[0].address == ADDRESSES[1]);
+        CHECK(reader.Controllers()[0].family == static_cast<uint8_t>(ControllerFamily::ProController2));
+    }
+    CHECK(ReadMatches(reader, source, source.size()));
+    CaptureRecord rec;
+    CHECK(!reader.Next(rec));
+    CHECK(reader.Position() == source.size());
+
+    // Seeks land on the first record at or after the time, with the matching position
+    int misses = 0;
+    for (size_t target : { size_t(0), size_t(1), size_t(255), size_t(256), size_t(257), size_t(2000), source.size() - 1 }) {
+        int64_t t = source[target].timestampUs;
+        size_t expected = target;
+        while (expected > 0 && source[expected - 1].timestampUs >= t) --expected;
+        reader.Seek(t);
+        if (reader.Position() != expected || !reader.Next(rec) || rec.timestampUs != source[expected].timestampUs) ++misses;
+    }
+    reader.Seek(source.back().timestampUs + 1);
+    CHECK(!reader.Next(rec));
+    CHECK(misses == 0);
+}
+
+// A crash leaves the placeholder header and a record cut in half
+void TestRecovery(const std::vector<SourceRecord>& source, const std::string& path, const std::string& crashedPath) {
+    std::vector<uint8_t> bytes = ReadFile(path);
+    CaptureFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    uint64_t cut = header.controllerOffset - 40;   // inside the last record
+    bytes.resize(cut);
+    header.recordCount = header.controllerOffset = header.indexOffset = header.indexCount = 0;
+    header.controllerCount = 0;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::ofstream(crashedPath, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+    CaptureReader reader;
+    CHECK(reader.Open(crashedPath));
+    CHECK(reader.Recovered());
+    CHECK(reader.Controllers().size() == 3);
+    // Everything up to the cut survives; a compressed capture loses the block that was cut
+    size_t lost = reader.Compressed() ? CAPTURE_BLOCK_RECORDS : 0;
+    CHECK(reader.RecordCount() > 0 && reader.RecordCount() < source.size());
+    CHECK(reader.RecordCount() + lost >= source.size() - 1);
+    CHECK(ReadMatches(reader, source, reader.RecordCount()));
+    CaptureRecord rec;
+    CHECK(!reader.Next(rec));
+    size_t target = reader.RecordCount() / 2;
+    reader.Seek(source[target].timestampUs);
+    CHECK(reader.Next(rec) && rec.timestampUs == source[target].timestampUs);
+}
+
+void TestSession(const std::string& path) {
+    auto& session = CaptureSession::Instance();
+    const uint8_t frame[4] = { 1, 2, 3, 4 };
+    std::shared_ptr<CaptureChannel> channel = session.OpenChannel(1, ControllerFamily::JoyCon2);
+    channel->Notification(frame, sizeof(frame), 10);   // not recording
+    CHECK(session.Start(path));
+    CHECK(session.Running() && session.Path() == path);
+    channel->Notification(frame, sizeof(frame), 20);
+    session.CommandWrite(1, frame, 2, 30);
+    session.Stop();
+    channel->Notification(frame, sizeof(frame), 40);   // stopped
+    CHECK(!session.Running());
+
+    CaptureReader reader;
+    CHECK(reader.Open(path));
+    CHECK(reader.RecordCount() == 2);
+    CaptureRecord rec;
+    CHECK(reader.Next(rec) && rec.timestampUs == 20 && rec.length == 4 && rec.kind == CaptureRecordKind::Notification);
+    CHECK(reader.Next(rec) && rec.timestampUs == 30 && rec.length == 2 && rec.kind == CaptureRecordKind::CommandWrite);
+    CHECK(!reader.Next(rec));
+}
+
+// Two controllers notifying from their own threads while the writer thread drains them; one
+// controller goes away mid-session. Each keeps its order and nothing is lost or duplicated.
+void TestSessionWriterThread(const std::string& path) {
+    auto& session = CaptureSession::Instance();
+    CHECK(session.Start(path));
+    constexpr int COUNT = 2000;
+    auto produce = [&](uint64_t address, int64_t offsetUs) {
+        std::shared_ptr<CaptureChannel> channel = session.OpenChannel(address, ControllerFamily::JoyCon2);
+        uint8_t frame[JOYCON_FRAME_SIZE] = {};
+        for (int i = 0; i < COUNT; ++i) {
+            std::memcpy(frame, &i, sizeof(i));
+            channel->Notification(frame, sizeof(frame), offsetUs + i * 100);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));   // ~5 kHz, far above a controller
+        }
+    };
+    std::thread left(produce, ADDRESSES[0], 0);
+    std::thread right(produce, ADDRESSES[1], 50);
+    left.join();
+    right.join();
+    session.Flush();
+    uint64_t dropped = session.Dropped();
+    session.Stop();
+
+    CaptureReader reader;
+    CHECK(reader.Open(path));
+    CHECK(reader.RecordCount() + dropped == 2 * COUNT);
+    CHECK(dropped < COUNT / 10);
+    int64_t lastUs[2] = { -1, -1 };
+    int lastIndex[2] = { -1, -1 };
+    bool ordered = true;
+    CaptureRecord rec;
+    while (reader.Next(rec)) {
+        int c = rec.timestampUs % 100 == 0 ? 0 : 1;
+        int index;
+        std::memcpy(&index, rec.data, sizeof(index));
+        ordered &= rec.timestampUs > lastUs[c] && index > lastIndex[c] && rec.length == JOYCON_FRAME_SIZE;
+        lastUs[c] = rec.timestampUs;
+        lastIndex[c] = index;
+    }
+    CHECK(ordered);
+    CHECK(dropped > 0 || (lastIndex[0] == COUNT - 1 && lastIndex[1] == COUNT - 1));
+}
+
+// FNV-1a over every report the player pipeline builds, per controller
+struct ReportSink {
+    uint64_t hash = 1469598103934665603ull;
+    uint64_t count = 0;
+    int64_t lastUs = 0;
+    std::unique_ptr<PlayerPipeline> player;
+    void Add(ControllerFamily family, const uint8_t* data, size_t length, int64_t arrivalUs) {
+        if (!player) player = std::make_unique<PlayerPipeline>(family, JoyConSide::Left, JoyConOrientation::Upright, "replay");
+        uint8_t raw[JOYCON_FRAME_SIZE] = {};
+        std::memcpy(raw, data, (std::min)(length, JOYCON_FRAME_SIZE));
+        JoyConInputFrame frame = player->Decode(JoyConFrameView(raw, JOYCON_FRAME_SIZE), static_cast<uint32_t>(length), arrivalUs);
+        DS4_REPORT_EX report = player->Report(frame, GyroStickSettings{ GyroStickMode::Replace });
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&report);
+        for (size_t i = 0; i < sizeof(report); ++i) hash = (hash ^ bytes[i]) * 1099511628211ull;
+        hash = (hash ^ static_cast<uint64_t>(arrivalUs)) * 1099511628211ull;
+        lastUs = arrivalUs;
+        ++count;
+    }
+};
+
+void Attach(CaptureReplay& replay, std::vector<ReportSink>& sinks) {
+    sinks.clear();
+    sinks.resize(replay.ControllerCount());
+    for (size_t c = 0; c < replay.ControllerCount(); ++c) {
+        ReplayTransport& t = replay.Transport(c);
+        t.Subscribe([&sink = sinks[c], family = t.Family()](const uint8_t* data, size_t length, int64_t arrivalUs) {
+            sink.Add(family, data, length, arrivalUs);
+        });
+    }
+}
+
+void TestReplay(const std::vector<SourceRecord>& source, const std::string& path) {
+    CaptureReader reader;
+    CHECK(reader.Open(path));
+
+    // What the pipeline should see: every notification, in capture order
+    std::vector<ReportSink> expected(reader.Controllers().size());
+    for (const SourceRecord& r : source) {
+        if (r.kind != CaptureRecordKind::Notification) continue;
+        for (size_t c = 0; c < expected.size(); ++c)
+            if (reader.Controllers()[c].address == r.address) expected[c].Add(r.family, r.bytes.data(), r.bytes.size(), r.timestampUs);
+    }
+    CaptureReplay replay(reader);
+    CHECK(replay.ControllerCount() == 3);
+    std::vector<ReportSink> sinks;
+    Attach(replay, sinks);
+
+    // Single step, then the rest unpaced
+    CHECK(replay.Step());
+    CHECK(sinks[0].count + sinks[1].count + sinks[2].count == 1);
+    CHECK(replay.CurrentUs() == source[1].timestampUs);
+    uint64_t rest = replay.Run(0.0);
+    CHECK(rest + 1 == 3 * FRAMES_PER_CONTROLLER);
+    CHECK(!replay.Step());
+    bool same = true;
+    for (size_t c = 0; c < 3; ++c) same &= sinks[c].hash == expected[c].hash && sinks[c].count == FRAMES_PER_CONTROLLER;
+    CHECK(same);
+
+    // Replaying again gives the same reports
+    replay.Rewind();
+    Attach(replay, sinks);
+    replay.Run(0.0);
+    same = true;
+    for (size_t c = 0; c < 3; ++c) same &= sinks[c].hash == expected[c].hash;
+    CHECK(same);
+
+    // Paced at 4x: 400 ms of capture in about 100 ms
+    replay.Seek(source.front().timestampUs + 1000000);
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<bool> stop{ false };
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        stop.store(true);
+    });
+    Attach(replay, sinks);
+    replay.Run(4.0, &stop);
+    stopper.join();
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    double capturedMs = (replay.CurrentUs() - (source.front().timestampUs + 1000000)) / 1000.0;
+    std::printf("  paced 4x: %.1f ms of capture in %.1f ms\n", capturedMs, elapsedMs);
+    CHECK(capturedMs > 4.0 * 60.0 && capturedMs < 4.0 * 130.0);
+
+    // The pipeline's own writes land on the replay transport
+    const uint8_t cmd[2] = { 0x09, 0x91 };
+    CHECK(replay.Transport(0).Write(cmd, sizeof(cmd)));
+    CHECK(replay.Transport(0).Commands().size() == 1);
+}
+
+// Eight controllers at 125 Hz for a minute, held mostly still with IMU noise, a slow rotation
+// and occasional buttons and stick moves; rumble writes to two of them
+void TestLongSession(const std::string& path) {
+    constexpr int CONTROLLERS = 8;
+    constexpr int FRAMES = 7500;
+    std::vector<SourceRecord> records;
+    records.reserve(CONTROLLERS * FRAMES + 2 * 3750);
+    for (int c = 0; c < CONTROLLERS; ++c) {
+        SimulationSettings settings;
+        settings.family = FAMILIES[c % 3];
+        settings.periodUs = 8000.0;
+        settings.jitterUs = 3000.0;
+        settings.gyroNoiseDps = 0.04f;   // a few counts, as a controller at rest
+        settings.accelNoiseG = 0.002f;
+        settings.seed = 100 + c;
+        SimulatedController sim(settings, [c](int64_t elapsedUs) {
+            SimulatedInput in;
+            double t = elapsedUs / 1e6;
+            in.buttons = static_cast<int64_t>(t * 0.7 + c) % 5 == 0 ? BUTTON_A_MASK : 0;
+            in.leftStick.x = static_cast<uint16_t>(2048 + (static_cast<int64_t>(t / 3) % 2 ? 900 : 0));
+            in.gyroDps[1] = static_cast<float>(15.0 * std::sin(t * 0.5 + c));
+            in.accelG[0] = static_cast<float>(0.2 * std::sin(t * 0.5 + c));
+            return in;
+        });
+        sim.Generate(FRAMES, [&](const uint8_t* data, size_t length, int64_t arrivalUs) {
+            records.push_back({ arrivalUs, ADDRESSES[0] + 0x10 + c, settings.family, CaptureRecordKind::Notification, { data, data + length } });
+        }, 5000000);
+    }
+    for (int i = 0; i < 3750; ++i) {
+        uint8_t rumble[16] = { 0x00, static_cast<uint8_t>(0x50 | (i & 0x0F)), 0x01, static_cast<uint8_t>(i % 7 ? 0 : 0x80) };
+        for (int c = 0; c < 2; ++c)
+            records.push_back({ 5000000 + i * 16000 + c * 300, ADDRESSES[0] + 0x10 + c, FAMILIES[c], CaptureRecordKind::CommandWrite, { std::begin(rumble), std::end(rumble) } });
+    }
+    std::stable_sort(records.begin(), records.end(), [](const SourceRecord& a, const SourceRecord& b) { return a.timestampUs < b.timestampUs; });
+
+    size_t rawBytes = 0;
+    for (const SourceRecord& r : records) rawBytes += sizeof(CaptureRecordHeader) + ((r.bytes.size() + 7) & ~size_t(7));
+
+    CaptureWriter writer;
+    CHECK(writer.Open(path, CaptureCompression::Delta));
+    const size_t warmup = 2000;   // every controller seen, stdio buffer in place
+    WriteSession(writer, std::vector<SourceRecord>(records.begin(), records.begin() + warmup));
+    uint64_t allocations = AllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = warmup; i < records.size(); ++i) {
+        const SourceRecord& r = records[i];
+        if (r.kind == CaptureRecordKind::Notification)
+            writer.RecordNotification(r.address, r.family, r.bytes.data(), r.bytes.size(), r.timestampUs);
+        else
+            writer.RecordCommandWrite(r.address, r.bytes.data(), r.bytes.size(), r.timestampUs);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (records.size() - warmup);
+    allocations = AllocationCount() - allocations;
+    CHECK(writer.Close());
+    CHECK(allocations == 0);
+
+    size_t bytes = ReadFile(path).size();
+    double perRecord = static_cast<double>(bytes) / records.size();
+    double threeHoursMB = perRecord * (CONTROLLERS * 125.0 + 2 * 62.5) * 3 * 3600 / 1e6;
+    std::printf("  long session: %zu records, %zu bytes raw, %zu compressed (%.1f bytes/record, %.1fx), "
+                "%.0f ns/record, %llu allocations; 3 h x 8 controllers ~ %.0f MB\n",
+        records.size(), rawBytes, bytes, perRecord, static_cast<double>(rawBytes) / bytes, ns,
+        static_cast<unsigned long long>(allocations), threeHoursMB);
+    CHECK(bytes * 5 < rawBytes);
+
+    CaptureReader reader;
+    CHECK(reader.Open(path));
+    CHECK(reader.RecordCount() == records.size());
+    CHECK(ReadMatches(reader, records, records.size()));
+}
+
+} // namespace
+
+int main() {
+    const std::string rawPath = "capture_test_raw.jc2cap";
+    const std::string deltaPath = "capture_test.jc2cap";
+    const std::string crashedPath = "capture_test_crashed.jc2cap";
+    const std::string sessionPath = "capture_test_session.jc2cap";
+    const std::string longPath = "capture_test_long.jc2cap";
+    std::vector<SourceRecord> source = MakeSession();
+
+    for (CaptureCompression compression : { CaptureCompression::None, CaptureCompression::Delta }) {
+        const std::string& path = compression == CaptureCompression::Delta ? deltaPath : rawPath;
+        TestRoundTripAndSeek(source, path, compression);
+        TestRecovery(source, path, crashedPath);
+        TestReplay(source, path);
+    }
+    TestSession(sessionPath);
+    TestSessionWriterThread(sessionPath);
+    TestLongSession(longPath);
+
+    for (const std::string& path : { rawPath, crashedPath, sessionPath, longPath }) std::remove(path.c_str());
+    // capture_test.jc2cap (compressed) is kept for the joycon2_replay smoke test
+    return TestSummary("capture_replay");
+}
@@ -0,0 +1,919 @@
+// Unit tests for the platform-neutral core (joycon2_core)
+#include "TestUtil.h"
+#include "ConfigManager.h"
+#include "MouseInterpolator.h"
+#include "VibrationMapping.h"
+#include "StickCalibrator.h"
+#include "GyroCalibration.h"
+#include "MotionFusion.h"
+#include "GyroMouse.h"
+#include "GyroStick.h"
+#include "DualImuFusion.h"
+#include "TouchpadEncoder.h"
+#include "PlayerPipeline.h"
+#include "LatencyHistogram.h"
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void TestDecodeSampleFrame() {
+    RawFrame raw = MakeSampleFrame();
+    JoyConInputFrame frame = DecodeInputFrame(raw, sizeof(SAMPLE_NOTIFICATION));
+
+    CHECK(frame.length == sizeof(SAMPLE_NOTIFICATION));
+    CHECK(frame.buttons == 0x00000000E0FFull);
+    CHECK(frame.leftStick.x == 2047 && frame.leftStick.y == 2047);
+    CHECK(frame.rightStick.x == 2083 && frame.rightStick.y == 1954);
+    CHECK(frame.opticalX == 0 && frame.opticalY == 0);
+    CHECK(frame.motion.accelX == -66 && frame.motion.accelY == 437 && frame.motion.accelZ == 4078);
+    CHECK(frame.motion.gyroX == -2 && frame.motion.gyroY == 4 && frame.motion.gyroZ == 2);
+    CHECK(frame.triggerL == 0 && frame.triggerR == 0);
+}
+
+void TestButtonWordOffsets() {
+    RawFrame raw = MakeSampleFrame();
+    SetButtonBytes(raw, 0x112233445566ull);
+    JoyConInputFrame frame = DecodeInputFrame(raw, sizeof(SAMPLE_NOTIFICATION));
+
+    CHECK(frame.buttons == 0x112233445566ull);
+    CHECK(frame.JoyConButtons(JoyConSide::Right) == 0x112233);  // bytes 3..5
+    CHECK(frame.JoyConButtons(JoyConSide::Left) == 0x223344);   // bytes 4..6
+}
+
+void TestFrameLayoutSelection() {
+    static_assert(FindFrameLayout(ControllerFamily::NSOGC).triggers == 0x3C);
+    static_assert(FindFrameLayoutIndex(ControllerFamily::ProController2, 0xFFFFFFFF) < FRAME_LAYOUT_COUNT);
+
+    // Every family decodes the sample notification field for field like the default decoder
+    RawFrame raw = MakeSampleFrame();
+    JoyConInputFrame expected = DecodeInputFrame(raw, sizeof(SAMPLE_NOTIFICATION));
+    for (const auto& entry : FRAME_LAYOUTS) {
+        JoyConInputFrame frame = SelectFrameDecoder(entry.family, entry.minFirmware)(raw, sizeof(SAMPLE_NOTIFICATION));
+        CHECK(frame.buttons == expected.buttons);
+        CHECK(frame.leftStick.x == expected.leftStick.x && frame.rightStick.y == expected.rightStick.y);
+        CHECK(frame.motion.accelZ == expected.motion.accelZ && frame.motion.gyroY == expected.motion.gyroY);
+    }
+}
+
+void TestShortFrameKeepsSticksCentered() {
+    RawFrame raw{};
+    JoyConInputFrame frame = DecodeInputFrame(raw, 12);
+    CHECK(frame.length == 12);
+    CHECK(frame.leftStick.x == 2048 && frame.rightStick.y == 2048);
+
+    StickData stick = DecodeJoystick(frame, JoyConSide::Left, JoyConOrientation::Upright);
+    CHECK(stick.x == 0 && stick.y == 0);
+
+    // Reports need the IMU block; anything shorter yields a neutral report
+    DS4_REPORT_EX report = GenerateDS4Report(frame, JoyConSide::Left, JoyConOrientation::Upright);
+    CHECK(report.Report.bThumbLX == 0x80 && report.Report.bThumbLY == 0x80);
+    CHECK((report.Report.wButtons & 0xF) == DS4_BUTTON_DPAD_NONE);
+}
+
+void TestOversizedFrameIsCapped() {
+    RawFrame raw = MakeSampleFrame();
+    JoyConInputFrame frame = DecodeInputFrame(raw, 200);
+    CHECK(frame.length == JOYCON_FRAME_SIZE);
+}
+
+void TestJoystickDeadzoneAndGain() {
+    RawFrame raw = MakeSampleFrame();
+    // Left stick fully right (x = 4095), centered vertically
+    raw[10] = 0xFF; raw[11] = 0x0F; raw[12] = 0x80;
+    JoyConInputFrame frame = DecodeInputFrame(raw, sizeof(SAMPLE_NOTIFICATION));
+
+    StickData upright = DecodeJoystick(frame, JoyConSide::Left, JoyConOrientation::Upright);
+    CHECK(upright.x == 32767 && upright.y == 0);
+
+    // Held sideways the left Joy-Con's X axis becomes vertical
+    StickData sideways = DecodeJoystick(frame, JoyConSide::Left, JoyConOrientation::Sideways);
+    CHECK(sideways.x == 0 && sideways.y == -32767);
+}
+
+void TestConfigRoundTrip() {
+    AppConfig config;
+    config.proConfig.layouts.push_back({ "FPS", ButtonMapping::L3, ButtonMapping::DPAD_LEFT });
+    config.proConfig.layouts.push_back({ "Racing", ButtonMapping::R2, ButtonMapping::NONE });
+    config.proConfig.activeLayoutIndex = 1;
+    config.mouseConfig.chatKeyEnabled = false;
+    config.mouseConfig.fastSensitivity = 1.5f;
+    config.mouseConfig.interpolationRateHz = 250;
+    config.mouseConfig.source = MouseSource::GyroFlick;
+    config.mouseConfig.gyro.space = GyroSpace::Local;
+    config.mouseConfig.gyro.countsPer360 = 5400.0f;
+    config.vibrationConfig.enabled = false;
+    config.vibrationConfig.intensity = 0.25f;
+    config.gyroStickConfig.mode = GyroStickMode::Blend;
+    config.gyroStickConfig.fullDeflectionDps = 240.0f;
+    config.dsuConfig.enabled = true;
+    config.dsuConfig.port = 26761;
+    config.pipelineConfig.latestOnly = true;
+    config.pipelineConfig.dualMerge = DualMergePolicy::NearestArrival;
+    config.pipelineConfig.dualMergeDeadlineUs = 2500;
+    config.language = "en";
+    StickCalibration learned;
+    learned.valid = true;
+    learned.centerX = 2101; learned.centerY = 1990;
+    learned.minX = 700; learned.maxX = 3350;
+    learned.minY = 650; learned.maxY = 3300;
+    learned.noise = 7;
+    config.stickCalibrations.push_back({ "A1B2C3D4E5F6", {}, learned });
+    config.gyroCalibrations.push_back({ "A1B2C3D4E5F6", { true, 31, -17, 4 } });
+
+    AppConfig parsed;
+    CHECK(JSONToConfig(ConfigToJSON(config), parsed));
+    CHECK(parsed.proConfig.activeLayoutIndex == 1);
+    CHECK(parsed.proConfig.layouts.size() == 2);
+    CHECK(parsed.proConfig.layouts[0].name == "FPS");
+    CHECK(parsed.proConfig.layouts[0].glMapping == ButtonMapping::L3);
+    CHECK(parsed.proConfig.layouts[0].grMapping == ButtonMapping::DPAD_LEFT);
+    CHECK(parsed.proConfig.layouts[1].glMapping == ButtonMapping::R2);
+    CHECK(!parsed.mouseConfig.chatKeyEnabled);
+    CHECK(std::fabs(parsed.mouseConfig.fastSensitivity - 1.5f) < 1e-6f);
+    CHECK(parsed.mouseConfig.interpolationRateHz == 250);
+    CHECK(parsed.mouseConfig.source == MouseSource::GyroFlick);
+    CHECK(parsed.mouseConfig.gyro.space == GyroSpace::Local);
+    CHECK(parsed.mouseConfig.gyro.countsPer360 == 5400.0f);
+    CHECK(parsed.mouseConfig.gyro.flickTimeMs == 100.0f);
+    CHECK(!parsed.vibrationConfig.enabled);
+    CHECK(std::fabs(parsed.vibrationConfig.intensity - 0.25f) < 1e-6f);
+    CHECK(parsed.gyroStickConfig.mode == GyroStickMode::Blend);
+    CHECK(parsed.gyroStickConfig.space == GyroSpace::World);
+    CHECK(parsed.gyroStickConfig.fullDeflectionDps == 240.0f);
+    CHECK(parsed.gyroStickConfig.smoothingMs == 15.0f);
+    CHECK(parsed.dsuConfig.enabled && parsed.dsuConfig.port == 26761);
+    CHECK(parsed.pipelineConfig.latestOnly);
+    CHECK(parsed.pipelineConfig.dualMerge == DualMergePolicy::NearestArrival);
+    CHECK(parsed.pipelineConfig.dualMergeDeadlineUs == 2500);
+    CHECK(parsed.language == "en");
+    CHECK(parsed.stickCalibrations.size() == 1);
+    if (!parsed.stickCalibrations.empty()) {
+        const StickCalibrationRecord& rec = parsed.stickCalibrations[0];
+        CHECK(rec.deviceId == "A1B2C3D4E5F6");
+        CHECK(!rec.left.valid);
+        CHECK(rec.right.valid && rec.right.centerX == 2101 && rec.right.centerY == 1990);
+        CHECK(rec.right.minX == 700 && rec.right.maxX == 3350 && rec.right.minY == 650 && rec.right.maxY == 3300);
+        CHECK(rec.right.noise == 7);
+    }
+    CHECK(parsed.gyroCalibrations.size() == 1);
+    if (!parsed.gyroCalibrations.empty()) {
+        const GyroBias& bias = parsed.gyroCalibrations[0].bias;
+        CHECK(parsed.gyroCalibrations[0].deviceId == "A1B2C3D4E5F6");
+        CHECK(bias.valid && bias.x == 31 && bias.y == -17 && bias.z == 4);
+    }
+}
+
+// Drift the resting position, then push the stick to each edge (two frames per edge)
+void FeedWornStick(StickCalibrator& cal) {
+    for (int i = 0; i < 200; ++i)
+        cal.Observe(static_cast<uint16_t>(2100 + (i % 3) - 1), static_cast<uint16_t>(2000 + (i % 5) - 2));
+    const uint16_t edges[][2] = { { 3300, 2000 }, { 800, 2000 }, { 2100, 3200 }, { 2100, 900 } };
+    for (const auto& e : edges) {
+        cal.Observe(e[0], e[1]);
+        cal.Observe(e[0], e[1]);
+        for (int i = 0; i < 20; ++i) cal.Observe(2100, 2000);
+    }
+}
+
+void TestStickCalibratorLearnsCenterAndExtents() {
+    StickCalibrator cal;
+    CHECK(!cal.Current().valid);
+    FeedWornStick(cal);
+
+    StickCalibration c = cal.Current();
+    CHECK(c.valid);
+    CHECK(std::abs(c.centerX - 2100) <= 2 && std::abs(c.centerY - 2000) <= 3);
+    CHECK(c.maxX == 3300 && c.minX == 800 && c.maxY == 3200 && c.minY == 900);
+    CHECK(c.noise <= 3);
+
+    // A single corrupt sample must not stretch the range
+    cal.Observe(4095, 0);
+    cal.Observe(2100, 2000);
+    c = cal.Current();
+    CHECK(c.maxX == 3300 && c.minY == 900);
+}
+
+void TestCalibratedLookupTable() {
+    StickCalibrator learner;
+    FeedWornStick(learner);
+    StickCalibration c = learner.Current();
+    StickLUT lut;
+    BuildStickLUT(c, lut);
+
+    CHECK(lut.x.rest[2100] && lut.y.rest[2000]);
+    CHECK(!lut.x.rest[2400]);
+    CHECK(lut.x.value[3300] == 32767 && lut.x.value[800] == -32767);
+    CHECK(lut.y.value[3200] == 32767 && lut.y.value[900] == -32767);
+    // The drifted center reads as zero deflection; the default table reads a small offset
+    CHECK(lut.x.value[c.centerX] == 0);
+    CHECK(DefaultStickLUT().x.value[c.centerX] > 0);
+}
+
+void TestControllerCalibrationRepublishes() {
+    ControllerStickCalibration sticks("0000DEADBEEF", true, false);
+    CHECK(!sticks.Learned());
+
+    RawFrame raw = MakeSampleFrame();
+    auto feed = [&](uint16_t x, uint16_t y, int frames) {
+        raw[10] = static_cast<uint8_t>(x & 0xFF);
+        raw[11] = static_cast<uint8_t>(((x >> 8) & 0x0F) | ((y & 0x0F) << 4));
+        raw[12] = static_cast<uint8_t>(y >> 4);
+        for (int i = 0; i < frames; ++i) sticks.Observe(DecodeInputFrame(raw, sizeof(SAMPLE_NOTIFICATION)));
+    };
+    feed(1990, 2080, 100);
+    feed(3250, 2080, 2); feed(1990, 2080, 10);
+    feed(700, 2080, 2); feed(1990, 2080, 10);
+    feed(1990, 3300, 2); feed(1990, 2080, 10);
+    feed(1990, 800, 2); feed(1990, 2080, 100);
+
+    CHECK(sticks.Learned());
+    StickCalibrationRecord rec = sticks.Snapshot();
+    CHECK(rec.deviceId == "0000DEADBEEF");
+    CHECK(rec.left.valid && !rec.right.valid);
+    CHECK(rec.left.maxX == 3250);
+
+    // The resting frame now decodes as centered through the learned table
+    StickData s = DecodeJoystick(DecodeInputFrame(raw, sizeof(SAMPLE_NOTIFICATION)),
+                                 JoyConSide::Left, JoyConOrientation::Upright, sticks.Left());
+    CHECK(s.x == 0 && s.y == 0);
+}
+
+void TestStickCurveShapes() {
+    StickCurve curve;
+    curve.exponent = 2.0f;
+    CHECK(std::fabs(EvaluateStickCurve(curve, 0.5f) - 0.25f) < 1e-5f);
+    CHECK(EvaluateStickCurve(curve, 1.5f) == 1.0f);
+
+    // Spline through the points, never decreasing between them
+    curve.points = { { 0.25f, 0.1f }, { 0.5f, 0.2f }, { 0.75f, 0.6f } };
+    CHECK(std::fabs(EvaluateStickCurve(curve, 0.5f) - 0.2f) < 1e-5f);
+    float prev = 0.0f;
+    for (int i = 0; i <= 100; ++i) {
+        float v = EvaluateStickCurve(curve, i / 100.0f);
+        CHECK(v >= prev - 1e-6f);
+        prev = v;
+    }
+    CHECK(std::fabs(prev - 1.0f) < 1e-5f);
+
+    // Anti-deadzone: the first step past the inner deadzone jumps straight to it
+    StickCurve anti;
+    anti.innerDeadzone = 0.1f;
+    anti.outerDeadzone = 0.1f;
+    anti.antiDeadzone = 0.2f;
+    CHECK(StickCurveResponse(anti, 0.09f) == 0.0f);
+    CHECK(std::fabs(StickCurveResponse(anti, 0.1001f) - 0.2f) < 1e-3f);
+    CHECK(StickCurveResponse(anti, 0.9f) == 1.0f);
+}
+
+void TestAxialAndRadialLookupTables() {
+    // Uncalibrated curves use the legacy nominal extent: raw 2048 + 1204.7 is full deflection
+    auto raw = [](float n) { return static_cast<uint16_t>(STICK_RAW_CENTER + n * 2048.0f / 1.7f); };
+
+    StickCurve axial;
+    axial.mode = StickDeadzoneMode::Axial;
+    axial.innerDeadzone = 0.2f;
+    axial.outerDeadzone = 0.0f;
+    StickLUT axialLut;
+    BuildStickLUT(StickCalibration{}, axialLut, axial);
+    CHECK(!axialLut.radial);
+    // Each axis has its own deadzone: a small X deflection is dropped even while Y is pushed
+    auto [ax, ay] = MapStick(axialLut, raw(0.15f), raw(0.8f));
+    CHECK(ax == 0 && ay > 20000);
+    CHECK(MapStick(axialLut, 4095, STICK_RAW_CENTER).first == 32767);
+
+    StickCurve radial = axial;
+    radial.mode = StickDeadzoneMode::Radial;
+    StickLUT radialLut;
+    BuildStickLUT(StickCalibration{}, radialLut, radial);
+    CHECK(radialLut.radial);
+    // The same X offset on a diagonal is outside the radial deadzone, and direction is kept
+    auto [rx, ry] = MapStick(radialLut, raw(0.15f), raw(0.15f));
+    CHECK(rx > 0 && std::abs(rx - ry) <= 1);
+    auto [zx, zy] = MapStick(radialLut, raw(0.1f), raw(0.1f));
+    CHECK(zx == 0 && zy == 0);
+    // Full deflection on a diagonal reaches the edge, not the corner
+    auto [dx, dy] = MapStick(radialLut, raw(0.8f), raw(0.8f));
+    float magnitude = std::sqrt(float(dx) * dx + float(dy) * dy);
+    CHECK(magnitude > 32000.0f && magnitude < 33000.0f);
+}
+
+void TestStickProfileRoundTrip() {
+    AppConfig config;
+    StickProfile profile;
+    profile.name = "Shooter";
+    profile.left.mode = StickDeadzoneMode::Radial;
+    profile.left.innerDeadzone = 0.12f;
+    profile.left.exponent = 1.5f;
+    profile.right.mode = StickDeadzoneMode::Axial;
+    profile.right.antiDeadzone = 0.25f;
+    profile.right.points = { { 0.3f, 0.1f }, { 0.7f, 0.5f } };
+    config.stickConfig.profiles = { StickProfile{ "Default", {}, {} }, profile };
+    config.stickConfig.activeProfileIndex = 1;
+
+    AppConfig parsed;
+    CHECK(JSONToConfig(ConfigToJSON(config), parsed));
+    CHECK(parsed.stickConfig.activeProfileIndex == 1);
+    CHECK(parsed.stickConfig.profiles.size() == 2);
+    if (parsed.stickConfig.profiles.size() == 2) {
+        CHECK(parsed.stickConfig.profiles[0].left.mode == StickDeadzoneMode::Classic);
+        const StickProfile& p = parsed.stickConfig.profiles[1];
+        CHECK(p.name == "Shooter");
+        CHECK(p.left.mode == StickDeadzoneMode::Radial);
+        CHECK(std::fabs(p.left.innerDeadzone - 0.12f) < 1e-6f);
+        CHECK(std::fabs(p.left.exponent - 1.5f) < 1e-6f);
+        CHECK(p.right.mode == StickDeadzoneMode::Axial);
+        CHECK(std::fabs(p.right.antiDeadzone - 0.25f) < 1e-6f);
+        CHECK(p.right.points.size() == 2 && std::fabs(p.right.points[1].second - 0.5f) < 1e-6f);
+    }
+}
+
+// Resting IMU: constant gyro offset plus a few counts of noise, gravity on Z
+MotionData RestingSample(int i, int bx, int by, int bz) {
+    int noise = (i * 7) % 11 - 5;
+    return MotionData{ SHORT(bx + noise), SHORT(by - noise), SHORT(bz + noise / 2),
+                       SHORT(noise * 3), SHORT(-noise * 2), SHORT(4096 + noise * 4) };
+}
+
+void TestGyroCalibrationLearnsBiasAtRest() {
+    GyroCalibration cal("dev");
+    for (int i = 0; i < GyroCalibration::WINDOW - 1; ++i) {
+        MotionData m = RestingSample(i, 40, -25, 7);
+        cal.Process(m);
+        CHECK(m.gyroX == RestingSample(i, 40, -25, 7).gyroX);   // untouched until a window rested
+    }
+    CHECK(!cal.Bias().valid && !cal.Learned());
+
+    long sumX = 0, sumY = 0, sumZ = 0;
+    for (int i = 0; i < 256; ++i) {
+        MotionData m = RestingSample(i, 40, -25, 7);
+        cal.Process(m);
+        sumX += m.gyroX; sumY += m.gyroY; sumZ += m.gyroZ;
+    }
+    CHECK(cal.Still() && cal.Learned());
+    GyroBias bias = cal.Bias();
+    CHECK(std::abs(bias.x - 40) <= 1 && std::abs(bias.y + 25) <= 1 && std::abs(bias.z - 7) <= 1);
+    CHECK(std::abs(sumX) < 256 && std::abs(sumY) < 256 && std::abs(sumZ) < 256);
+
+    GyroCalibrationRecord rec = cal.Snapshot();
+    CHECK(rec.deviceId == "dev" && rec.bias.valid && rec.bias.x == bias.x);
+}
+
+void TestGyroCalibrationLearnsDpsScaleBias() {
+    // A 3 dps zero-rate offset with +-0.3 dps of noise, at the Joy-Con 2 scale
+    auto counts = [](float dps) { return int(std::lround(dps * IMU_GYRO_COUNTS_PER_DPS)); };
+    auto sample = [&](int i) {
+        int noise = counts(0.3f) * ((i * 7) % 11 - 5) / 5;
+        return MotionData{ SHORT(counts(3.0f) + noise), SHORT(counts(-1.0f) - noise), SHORT(noise / 2),
+                           SHORT(noise / 4), 0, 4096 };
+    };
+    GyroCalibration cal("dev");
+    for (int i = 0; i < 4 * GyroCalibration::WINDOW; ++i) {
+        MotionData m = sample(i);
+        cal.Process(m);
+    }
+    CHECK(cal.Still() && cal.Learned());
+    GyroBias bias = cal.Bias();
+    CHECK(std::abs(bias.x - counts(3.0f)) <= 2 && std::abs(bias.y - counts(-1.0f)) <= 2 && std::abs(bias.z) <= 2);
+}
+
+void TestGyroCalibrationIgnoresMotion() {
+    GyroCalibration cal("dev", nullptr);
+    GyroCalibrationRecord seed{ "dev", { true, 10, 10, 10 } };
+    GyroCalibration seeded("dev", &seed);
+
+    for (int i = 0; i < 200; ++i) {
+        // Hand-held swing: large varying rates and accelerations
+        SHORT swing = SHORT(3000 * std::sin(i * 0.2));
+        MotionData m{ swing, SHORT(-swing / 2), SHORT(swing / 3), SHORT(swing / 4), 0, 4096 };
+        cal.Process(m);
+        MotionData s = m;
+        seeded.Process(s);
+        CHECK(s.gyroX == SHORT(swing - 10));
+    }
+    CHECK(!cal.Still() && !cal.Bias().valid && !seeded.Learned());
+
+    // A slow steady turn (15 dps) has no variance but is far beyond any plausible bias
+    for (int i = 0; i < 200; ++i) {
+        MotionData m = RestingSample(i, 0, 0, int(15 * IMU_GYRO_COUNTS_PER_DPS));
+        cal.Process(m);
+    }
+    CHECK(!cal.Bias().valid);
+
+    // Correction saturates instead of wrapping
+    GyroCalibrationRecord negative{ "dev", { true, -100, 100, 0 } };
+    GyroCalibration clamp("dev", &negative);
+    MotionData m{ 32700, -32700, 0, 0, 0, 4096 };
+    clamp.Process(m);
+    CHECK(m.gyroX == 32767 && m.gyroY == -32768);
+}
+
+MotionData ImuSample(float dpsX, float dpsY, float dpsZ, float gX, float gY, float gZ) {
+    auto gyro = [](float dps) { return SHORT(std::lround(dps * IMU_GYRO_COUNTS_PER_DPS)); };
+    auto accel = [](float g) { return SHORT(std::lround(g * IMU_ACCEL_COUNTS_PER_G)); };
+    return MotionData{ gyro(dpsX), gyro(dpsY), gyro(dpsZ), accel(gX), accel(gY), accel(gZ) };
+}
+
+MotionData Normalized(ControllerFamily family, JoyConSide side, JoyConOrientation orientation, MotionData raw) {
+    return NormalizeMotion(raw, SelectImuTransform(family, side, orientation));
+}
+
+void TestImuNormalizationFlat() {
+    // Lying flat and turning left: up is DS4 +Y in every grip, and so is the yaw rate
+    const SHORT oneG = SHORT(IMU_ACCEL_COUNTS_PER_G);
+    const SHORT yaw90 = SHORT(90 * IMU_GYRO_COUNTS_PER_DPS);
+    bool ok = true;
+    for (ControllerFamily family : { ControllerFamily::JoyCon2, ControllerFamily::ProController2, ControllerFamily::NSOGC }) {
+        for (JoyConSide side : { JoyConSide::Left, JoyConSide::Right }) {
+            for (JoyConOrientation o : { JoyConOrientation::Upright, JoyConOrientation::Sideways }) {
+                MotionData m = Normalized(family, side, o, MotionData{ 0, 0, yaw90, 0, 0, oneG });
+                ok &= m.accelX == 0 && m.accelY == 8192 && m.accelZ == 0;
+                ok &= m.gyroX == 0 && m.gyroY == 1440 && m.gyroZ == 0;
+            }
+        }
+    }
+    CHECK(ok);
+
+    // Beyond the DS4's range the output saturates
+    MotionData hard = Normalized(ControllerFamily::ProController2, JoyConSide::Left, JoyConOrientation::Upright,
+                                 MotionData{ 0, 0, 0, 0, 0, 20000 });
+    CHECK(hard.accelY == 32767);
+
+    // The DSU floats keep the full range and resolution
+    float accelG[3], gyroDps[3];
+    NormalizeMotionUnits(MotionData{ 0, 0, 1, 0, 0, 20000 },
+                         SelectImuTransform(ControllerFamily::ProController2), accelG, gyroDps);
+    CHECK(std::fabs(accelG[1] - 20000.0f / IMU_ACCEL_COUNTS_PER_G) < 1e-3f);
+    CHECK(std::fabs(gyroDps[1] - 1.0f / IMU_GYRO_COUNTS_PER_DPS) < 1e-5f);
+    CHECK(accelG[0] == 0.0f && gyroDps[2] == 0.0f);
+}
+
+void TestImuNormalizationGrips() {
+    const SHORT oneG = SHORT(IMU_ACCEL_COUNTS_PER_G);
+    using O = JoyConOrientation;
+    using S = JoyConSide;
+    const auto JC = ControllerFamily::JoyCon2;
+
+    // Rolled onto the left edge (right side up): up is DS4 +X. Sideways, that edge is the Joy-Con's
+    // bottom (left) or top (right); upright, it is the left Joy-Con's rail side (-Y).
+    CHECK(Normalized(JC, S::Left, O::Sideways, MotionData{ 0, 0, 0, SHORT(-oneG), 0, 0 }).accelX == 8192);
+    CHECK(Normalized(JC, S::Right, O::Sideways, MotionData{ 0, 0, 0, oneG, 0, 0 }).accelX == 8192);
+    CHECK(Normalized(JC, S::Left, O::Upright, MotionData{ 0, 0, 0, 0, SHORT(-oneG), 0 }).accelX == 8192);
+
+    // Nose up (far edge up): up points away from the player, DS4 -Z
+    CHECK(Normalized(JC, S::Left, O::Upright, MotionData{ 0, 0, 0, oneG, 0, 0 }).accelZ == -8192);
+    CHECK(Normalized(JC, S::Left, O::Sideways, MotionData{ 0, 0, 0, 0, SHORT(-oneG), 0 }).accelZ == -8192);
+    CHECK(Normalized(JC, S::Right, O::Sideways, MotionData{ 0, 0, 0, 0, oneG, 0 }).accelZ == -8192);
+
+    // Pitching the far edge up turns about DS4 +X in every grip
+    const SHORT rate = SHORT(45 * IMU_GYRO_COUNTS_PER_DPS);
+    MotionData upright = Normalized(JC, S::Left, O::Upright, MotionData{ 0, SHORT(-rate), 0, 0, 0, oneG });
+    MotionData left = Normalized(JC, S::Left, O::Sideways, MotionData{ SHORT(-rate), 0, 0, 0, 0, oneG });
+    MotionData right = Normalized(JC, S::Right, O::Sideways, MotionData{ rate, 0, 0, 0, 0, oneG });
+    CHECK(upright.gyroX == 720 && upright.gyroY == 0 && upright.gyroZ == 0);
+    CHECK(left.gyroX == upright.gyroX && right.gyroX == upright.gyroX);
+}
+
+void TestMotionFusionIntegratesRotation() {
+    MotionFusion fusion;
+    fusion.SetSamplePeriod(0.01f);
+    for (int i = 0; i < 100; ++i) fusion.Update(ImuSample(0, 0, 0, 0, 0, 1));
+    CHECK(std::fabs(fusion.Orientation().w - 1.0f) < 1e-4f);
+    CHECK(std::fabs(fusion.Gravity().z - 1.0f) < 1e-4f);
+
+    // One second at 90 dps about the vertical axis: a quarter turn of yaw, still upright
+    for (int i = 0; i < 100; ++i) fusion.Update(ImuSample(0, 0, 90, 0, 0, 1));
+    const Quaternion& q = fusion.Orientation();
+    float yaw = std::atan2(2 * (q.w * q.z + q.x * q.y), 1 - 2 * (q.y * q.y + q.z * q.z));
+    CHECK(std::fabs(yaw - 3.14159265f / 2) < 0.02f);
+    CHECK(std::fabs(fusion.Gravity().z - 1.0f) < 1e-3f);
+    CHECK(std::fabs(fusion.AngularVelocity().z - 3.14159265f / 2) < 0.01f);
+}
+
+void TestMotionFusionFollowsGravity() {
+    // Controller lying on its side: the accelerometer pulls the estimate over
+    MotionFusion fusion;
+    fusion.SetSamplePeriodUs(10000);
+    for (int i = 0; i < 1000; ++i) fusion.Update(ImuSample(0, 0, 0, 1, 0, 0));
+    CHECK(fusion.Gravity().x > 0.99f);
+
+    // Shaking (well above 1 g) is not mistaken for gravity
+    fusion.Reset();
+    for (int i = 0; i < 1000; ++i) fusion.Update(ImuSample(0, 0, 0, 2, 0, 0));
+    CHECK(std::fabs(fusion.Gravity().z - 1.0f) < 1e-4f);
+}
+
+MotionData GyroRamp(int64_t us) {
+    // 1 count per 10us on gyro X, crossing zero at 50ms
+    return MotionData{ SHORT((us - 50000) / 10), 0, 0, 0, 0, 4096 };
+}
+
+void TestDualImuFusionAlignsInTime() {
+    DualImuFusion imu;
+    MotionData out{};
+    CHECK(!imu.Sample(out));
+
+    // Left reports on the 10ms grid, right 4ms later: both are read at the same instant, so the
+    // merged ramp stays exact (averaging the newest samples would lag by half the offset)
+    bool exact = true;
+    imu.Push(1, -6000, GyroRamp(-6000));
+    for (int64_t t = 0; t < 100000; t += 10000) {
+        imu.Push(0, t, GyroRamp(t));
+        CHECK(imu.Sample(out));
+        exact &= t == 0 || out.gyroX == GyroRamp(t - 6000).gyroX;   // left has no history yet
+        imu.Push(1, t + 4000, GyroRamp(t + 4000));
+        CHECK(imu.Sample(out));
+        exact &= out.gyroX == GyroRamp(t).gyroX;
+        exact &= out.accelZ == 4096;
+    }
+    CHECK(exact);
+
+    // Crossing zero is not "missing": one side at 0 and the other at 1000 give 500
+    DualImuFusion cross;
+    cross.Push(0, 0, MotionData{ 0, 0, 0, 0, 0, 4096 });
+    cross.Push(1, 0, MotionData{ 1000, 0, 0, 0, 0, 4096 });
+    CHECK(cross.Sample(out) && out.gyroX == 500);
+
+    // A side that went silent is dropped instead of holding the merge back
+    cross.Push(0, 200000, MotionData{ 300, 0, 0, 0, 0, 4096 });
+    CHECK(cross.Sample(out) && out.gyroX == 300);
+}
+
+void TestDualImuFusionWeightsAndMounts() {
+    // Right IMU mounted with X reversed: both read the same rotation once in the body frame
+    ImuMount mirrored{ { 0, 1, 2 }, { -1, 1, 1 } };
+    DualImuFusion imu(JOYCON_LEFT_IMU_MOUNT, mirrored);
+    MotionData out{};
+    for (int i = 0; i < 4; ++i) {
+        imu.Push(0, i * 10000, MotionData{ 200, 0, 0, 0, 0, 4096 });
+        imu.Push(1, i * 10000, MotionData{ -200, 0, 0, 0, 0, 4096 });
+    }
+    CHECK(imu.Sample(out) && out.gyroX == 200);
+
+    // A noisy side loses its say
+    DualImuFusion noisy;
+    for (int i = 0; i < 200; ++i) {
+        SHORT jitter = SHORT((i % 2) ? 400 : -400);
+        noisy.Push(0, i * 10000, MotionData{ jitter, 0, 0, 0, 0, 4096 });
+        noisy.Push(1, i * 10000, MotionData{ 0, 0, 0, 0, 0, 4096 });
+    }
+    CHECK(noisy.Weight(1) > 0.99f);
+    CHECK(noisy.Sample(out) && std::abs(out.gyroX) < 4);
+}
+
+void TestGyroMouseSensitivityAndRatchet() {
+    GyroMouseSettings s;
+    s.space = GyroSpace::Local;
+    CHECK(GyroSensitivity(s, 0.0f) == s.minSens);
+    CHECK(GyroSensitivity(s, 500.0f) == s.maxSens);
+    CHECK(std::fabs(GyroSensitivity(s, 65.0f) - 1.5f) < 1e-4f);
+
+    // One second turning left at 90 dps with 1:1 sensitivity: a quarter of countsPer360, leftwards
+    s.minSens = s.maxSens = 1.0f;
+    const ImuTransform& upright = SelectImuTransform(ControllerFamily::JoyCon2);
+    MotionFusion fusion;
+    fusion.SetSamplePeriod(0.01f);
+    float dx = 0.0f, dy = 0.0f;
+    for (int i = 0; i < 100; ++i) {
+        fusion.Update(ImuSample(0, 0, 90, 0, 0, 1));
+        MouseDelta d = GyroMouseDelta(fusion, upright, s, false);
+        dx += d.dx;
+        dy += d.dy;
+    }
+    CHECK(std::fabs(dx + 900.0f) < 5.0f);
+    CHECK(std::fabs(dy) < 1e-3f);
+
+    // Tremor below the deadband and anything while ratcheting is dropped
+    fusion.Update(ImuSample(0.2f, 0, 0.2f, 0, 0, 1));
+    CHECK(GyroMouseDelta(fusion, upright, s, false).dx == 0.0f);
+    fusion.Update(ImuSample(0, 0, 90, 0, 0, 1));
+    CHECK(GyroMouseDelta(fusion, upright, s, true).dx == 0.0f);
+
+    // Tilting the far edge up (about the upright Joy-Con's Y axis) moves the pointer up; the same
+    // motion for a sideways right Joy-Con is about its X axis
+    fusion.Update(ImuSample(0, -90, 0, 0, 0, 1));
+    MouseDelta up = GyroMouseDelta(fusion, upright, s, false);
+    CHECK(up.dy < -8.0f && std::fabs(up.dx) < 1e-3f);
+    fusion.Update(ImuSample(90, 0, 0, 0, 0, 1));
+    const ImuTransform& sideways = SelectImuTransform(ControllerFamily::JoyCon2, JoyConSide::Right, JoyConOrientation::Sideways);
+    CHECK(std::fabs(GyroMouseDelta(fusion, sideways, s, false).dy - up.dy) < 0.1f);
+}
+
+void TestGyroMouseWorldYaw() {
+    // Controller rolled onto its side: turning about the world's vertical axis is still yaw
+    GyroMouseSettings s;
+    s.minSens = s.maxSens = 1.0f;
+    MotionFusion fusion;
+    fusion.SetSamplePeriod(0.01f);
+    for (int i = 0; i < 1000; ++i) fusion.Update(ImuSample(0, 0, 0, 0, 1, 0));
+    fusion.Update(ImuSample(0, 90, 0, 0, 1, 0));
+    const ImuTransform& upright = SelectImuTransform(ControllerFamily::JoyCon2);
+    CHECK(GyroMouseDelta(fusion, upright, s, false).dx < -8.0f);
+    s.space = GyroSpace::Local;
+    CHECK(GyroMouseDelta(fusion, upright, s, false).dx == 0.0f);
+}
+
+void TestGyroStick() {
+    const ImuTransform& upright = SelectImuTransform(ControllerFamily::JoyCon2);
+    GyroStickSettings s;
+    s.mode = GyroStickMode::Replace;
+    s.smoothingMs = 0.0f;
+    MotionFusion fusion;
+    fusion.SetSamplePeriod(0.01f);
+    GyroStick stick;
+    auto step = [&](MotionData m) {
+        fusion.Update(m);
+        stick.Update(fusion, upright, s);
+    };
+
+    // Tremor leaves the stick centered; just past the deadzone it starts at minDeflection
+    step(ImuSample(0, 0, 1, 0, 0, 1));
+    CHECK(stick.X() == 0.0f && stick.Y() == 0.0f);
+    step(ImuSample(0, 0, 2.5f, 0, 0, 1));
+    CHECK(stick.X() < -s.minDeflection && stick.X() > -0.11f);
+
+    // Turning left halfway between deadzone and full speed, then tilting up faster than full
+    step(ImuSample(0, 0, 91, 0, 0, 1));
+    CHECK(std::fabs(stick.X() + 0.55f) < 1e-3f && std::fabs(stick.Y()) < 1e-3f);
+
+    DS4_REPORT_EX report{};
+    DS4_REPORT_INIT(reinterpret_cast<DS4_REPORT*>(&report.Report));
+    report.Report.bThumbRX = 200;
+    s.mode = GyroStickMode::Off;
+    stick.Apply(report, s);
+    CHECK(report.Report.bThumbRX == 200);
+    s.mode = GyroStickMode::Blend;
+    stick.Apply(report, s);
+    CHECK(report.Report.bThumbRX == 130 && report.Report.bThumbRY == 128);
+
+    step(ImuSample(0, -240, 0, 0, 0, 1));
+    CHECK(std::fabs(stick.Y() + 1.0f) < 1e-3f);
+    s.mode = GyroStickMode::Replace;
+    stick.Apply(report, s);
+    CHECK(report.Report.bThumbRX == 128 && report.Report.bThumbRY == 0);
+
+    // Smoothing: five 10 ms steps with a 50 ms time constant reach 1 - (5/6)^5 of a step
+    s.smoothingMs = 50.0f;
+    stick.Reset();
+    for (int i = 0; i < 5; ++i) step(ImuSample(0, 0, 240, 0, 0, 1));
+    CHECK(std::fabs(stick.X() + (1.0f - std::pow(5.0f / 6.0f, 5.0f))) < 1e-3f);
+}
+
+void TestFlickStick() {
+    GyroMouseSettings s;
+    FlickStick flick;
+    auto run = [&](float x, float y, int steps) {
+        float turn = 0.0f;
+        for (int i = 0; i < steps; ++i) turn += flick.Update(x, y, 0.01f, s);
+        return turn;
+    };
+    CHECK(run(0, 0, 5) == 0.0f);
+
+    // Flicking right turns a quarter to the right within flickTime, then stays there
+    float first = flick.Update(1, 0, 0.01f, s);
+    CHECK(first > 9.0f && first < 90.0f);
+    CHECK(std::fabs(first + run(1, 0, 20) - 90.0f) < 1e-3f);
+    CHECK(flick.Active());
+
+    // Rotating the held stick from right to down turns another quarter, immediately
+    CHECK(std::fabs(run(0.7071f, 0.7071f, 1) + run(0, 1, 1) - 90.0f) < 1e-2f);
+
+    // Released, then flicked left
+    run(0, 0, 1);
+    CHECK(!flick.Active());
+    CHECK(std::fabs(run(-1, 0, 20) + 90.0f) < 1e-3f);
+}
+
+JoyConInputFrame OpticalFrame(int16_t x, int16_t y) {
+    JoyConInputFrame frame;
+    frame.length = 0x3C;
+    frame.opticalX = x;
+    frame.opticalY = y;
+    return frame;
+}
+
+uint16_t TouchX(const BYTE (&data)[3]) { return static_cast<uint16_t>(data[0] | ((data[1] & 0x0F) << 8)); }
+
+void TestTouchpadEncoderBatchesSamples() {
+    DS4TouchpadEncoder touchpad;
+    DS4_REPORT_EX report{};
+
+    // Two notifications between reports: both go out, oldest first, with their own counters
+    touchpad.Push(OpticalFrame(-32767, 0));
+    touchpad.Push(OpticalFrame(32767, 0));
+    touchpad.Encode(report);
+    CHECK(report.Report.bTouchPacketsN == 2);
+    CHECK(report.Report.sCurrentTouch.bPacketCounter == 1);
+    CHECK(report.Report.sPreviousTouch[0].bPacketCounter == 2);
+    CHECK(TouchX(report.Report.sCurrentTouch.bTouchData1) == 0);
+    CHECK(TouchX(report.Report.sPreviousTouch[0].bTouchData1) == 1920);
+    CHECK(report.Report.sCurrentTouch.bIsUpTrackingNum1 == 0);
+    CHECK(report.Report.sPreviousTouch[0].bIsUpTrackingNum1 == 0);
+    CHECK(report.Report.sCurrentTouch.bIsUpTrackingNum2 & 0x80);   // no second finger
+
+    // No new sample: the newest packet is repeated, counter unchanged
+    touchpad.Encode(report);
+    CHECK(report.Report.bTouchPacketsN == 1);
+    CHECK(report.Report.sCurrentTouch.bPacketCounter == 2);
+
+    // Lifting and touching again starts a new contact
+    JoyConInputFrame lifted;
+    lifted.length = 0x10;
+    touchpad.Push(lifted);
+    touchpad.Push(OpticalFrame(0, 0));
+    touchpad.Encode(report);
+    CHECK(report.Report.bTouchPacketsN == 2);
+    CHECK(report.Report.sCurrentTouch.bIsUpTrackingNum1 == 0x80);
+    CHECK(report.Report.sPreviousTouch[0].bIsUpTrackingNum1 == 1);
+    CHECK(report.Report.sPreviousTouch[0].bPacketCounter == 4);
+
+    // A stalled report keeps the newest three samples
+    for (int16_t x = 0; x < 5; ++x) touchpad.Push(OpticalFrame(x * 1000, 0));
+    touchpad.Encode(report);
+    CHECK(report.Report.bTouchPacketsN == 3);
+    CHECK(report.Report.sCurrentTouch.bPacketCounter == 7);
+    CHECK(report.Report.sPreviousTouch[1].bPacketCounter == 9);
+}
+
+void TestTouchpadEncoderFoldsDualFingers() {
+    DS4TouchpadEncoder touchpad;
+    DS4_REPORT_EX report{};
+
+    // Left then right notification share a packet; a second left one opens the next
+    touchpad.Push(OpticalFrame(0, 0), 0);
+    touchpad.Push(OpticalFrame(32767, 0), 1);
+    touchpad.Push(OpticalFrame(-32767, 0), 0);
+    touchpad.Encode(report);
+    CHECK(report.Report.bTouchPacketsN == 2);
+    const DS4_TOUCH& first = report.Report.sCurrentTouch;
+    const DS4_TOUCH& second = report.Report.sPreviousTouch[0];
+    CHECK(first.bIsUpTrackingNum1 == 0 && first.bIsUpTrackingNum2 == 1);
+    CHECK(TouchX(first.bTouchData1) == 960 && TouchX(first.bTouchData2) == 1920);
+    CHECK(TouchX(second.bTouchData1) == 0 && TouchX(second.bTouchData2) == 1920);
+    CHECK(second.bPacketCounter == first.bPacketCounter + 1);
+}
+
+void TestPlayerPipeline() {
+    PlayerPipeline player(ControllerFamily::JoyCon2, JoyConSide::Right, JoyConOrientation::Upright, "dev");
+    GyroStickSettings s;
+    s.mode = GyroStickMode::Replace;
+    s.smoothingMs = 0.0f;
+
+    // Turning at 90 dps about every axis, one notification every 8 ms
+    RawFrame raw = MakeSampleFrame();
+    SHORT rate = SHORT(90 * IMU_GYRO_COUNTS_PER_DPS);
+    for (size_t axis = 0; axis < 3; ++axis) {
+        raw[0x36 + 2 * axis] = static_cast<uint8_t>(rate & 0xFF);
+        raw[0x37 + 2 * axis] = static_cast<uint8_t>(rate >> 8);
+    }
+    DS4_REPORT_EX report{};
+    uint16_t lastStamp = 0;
+    bool increasing = true;
+    for (int64_t i = 0; i < 32; ++i) {
+        JoyConInputFrame frame = player.Decode(raw, sizeof(SAMPLE_NOTIFICATION), 1000000 + 8000 * i);
+        report = player.Report(frame, s);
+        increasing &= i == 0 || uint16_t(report.Report.wTimestamp - lastStamp) > 0;
+        lastStamp = report.Report.wTimestamp;
+    }
+    CHECK(increasing);
+    CHECK(std::abs(report.Report.bThumbRX - 128) + std::abs(report.Report.bThumbRY - 128) > 16);
+    CHECK(report.Report.bTouchPacketsN == 1);
+
+    // While the mouse owns the right stick the gyro leaves the report alone
+    JoyConInputFrame frame = player.Decode(raw, sizeof(SAMPLE_NOTIFICATION), 1000000 + 8000 * 32);
+    report = player.Report(frame, s, true);
+    DS4_REPORT_EX expected = SelectDS4ReportGenerator(JoyConSide::Right, JoyConOrientation::Upright)(frame, DefaultStickLUT());
+    CHECK(report.Report.bThumbLX == expected.Report.bThumbLX && report.Report.bThumbLY == expected.Report.bThumbLY);
+    CHECK(report.Report.bThumbRX == expected.Report.bThumbRX && report.Report.bThumbRY == expected.Report.bThumbRY);
+}
+
+void TestMouseInterpolationConservesMovement() {
+    MouseInterpolator interp;
+    auto now = Clock::now();
+    // 15ms report interval at 500Hz output -> spread over 7 ticks
+    interp.OnReport(10.5f, -7.0f, 15.0f, 2.0f, now);
+    CHECK(interp.ticksLeft == 7);
+
+    int totalX = 0, totalY = 0, ticks = 0;
+    while (interp.ticksLeft > 0) {
+        MouseMove move = interp.Tick(now);
+        totalX += move.dx;
+        totalY += move.dy;
+        ++ticks;
+    }
+    CHECK(ticks == 7);
+    CHECK(totalX == 10 && totalY == -7);
+    CHECK(std::fabs(interp.accumX - 0.5f) < 1e-4f);
+}
+
+void TestMouseInterpolationStopsOnZeroReport() {
+    MouseInterpolator interp;
+    auto now = Clock::now();
+    interp.OnReport(20.0f, 0.0f, 15.0f, 2.0f, now);
+    interp.Tick(now);
+    interp.OnReport(0.0f, 0.0f, 15.0f, 2.0f, now);
+    CHECK(interp.ticksLeft == 0);
+    MouseMove move = interp.Tick(now);
+    CHECK(move.dx == 0 && move.dy == 0);
+
+    // Residual sub-pixel accumulation is dropped after 50ms of inactivity
+    interp.accumX = 0.7f;
+    interp.Tick(now + std::chrono::milliseconds(60));
+    CHECK(interp.accumX == 0.0f);
+}
+
+void TestReportIntervalSmoothing() {
+    CHECK(ClampInterpolationRate(50) == 100);
+    CHECK(ClampInterpolationRate(1000) == 1000);
+    CHECK(ClampInterpolationRate(2000) == 1000);
+    CHECK(std::fabs(SmoothReportInterval(15.0f, 5.0f) - 12.0f) < 1e-5f);
+    CHECK(SmoothReportInterval(15.0f, 0.5f) == 15.0f);    // burst, ignored
+    CHECK(SmoothReportInterval(15.0f, 250.0f) == 15.0f);  // stall, ignored
+}
+
+void TestVibrationMapping() {
+    VibrationMotors full = ScaleVibration(255, 100, 1.0f);
+    CHECK(full.left == 255 && full.right == 100);
+    VibrationMotors half = ScaleVibration(200, 100, 0.5f);
+    CHECK(half.left == 100 && half.right == 50);
+
+    CHECK(SelectVibrationSample(VibrationMotors{ 0, 0 }) == VIB_NONE);
+    CHECK(SelectVibrationSample(VibrationMotors{ 181, 0 }) == VIB_BUZZ);
+    CHECK(SelectVibrationSample(VibrationMotors{ 0, 81 }) == VIB_STRONG_THUNK);
+    CHECK(SelectVibrationSample(VibrationMotors{ 80, 80 }) == VIB_DUN);
+}
+
+void TestDS4ReportInit() {
+    DS4_REPORT_EX report{};
+    DS4_REPORT_INIT(reinterpret_cast<PDS4_REPORT>(&report.Report));
+    CHECK(report.Report.bThumbLX == 0x80 && report.Report.bThumbRY == 0x80);
+    CHECK(report.Report.wButtons == DS4_BUTTON_DPAD_NONE);
+    CHECK(report.ReportBuffer[4] == DS4_BUTTON_DPAD_NONE);
+}
+
+void TestLatencyHistogram() {
+    // Every bucket's upper bound maps back to it, and the next value starts the next bucket
+    bool contiguous = true;
+    for (uint32_t b = 0; b + 1 < LatencyHistogram::BUCKETS; ++b) {
+        int64_t upper = LatencyHistogram::UpperBound(b);
+        contiguous &= LatencyHistogram::BucketOf(static_cast<uint32_t>(upper)) == b;
+        contiguous &= LatencyHistogram::BucketOf(static_cast<uint32_t>(upper + 1)) == b + 1;
+    }
+    CHECK(contiguous);
+    CHECK(LatencyHistogram::BucketOf(LatencyHistogram::MAX_US) == LatencyHistogram::BUCKETS - 1);
+
+    LatencyHistogram h;
+    CHECK(h.Count() == 0 && h.PercentileUs(0.5) == 0);
+    for (int64_t us = 1; us <= 1000; ++us) h.Record(us);
+    h.Record(-5);   // clock step: clamped to 0
+    CHECK(h.Count() == 1001);
+    CHECK(h.MaxUs() == 1000);
+    CHECK(std::fabs(h.MeanUs() - 500.0) < 1.0);
+    int64_t p50 = h.PercentileUs(0.5), p99 = h.PercentileUs(0.99);
+    CHECK(p50 >= 500 && p50 <= 500 * 9 / 8);
+    CHECK(p99 >= 990 && p99 <= 1000);   // capped at the largest sample
+    CHECK(h.PercentileUs(0.0) == 0);
+}
+
+} // namespace
+
+int main() {
+    TestDecodeSampleFrame();
+    TestButtonWordOffsets();
+    TestFrameLayoutSelection();
+    TestShortFrameKeepsSticksCentered();
+    TestOversizedFrameIsCapped();
+    TestJoystickDeadzoneAndGain();
+    TestConfigRoundTrip();
+    TestStickCalibratorLearnsCenterAndExtents();
+    TestCalibratedLookupTable();
+    TestControllerCalibrationRepublishes();
+    TestStickCurveShapes();
+    TestAxialAndRadialLookupTables();
+    TestStickProfileRoundTrip();
+    TestGyroCalibrationLearnsBiasAtRest();
+    TestGyroCalibrationLearnsDpsScaleBias();
+    TestGyroCalibrationIgnoresMotion();
+    TestImuNormalizationFlat();
+    TestImuNormalizationGrips();
+    TestMotionFusionIntegratesRotation();
+    TestMotionFusionFollowsGravity();
+    TestDualImuFusionAlignsInTime();
+    TestDualImuFusionWeightsAndMounts();
+    TestGyroMouseSensitivityAndRatchet();
+    TestGyroMouseWorldYaw();
+    TestFlickStick();
+    TestGyroStick();
+    TestTouchpadEncoderBatchesSamples();
+    TestTouchpadEncoderFoldsDualFingers();
+    TestPlayerPipeline();
+    TestMouseInterpolationConservesMovement();
+    TestMouseInterpolationStopsOnZeroReport();
+    TestReportIntervalSmoothing();
+    TestVibrationMapping();
+    TestDS4ReportInit();
+    TestLatencyHistogram();
+    return TestSummary("joycon2_core_tests");
+}
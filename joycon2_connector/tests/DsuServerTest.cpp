@@ -0,0 +1,273 @@
+// DSU server loopback test: a client on 127.0.0.1 queries version and ports, subscribes, and
+// checks every pad-data packet's CRC, numbering and payload, the delivery rate, that publishing
+// does not allocate, and that a report carrying several touch packets sends the newest.
+#include "TestUtil.h"
+#include "AllocationCounter.h"
+#include "DsuServer.h"
+#include "TouchpadEncoder.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+constexpr uint64_t MAC_A = 0x112233445566;
+constexpr uint64_t MAC_B = 0xAABBCCDDEEFF;
+constexpr int PUBLISH_COUNT = 250;
+constexpr int PUBLISH_PERIOD_US = 2000;   // 500 Hz, above the controllers' notification rate
+
+uint32_t Get32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+float GetFloat(const uint8_t* p) { float v; std::memcpy(&v, p, 4); return v; }
+
+struct Client {
+    int sock = -1;
+    sockaddr_in server{};
+
+    explicit Client(uint16_t port) {
+        sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        timeval timeout{ 0, 300000 };
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        server.sin_family = AF_INET;
+        server.sin_port = htons(port);
+        server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+    ~Client() { close(sock); }
+
+    void Send(uint32_t type, const uint8_t* payload, size_t length) {
+        uint8_t p[64] = {};
+        std::memcpy(p, "DSUC", 4);
+        uint16_t version = DSU_PROTOCOL_VERSION, size = uint16_t(4 + length);
+        uint32_t id = 0xC11E;
+        std::memcpy(p + 4, &version, 2);
+        std::memcpy(p + 6, &size, 2);
+        std::memcpy(p + 12, &id, 4);
+        std::memcpy(p + 16, &type, 4);
+        std::memcpy(p + 20, payload, length);
+        uint32_t crc = DsuCrc32(p, 20 + length);
+        std::memcpy(p + 8, &crc, 4);
+        sendto(sock, p, 20 + length, 0, reinterpret_cast<sockaddr*>(&server), sizeof(server));
+    }
+
+    // Bytes received, 0 on timeout
+    size_t Receive(uint8_t* buf, size_t capacity) {
+        ssize_t n = recv(sock, buf, capacity, 0);
+        return n > 0 ? size_t(n) : 0;
+    }
+};
+
+void Subscribe(Client& client, uint8_t flags, uint8_t slot, uint64_t mac) {
+    uint8_t request[8] = { flags, slot };
+    for (int b = 0; b < 6; ++b) request[2 + b] = uint8_t(mac >> (8 * (5 - b)));
+    client.Send(DSU_MSG_PAD_DATA, request, sizeof(request));
+}
+
+bool WaitForClients(DsuServer& server, int count) {
+    for (int i = 0; i < 100 && server.ClientCount() < count; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return server.ClientCount() >= count;
+}
+
+DS4_REPORT_EX TestReport(int i) {
+    DS4_REPORT_EX report{};
+    DS4_REPORT_INIT(reinterpret_cast<DS4_REPORT*>(&report.Report));
+    report.Report.bThumbLY = uint8_t(i);
+    report.Report.wButtons = uint16_t((report.Report.wButtons & ~0xF) | DS4_BUTTON_DPAD_EAST | DS4_BUTTON_CROSS);
+    report.Report.bTriggerR = 200;
+    return report;
+}
+
+DsuMotion TestMotion(int i) {
+    DsuMotion m;
+    m.timestampUs = 1000000 + uint64_t(i) * PUBLISH_PERIOD_US;
+    m.accelG[1] = 1.0f;
+    m.gyroDps[0] = 0.25f * i;
+    return m;
+}
+
+void TestRequests(DsuServer& server) {
+    Client client(server.Port());
+    uint8_t buf[256];
+
+    client.Send(DSU_MSG_VERSION, nullptr, 0);
+    size_t n = client.Receive(buf, sizeof(buf));
+    CHECK(n == DSU_VERSION_SIZE);
+    CHECK(DsuPacketValid(buf, n, "DSUS"));
+    CHECK(Get32(buf + 16) == DSU_MSG_VERSION);
+    CHECK((buf[20] | buf[21] << 8) == DSU_PROTOCOL_VERSION);
+
+    const uint8_t ports[7] = { 3, 0, 0, 0, 0, 1, 3 };
+    client.Send(DSU_MSG_PORTS, ports, sizeof(ports));
+    for (int expected : { 0, 1, 3 }) {
+        n = client.Receive(buf, sizeof(buf));
+        CHECK(n == DSU_PORT_INFO_SIZE);
+        CHECK(DsuPacketValid(buf, n, "DSUS"));
+        CHECK(buf[20] == expected);
+        CHECK(buf[21] == (expected == 3 ? 0 : 2));
+    }
+    const uint8_t macA[6] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+    client.Send(DSU_MSG_PORTS, ports, 5);
+    n = client.Receive(buf, sizeof(buf));
+    CHECK(n == DSU_PORT_INFO_SIZE && std::memcmp(buf + 24, macA, 6) == 0);
+
+    // A corrupted request is ignored
+    uint8_t bad[20] = {};
+    std::memcpy(bad, "DSUC", 4);
+    sendto(client.sock, bad, sizeof(bad), 0, reinterpret_cast<sockaddr*>(&client.server), sizeof(client.server));
+    CHECK(client.Receive(buf, sizeof(buf)) == 0);
+}
+
+void TestStream(DsuServer& server) {
+    Client client(server.Port());
+    Subscribe(client, 1, 0, 0);
+    CHECK(WaitForClients(server, 1));
+
+    uint64_t publishAllocs = 0;
+    std::thread publisher([&] {
+        auto next = std::chrono::steady_clock::now();
+        uint64_t before = AllocationCount();
+        for (int i = 0; i < PUBLISH_COUNT; ++i) {
+            next += std::chrono::microseconds(PUBLISH_PERIOD_US);
+            std::this_thread::sleep_until(next);
+            DS4_REPORT_EX report = TestReport(i);
+            DsuMotion motion = TestMotion(i);
+            server.Publish(0, report, motion);
+            server.Publish(1, report, motion);   // nobody subscribed to slot 1
+        }
+        publishAllocs = AllocationCount() - before;
+    });
+
+    uint8_t buf[256];
+    int received = 0, invalid = 0, outOfOrder = 0, wrongSlot = 0, wrongPayload = 0;
+    uint32_t lastNumber = 0;
+    std::chrono::steady_clock::time_point first, last;
+    while (size_t n = client.Receive(buf, sizeof(buf))) {
+        last = std::chrono::steady_clock::now();
+        if (received == 0) first = last;
+        if (n != DSU_PAD_DATA_SIZE || !DsuPacketValid(buf, n, "DSUS") || Get32(buf + 16) != DSU_MSG_PAD_DATA) {
+            ++invalid;
+            continue;
+        }
+        if (buf[20] != 0) ++wrongSlot;
+        uint32_t number = Get32(buf + 32);
+        if (received > 0 && number != lastNumber + 1) ++outOfOrder;
+        lastNumber = number;
+        ++received;
+
+        // Packet numbers start at 0, so they index the published sequence
+        int i = int(number);
+        bool ok = buf[21] == 2 && buf[31] == 1
+            && buf[36] == 0x20                     // d-pad right
+            && buf[37] == 0x40                     // cross
+            && buf[41] == uint8_t(255 - i % 256)   // left stick Y flipped to positive up
+            && buf[46] == 255 && buf[49] == 255 && buf[54] == 200
+            && GetFloat(buf + 80) == 1.0f && GetFloat(buf + 88) == 0.25f * i;
+        uint64_t ts;
+        std::memcpy(&ts, buf + 68, 8);
+        if (!ok || ts != TestMotion(i).timestampUs) ++wrongPayload;
+    }
+    publisher.join();
+
+    std::printf("  received %d/%d packets\n", received, PUBLISH_COUNT);
+    CHECK(invalid == 0);
+    CHECK(wrongSlot == 0);
+    CHECK(outOfOrder == 0);
+    CHECK(wrongPayload == 0);
+    CHECK(received >= PUBLISH_COUNT * 95 / 100);
+    CHECK(publishAllocs == 0);
+    CHECK(server.PacketCount(1) == 0);
+
+    // Arrivals keep the publishing rate (500 Hz) within 20%
+    if (received > 1) {
+        double spanUs = double(std::chrono::duration_cast<std::chrono::microseconds>(last - first).count());
+        double rateHz = (received - 1) * 1e6 / spanUs;
+        std::printf("  arrival rate %.1f Hz\n", rateHz);
+        CHECK(rateHz > 400.0 && rateHz < 600.0);
+    }
+}
+
+void TestSubscribeByMac(DsuServer& server) {
+    Client client(server.Port());
+    Subscribe(client, 2, 0, MAC_B);
+    CHECK(WaitForClients(server, 1));
+
+    server.Publish(0, TestReport(0), TestMotion(0));
+    server.Publish(1, TestReport(1), TestMotion(1));
+    uint8_t buf[256];
+    size_t n = client.Receive(buf, sizeof(buf));
+    CHECK(n == DSU_PAD_DATA_SIZE && DsuPacketValid(buf, n, "DSUS"));
+    CHECK(buf[20] == 1);
+    CHECK(client.Receive(buf, sizeof(buf)) == 0);
+}
+
+JoyConInputFrame TouchFrame(int16_t x) {
+    JoyConInputFrame frame;
+    frame.length = 0x3C;
+    frame.opticalX = x;
+    return frame;
+}
+
+uint16_t Get16(const uint8_t* p) { return uint16_t(p[0] | p[1] << 8); }
+
+// Two samples queued between reports (the dual merge thread holding a frame): DSU gets the newer
+void TestNewestTouchPacket(DsuServer& server) {
+    Client client(server.Port());
+    Subscribe(client, 1, 0, 0);
+    CHECK(WaitForClients(server, 2));   // the MAC client is still subscribed
+
+    DS4TouchpadEncoder touchpad;
+    DS4_REPORT_EX report = TestReport(0);
+    touchpad.Push(TouchFrame(-32767));
+    touchpad.Push(TouchFrame(32767));
+    touchpad.Encode(report);
+    CHECK(report.Report.bTouchPacketsN == 2);
+    server.Publish(0, report, TestMotion(0));
+    uint8_t buf[256];
+    size_t n = client.Receive(buf, sizeof(buf));
+    CHECK(n == DSU_PAD_DATA_SIZE && DsuPacketValid(buf, n, "DSUS"));
+    CHECK(buf[56] == 1 && Get16(buf + 58) == 1920);
+
+    // The finger lifted after touching: DSU reports it up
+    JoyConInputFrame lifted;
+    lifted.length = 0x10;
+    touchpad.Push(TouchFrame(0));
+    touchpad.Push(lifted);
+    touchpad.Encode(report);
+    CHECK(report.Report.bTouchPacketsN == 2);
+    server.Publish(0, report, TestMotion(1));
+    n = client.Receive(buf, sizeof(buf));
+    CHECK(n == DSU_PAD_DATA_SIZE && buf[56] == 0);
+}
+
+} // namespace
+
+int main() {
+    // Known CRC-32 check value
+    CHECK(DsuCrc32(reinterpret_cast<const uint8_t*>("123456789"), 9) == 0xCBF43926u);
+
+    DsuServer server;
+    CHECK(server.Start(0));
+    CHECK(server.Port() != 0);
+    CHECK(server.AcquireSlot(MAC_A) == 0);
+    CHECK(server.AcquireSlot(MAC_B) == 1);
+
+    TestRequests(server);
+    TestStream(server);
+    server.Stop();
+    CHECK(!server.Running());
+
+    // A restarted server forgets its clients but keeps the slots
+    CHECK(server.Start(0));
+    CHECK(server.ClientCount() == 0);
+    TestSubscribeByMac(server);
+    TestNewestTouchPacket(server);
+    server.ReleaseSlot(1);
+    CHECK(server.AcquireSlot(MAC_B) == 1);
+    server.Stop();
+
+    return TestSummary("dsu_server_loopback");
+}
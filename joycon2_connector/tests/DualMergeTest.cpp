@@ -0,0 +1,196 @@
+// Dual Joy-Con merge policies: scripted arrivals for each policy's decision and deadline, then
+// two simulated Joy-Cons with jitter and a phase offset merged under every policy, comparing the
+// skew between the halves of each report against the latency the policy adds.
+#include "TestUtil.h"
+#include "DualMerge.h"
+#include "SimulatedController.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Feeds one arrival and asks right away, as the merge thread does after taking a frame
+bool ArriveAndAsk(DualFramePairer& pairer, int side, int64_t us, int64_t& wakeAtUs) {
+    pairer.Arrive(side, us);
+    return pairer.Ready(us, wakeAtUs);
+}
+
+void TestAnyChange() {
+    DualFramePairer pairer(DualMergePolicy::AnyChange, 4000);
+    auto skew = std::make_unique<LatencyHistogram>();
+    int64_t wake = 0;
+    CHECK(!ArriveAndAsk(pairer, 0, 1000, wake) && wake == 0);   // no right frame yet
+    CHECK(ArriveAndAsk(pairer, 1, 1500, wake));
+    pairer.Emitted(1500, *skew);
+    CHECK(!pairer.Ready(2000, wake) && wake == 0);              // nothing new
+    CHECK(ArriveAndAsk(pairer, 0, 9000, wake));                 // one side is enough
+    pairer.Emitted(9000, *skew);
+    CHECK(skew->Count() == 2 && skew->MaxUs() == 7500);
+    CHECK(pairer.Expired() == 0);
+}
+
+void TestWaitForBoth() {
+    DualFramePairer pairer(DualMergePolicy::WaitForBoth, 4000);
+    auto skew = std::make_unique<LatencyHistogram>();
+    int64_t wake = 0;
+    pairer.Arrive(0, 1000);
+    CHECK(ArriveAndAsk(pairer, 1, 1500, wake));
+    pairer.Emitted(1500, *skew);
+
+    CHECK(!ArriveAndAsk(pairer, 0, 9000, wake) && wake == 13000);
+    CHECK(!ArriveAndAsk(pairer, 0, 11000, wake) && wake == 13000);   // the wait runs from the first
+    CHECK(ArriveAndAsk(pairer, 1, 12000, wake));
+    pairer.Emitted(12000, *skew);
+    CHECK(skew->MaxUs() == 1000);
+    CHECK(pairer.Expired() == 0);
+
+    // The right Joy-Con goes quiet: the left one is emitted alone at the deadline
+    CHECK(!ArriveAndAsk(pairer, 0, 20000, wake) && wake == 24000);
+    CHECK(!pairer.Ready(23999, wake));
+    CHECK(pairer.Ready(24000, wake));
+    pairer.Emitted(24000, *skew);
+    CHECK(pairer.Expired() == 1);
+}
+
+void TestNearestArrival() {
+    DualFramePairer pairer(DualMergePolicy::NearestArrival, 4000);
+    auto skew = std::make_unique<LatencyHistogram>();
+    int64_t wake = 0;
+    // Right notifies at 1000 + 8000k, left at 3000 + 8000k: each left frame follows a right one by
+    // 2000 and precedes the next by 6000, so it pairs with the held right frame at once
+    for (int64_t k = 0; k < 4; ++k) {
+        int64_t right = 1000 + 8000 * k, left = 3000 + 8000 * k;
+        bool rightReady = ArriveAndAsk(pairer, 1, right, wake);
+        if (rightReady) pairer.Emitted(right, *skew);
+        CHECK(ArriveAndAsk(pairer, 0, left, wake));
+        pairer.Emitted(left, *skew);
+    }
+    CHECK(skew->MaxUs() <= 6000);
+
+    // Now the left frame lands 6000 after the right one and the next right is due 2000 later:
+    // it waits for that one, no longer than the deadline
+    pairer.Arrive(1, 33000);
+    pairer.Emitted(33000, *skew);
+    int64_t left = 33000 + 6000;
+    CHECK(!ArriveAndAsk(pairer, 0, left, wake) && wake == left + 4000);
+    CHECK(ArriveAndAsk(pairer, 1, 41000, wake));
+    auto paired = std::make_unique<LatencyHistogram>();
+    pairer.Emitted(41000, *paired);
+    CHECK(paired->MaxUs() == 2000);
+
+    // The right frame is late: past left + held gap no later frame can be closer
+    DualFramePairer capped(DualMergePolicy::NearestArrival, 50000);
+    for (int64_t k = 0; k < 4; ++k) {
+        capped.Arrive(1, 8000 * k);
+        capped.Arrive(0, 8000 * k + 1000);
+        capped.Emitted(8000 * k + 1000, *skew);
+    }
+    capped.Arrive(1, 32000);
+    capped.Emitted(32000, *skew);
+    CHECK(!ArriveAndAsk(capped, 0, 37000, wake) && wake == 42000);
+    CHECK(capped.Ready(42000, wake));
+    capped.Emitted(42000, *skew);
+    CHECK(capped.Expired() == 0);   // gave up early, not at the deadline
+}
+
+void TestPolicyStrings() {
+    for (DualMergePolicy p : { DualMergePolicy::AnyChange, DualMergePolicy::NearestArrival, DualMergePolicy::WaitForBoth })
+        CHECK(StringToDualMergePolicy(DualMergePolicyToString(p)) == p);
+    CHECK(StringToDualMergePolicy("bogus") == DualMergePolicy::AnyChange);
+}
+
+struct Arrival {
+    int side;
+    int64_t us;
+};
+
+struct MergeRun {
+    uint64_t reports = 0;
+    int64_t skewP50 = 0, skewP99 = 0;
+    double meanHoldUs = 0.0;   // from the first new frame to its report
+    int64_t maxHoldUs = 0;
+    uint64_t expired = 0;
+};
+
+// Replays the arrivals in time order with the merge thread's timed waits
+MergeRun Merge(const std::vector<Arrival>& arrivals, DualMergePolicy policy, int64_t deadlineUs) {
+    DualFramePairer pairer(policy, deadlineUs);
+    auto skew = std::make_unique<LatencyHistogram>();
+    auto hold = std::make_unique<LatencyHistogram>();
+    int64_t wakeAtUs = 0, firstNewUs = 0;
+    auto emit = [&](int64_t nowUs) {
+        if (skew->Count() > 0) hold->Record(nowUs - firstNewUs);   // not the wait for the first pair
+        pairer.Emitted(nowUs, *skew);
+        firstNewUs = 0;
+    };
+    for (const Arrival& a : arrivals) {
+        int64_t wokeUs = wakeAtUs;
+        if (wokeUs && wokeUs <= a.us && pairer.Ready(wokeUs, wakeAtUs)) emit(wokeUs);
+        pairer.Arrive(a.side, a.us);
+        if (!firstNewUs) firstNewUs = a.us;
+        if (pairer.Ready(a.us, wakeAtUs)) emit(a.us);
+    }
+    MergeRun run;
+    run.reports = skew->Count();
+    run.skewP50 = skew->PercentileUs(0.5);
+    run.skewP99 = skew->PercentileUs(0.99);
+    run.meanHoldUs = hold->MeanUs();
+    run.maxHoldUs = hold->MaxUs();
+    run.expired = pairer.Expired();
+    return run;
+}
+
+void TestSimulatedPair() {
+    SimulationSettings settings;
+    settings.periodUs = 7500.0;
+    settings.jitterUs = 1500.0;
+    settings.lossRate = 0.01;
+    InputScript still = [](int64_t) { return SimulatedInput{}; };
+    settings.seed = 11;
+    SimulatedController left(settings, still);
+    settings.seed = 12;
+    settings.address += 1;
+    SimulatedController right(settings, still);
+
+    std::vector<Arrival> arrivals;
+    NotificationHandler onLeft = [&](const uint8_t*, size_t, int64_t us) { arrivals.push_back({ 0, us }); };
+    NotificationHandler onRight = [&](const uint8_t*, size_t, int64_t us) { arrivals.push_back({ 1, us }); };
+    constexpr size_t SAMPLES = 8000;
+    left.Generate(SAMPLES, onLeft, 0);
+    right.Generate(SAMPLES, onRight, 2500);   // the halves are out of phase by a third of a period
+    std::stable_sort(arrivals.begin(), arrivals.end(), [](const Arrival& a, const Arrival& b) { return a.us < b.us; });
+
+    constexpr int64_t DEADLINE_US = 4000;
+    MergeRun any = Merge(arrivals, DualMergePolicy::AnyChange, DEADLINE_US);
+    MergeRun nearest = Merge(arrivals, DualMergePolicy::NearestArrival, DEADLINE_US);
+    MergeRun both = Merge(arrivals, DualMergePolicy::WaitForBoth, DEADLINE_US);
+    for (auto [name, run] : { std::pair{ "any", any }, std::pair{ "nearest", nearest }, std::pair{ "both", both } }) {
+        std::printf("  %-8s %5llu reports, skew p50 %4lld us p99 %4lld us, hold mean %6.1f us max %4lld us, %llu unpaired\n",
+            name, static_cast<unsigned long long>(run.reports), static_cast<long long>(run.skewP50),
+            static_cast<long long>(run.skewP99), run.meanHoldUs, static_cast<long long>(run.maxHoldUs),
+            static_cast<unsigned long long>(run.expired));
+    }
+
+    // Any change answers every frame at once, pairing with whatever the other side last sent
+    CHECK(any.maxHoldUs == 0);
+    CHECK(any.reports > nearest.reports && nearest.reports >= both.reports);
+    // Holding for the nearer partner narrows the skew, at a bounded cost in latency
+    CHECK(nearest.skewP50 < any.skewP50);
+    CHECK(nearest.maxHoldUs <= DEADLINE_US);
+    // Waiting for both pairs each report's halves within about the phase offset plus jitter
+    CHECK(both.skewP99 < any.skewP99);
+    CHECK(both.maxHoldUs <= DEADLINE_US);
+    CHECK(both.expired > 0 && both.expired < both.reports / 10);   // only around lost notifications
+}
+
+} // namespace
+
+int main() {
+    TestAnyChange();
+    TestWaitForBoth();
+    TestNearestArrival();
+    TestPolicyStrings();
+    TestSimulatedPair();
+    return TestSummary("dual_merge");
+}
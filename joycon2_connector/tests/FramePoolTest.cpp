@@ -0,0 +1,329 @@
+// Frame pool tests: slot accounting and exhaustion, shared references, mailbox replacement, a
+// left/right/merge/telemetry stress run checking every frame arrives intact, and a dual Joy-Con
+// pipeline (ring -> decode into a pool slot -> mailbox -> merge -> report, with capture on)
+// that makes no heap allocations once running. The merge loop's signal must sleep while both
+// sides are idle and time each handoff.
+#include "TestUtil.h"
+#include "AllocationCounter.h"
+#include "CaptureFile.h"
+#include "FramePool.h"
+#include "FrameRing.h"
+#include "LatencyHistogram.h"
+#include "SensorClock.h"
+#include "SimulatedController.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace {
+
+struct TestFrame {
+    uint32_t side;
+    uint32_t sequence;
+    uint32_t check;
+    uint8_t pad[52];
+};
+
+constexpr uint32_t Check(uint32_t side, uint32_t sequence) { return (sequence * 2654435761u) ^ (side << 31); }
+
+using Pool = FramePool<TestFrame, 8>;
+
+void TestAccounting() {
+    auto pool = std::make_unique<Pool>();
+    std::vector<Pool::Ref> held;
+    for (int i = 0; i < 8; ++i) held.push_back(pool->Acquire());
+    bool all = true;
+    for (const auto& ref : held) all &= static_cast<bool>(ref);
+    CHECK(all);
+    CHECK(pool->InUse() == 8);
+    CHECK(!pool->Acquire());
+    CHECK(pool->Exhausted() == 1);
+
+    // A copy keeps the slot alive after the original lets go
+    held[3]->sequence = 42;
+    Pool::Ref copy = held[3];
+    held[3].Reset();
+    CHECK(pool->InUse() == 8);
+    CHECK(copy->sequence == 42);
+    copy.Reset();
+    CHECK(pool->InUse() == 7);
+    CHECK(pool->Acquire());   // the freed slot, released again at the end of the statement
+    held.clear();
+    CHECK(pool->InUse() == 0);
+    CHECK(pool->Acquired() == 9);
+}
+
+void TestMailbox() {
+    auto pool = std::make_unique<Pool>();
+    {
+        FrameMailbox<TestFrame, 8> box(*pool);
+        CHECK(!box.HasNew() && !box.Take());
+        for (uint32_t i = 0; i < 3; ++i) {
+            Pool::Ref f = pool->Acquire();
+            f->sequence = i;
+            box.Publish(std::move(f));
+        }
+        CHECK(box.Replaced() == 2);
+        CHECK(pool->InUse() == 1);   // the frames published over went back to the pool
+        CHECK(box.HasNew());
+        Pool::Ref newest = box.Take();
+        CHECK(newest && newest->sequence == 2);
+        CHECK(!box.HasNew() && !box.Take());
+        box.Publish(pool->Acquire());
+    }
+    CHECK(pool->InUse() == 0);   // the mailbox releases what was never taken
+}
+
+// Two sides publish, the merge thread keeps the latest of each and forwards copies to a
+// telemetry thread, as the dual player does with its consumers
+void TestStress() {
+    constexpr uint32_t FRAMES = 200000;
+    using StressPool = FramePool<TestFrame, 16>;
+    auto pool = std::make_unique<StressPool>();
+    FrameMailbox<TestFrame, 16> sides[2] = { FrameMailbox<TestFrame, 16>(*pool), FrameMailbox<TestFrame, 16>(*pool) };
+    FrameMailbox<TestFrame, 16> telemetry(*pool);
+    std::atomic<int> producing{ 2 };
+    std::atomic<bool> started{ false }, merging{ true };
+    std::atomic<uint64_t> corrupt{ 0 }, reordered{ 0 }, telemetryFrames{ 0 };
+
+    auto producer = [&](uint32_t side) {
+        while (!started.load()) std::this_thread::yield();
+        for (uint32_t i = 1; i <= FRAMES; ++i) {
+            if (i % 32 == 0) std::this_thread::yield();   // let the consumers interleave
+            StressPool::Ref f = pool->Acquire();
+            if (!f) continue;
+            f->side = side;
+            f->sequence = i;
+            f->check = Check(side, i);
+            sides[side].Publish(std::move(f));
+        }
+        producing.fetch_sub(1);
+    };
+    std::thread left(producer, 0), right(producer, 1);
+    std::thread telemetryThread([&] {
+        while (merging.load() || telemetry.HasNew()) {
+            StressPool::Ref f = telemetry.Take();
+            if (!f) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (f->check != Check(f->side, f->sequence)) corrupt.fetch_add(1);
+            telemetryFrames.fetch_add(1);
+        }
+    });
+
+    StressPool::Ref current[2];
+    uint32_t last[2] = { 0, 0 };
+    started.store(true);
+    while (producing.load() > 0 || sides[0].HasNew() || sides[1].HasNew()) {
+        for (uint32_t side = 0; side < 2; ++side) {
+            StressPool::Ref f = sides[side].Take();
+            if (!f) continue;
+            if (f->side != side || f->check != Check(side, f->sequence)) corrupt.fetch_add(1);
+            if (f->sequence <= last[side]) reordered.fetch_add(1);
+            last[side] = f->sequence;
+            current[side] = std::move(f);
+            telemetry.Publish(current[side]);   // shared, not copied
+        }
+    }
+    left.join();
+    right.join();
+    merging.store(false);
+    telemetryThread.join();
+
+    std::printf("  stress: %llu taken by telemetry, %llu replaced in the side mailboxes, %llu exhausted\n",
+        static_cast<unsigned long long>(telemetryFrames.load()),
+        static_cast<unsigned long long>(sides[0].Replaced() + sides[1].Replaced()),
+        static_cast<unsigned long long>(pool->Exhausted()));
+    CHECK(corrupt.load() == 0);
+    CHECK(reordered.load() == 0);
+    CHECK(last[0] == FRAMES && last[1] == FRAMES);
+    // Two producers, three mailboxes and the merge thread's two frames: 16 slots never run out
+    CHECK(pool->Exhausted() == 0);
+    current[0].Reset();
+    current[1].Reset();
+    CHECK(pool->InUse() == 0);
+}
+
+int64_t NowUs() { return SteadyMicros(std::chrono::steady_clock::now()); }
+
+// The dual player's merge loop: it wakes when a side publishes, sleeps indefinitely while both
+// are idle, and times each handoff from the first publish to the merged submit
+void TestMergeSignal() {
+    using SignalPool = FramePool<TestFrame, 16>;
+    auto pool = std::make_unique<SignalPool>();
+    FrameMailbox<TestFrame, 16> leftBox(*pool), rightBox(*pool);
+    FrameSignal signal;
+    auto latency = std::make_unique<LatencyHistogram>();
+    std::atomic<bool> running{ true };
+    std::atomic<uint64_t> wakeups{ 0 }, submits{ 0 };
+
+    std::thread merge([&] {
+        SignalPool::Ref left, right;
+        bool fresh = false;
+        while (running.load()) {
+            uint32_t generation = signal.Generation();
+            if (SignalPool::Ref f = leftBox.Take()) left = std::move(f), fresh = true;
+            if (SignalPool::Ref f = rightBox.Take()) right = std::move(f), fresh = true;
+            int64_t notifiedUs = signal.Claim();
+            if (!left || !right || !fresh) {
+                signal.Wait(generation);
+                wakeups.fetch_add(1);
+                continue;
+            }
+            fresh = false;
+            if (notifiedUs) latency->Record(NowUs() - notifiedUs);
+            submits.fetch_add(1);
+        }
+    });
+
+    auto publish = [&](FrameMailbox<TestFrame, 16>& box, uint32_t sequence) {
+        SignalPool::Ref f = pool->Acquire();
+        f->sequence = sequence;
+        box.Publish(std::move(f));
+        signal.Notify(NowUs());
+    };
+    constexpr uint32_t ROUNDS = 200;
+    for (uint32_t i = 0; i < ROUNDS; ++i) {
+        publish(leftBox, i);
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        publish(rightBox, i);
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t idleWakeups = wakeups.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(wakeups.load() == idleWakeups);   // no polling while both Joy-Cons are quiet
+    uint64_t submitted = submits.load();
+    CHECK(submitted >= ROUNDS && submitted <= 2 * ROUNDS);
+    CHECK(wakeups.load() <= 2 * ROUNDS + 1);
+    CHECK(latency->Count() >= submitted / 2 && latency->Count() <= submitted);
+
+    // A publish after the idle stretch is picked up straight away
+    publish(leftBox, ROUNDS);
+    for (int i = 0; i < 1000 && submits.load() == submitted; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CHECK(submits.load() == submitted + 1);
+
+    running.store(false);
+    signal.Wake();
+    merge.join();
+
+    // Timed waits, used while a merge policy holds one half: the deadline ends the wait, and so
+    // does a publish
+    auto start = std::chrono::steady_clock::now();
+    signal.WaitUntil(signal.Generation(), start + std::chrono::milliseconds(5));
+    CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5));
+    uint32_t generation = signal.Generation();
+    std::thread notifier([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        signal.Notify(NowUs());
+    });
+    start = std::chrono::steady_clock::now();
+    signal.WaitUntil(generation, start + std::chrono::seconds(10));
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+    CHECK(signal.Generation() != generation);
+    notifier.join();
+    std::printf("  merge signal: %llu submits, %llu wakeups, wake to submit p50 %lld us, p99 %lld us, max %lld us\n",
+        static_cast<unsigned long long>(submits.load()), static_cast<unsigned long long>(wakeups.load()),
+        static_cast<long long>(latency->PercentileUs(0.5)), static_cast<long long>(latency->PercentileUs(0.99)),
+        static_cast<long long>(latency->MaxUs()));
+    CHECK(pool->InUse() == 0);
+}
+
+void TestDualPipelineAllocations() {
+    using FramePoolT = FramePool<JoyConInputFrame, 16>;
+    auto pool = std::make_unique<FramePoolT>();
+    FrameMailbox<JoyConInputFrame, 16> leftBox(*pool), rightBox(*pool);
+    auto leftRing = std::make_unique<FrameRing>();
+    auto rightRing = std::make_unique<FrameRing>();
+    CHECK(CaptureSession::Instance().Start("frame_pool_test.jc2cap"));
+
+    SimulationSettings settings;
+    settings.periodUs = 8000.0;
+    settings.jitterUs = 2000.0;
+    settings.gyroNoiseDps = 0.5f;
+    InputScript script = [](int64_t elapsedUs) {
+        SimulatedInput in;
+        in.buttons = (elapsedUs / 100000) % 2 ? BUTTON_A_MASK : 0;
+        in.rightStick.x = static_cast<uint16_t>(1000 + elapsedUs / 1000 % 2000);
+        return in;
+    };
+    settings.seed = 1;
+    SimulatedController leftSim(settings, script);
+    settings.seed = 2;
+    settings.address += 1;
+    SimulatedController rightSim(settings, script);
+
+    DualReportGenerator generate = SelectDualReportGenerator(GyroSource::Both);
+    FramePoolT::Ref leftFrame, rightFrame;
+    bool fresh = false;
+    uint64_t reports = 0;
+    uint32_t buttonsSeen = 0;
+
+    auto decodeSide = [&](FrameRing& ring, FrameMailbox<JoyConInputFrame, 16>& box) {
+        ring.Drain([&](JoyConFrameView raw, uint32_t length, int64_t) {
+            FramePoolT::Ref frame = pool->Acquire();
+            if (!frame) return;
+            *frame = DecodeInputFrame(raw, length);
+            box.Publish(std::move(frame));
+        });
+    };
+    auto merge = [&] {
+        if (FramePoolT::Ref f = leftBox.Take()) leftFrame = std::move(f), fresh = true;
+        if (FramePoolT::Ref f = rightBox.Take()) rightFrame = std::move(f), fresh = true;
+        if (!leftFrame || !rightFrame || !fresh) return;
+        fresh = false;
+        DS4_REPORT_EX report = generate(*leftFrame, *rightFrame, DefaultStickLUT(), DefaultStickLUT());
+        buttonsSeen |= report.Report.wButtons;
+        ++reports;
+    };
+    auto leftCapture = CaptureSession::Instance().OpenChannel(leftSim.Address(), ControllerFamily::JoyCon2);
+    auto rightCapture = CaptureSession::Instance().OpenChannel(rightSim.Address(), ControllerFamily::JoyCon2);
+    NotificationHandler onLeft = [&](const uint8_t* data, size_t length, int64_t arrivalUs) {
+        leftCapture->Notification(data, length, arrivalUs);
+        leftRing->Push(data, length, arrivalUs);
+        decodeSide(*leftRing, leftBox);
+        merge();
+    };
+    NotificationHandler onRight = [&](const uint8_t* data, size_t length, int64_t arrivalUs) {
+        rightCapture->Notification(data, length, arrivalUs);
+        rightRing->Push(data, length, arrivalUs);
+        decodeSide(*rightRing, rightBox);
+        merge();
+    };
+
+    auto run = [&](int frames) {
+        for (int i = 0; i < frames; ++i) {
+            leftSim.Generate(1, onLeft, 1000000);
+            rightSim.Generate(1, onRight, 1000000);
+        }
+    };
+    run(500);   // warm-up: capture controllers registered, stdio buffer in place
+    CaptureSession::Instance().Flush();
+    uint64_t before = AllocationCount();
+    run(20000);
+    uint64_t allocations = AllocationCount() - before;
+    CaptureSession::Instance().Stop();
+    std::remove("frame_pool_test.jc2cap");
+
+    std::printf("  dual pipeline: %llu reports, %u slots in use, %llu heap allocations in steady state\n",
+        static_cast<unsigned long long>(reports), pool->InUse(), static_cast<unsigned long long>(allocations));
+    CHECK(allocations == 0);
+    CHECK(reports >= 20500);
+    CHECK(buttonsSeen != 0);
+    CHECK(pool->Exhausted() == 0);
+    CHECK(pool->InUse() == 2);   // the merge thread's current left and right frames
+}
+
+} // namespace
+
+int main() {
+    TestAccounting();
+    TestMailbox();
+    TestStress();
+    TestMergeSignal();
+    TestDualPipelineAllocations();
+    return TestSummary("frame_pool");
+}
@@ -0,0 +1,136 @@
+// FrameRing tests: ordering, zero padding, overrun and latest-only accounting, and a producer /
+// consumer stress run checking that every frame arrives intact and in order or is counted.
+#include "TestUtil.h"
+#include "FrameRing.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace {
+
+// Frame i: sequence number in bytes 0..3, then a pattern derived from it
+uint32_t FillFrame(uint8_t* data, uint32_t i) {
+    uint32_t length = 16 + i % (JOYCON_FRAME_SIZE - 15);
+    std::memcpy(data, &i, 4);
+    for (uint32_t b = 4; b < length; ++b) data[b] = static_cast<uint8_t>(i * 31 + b);
+    return length;
+}
+
+bool FrameIntact(JoyConFrameView frame, uint32_t length, uint32_t& sequence) {
+    std::memcpy(&sequence, frame.data(), 4);
+    bool ok = length == 16 + sequence % (JOYCON_FRAME_SIZE - 15);
+    for (uint32_t b = 4; b < length; ++b) ok &= frame[b] == static_cast<uint8_t>(sequence * 31 + b);
+    for (uint32_t b = length; b < JOYCON_FRAME_SIZE; ++b) ok &= frame[b] == 0;
+    return ok;
+}
+
+void TestQueueOrderAndPadding() {
+    auto ring = std::make_unique<FrameRing>();
+    uint8_t data[JOYCON_FRAME_SIZE];
+    // A long frame first, so the short ones must clear its leftovers
+    std::memset(data, 0xAB, sizeof(data));
+    CHECK(ring->Push(data, 100, 5));
+    for (uint32_t i = 1; i <= 3; ++i) CHECK(ring->Push(data, FillFrame(data, i), 1000 * i));
+    CHECK(ring->Size() == 4);
+
+    int calls = 0;
+    bool ok = true;
+    ring->Drain([&](JoyConFrameView frame, uint32_t length, int64_t arrivalUs) {
+        if (calls++ == 0) {
+            ok &= length == JOYCON_FRAME_SIZE && arrivalUs == 5;
+            return;
+        }
+        uint32_t sequence = 0;
+        ok &= FrameIntact(frame, length, sequence) && sequence == uint32_t(calls - 1);
+        ok &= arrivalUs == 1000 * int64_t(sequence);
+    });
+    CHECK(calls == 4 && ok);
+    CHECK(ring->Size() == 0);
+    CHECK(ring->Drain([](JoyConFrameView, uint32_t, int64_t) {}) == 0);
+}
+
+void TestOverrunAndLatestOnly() {
+    auto ring = std::make_unique<FrameRing>();
+    uint8_t data[JOYCON_FRAME_SIZE] = {};
+    for (uint32_t i = 0; i < FrameRing::CAPACITY; ++i) CHECK(ring->Push(data, FillFrame(data, i), i));
+    CHECK(!ring->Push(data, FillFrame(data, 99), 99));
+    CHECK(ring->Overruns() == 1);
+    CHECK(ring->Drain([](JoyConFrameView, uint32_t, int64_t) {}) == FrameRing::CAPACITY);
+
+    auto latest = std::make_unique<FrameRing>(FrameRingMode::LatestOnly);
+    for (uint32_t i = 0; i < 5; ++i) latest->Push(data, FillFrame(data, i), i);
+    uint32_t newest = 0;
+    bool ok = true;
+    CHECK(latest->Drain([&](JoyConFrameView frame, uint32_t length, int64_t) { ok &= FrameIntact(frame, length, newest); }) == 1);
+    CHECK(ok && newest == 4);
+    CHECK(latest->Skipped() == 4 && latest->Overruns() == 0);
+}
+
+// retry: the producer re-pushes dropped frames, so a queue must deliver every one of them
+void TestProducerConsumer(FrameRingMode mode, bool retry) {
+    constexpr uint32_t FRAMES = 200000;
+    auto ring = std::make_unique<FrameRing>(mode);
+    std::atomic<bool> done{ false };
+    uint32_t received = 0, corrupt = 0, outOfOrder = 0;
+
+    std::thread consumer([&] {
+        uint32_t last = 0;
+        bool first = true;
+        while (true) {
+            bool finished = done.load(std::memory_order_acquire);
+            ring->Drain([&](JoyConFrameView frame, uint32_t length, int64_t arrivalUs) {
+                uint32_t sequence = 0;
+                if (!FrameIntact(frame, length, sequence) || arrivalUs != sequence) ++corrupt;
+                if (!first && sequence <= last) ++outOfOrder;
+                first = false;
+                last = sequence;
+                ++received;
+            });
+            if (finished) break;
+            ring->Wait();
+        }
+    });
+
+    uint8_t data[JOYCON_FRAME_SIZE];
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        uint32_t length = FillFrame(data, i);
+        while (!ring->Push(data, length, i) && retry) std::this_thread::yield();
+        if (i % 1024 == 0) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    ring->Wake();
+    consumer.join();
+
+    std::printf("  %s%s: received %u, overruns %llu, skipped %llu\n", mode == FrameRingMode::Queue ? "queue" : "latest", retry ? " (retry)" : "",
+                received, static_cast<unsigned long long>(ring->Overruns()), static_cast<unsigned long long>(ring->Skipped()));
+    CHECK(corrupt == 0);
+    CHECK(outOfOrder == 0);
+    if (retry && mode == FrameRingMode::Queue) CHECK(received == FRAMES);
+    else if (!retry) CHECK(received + ring->Overruns() + ring->Skipped() == FRAMES);
+    CHECK(received > 0);
+}
+
+void TestWakeReleasesWait() {
+    auto ring = std::make_unique<FrameRing>();
+    std::atomic<bool> returned{ false };
+    std::thread waiter([&] {
+        ring->Wait();
+        returned.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ring->Wake();
+    waiter.join();
+    CHECK(returned.load());
+}
+
+} // namespace
+
+int main() {
+    TestQueueOrderAndPadding();
+    TestOverrunAndLatestOnly();
+    TestProducerConsumer(FrameRingMode::Queue, false);
+    TestProducerConsumer(FrameRingMode::Queue, true);
+    TestProducerConsumer(FrameRingMode::LatestOnly, false);
+    TestWakeReleasesWait();
+    return TestSummary("frame_ring_spsc");
+}
@@ -0,0 +1,29 @@
+#pragma once
+// Known controller notifications shared by the tests and benchmarks
+#include "JoyConDecoder.h"
+#include <array>
+#include <cstdint>
+
+// Left Joy-Con 2 notification with IMU enabled (see README "BLE Protocol Notes")
+inline constexpr uint8_t SAMPLE_NOTIFICATION[] = {
+    0x08, 0x67, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xff, 0x0f, 0xff, 0xf7, 0x7f, 0x23, 0x28, 0x7a,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f,
+    0x0e, 0x00, 0x79, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xce, 0x7b, 0x52, 0x01, 0x05, 0x00,
+    0xbe, 0xff, 0xb5, 0x01, 0xee, 0x0f, 0xfe, 0xff, 0x04, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+};
+
+using RawFrame = std::array<uint8_t, JOYCON_FRAME_SIZE>;
+
+inline RawFrame MakeSampleFrame() {
+    RawFrame raw{};
+    for (size_t i = 0; i < sizeof(SAMPLE_NOTIFICATION); ++i) raw[i] = SAMPLE_NOTIFICATION[i];
+    return raw;
+}
+
+// Write a 48-bit button state into bytes 3..8 (big-endian), as the controllers send it
+inline void SetButtonBytes(RawFrame& raw, uint64_t state) {
+    for (int i = 8; i >= 3; --i) {
+        raw[i] = static_cast<uint8_t>(state & 0xFF);
+        state >>= 8;
+    }
+}
@@ -0,0 +1,122 @@
+// Timing harness: feeds DS4SensorClock simulated BLE arrival patterns and checks that the DS4
+// timestamps are strictly increasing and advance at the true notification rate.
+#include "TestUtil.h"
+#include "SensorClock.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Deterministic jitter source (LCG), uniform in [-1, 1]
+struct Jitter {
+    uint32_t state = 12345;
+    double Next() {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) / double(1u << 23) - 1.0;
+    }
+};
+
+struct Pattern {
+    const char* name;
+    std::vector<int64_t> arrivals;   // microseconds
+    std::vector<int64_t> sampleUs;   // when each notification was actually sampled
+    double periodUs;
+};
+
+// Sampled every period, delivered with uniform jitter
+Pattern Steady(const char* name, double periodUs, double jitterUs, int count) {
+    Pattern p{ name, {}, {}, periodUs };
+    Jitter jitter;
+    for (int i = 0; i < count; ++i) {
+        int64_t sample = 1000000 + static_cast<int64_t>(i * periodUs);
+        p.sampleUs.push_back(sample);
+        p.arrivals.push_back(sample + static_cast<int64_t>(jitterUs * (jitter.Next() + 1.0) * 0.5));
+    }
+    return p;
+}
+
+// Two notifications per connection event, delivered back to back
+Pattern Bursts(const char* name, double periodUs, int count) {
+    Pattern p{ name, {}, {}, periodUs };
+    Jitter jitter;
+    for (int i = 0; i < count; i += 2) {
+        int64_t event = 1000000 + static_cast<int64_t>((i + 1) * periodUs + 1000 * jitter.Next());
+        for (int k = 0; k < 2; ++k) {
+            p.sampleUs.push_back(1000000 + static_cast<int64_t>((i + k) * periodUs));
+            p.arrivals.push_back(event + k * 400);
+        }
+    }
+    return p;
+}
+
+// Every dropEvery-th notification is lost
+Pattern Dropouts(const char* name, double periodUs, int dropEvery, int count) {
+    Pattern steady = Steady(name, periodUs, 500, count);
+    Pattern p{ name, {}, {}, periodUs };
+    for (int i = 0; i < count; ++i) {
+        if (i % dropEvery == dropEvery - 1) continue;
+        p.sampleUs.push_back(steady.sampleUs[i]);
+        p.arrivals.push_back(steady.arrivals[i]);
+    }
+    return p;
+}
+
+// Link stall: nothing arrives for stallUs halfway through (gaps beyond 65536 ticks, ~350ms,
+// cannot be represented by the 16-bit timestamp at all)
+Pattern Stall(const char* name, double periodUs, int64_t stallUs, int count) {
+    Pattern p = Steady(name, periodUs, 2000, count);
+    for (int i = count / 2; i < count; ++i) {
+        p.sampleUs[i] += stallUs;
+        p.arrivals[i] += stallUs;
+    }
+    return p;
+}
+
+// stepTolerance: largest allowed deviation of one timestamp step from the true sample interval,
+// as a fraction of the period, once the clock has seen a full window
+void Check(const Pattern& p, double stepTolerance) {
+    DS4SensorClock clock;
+    std::vector<uint16_t> stamps;
+    for (int64_t arrival : p.arrivals) stamps.push_back(clock.Stamp(arrival));
+
+    uint64_t backwards = 0;
+    int64_t totalTicks = 0;
+    double worstStep = 0.0, sumSq = 0.0;
+    size_t steps = 0;
+    for (size_t i = 1; i < stamps.size(); ++i) {
+        uint16_t delta = static_cast<uint16_t>(stamps[i] - stamps[i - 1]);
+        if (delta == 0 || delta >= 0x8000) ++backwards;
+        totalTicks += delta;
+        if (i < 2 * DS4SensorClock::WINDOW) continue;
+        double stepUs = delta * double(DS4_TIMESTAMP_DEN) / DS4_TIMESTAMP_NUM;
+        double trueUs = double(p.sampleUs[i] - p.sampleUs[i - 1]);
+        double err = std::fabs(stepUs - trueUs) / p.periodUs;
+        worstStep = (std::max)(worstStep, err);
+        sumSq += err * err;
+        ++steps;
+    }
+
+    // Rate: the timestamps must cover the same span as the samples (within 1%)
+    double stampedUs = totalTicks * double(DS4_TIMESTAMP_DEN) / DS4_TIMESTAMP_NUM;
+    double trueUs = double(p.sampleUs.back() - p.sampleUs.front());
+    double rateError = std::fabs(stampedUs - trueUs) / trueUs;
+    double rmsStep = steps ? std::sqrt(sumSq / steps) : 0.0;
+
+    std::printf("%-28s %5zu stamps, rate error %.3f%%, step error rms %.3f worst %.3f periods\n",
+        p.name, stamps.size(), 100 * rateError, rmsStep, worstStep);
+    CHECK(backwards == 0);
+    CHECK(rateError < 0.01);
+    CHECK(worstStep < stepTolerance);
+}
+
+} // namespace
+
+int main() {
+    Check(Steady("steady 15ms", 15000, 0, 2000), 0.01);
+    Check(Steady("steady 15ms, 3ms jitter", 15000, 3000, 2000), 0.1);
+    Check(Steady("steady 7.5ms, 2ms jitter", 7500, 2000, 4000), 0.1);
+    Check(Bursts("bursts of 2 per 15ms event", 7500, 4000), 0.25);
+    Check(Dropouts("1 in 50 dropped", 7500, 50, 4000), 1.0);
+    Check(Stall("150ms stall", 15000, 150000, 2000), 0.5);
+    return TestSummary("sensor_clock_timing");
+}
@@ -0,0 +1,179 @@
+// Simulated controller: frames decode back to their scripted input for every family, loss and
+// jitter follow the settings, command writes are recorded, and a real-time run drives the
+// ring -> decode -> DS4 report pipeline at the configured rate.
+#include "TestUtil.h"
+#include "SimulatedController.h"
+#include "FrameRing.h"
+#include "ImuNormalization.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+namespace {
+
+SimulatedInput TestInput() {
+    SimulatedInput in;
+    in.buttons = BUTTON_A_MASK | BUTTON_DPAD_LEFT | BUTTON_GL_MASK;
+    in.leftStick = { 100, 4000 };
+    in.rightStick = { 3900, 2048 };
+    in.opticalX = -1234;
+    in.opticalY = 567;
+    in.gyroDps[0] = 90.0f;
+    in.gyroDps[1] = -45.0f;
+    in.gyroDps[2] = 300.0f;   // past the sensor range: saturates
+    in.accelG[2] = -1.0f;
+    in.triggerL = 17;
+    in.triggerR = 240;
+    return in;
+}
+
+void TestEncodeRoundTrip() {
+    for (ControllerFamily family : { ControllerFamily::JoyCon2, ControllerFamily::ProController2, ControllerFamily::NSOGC }) {
+        SimulatedInput in = TestInput();
+        uint8_t raw[JOYCON_FRAME_SIZE];
+        size_t length = EncodeInputFrame(in, family, raw);
+        CHECK(length == SIMULATED_FRAME_LENGTH);
+        JoyConInputFrame frame = SelectFrameDecoder(family)(JoyConFrameView(raw, JOYCON_FRAME_SIZE), length);
+        CHECK(frame.buttons == in.buttons);
+        CHECK(frame.leftStick.x == 100 && frame.leftStick.y == 4000);
+        CHECK(frame.rightStick.x == 3900 && frame.rightStick.y == 2048);
+        CHECK(frame.opticalX == -1234 && frame.opticalY == 567);
+        CHECK(frame.motion.gyroX == 12000 && frame.motion.gyroY == -6000 && frame.motion.gyroZ == 32767);
+        CHECK(frame.motion.accelX == 0 && frame.motion.accelZ == -4096);
+        CHECK(frame.triggerL == 17 && frame.triggerR == 240);
+    }
+
+    // Same bytes as a real Joy-Con where the layout defines them
+    SimulatedInput in;
+    uint8_t raw[JOYCON_FRAME_SIZE];
+    EncodeInputFrame(in, ControllerFamily::JoyCon2, raw);
+    JoyConInputFrame frame = DecodeInputFrame(JoyConFrameView(raw, JOYCON_FRAME_SIZE), SIMULATED_FRAME_LENGTH);
+    DS4_REPORT_EX report = GenerateDS4Report(frame, JoyConSide::Left, JoyConOrientation::Upright);
+    CHECK(report.Report.bThumbLX == 128 && report.Report.bThumbLY == 128);
+}
+
+void TestStepScript() {
+    SimulatedInput pressed;
+    pressed.buttons = BUTTON_B_MASK;
+    SimulatedInput pushed;
+    pushed.leftStick = { 4095, 2048 };
+    InputScript script = StepScript({ { 100000, pushed }, { 20000, pressed } });
+    CHECK(script(0).buttons == 0);
+    CHECK(script(20000).buttons == BUTTON_B_MASK);
+    CHECK(script(99999).buttons == BUTTON_B_MASK);
+    CHECK(script(100000).buttons == 0 && script(100000).leftStick.x == 4095);
+    CHECK(script(5000000).leftStick.x == 4095);
+}
+
+// The sample index rides in the button bytes, so each arrival can be checked against its sample
+void TestLossAndJitter() {
+    SimulationSettings settings;
+    settings.family = ControllerFamily::ProController2;
+    settings.periodUs = 7500.0;
+    settings.jitterUs = 4000.0;
+    settings.lossRate = 0.1;
+    settings.gyroNoiseDps = 2.0f;
+    settings.seed = 77;
+    SimulatedController sim(settings, [&](int64_t elapsedUs) {
+        SimulatedInput in;
+        in.buttons = static_cast<uint64_t>(elapsedUs / 7500);
+        in.gyroDps[1] = 100.0f;
+        return in;
+    });
+
+    constexpr size_t SAMPLES = 20000;
+    size_t received = 0, badTiming = 0, outOfOrder = 0, noisy = 0;
+    int64_t lastArrival = -1;
+    sim.Generate(SAMPLES, [&](const uint8_t* data, size_t length, int64_t arrivalUs) {
+        JoyConInputFrame frame = SelectFrameDecoder(ControllerFamily::ProController2)(JoyConFrameView(data, JOYCON_FRAME_SIZE), length);
+        int64_t sampleUs = static_cast<int64_t>(frame.buttons) * 7500;
+        if (arrivalUs < sampleUs || arrivalUs > sampleUs + 4000) ++badTiming;
+        if (arrivalUs < lastArrival) ++outOfOrder;
+        float gyroY = frame.motion.gyroY / IMU_GYRO_COUNTS_PER_DPS;
+        if (std::fabs(gyroY - 100.0f) > 2.01f) ++noisy;
+        lastArrival = arrivalUs;
+        ++received;
+    });
+    double lossRate = double(sim.Lost()) / SAMPLES;
+    std::printf("  offline: %zu/%zu delivered, loss %.3f\n", received, SAMPLES, lossRate);
+    CHECK(sim.Delivered() == received);
+    CHECK(sim.Delivered() + sim.Lost() == SAMPLES);
+    CHECK(lossRate > 0.08 && lossRate < 0.12);
+    CHECK(badTiming == 0);
+    CHECK(outOfOrder == 0);
+    CHECK(noisy == 0);
+}
+
+void TestCommandWrites() {
+    SimulatedController sim(SimulationSettings{}, nullptr);
+    const uint8_t led[] = { 0x09, 0x91, 0x01, 0x07, 0x00, 0x08, 0x00, 0x00, 0x01 };
+    CHECK(sim.Write(led, sizeof(led)));
+    CHECK(sim.Write(led, 4));
+    auto commands = sim.Commands();
+    CHECK(commands.size() == 2);
+    CHECK(commands.size() == 2 && commands[0].size() == sizeof(led) && commands[0][8] == 0x01 && commands[1].size() == 4);
+}
+
+// Real time: transport thread -> ring -> stage thread decoding and building reports
+void TestRealTimePipeline() {
+    constexpr double PERIOD_US = 2000.0;   // 500 Hz
+    SimulationSettings settings;
+    settings.family = ControllerFamily::ProController2;
+    settings.periodUs = PERIOD_US;
+    settings.jitterUs = 500.0;
+    SimulatedInput pressed;
+    pressed.buttons = BUTTON_A_MASK;
+    pressed.leftStick = { 4095, 2048 };
+    SimulatedController sim(settings, StepScript({ { 0, SimulatedInput{} }, { 100000, pressed } }));
+
+    auto ring = std::make_unique<FrameRing>();
+    std::atomic<bool> running{ true };
+    uint64_t processed = 0, pressedReports = 0;
+    int64_t firstUs = 0, lastUs = 0;
+    FrameDecoder decode = SelectFrameDecoder(sim.Family());
+    auto process = [&](JoyConFrameView raw, uint32_t length, int64_t arrivalUs) {
+        JoyConInputFrame frame = decode(raw, length);
+        DS4_REPORT_EX report = GenerateProControllerReport(frame);
+        if ((report.Report.wButtons & DS4_BUTTON_CIRCLE) && report.Report.bThumbLX == 255) ++pressedReports;
+        if (processed++ == 0) firstUs = arrivalUs;
+        lastUs = arrivalUs;
+    };
+    std::thread stage([&] {
+        while (running.load(std::memory_order_acquire)) {
+            ring->Drain(process);
+            ring->Wait();
+        }
+        ring->Drain(process);
+    });
+
+    CHECK(sim.Subscribe([&](const uint8_t* data, size_t length, int64_t arrivalUs) { ring->Push(data, length, arrivalUs); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    sim.Unsubscribe();
+    running.store(false, std::memory_order_release);
+    ring->Wake();
+    stage.join();
+
+    std::printf("  real time: %llu frames, %llu with the scripted press\n",
+                static_cast<unsigned long long>(processed), static_cast<unsigned long long>(pressedReports));
+    CHECK(processed == sim.Delivered());
+    CHECK(ring->Overruns() == 0);
+    CHECK(pressedReports > 0 && pressedReports < processed);
+    if (processed > 1) {
+        double rateHz = double(processed - 1) * 1e6 / double(lastUs - firstUs);
+        std::printf("  arrival rate %.1f Hz\n", rateHz);
+        CHECK(rateHz > 400.0 && rateHz < 600.0);
+    }
+}
+
+} // namespace
+
+int main() {
+    TestEncodeRoundTrip();
+    TestStepScript();
+    TestLossAndJitter();
+    TestCommandWrites();
+    TestRealTimePipeline();
+    return TestSummary("simulated_controller");
+}
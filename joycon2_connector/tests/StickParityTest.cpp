@@ -0,0 +1,107 @@
+// Parity test: uncalibrated stick lookup tables must reproduce the original float stick math
+// bit-for-bit, for every raw stick position and every generator.
+#include "TestUtil.h"
+#include "LegacyDecoder.h"
+#include <cstring>
+
+namespace {
+
+constexpr size_t SAMPLE_LENGTH = sizeof(SAMPLE_NOTIFICATION);
+
+void PutStick(RawFrame& raw, size_t offset, uint16_t x, uint16_t y) {
+    raw[offset] = static_cast<uint8_t>(x & 0xFF);
+    raw[offset + 1] = static_cast<uint8_t>(((x >> 8) & 0x0F) | ((y & 0x0F) << 4));
+    raw[offset + 2] = static_cast<uint8_t>(y >> 4);
+}
+
+struct Sweep {
+    const char* name;
+    uint64_t checked = 0;
+    uint64_t mismatches = 0;
+
+    void Compare(const DS4_REPORT_EX& expected, const DS4_REPORT_EX& actual, uint16_t x, uint16_t y) {
+        ++checked;
+        if (std::memcmp(&expected.Report, &actual.Report, sizeof(expected.Report)) == 0) return;
+        if (mismatches++ < 5) {
+            std::printf("  %s: mismatch at stick (%u, %u): L %02X,%02X vs %02X,%02X  R %02X,%02X vs %02X,%02X\n",
+                name, x, y,
+                expected.Report.bThumbLX, expected.Report.bThumbLY, actual.Report.bThumbLX, actual.Report.bThumbLY,
+                expected.Report.bThumbRX, expected.Report.bThumbRY, actual.Report.bThumbRX, actual.Report.bThumbRY);
+        }
+    }
+
+    void Finish() {
+        std::printf("%-28s %12llu reports, %llu mismatches\n", name,
+            static_cast<unsigned long long>(checked), static_cast<unsigned long long>(mismatches));
+        CHECK(mismatches == 0);
+    }
+};
+
+// Every (x, y) of one stick; the other stick stays centered
+template <typename Legacy, typename Current>
+void SweepStick(const char* name, size_t offset, Legacy legacyGen, Current currentGen) {
+    Sweep sweep{ name };
+    RawFrame raw = MakeSampleFrame();
+    PutStick(raw, 10, 2048, 2048);
+    PutStick(raw, 13, 2048, 2048);
+    for (uint16_t y = 0; y < 4096; ++y) {
+        for (uint16_t x = 0; x < 4096; ++x) {
+            PutStick(raw, offset, x, y);
+            DS4_REPORT_EX expected = legacyGen(ToVector(raw, SAMPLE_LENGTH));
+            DS4_REPORT_EX actual = currentGen(DecodeInputFrame(raw, SAMPLE_LENGTH));
+            sweep.Compare(expected, actual, x, y);
+        }
+    }
+    sweep.Finish();
+}
+
+void TestStickToByte() {
+    int mismatches = 0;
+    for (int v = -32768; v <= 32767; ++v) {
+        int16_t s = static_cast<int16_t>(v);
+        if (StickToByte(s) != static_cast<uint8_t>((s / 32767.0f) * 127 + 128)) ++mismatches;
+    }
+    CHECK(mismatches == 0);
+}
+
+} // namespace
+
+int main() {
+    TestStickToByte();
+
+    for (JoyConOrientation o : { JoyConOrientation::Upright, JoyConOrientation::Sideways }) {
+        bool upright = (o == JoyConOrientation::Upright);
+        SweepStick(upright ? "left joy-con upright" : "left joy-con sideways", 10,
+            [o](const std::vector<uint8_t>& b) {
+                return legacy::NormalizedMotion(legacy::GenerateDS4Report(b, JoyConSide::Left, o),
+                    SelectImuTransform(ControllerFamily::JoyCon2, JoyConSide::Left, o));
+            },
+            [o](const JoyConInputFrame& f) { return GenerateDS4Report(f, JoyConSide::Left, o); });
+        SweepStick(upright ? "right joy-con upright" : "right joy-con sideways", 13,
+            [o](const std::vector<uint8_t>& b) {
+                return legacy::NormalizedMotion(legacy::GenerateDS4Report(b, JoyConSide::Right, o),
+                    SelectImuTransform(ControllerFamily::JoyCon2, JoyConSide::Right, o));
+            },
+            [o](const JoyConInputFrame& f) { return GenerateDS4Report(f, JoyConSide::Right, o); });
+    }
+
+    SweepStick("pro controller left stick", 10,
+        [](const std::vector<uint8_t>& b) {
+            return legacy::NormalizedMotion(legacy::GenerateProControllerReport(b),
+                SelectImuTransform(ControllerFamily::ProController2));
+        },
+        [](const JoyConInputFrame& f) { return GenerateProControllerReport(f); });
+    SweepStick("pro controller right stick", 13,
+        [](const std::vector<uint8_t>& b) {
+            return legacy::NormalizedMotion(legacy::GenerateProControllerReport(b),
+                SelectImuTransform(ControllerFamily::ProController2));
+        },
+        [](const JoyConInputFrame& f) { return GenerateProControllerReport(f); });
+    SweepStick("nso gc main stick", 10,
+        [](const std::vector<uint8_t>& b) {
+            return legacy::NormalizedMotion(legacy::GenerateNSOGCReport(b), SelectImuTransform(ControllerFamily::NSOGC));
+        },
+        [](const JoyConInputFrame& f) { return GenerateNSOGCReport(f); });
+
+    return TestSummary("stick_lut_parity");
+}
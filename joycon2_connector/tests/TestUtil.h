@@ -0,0 +1,28 @@
+#pragma once
+// Minimal assertion helpers shared by the test executables (no external framework)
+#include "JoyConDecoder.h"
+#include "SampleFrames.h"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+inline int g_testFailures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);          \
+            ++g_testFailures;                                                        \
+        }                                                                            \
+    } while (0)
+
+inline std::vector<uint8_t> ToVector(const RawFrame& raw, size_t length) {
+    return std::vector<uint8_t>(raw.begin(), raw.begin() + length);
+}
+
+inline int TestSummary(const char* name) {
+    if (g_testFailures == 0) std::printf("%s: all checks passed\n", name);
+    else std::printf("%s: %d check(s) failed\n", name, g_testFailures);
+    return g_testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+// Capture diff: finds which bytes and bits of a notification change across a recorded frame
+// stream, optionally relative to a baseline capture. Record the controller idle, then record
+// while exercising one input (a button, a stick, the trigger); the bytes that change only in
+// the second capture are that input's field. Offsets are labelled with a FrameLayout.
+#include "FrameCorpus.h"
+#include "FrameLayout.h"
+#include <bitset>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+
+struct ByteStats {
+    uint8_t min = 0xFF, max = 0;
+    uint8_t toggled = 0;       // bits that differed between consecutive frames
+    uint32_t changes = 0;      // frames whose value differed from the previous frame
+    uint32_t increments = 0;   // ... by exactly +1 (mod 256): counters and timestamps
+    std::bitset<256> seen;
+};
+
+struct CaptureStats {
+    size_t frames = 0;
+    uint32_t minLength = JOYCON_FRAME_SIZE, maxLength = 0;
+    ByteStats bytes[JOYCON_FRAME_SIZE];
+};
+
+CaptureStats Analyze(const FrameCorpus& corpus) {
+    CaptureStats stats;
+    stats.frames = corpus.frames.size();
+    for (size_t i = 0; i < corpus.frames.size(); ++i) {
+        uint32_t length = corpus.lengths[i];
+        if (length < stats.minLength) stats.minLength = length;
+        if (length > stats.maxLength) stats.maxLength = length;
+        for (size_t k = 0; k < JOYCON_FRAME_SIZE; ++k) {
+            ByteStats& b = stats.bytes[k];
+            uint8_t v = corpus.frames[i][k];
+            if (v < b.min) b.min = v;
+            if (v > b.max) b.max = v;
+            b.seen.set(v);
+            if (i == 0) continue;
+            uint8_t prev = corpus.frames[i - 1][k];
+            if (v == prev) continue;
+            ++b.changes;
+            b.toggled |= static_cast<uint8_t>(v ^ prev);
+            if (v == static_cast<uint8_t>(prev + 1)) ++b.increments;
+        }
+    }
+    return stats;
+}
+
+const char* Classify(const ByteStats& b) {
+    if (b.changes == 0) return "const";
+    if (b.increments * 10 >= b.changes * 9) return "counter";
+    // A few independent bits taking few combinations: button or flag bits
+    int bits = static_cast<int>(std::bitset<8>(b.toggled).count());
+    if (bits <= 4 && b.seen.count() <= (1u << bits)) return "bits";
+    return "analog";
+}
+
+// "leftStick+1" for offset 11 of the Joy-Con 2 layout, "" outside every field
+std::string FieldName(const FrameLayout& layout, size_t offset) {
+    const struct { const char* name; uint8_t start; uint8_t size; } fields[] = {
+        { "buttons", layout.buttons, 6 },
+        { "leftStick", layout.leftStick, 3 },
+        { "rightStick", layout.rightStick, 3 },
+        { "optical", layout.optical, 4 },
+        { "motion", layout.motion, 12 },
+        { "triggers", layout.triggers, 2 },
+    };
+    for (const auto& f : fields) {
+        if (offset < f.start || offset >= size_t(f.start) + f.size) continue;
+        char name[32];
+        if (offset == f.start) std::snprintf(name, sizeof(name), "%s", f.name);
+        else std::snprintf(name, sizeof(name), "%s+%zu", f.name, offset - f.start);
+        return name;
+    }
+    return "";
+}
+
+std::string Bits(uint8_t v) {
+    std::string s;
+    for (int bit = 7; bit >= 0; --bit) s += (v >> bit) & 1 ? '1' : '.';
+    return s;
+}
+
+// "synthetic:<kind>" generates a corpus; anything else is a hex capture file
+bool LoadSource(const std::string& source, size_t syntheticFrames, FrameCorpus& corpus) {
+    const std::string prefix = "synthetic:";
+    if (source.compare(0, prefix.size(), prefix) == 0) {
+        CorpusKind kind;
+        if (!ParseCorpusKind(source.c_str() + prefix.size(), kind)) return false;
+        corpus = MakeSyntheticCorpus(kind, syntheticFrames);
+        return true;
+    }
+    return LoadHexCorpus(source, CorpusKind::JoyConLeft, corpus);
+}
+
+struct Options {
+    std::string capture;
+    std::string baseline;
+    const FrameLayoutEntry* layout = &FRAME_LAYOUTS[0];
+    bool all = false;
+    size_t syntheticFrames = 1000;
+};
+
+void PrintUsage() {
+    std::printf(
+        "usage: joycon2_capture_diff <capture> [options]\n"
+        "  <capture>                 hex capture (one notification per line) or synthetic:left|right|pro|gc\n"
+        "  --baseline <capture>      only report bytes/bits that change beyond this capture\n"
+        "  --layout <name>           label offsets with this layout (");
+    for (size_t i = 0; i < FRAME_LAYOUT_COUNT; ++i)
+        std::printf("%s%s", FRAME_LAYOUTS[i].name, i + 1 < FRAME_LAYOUT_COUNT ? ", " : "");
+    std::printf(
+        "; default %s)\n"
+        "  --all                     also list bytes that never change\n"
+        "  --frames <n>              frames per synthetic capture (default 1000)\n",
+        FRAME_LAYOUTS[0].name);
+}
+
+bool ParseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--baseline" && hasValue) opt.baseline = argv[++i];
+        else if (arg == "--all") opt.all = true;
+        else if (arg == "--frames" && hasValue) opt.syntheticFrames = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--layout" && hasValue) {
+            const char* name = argv[++i];
+            opt.layout = nullptr;
+            for (const auto& entry : FRAME_LAYOUTS)
+                if (!std::strcmp(entry.name, name)) opt.layout = &entry;
+            if (!opt.layout) return false;
+        }
+        else if (arg[0] != '-' && opt.capture.empty()) opt.capture = arg;
+        else return false;
+    }
+    return !opt.capture.empty() && opt.syntheticFrames >= 2;
+}
+
+void PrintCapture(const char* title, const std::string& source, const CaptureStats& stats) {
+    std::printf("%s: %s (%zu frames, %u-%u bytes)\n", title, source.c_str(), stats.frames,
+        stats.minLength, stats.maxLength);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) {
+        PrintUsage();
+        return 2;
+    }
+
+    FrameCorpus corpus, baselineCorpus;
+    if (!LoadSource(opt.capture, opt.syntheticFrames, corpus)) {
+        std::fprintf(stderr, "cannot load capture %s\n", opt.capture.c_str());
+        return 1;
+    }
+    const bool diff = !opt.baseline.empty();
+    if (diff && !LoadSource(opt.baseline, opt.syntheticFrames, baselineCorpus)) {
+        std::fprintf(stderr, "cannot load baseline %s\n", opt.baseline.c_str());
+        return 1;
+    }
+
+    const CaptureStats stats = Analyze(corpus);
+    const CaptureStats baseline = diff ? Analyze(baselineCorpus) : CaptureStats{};
+    PrintCapture("capture", opt.capture, stats);
+    if (diff) PrintCapture("baseline", opt.baseline, baseline);
+    std::printf("layout: %s\n\n", opt.layout->name);
+
+    std::printf("offset  field          class    changes  min  max  toggled   %s\n", diff ? "new bits  range +/-" : "");
+    size_t reported = 0;
+    for (size_t k = 0; k < JOYCON_FRAME_SIZE; ++k) {
+        const ByteStats& b = stats.bytes[k];
+        uint8_t newBits = 0;
+        int rangeDelta = 0;
+        if (diff) {
+            const ByteStats& base = baseline.bytes[k];
+            newBits = static_cast<uint8_t>(b.toggled & ~base.toggled);
+            rangeDelta = (b.max - b.min) - (base.max - base.min);
+            // A baseline that was already this active says nothing new about the byte
+            if (!opt.all && newBits == 0 && rangeDelta <= 16) continue;
+        } else if (!opt.all && b.changes == 0) {
+            continue;
+        }
+
+        std::printf("0x%02zX    %-14s %-8s %7u  %3u  %3u  %s",
+            k, FieldName(opt.layout->layout, k).c_str(), Classify(b), b.changes, b.min, b.max, Bits(b.toggled).c_str());
+        if (diff) std::printf("  %s  %+d", Bits(newBits).c_str(), rangeDelta);
+        std::printf("\n");
+        ++reported;
+    }
+    if (reported == 0) std::printf("(no %s bytes)\n", diff ? "differing" : "changing");
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Capture replay: feeds a recorded session (.jc2cap, see CaptureFile.h) back through the frame
+// ring and the app's per-player pipeline (PlayerPipeline: sensor clock, decode, gyro bias,
+// fusion, stick calibration, report, gyro stick, touchpad), and prints per controller what it
+// produced. Reports are hashed, so two runs over the same capture (or before and after a change
+// anywhere in that pipeline) can be compared. Not covered: the dual Joy-Con merge (each half is
+// replayed as a single Joy-Con), mouse mode, the user's saved calibration and stick curves
+// (every run starts uncalibrated with linear curves), and ViGEm/DSU output.
+#include "CaptureReplay.h"
+#include "FrameRing.h"
+#include "PlayerPipeline.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+
+namespace {
+
+struct Options {
+    std::string capture;
+    double speed = 0.0;
+    bool step = false;
+    double seekMs = -1.0;
+    JoyConSide side = JoyConSide::Right;
+    GyroStickSettings gyroStick;
+};
+
+void PrintUsage() {
+    std::printf(
+        "usage: joycon2_replay <capture.jc2cap> [options]\n"
+        "  --speed <x>         pace at x times the captured rate (default 0: as fast as possible)\n"
+        "  --step              print each notification and wait for Enter (q quits)\n"
+        "  --seek <ms>         start this many milliseconds into the capture\n"
+        "  --side left|right   Joy-Con 2 side for the report mapping (default right)\n"
+        "  --gyro-stick off|replace|blend   gyro to right stick mode (default off)\n");
+}
+
+bool ParseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--speed" && hasValue) opt.speed = std::strtod(argv[++i], nullptr);
+        else if (arg == "--step") opt.step = true;
+        else if (arg == "--seek" && hasValue) opt.seekMs = std::strtod(argv[++i], nullptr);
+        else if (arg == "--side" && hasValue) {
+            std::string side = argv[++i];
+            if (side == "left") opt.side = JoyConSide::Left;
+            else if (side == "right") opt.side = JoyConSide::Right;
+            else return false;
+        }
+        else if (arg == "--gyro-stick" && hasValue) {
+            std::string mode = argv[++i];
+            opt.gyroStick.mode = StringToGyroStickMode(mode);
+            if (GyroStickModeToString(opt.gyroStick.mode) != mode) return false;
+        }
+        else if (arg[0] != '-' && opt.capture.empty()) opt.capture = arg;
+        else return false;
+    }
+    return !opt.capture.empty() && opt.speed >= 0.0;
+}
+
+const char* FamilyName(ControllerFamily family) {
+    switch (family) {
+    case ControllerFamily::JoyCon2: return "Joy-Con 2";
+    case ControllerFamily::ProController2: return "Pro Controller 2";
+    case ControllerFamily::NSOGC: return "NSO GameCube";
+    }
+    return "unknown";
+}
+
+// One controller's pipeline: ring -> player pipeline, run synchronously after each delivery
+// so the output does not depend on thread scheduling
+struct ReplayPipeline {
+    ControllerFamily family;
+    const GyroStickSettings& gyroStick;
+    PlayerPipeline player;
+    FrameRing ring{ FrameRingMode::Queue };
+    uint64_t reports = 0;
+    uint64_t hash = 1469598103934665603ull;   // FNV-1a over every report
+    JoyConInputFrame last{};
+
+    ReplayPipeline(ControllerFamily family, JoyConSide side, uint64_t address, const GyroStickSettings& gyroStick)
+        : family(family), gyroStick(gyroStick),
+          player(family, side, JoyConOrientation::Upright, std::to_string(address)) {}
+
+    void Process() {
+        ring.Drain([this](JoyConFrameView raw, uint32_t length, int64_t arrivalUs) {
+            last = player.Decode(raw, length, arrivalUs);
+            DS4_REPORT_EX report = player.Report(last, gyroStick);
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&report);
+            for (size_t i = 0; i < sizeof(report); ++i) hash = (hash ^ bytes[i]) * 1099511628211ull;
+            ++reports;
+        });
+    }
+};
+
+void PrintAddress(uint64_t address) {
+    for (int i = 5; i >= 0; --i) std::printf("%02X%s", static_cast<unsigned>((address >> (i * 8)) & 0xFF), i ? ":" : "");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) {
+        PrintUsage();
+        return 2;
+    }
+
+    CaptureReader reader;
+    if (!reader.Open(opt.capture)) {
+        std::fprintf(stderr, "cannot open capture %s\n", opt.capture.c_str());
+        return 1;
+    }
+    std::printf("capture: %s (%llu records, %zu controllers%s%s)\n", opt.capture.c_str(),
+        static_cast<unsigned long long>(reader.RecordCount()), reader.Controllers().size(),
+        reader.Compressed() ? ", delta-compressed" : "",
+        reader.Recovered() ? ", recovered from an unclosed file" : "");
+
+    CaptureReplay replay(reader);
+    std::deque<ReplayPipeline> pipelines;   // rings do not move
+    for (size_t c = 0; c < replay.ControllerCount(); ++c) {
+        ReplayTransport& transport = replay.Transport(c);
+        ReplayPipeline& p = pipelines.emplace_back(transport.Family(), opt.side, transport.Address(), opt.gyroStick);
+        transport.Subscribe([&p](const uint8_t* data, size_t length, int64_t arrivalUs) {
+            p.ring.Push(data, length, arrivalUs);
+            p.Process();
+        });
+    }
+    if (opt.seekMs >= 0.0) replay.Seek(reader.StartUs() + static_cast<int64_t>(opt.seekMs * 1000.0));
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t delivered = 0;
+    if (opt.step) {
+        char line[64];
+        while (replay.Step()) {
+            ++delivered;
+            std::printf("%10.3f ms", (replay.CurrentUs() - reader.StartUs()) / 1000.0);
+            for (size_t c = 0; c < pipelines.size(); ++c) {
+                const JoyConInputFrame& f = pipelines[c].last;
+                std::printf("  [%zu] buttons %012llX L %4u,%4u R %4u,%4u", c, static_cast<unsigned long long>(f.buttons),
+                    f.leftStick.x, f.leftStick.y, f.rightStick.x, f.rightStick.y);
+            }
+            std::printf("\n");
+            if (!std::fgets(line, sizeof(line), stdin) || line[0] == 'q') break;
+        }
+    } else {
+        delivered = replay.Run(opt.speed);
+    }
+    double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t c = 0; c < pipelines.size(); ++c) {
+        const ReplayPipeline& p = pipelines[c];
+        std::printf("[%zu] ", c);
+        PrintAddress(replay.Transport(c).Address());
+        std::printf("  %-16s  %8llu notifications  %8llu reports  %4llu overruns  report hash %016llX\n",
+            FamilyName(p.family), static_cast<unsigned long long>(replay.Transport(c).Delivered()),
+            static_cast<unsigned long long>(p.reports), static_cast<unsigned long long>(p.ring.Overruns()),
+            static_cast<unsigned long long>(p.hash));
+    }
+    std::printf("replayed %llu notifications in %.1f ms", static_cast<unsigned long long>(delivered), elapsedNs / 1e6);
+    if (delivered && opt.speed == 0.0 && !opt.step) std::printf(" (%.0f ns per notification)", elapsedNs / delivered);
+    std::printf("\n");
+    return 0;
+}